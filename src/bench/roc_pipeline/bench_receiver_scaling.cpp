@@ -0,0 +1,557 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+// Receiver scaling benchmark.
+//
+// A stream is encoded once by a sender pipeline and kept in memory. For every
+// number of sessions N, a new receiver is fed with N copies of this stream,
+// each coming from its own source address, while frames are read from the
+// receiver. Time is simulated: every read() advances it by one frame, and
+// packets are delivered when they become due, so the receiver sees the same
+// packet flow as in real time, but the benchmark runs as fast as possible.
+//
+// After warmup, which covers the target latency, the benchmark measures
+// CPU time, heap allocations, and duration of every read(), and prints a
+// CSV row for every N.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "roc_audio/resampler_profile.h"
+#include "roc_core/array.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/helpers.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/time.h"
+#include "roc_fec/codec_map.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+#include "roc_pipeline/port_utils.h"
+#include "roc_pipeline/receiver.h"
+#include "roc_pipeline/sender.h"
+#include "roc_rtp/format_map.h"
+
+using namespace roc;
+
+namespace {
+
+enum { MaxPacketSize = 2048, MaxSessionCounts = 64, SourcePort = 20000 };
+
+const size_t DefaultSessionCounts[] = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000 };
+
+struct Options {
+    size_t session_counts[MaxSessionCounts];
+    size_t n_session_counts;
+
+    const char* fec;
+    pipeline::PortProtocol source_proto;
+    pipeline::PortProtocol repair_proto;
+
+    const char* profile;
+    audio::ResamplerProfile profile_id;
+    bool resampling;
+
+    size_t n_frames;
+};
+
+// Counts allocations, to check that receiver doesn't allocate in steady state.
+class CountingAllocator : public core::IAllocator {
+public:
+    CountingAllocator()
+        : n_allocations_(0) {
+    }
+
+    virtual void* allocate(size_t size) {
+        n_allocations_++;
+        return heap_.allocate(size);
+    }
+
+    virtual void deallocate(void* ptr) {
+        heap_.deallocate(ptr);
+    }
+
+    size_t num_allocations() const {
+        return n_allocations_;
+    }
+
+private:
+    core::HeapAllocator heap_;
+    size_t n_allocations_;
+};
+
+struct Result {
+    size_t n_sessions;
+    size_t n_frames;
+
+    double cpu_per_frame;
+    double allocs_per_frame;
+
+    core::nanoseconds_t read_p50;
+    core::nanoseconds_t read_p99;
+    core::nanoseconds_t read_p999;
+    core::nanoseconds_t read_max;
+};
+
+core::nanoseconds_t thread_cpu_time() {
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0;
+    }
+    return core::nanoseconds_t(ts.tv_sec) * core::Second + ts.tv_nsec;
+}
+
+int compare_durations(const void* a, const void* b) {
+    const core::nanoseconds_t da = *(const core::nanoseconds_t*)a;
+    const core::nanoseconds_t db = *(const core::nanoseconds_t*)b;
+    return da < db ? -1 : da > db ? 1 : 0;
+}
+
+core::nanoseconds_t percentile(const core::Array<core::nanoseconds_t>& sorted,
+                               double p) {
+    size_t n = size_t(p * double(sorted.size()));
+    if (n >= sorted.size()) {
+        n = sorted.size() - 1;
+    }
+    return sorted[n];
+}
+
+void print_usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [--sessions=N,N,...] [--fec=none|rs8m|ldpc]"
+            " [--profile=low|medium|high] [--no-resampling] [--frames=N] [-v]\n",
+            argv0);
+}
+
+bool parse_sessions(const char* str, Options& opts) {
+    opts.n_session_counts = 0;
+
+    while (*str) {
+        char* end = NULL;
+        const long n = strtol(str, &end, 10);
+        if (end == str || n <= 0 || (*end != ',' && *end != '\0')) {
+            return false;
+        }
+        if (opts.n_session_counts == MaxSessionCounts) {
+            return false;
+        }
+        opts.session_counts[opts.n_session_counts++] = (size_t)n;
+        str = *end ? end + 1 : end;
+    }
+
+    return opts.n_session_counts != 0;
+}
+
+bool parse_options(int argc, char** argv, Options& opts) {
+    opts.n_session_counts = 0;
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(DefaultSessionCounts); n++) {
+        opts.session_counts[opts.n_session_counts++] = DefaultSessionCounts[n];
+    }
+
+    opts.fec = "none";
+    opts.source_proto = pipeline::Proto_RTP;
+    opts.repair_proto = pipeline::Proto_None;
+
+    opts.profile = "medium";
+    opts.profile_id = audio::ResamplerProfile_Medium;
+    opts.resampling = true;
+
+    opts.n_frames = 1000;
+
+    int verbosity = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+
+        if (strncmp(arg, "--sessions=", 11) == 0) {
+            if (!parse_sessions(arg + 11, opts)) {
+                fprintf(stderr, "invalid --sessions\n");
+                return false;
+            }
+        } else if (strcmp(arg, "--fec=none") == 0) {
+            opts.fec = "none";
+            opts.source_proto = pipeline::Proto_RTP;
+            opts.repair_proto = pipeline::Proto_None;
+        } else if (strcmp(arg, "--fec=rs8m") == 0) {
+            opts.fec = "rs8m";
+            opts.source_proto = pipeline::Proto_RTP_RSm8_Source;
+            opts.repair_proto = pipeline::Proto_RSm8_Repair;
+        } else if (strcmp(arg, "--fec=ldpc") == 0) {
+            opts.fec = "ldpc";
+            opts.source_proto = pipeline::Proto_RTP_LDPC_Source;
+            opts.repair_proto = pipeline::Proto_LDPC_Repair;
+        } else if (strcmp(arg, "--profile=low") == 0) {
+            opts.profile = "low";
+            opts.profile_id = audio::ResamplerProfile_Low;
+        } else if (strcmp(arg, "--profile=medium") == 0) {
+            opts.profile = "medium";
+            opts.profile_id = audio::ResamplerProfile_Medium;
+        } else if (strcmp(arg, "--profile=high") == 0) {
+            opts.profile = "high";
+            opts.profile_id = audio::ResamplerProfile_High;
+        } else if (strcmp(arg, "--no-resampling") == 0) {
+            opts.resampling = false;
+        } else if (strncmp(arg, "--frames=", 9) == 0) {
+            const long n = strtol(arg + 9, NULL, 10);
+            if (n <= 0) {
+                fprintf(stderr, "invalid --frames\n");
+                return false;
+            }
+            opts.n_frames = (size_t)n;
+        } else if (strcmp(arg, "-v") == 0) {
+            verbosity++;
+        } else {
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+
+    core::Logger::instance().set_level(LogLevel(LogError + verbosity));
+
+    return true;
+}
+
+pipeline::PortConfig make_port(pipeline::PortProtocol proto, int port) {
+    pipeline::PortConfig config;
+    config.protocol = proto;
+    if (proto != pipeline::Proto_None) {
+        if (!config.address.set_ipv4("127.0.0.1", port)) {
+            roc_panic("can't initialize port address");
+        }
+    }
+    return config;
+}
+
+pipeline::SenderConfig sender_config(const Options& opts) {
+    pipeline::SenderConfig config;
+    config.fec_encoder.scheme = pipeline::port_fec_scheme(opts.source_proto);
+    config.timing = false;
+    return config;
+}
+
+pipeline::ReceiverConfig receiver_config(const Options& opts) {
+    pipeline::ReceiverConfig config;
+    config.common.resampling = opts.resampling;
+    config.common.timing = false;
+    config.default_session.resampler = audio::resampler_profile(opts.profile_id);
+    return config;
+}
+
+// Encodes a sine wave long enough for warmup and measurement.
+bool encode_stream(const Options& opts,
+                   core::nanoseconds_t duration,
+                   const fec::CodecMap& codec_map,
+                   const rtp::FormatMap& format_map,
+                   packet::PacketPool& packet_pool,
+                   core::BufferPool<uint8_t>& byte_buffer_pool,
+                   core::BufferPool<audio::sample_t>& sample_buffer_pool,
+                   core::IAllocator& allocator,
+                   core::Array<packet::PacketPtr>& stream) {
+    const pipeline::SenderConfig config = sender_config(opts);
+
+    packet::Queue queue;
+
+    pipeline::Sender sender(config, make_port(opts.source_proto, 10001), queue,
+                            make_port(opts.repair_proto, 10002), queue,
+                            pipeline::PortConfig(), queue, codec_map, format_map,
+                            packet_pool, byte_buffer_pool, sample_buffer_pool,
+                            allocator);
+    if (!sender.valid()) {
+        roc_log(LogError, "can't create sender pipeline");
+        return false;
+    }
+
+    core::Slice<audio::sample_t> buffer =
+        new (sample_buffer_pool) core::Buffer<audio::sample_t>(sample_buffer_pool);
+    if (!buffer) {
+        roc_log(LogError, "can't allocate frame buffer");
+        return false;
+    }
+    buffer.resize(config.internal_frame_size);
+
+    const size_t num_ch = packet::num_channels(config.input_channels);
+    const size_t n_samples =
+        size_t(duration / core::Millisecond) * config.input_sample_rate / 1000;
+
+    for (size_t pos = 0; pos < n_samples;) {
+        for (size_t n = 0; n < buffer.size(); n += num_ch) {
+            const audio::sample_t sample = audio::sample_t(
+                sin(2 * M_PI * 440 * double(pos + n / num_ch) / config.input_sample_rate)
+                * 0.5);
+            for (size_t ch = 0; ch < num_ch; ch++) {
+                buffer.data()[n + ch] = sample;
+            }
+        }
+
+        audio::Frame frame(buffer.data(), buffer.size());
+        sender.write(frame);
+
+        pos += buffer.size() / num_ch;
+    }
+
+    if (!stream.grow(queue.size())) {
+        roc_log(LogError, "can't allocate stream");
+        return false;
+    }
+
+    while (packet::PacketPtr pp = queue.read()) {
+        stream.push_back(pp);
+    }
+
+    return true;
+}
+
+// Copies stream packet so that it looks as if it was received from given port.
+packet::PacketPtr copy_packet(const packet::Packet& packet,
+                              packet::PacketPool& pool,
+                              const packet::Address& src_addr,
+                              core::nanoseconds_t now) {
+    packet::PacketPtr pp = new (pool) packet::Packet(pool);
+    if (!pp) {
+        return NULL;
+    }
+
+    pp->add_flags(packet::Packet::FlagUDP);
+    pp->udp()->src_addr = src_addr;
+    pp->udp()->dst_addr = packet.udp()->dst_addr;
+    pp->udp()->receive_timestamp = now;
+
+    pp->set_data(packet.data());
+
+    return pp;
+}
+
+bool run_receiver(const Options& opts,
+                  size_t n_sessions,
+                  size_t n_warmup_frames,
+                  const core::Array<packet::PacketPtr>& stream,
+                  core::nanoseconds_t stream_duration,
+                  const fec::CodecMap& codec_map,
+                  const rtp::FormatMap& format_map,
+                  CountingAllocator& allocator,
+                  Result& result) {
+    const pipeline::ReceiverConfig config = receiver_config(opts);
+
+    core::BufferPool<uint8_t> byte_buffer_pool(allocator, MaxPacketSize, false);
+    core::BufferPool<audio::sample_t> sample_buffer_pool(
+        allocator, config.common.internal_frame_size, false);
+    packet::PacketPool packet_pool(allocator, false);
+
+    core::Array<packet::Address> addresses(allocator);
+    if (!addresses.grow(n_sessions)) {
+        roc_log(LogError, "can't allocate addresses");
+        return false;
+    }
+    for (size_t n = 0; n < n_sessions; n++) {
+        packet::Address addr;
+        if (!addr.set_ipv4("127.0.0.2", int(SourcePort + n))) {
+            roc_log(LogError, "can't initialize address");
+            return false;
+        }
+        addresses.push_back(addr);
+    }
+
+    core::Array<core::nanoseconds_t> durations(allocator);
+    if (!durations.grow(opts.n_frames)) {
+        roc_log(LogError, "can't allocate durations");
+        return false;
+    }
+
+    pipeline::Receiver receiver(config, codec_map, format_map, packet_pool,
+                                byte_buffer_pool, sample_buffer_pool, allocator);
+    if (!receiver.valid()) {
+        roc_log(LogError, "can't create receiver pipeline");
+        return false;
+    }
+
+    if (!receiver.add_port(make_port(opts.source_proto, 10001))) {
+        roc_log(LogError, "can't add receiver source port");
+        return false;
+    }
+    if (opts.repair_proto != pipeline::Proto_None) {
+        if (!receiver.add_port(make_port(opts.repair_proto, 10002))) {
+            roc_log(LogError, "can't add receiver repair port");
+            return false;
+        }
+    }
+
+    core::Slice<audio::sample_t> buffer =
+        new (sample_buffer_pool) core::Buffer<audio::sample_t>(sample_buffer_pool);
+    if (!buffer) {
+        roc_log(LogError, "can't allocate frame buffer");
+        return false;
+    }
+    buffer.resize(config.common.internal_frame_size);
+
+    const size_t num_ch = packet::num_channels(config.common.output_channels);
+    const size_t n_frames = n_warmup_frames + opts.n_frames;
+
+    size_t stream_pos = 0;
+
+    core::nanoseconds_t cpu_time = 0;
+    size_t n_allocations = 0;
+
+    for (size_t nf = 0; nf < n_frames; nf++) {
+        const core::nanoseconds_t now = core::nanoseconds_t(
+            double(nf * buffer.size() / num_ch) * core::Second
+            / config.common.output_sample_rate);
+
+        // packets are spread evenly over the stream duration
+        for (; stream_pos < stream.size(); stream_pos++) {
+            const core::nanoseconds_t due = core::nanoseconds_t(
+                double(stream_pos) * stream_duration / stream.size());
+            if (due > now) {
+                break;
+            }
+            for (size_t ns = 0; ns < n_sessions; ns++) {
+                packet::PacketPtr pp =
+                    copy_packet(*stream[stream_pos], packet_pool, addresses[ns], now);
+                if (!pp) {
+                    roc_log(LogError, "can't allocate packet");
+                    return false;
+                }
+                receiver.write(pp);
+            }
+        }
+
+        if (nf == n_warmup_frames) {
+            n_allocations = allocator.num_allocations();
+        }
+
+        audio::Frame frame(buffer.data(), buffer.size());
+
+        const core::nanoseconds_t cpu_start = thread_cpu_time();
+        const core::nanoseconds_t wall_start = core::timestamp();
+
+        if (!receiver.read(frame)) {
+            roc_log(LogError, "receiver unexpectedly returned EOF");
+            return false;
+        }
+
+        const core::nanoseconds_t wall_time = core::timestamp() - wall_start;
+        const core::nanoseconds_t frame_cpu_time = thread_cpu_time() - cpu_start;
+
+        if (nf >= n_warmup_frames) {
+            cpu_time += frame_cpu_time;
+            durations.push_back(wall_time);
+        }
+    }
+
+    n_allocations = allocator.num_allocations() - n_allocations;
+
+    if (receiver.num_sessions() != n_sessions) {
+        roc_log(LogError, "unexpected number of sessions: expected=%lu actual=%lu",
+                (unsigned long)n_sessions, (unsigned long)receiver.num_sessions());
+        return false;
+    }
+
+    qsort(&durations[0], durations.size(), sizeof(core::nanoseconds_t),
+          compare_durations);
+
+    result.n_sessions = n_sessions;
+    result.n_frames = opts.n_frames;
+    result.cpu_per_frame = double(cpu_time) / opts.n_frames;
+    result.allocs_per_frame = double(n_allocations) / opts.n_frames;
+    result.read_p50 = percentile(durations, 0.5);
+    result.read_p99 = percentile(durations, 0.99);
+    result.read_p999 = percentile(durations, 0.999);
+    result.read_max = durations[durations.size() - 1];
+
+    return true;
+}
+
+void print_header() {
+    printf("sessions,fec,profile,resampling,frames,frame_us,cpu_per_frame_us,"
+           "cpu_per_session_us,cpu_load,allocs_per_frame,"
+           "read_p50_us,read_p99_us,read_p999_us,read_max_us\n");
+}
+
+void print_result(const Options& opts,
+                  const Result& result,
+                  core::nanoseconds_t frame_duration) {
+    const double us = double(core::Microsecond);
+
+    printf("%lu,%s,%s,%d,%lu,%.1f,%.2f,%.3f,%.4f,%.3f,%.2f,%.2f,%.2f,%.2f\n",
+           (unsigned long)result.n_sessions, opts.fec, opts.profile,
+           (int)opts.resampling, (unsigned long)result.n_frames,
+           double(frame_duration) / us, result.cpu_per_frame / us,
+           result.cpu_per_frame / result.n_sessions / us,
+           result.cpu_per_frame / double(frame_duration), result.allocs_per_frame,
+           double(result.read_p50) / us, double(result.read_p99) / us,
+           double(result.read_p999) / us, double(result.read_max) / us);
+    fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!parse_options(argc, argv, opts)) {
+        return 1;
+    }
+
+    CountingAllocator allocator;
+
+    fec::CodecMap codec_map;
+    rtp::FormatMap format_map;
+
+    const pipeline::SenderConfig send_config = sender_config(opts);
+    const pipeline::ReceiverConfig recv_config = receiver_config(opts);
+
+    const size_t num_ch = packet::num_channels(recv_config.common.output_channels);
+
+    const core::nanoseconds_t frame_duration =
+        core::nanoseconds_t(recv_config.common.internal_frame_size / num_ch)
+        * core::Second / recv_config.common.output_sample_rate;
+
+    // warmup covers target latency and gives sessions time to settle
+    const size_t n_warmup_frames =
+        size_t((recv_config.default_session.target_latency + core::Second)
+               / frame_duration);
+
+    // stream is a bit longer than needed, so that sessions never run out of
+    // packets and are not terminated by watchdog
+    const core::nanoseconds_t stream_duration = frame_duration
+        * core::nanoseconds_t(n_warmup_frames + opts.n_frames)
+        + recv_config.default_session.target_latency + core::Second;
+
+    int code = 0;
+
+    {
+        core::BufferPool<uint8_t> byte_buffer_pool(allocator, MaxPacketSize, false);
+        core::BufferPool<audio::sample_t> sample_buffer_pool(
+            allocator, send_config.internal_frame_size, false);
+        packet::PacketPool packet_pool(allocator, false);
+
+        core::Array<packet::PacketPtr> stream(allocator);
+
+        if (!encode_stream(opts, stream_duration, codec_map, format_map, packet_pool,
+                           byte_buffer_pool, sample_buffer_pool, allocator, stream)) {
+            return 1;
+        }
+
+        print_header();
+
+        for (size_t n = 0; n < opts.n_session_counts; n++) {
+            Result result;
+            if (!run_receiver(opts, opts.session_counts[n], n_warmup_frames, stream,
+                              stream_duration, codec_map, format_map, allocator,
+                              result)) {
+                code = 1;
+                break;
+            }
+            print_result(opts, result, frame_duration);
+        }
+    }
+
+    return code;
+}
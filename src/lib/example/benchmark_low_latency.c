@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/* Roc low-latency benchmark.
+ *
+ * This example runs a sender and a receiver in one process, connected via the
+ * loopback interface, with low-latency settings: 2ms packets, 64-sample frames,
+ * and 10ms target latency. All threads are pinned to a single CPU core.
+ *
+ * The sender writes silence with a short impulse every half second. The receiver
+ * pushes frames to a callback from its own timer thread, and the callback detects
+ * impulses and measures the end-to-end latency.
+ *
+ * Every second, the benchmark prints measured latency, CPU usage of the process
+ * relative to one core, receiver timer jitter, and packet counters.
+ *
+ * Building:
+ *   gcc benchmark_low_latency.c -lroc -lpthread
+ *
+ * Running:
+ *   ./a.out [duration_seconds]
+ */
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include <roc/address.h>
+#include <roc/context.h>
+#include <roc/log.h>
+#include <roc/receiver.h>
+#include <roc/sender.h>
+
+/* Benchmark parameters. */
+#define BENCH_SAMPLE_RATE 44100
+#define BENCH_NUM_CHANNELS 2
+#define BENCH_FRAME_SAMPLES 64
+#define BENCH_PACKET_LENGTH 2000000ull  /* 2ms */
+#define BENCH_TARGET_LATENCY 10000000ull /* 10ms */
+#define BENCH_IMPULSE_INTERVAL (BENCH_SAMPLE_RATE / 2)
+#define BENCH_IMPULSE_VALUE 0.9f
+#define BENCH_DEFAULT_DURATION 10
+#define BENCH_CPU 0
+
+#define oops(msg)                                                                        \
+    do {                                                                                 \
+        fprintf(stderr, "oops: %s\n", msg);                                              \
+        exit(1);                                                                         \
+    } while (0)
+
+/* Measurements shared between the sender (main) thread and receiver callback. */
+static pthread_mutex_t bench_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Time when the last impulse was written, in nanoseconds. */
+static long long bench_impulse_sent;
+
+/* Latency statistics for the current report interval, in nanoseconds. */
+static long long bench_latency_min;
+static long long bench_latency_max;
+static long long bench_latency_sum;
+static long long bench_latency_count;
+
+static long long timestamp_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static long long cpu_time_ns(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ((long long)ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000000
+        + ((long long)ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) * 1000;
+}
+
+static void pin_to_cpu(void) {
+#ifdef __linux__
+    /* Threads created after this call, including network and timer threads
+     * of the library, inherit the affinity of the main thread. */
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(BENCH_CPU, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        fprintf(stderr, "warning: can't pin process to cpu %d\n", BENCH_CPU);
+    }
+#endif
+}
+
+static void receiver_callback(void* arg, const roc_frame* frame) {
+    (void)arg;
+
+    const float* samples = (const float*)frame->samples;
+    const size_t num_samples = frame->samples_size / sizeof(float);
+
+    size_t i;
+    for (i = 0; i < num_samples; i += BENCH_NUM_CHANNELS) {
+        if (samples[i] < BENCH_IMPULSE_VALUE / 2) {
+            continue;
+        }
+
+        /* Time when the impulse sample is played, relative to frame start. */
+        const long long now = timestamp_ns()
+            + (long long)(i / BENCH_NUM_CHANNELS) * 1000000000 / BENCH_SAMPLE_RATE;
+
+        pthread_mutex_lock(&bench_mutex);
+
+        if (bench_impulse_sent != 0) {
+            const long long latency = now - bench_impulse_sent;
+
+            if (bench_latency_count == 0 || latency < bench_latency_min) {
+                bench_latency_min = latency;
+            }
+            if (bench_latency_count == 0 || latency > bench_latency_max) {
+                bench_latency_max = latency;
+            }
+            bench_latency_sum += latency;
+            bench_latency_count++;
+
+            bench_impulse_sent = 0;
+        }
+
+        pthread_mutex_unlock(&bench_mutex);
+        break;
+    }
+}
+
+static void print_report(roc_sender* sender,
+                         roc_receiver* receiver,
+                         int second,
+                         long long wall_time,
+                         long long cpu_time) {
+    roc_sender_stats send_stats;
+    memset(&send_stats, 0, sizeof(send_stats));
+    roc_sender_get_stats(sender, &send_stats);
+
+    roc_receiver_stats recv_stats;
+    memset(&recv_stats, 0, sizeof(recv_stats));
+    roc_receiver_get_stats(receiver, &recv_stats);
+
+    pthread_mutex_lock(&bench_mutex);
+
+    const long long count = bench_latency_count;
+    const double lat_min = (double)bench_latency_min / 1000000;
+    const double lat_max = (double)bench_latency_max / 1000000;
+    const double lat_avg =
+        count != 0 ? (double)bench_latency_sum / (double)count / 1000000 : 0;
+
+    bench_latency_min = bench_latency_max = bench_latency_sum = bench_latency_count = 0;
+
+    pthread_mutex_unlock(&bench_mutex);
+
+    printf("%3d: cpu=%5.1f%% latency_ms=%.2f/%.2f/%.2f (min/avg/max)"
+           " jitter_us=%.1f/%.1f (mean/max) sent=%llu recv=%llu late=%llu\n",
+           second, (double)cpu_time * 100 / (double)wall_time, lat_min, lat_avg, lat_max,
+           (double)recv_stats.timer_mean_jitter / 1000,
+           (double)recv_stats.timer_max_jitter / 1000, send_stats.packets_sent,
+           recv_stats.packets_received, recv_stats.packets_late);
+}
+
+int main(int argc, char** argv) {
+    int duration = BENCH_DEFAULT_DURATION;
+    if (argc > 1) {
+        duration = atoi(argv[1]);
+        if (duration <= 0) {
+            oops("duration should be a positive number of seconds");
+        }
+    }
+
+    roc_log_set_level(ROC_LOG_ERROR);
+
+    pin_to_cpu();
+
+    /* Create context. */
+    roc_context_config context_config;
+    memset(&context_config, 0, sizeof(context_config));
+
+    roc_context* context = roc_context_open(&context_config);
+    if (!context) {
+        oops("roc_context_open");
+    }
+
+    /* Create receiver with low target latency.
+     * Automatic timing is disabled since the receiver timer thread paces reads.
+     * Resampling is disabled since both peers share the same clock. */
+    roc_receiver_config receiver_config;
+    memset(&receiver_config, 0, sizeof(receiver_config));
+
+    receiver_config.frame_sample_rate = BENCH_SAMPLE_RATE;
+    receiver_config.frame_channels = ROC_CHANNEL_SET_STEREO;
+    receiver_config.frame_encoding = ROC_FRAME_ENCODING_PCM_FLOAT;
+    receiver_config.resampler_profile = ROC_RESAMPLER_DISABLE;
+    receiver_config.target_latency = BENCH_TARGET_LATENCY;
+
+    roc_receiver* receiver = roc_receiver_open(context, &receiver_config);
+    if (!receiver) {
+        oops("roc_receiver_open");
+    }
+
+    roc_address recv_addr;
+    if (roc_address_init(&recv_addr, ROC_AF_AUTO, "127.0.0.1", 0) != 0) {
+        oops("roc_address_init");
+    }
+    if (roc_receiver_bind(receiver, ROC_PORT_AUDIO_SOURCE, ROC_PROTO_RTP, &recv_addr)
+        != 0) {
+        oops("roc_receiver_bind");
+    }
+
+    /* Create sender with small packets.
+     * FEC is disabled so that the benchmark doesn't depend on OpenFEC. */
+    roc_sender_config sender_config;
+    memset(&sender_config, 0, sizeof(sender_config));
+
+    sender_config.frame_sample_rate = BENCH_SAMPLE_RATE;
+    sender_config.frame_channels = ROC_CHANNEL_SET_STEREO;
+    sender_config.frame_encoding = ROC_FRAME_ENCODING_PCM_FLOAT;
+    sender_config.resampler_profile = ROC_RESAMPLER_DISABLE;
+    sender_config.fec_code = ROC_FEC_DISABLE;
+    sender_config.packet_length = BENCH_PACKET_LENGTH;
+    sender_config.automatic_timing = 1;
+
+    roc_sender* sender = roc_sender_open(context, &sender_config);
+    if (!sender) {
+        oops("roc_sender_open");
+    }
+
+    roc_address send_addr;
+    if (roc_address_init(&send_addr, ROC_AF_AUTO, "127.0.0.1", 0) != 0) {
+        oops("roc_address_init");
+    }
+    if (roc_sender_bind(sender, &send_addr) != 0) {
+        oops("roc_sender_bind");
+    }
+    if (roc_sender_connect(sender, ROC_PORT_AUDIO_SOURCE, ROC_PROTO_RTP, &recv_addr)
+        != 0) {
+        oops("roc_sender_connect");
+    }
+
+    /* Start pushing received frames to the callback. */
+    if (roc_receiver_start(receiver,
+                           BENCH_FRAME_SAMPLES * BENCH_NUM_CHANNELS * sizeof(float),
+                           receiver_callback, NULL)
+        != 0) {
+        oops("roc_receiver_start");
+    }
+
+    /* Write frames with periodic impulses. */
+    float samples[BENCH_FRAME_SAMPLES * BENCH_NUM_CHANNELS];
+
+    roc_frame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.samples = samples;
+    frame.samples_size = sizeof(samples);
+
+    const long long frames_per_second = BENCH_SAMPLE_RATE / BENCH_FRAME_SAMPLES;
+
+    long long n_samples = 0;
+    long long n_frames = 0;
+
+    long long report_wall = timestamp_ns();
+    long long report_cpu = cpu_time_ns();
+
+    int second = 0;
+
+    while (second < duration) {
+        memset(samples, 0, sizeof(samples));
+
+        long long impulse_pos = -1;
+
+        long long i;
+        for (i = 0; i < BENCH_FRAME_SAMPLES; i++) {
+            if ((n_samples + i) % BENCH_IMPULSE_INTERVAL == 0) {
+                samples[i * BENCH_NUM_CHANNELS] = BENCH_IMPULSE_VALUE;
+                samples[i * BENCH_NUM_CHANNELS + 1] = BENCH_IMPULSE_VALUE;
+                impulse_pos = i;
+            }
+        }
+
+        if (roc_sender_write(sender, &frame) != 0) {
+            oops("roc_sender_write");
+        }
+
+        if (impulse_pos >= 0) {
+            /* The frame was just accepted by the sender at its scheduled time. */
+            pthread_mutex_lock(&bench_mutex);
+            bench_impulse_sent =
+                timestamp_ns() + impulse_pos * 1000000000 / BENCH_SAMPLE_RATE;
+            pthread_mutex_unlock(&bench_mutex);
+        }
+
+        n_samples += BENCH_FRAME_SAMPLES;
+        n_frames++;
+
+        if (n_frames % frames_per_second == 0) {
+            const long long wall = timestamp_ns();
+            const long long cpu = cpu_time_ns();
+
+            second++;
+            print_report(sender, receiver, second, wall - report_wall, cpu - report_cpu);
+
+            report_wall = wall;
+            report_cpu = cpu;
+        }
+    }
+
+    /* Stop receiver timer thread and destroy everything. */
+    if (roc_receiver_stop(receiver) != 0) {
+        oops("roc_receiver_stop");
+    }
+
+    if (roc_sender_close(sender) != 0) {
+        oops("roc_sender_close");
+    }
+
+    if (roc_receiver_close(receiver) != 0) {
+        oops("roc_receiver_close");
+    }
+
+    if (roc_context_close(context) != 0) {
+        oops("roc_context_close");
+    }
+
+    return 0;
+}
@@ -126,6 +126,57 @@ ROC_API const char* roc_address_ip(const roc_address* address, char* buf, size_t
  */
 ROC_API int roc_address_port(const roc_address* address);
 
+/** Set multicast interface.
+ *
+ * If @p address is a multicast group used to bind a receiver port, the receiver
+ * joins the group on the network interface with the given IP address. If @p address
+ * is used to bind a sender port, outgoing packets to multicast destinations are
+ * sent via the network interface with the given IP address. If the interface is
+ * not set, it is selected by the operating system.
+ *
+ * @b Parameters
+ *  - @p address should point to a properly initialized address struct
+ *  - @p ip should point to a zero-terminated string with an IP address of the
+ *    same family as @p address
+ *
+ * @b Returns
+ *  - returns zero if the interface was successfully set
+ *  - returns a negative value if the arguments are invalid
+ */
+ROC_API int roc_address_set_multicast_interface(roc_address* address, const char* ip);
+
+/** Set TTL for outgoing multicast packets.
+ *
+ * Affects packets sent to multicast destinations from a sender port bound
+ * to @p address. If not set, the operating system default is used, which
+ * usually limits multicast traffic to the local network.
+ *
+ * @b Parameters
+ *  - @p address should point to a properly initialized address struct
+ *  - @p ttl should be in range [0; 255]
+ *
+ * @b Returns
+ *  - returns zero if the TTL was successfully set
+ *  - returns a negative value if the arguments are invalid
+ */
+ROC_API int roc_address_set_multicast_ttl(roc_address* address, int ttl);
+
+/** Enable or disable loopback of outgoing multicast packets.
+ *
+ * Affects packets sent to multicast destinations from a sender port bound
+ * to @p address. If enabled, the packets are also delivered to receivers on
+ * the local host. If not set, the operating system default is used.
+ *
+ * @b Parameters
+ *  - @p address should point to a properly initialized address struct
+ *  - @p enabled should be zero to disable loopback and non-zero to enable it
+ *
+ * @b Returns
+ *  - returns zero if the mode was successfully set
+ *  - returns a negative value if the arguments are invalid
+ */
+ROC_API int roc_address_set_multicast_loop(roc_address* address, int enabled);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
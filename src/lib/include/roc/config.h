@@ -31,7 +31,13 @@ typedef enum roc_port_type {
      * If FEC is used, this type of port is used to send or receive FEC repair packets
      * containing redundant data for audio plus some FEC headers.
      */
-    ROC_PORT_AUDIO_REPAIR = 2
+    ROC_PORT_AUDIO_REPAIR = 2,
+
+    /** Network port for control packets.
+     * This type of port is used to exchange RTCP sender and receiver reports
+     * between sender and receiver.
+     */
+    ROC_PORT_CONTROL = 3
 } roc_port_type;
 
 /** Network protocol. */
@@ -50,7 +56,10 @@ typedef enum roc_protocol {
     ROC_PROTO_RTP_LDPC_SOURCE = 4,
 
     /** FEC repair packet + FECFRAME LDPC-Staircase header (RFC 6816). */
-    ROC_PROTO_LDPC_REPAIR = 5
+    ROC_PROTO_LDPC_REPAIR = 5,
+
+    /** RTCP control packet (RFC 3550). */
+    ROC_PROTO_RTCP = 6
 } roc_protocol;
 
 /** Forward Error Correction code. */
@@ -127,6 +136,20 @@ typedef enum roc_resampler_profile {
     ROC_RESAMPLER_LOW = 3
 } roc_resampler_profile;
 
+/** Thread scheduling policy. */
+typedef enum roc_thread_policy {
+    /** Default policy.
+     * Scheduling policy and priority of the thread are not changed.
+     */
+    ROC_THREAD_POLICY_DEFAULT = 0,
+
+    /** First-in first-out realtime policy (SCHED_FIFO). */
+    ROC_THREAD_POLICY_FIFO = 1,
+
+    /** Round-robin realtime policy (SCHED_RR). */
+    ROC_THREAD_POLICY_RR = 2
+} roc_thread_policy;
+
 /** Context configuration.
  * @see roc_context
  */
@@ -144,6 +167,51 @@ typedef struct roc_context_config {
      * If zero, default value is used.
      */
     unsigned int max_frame_size;
+
+    /** Socket receive buffer size in bytes (SO_RCVBUF).
+     * Applied to every port bound by receivers using this context.
+     * If zero, the operating system default is used.
+     */
+    unsigned int socket_recv_buffer_size;
+
+    /** Socket send buffer size in bytes (SO_SNDBUF).
+     * Applied to every port bound by senders using this context.
+     * If zero, the operating system default is used.
+     */
+    unsigned int socket_send_buffer_size;
+
+    /** Number of network threads.
+     * Every network thread runs its own event loop. Ports of senders and receivers
+     * using this context are assigned to threads round-robin.
+     * If zero, one thread is used.
+     */
+    unsigned int network_threads;
+
+    /** Bind every receiver port in all network threads.
+     * If non-zero and there are several network threads, every unicast port of
+     * receivers is bound in every thread using SO_REUSEPORT, and the operating system
+     * distributes incoming flows between threads. Packets from one sender are always
+     * handled by one thread.
+     */
+    unsigned int network_reuse_port;
+
+    /** Scheduling policy of network threads.
+     * If the process doesn't have permissions to use a realtime policy, an error is
+     * logged and the threads run with the default policy.
+     */
+    roc_thread_policy network_thread_policy;
+
+    /** Scheduling priority of network threads.
+     * Used only with realtime policies. Should be in range allowed by the operating
+     * system, e.g. [1; 99] on Linux.
+     */
+    int network_thread_priority;
+
+    /** CPU affinity mask of network threads.
+     * Bit N allows the thread to run on CPU N.
+     * If zero, the affinity is not changed.
+     */
+    unsigned long long network_thread_cpu_mask;
 } roc_context_config;
 
 /** Sender configuration.
@@ -231,6 +299,22 @@ typedef struct roc_sender_config {
      * If zero, default value is used.
      */
     unsigned int fec_block_repair_packets;
+
+    /** Enable adaptive number of repair packets.
+     * Used if some FEC code is selected.
+     * If non-zero, the sender starts with @c fec_block_repair_packets repair packets
+     * per block and then adjusts this number according to the loss ratio reported
+     * via roc_sender_report_loss(), or by the receiver via RTCP if a control port
+     * is connected. In this case, @c fec_block_repair_packets is
+     * the maximum number of repair packets per block.
+     */
+    unsigned int fec_adaptive_repair;
+
+    /** RTCP sender report interval, in nanoseconds.
+     * Used only if the sender is connected to a @c ROC_PORT_CONTROL port.
+     * If zero, default value is used.
+     */
+    unsigned long long report_interval;
 } roc_sender_config;
 
 /** Receiver configuration.
@@ -259,6 +343,14 @@ typedef struct roc_receiver_config {
      */
     unsigned int automatic_timing;
 
+    /** Busy-wait interval before every frame deadline, in nanoseconds.
+     * Used when frames are pushed to a callback by roc_receiver_start(). The timer
+     * thread sleeps until the deadline minus this interval and then busy-waits,
+     * trading CPU time for wakeup accuracy.
+     * If zero, default value is used. If negative, busy-waiting is disabled.
+     */
+    long long timer_spin_time;
+
     /** Resampler profile to use.
      * If non-zero, the receiver employs resampler for two purposes:
      *  - adjust the sender clock to the receiver clock, which may differ a bit
@@ -313,6 +405,22 @@ typedef struct roc_receiver_config {
      * @see broken_playback_timeout.
      */
     unsigned long long breakage_detection_window;
+
+    /** RTCP receiver report interval, in nanoseconds.
+     * Used only if the receiver is bound to a @c ROC_PORT_CONTROL port.
+     * If zero, default value is used.
+     */
+    unsigned long long report_interval;
+
+    /** Enable early FEC repair.
+     * Used if some FEC code is selected.
+     * If non-zero, lost packets are restored as soon as their FEC block has
+     * enough source and repair packets, instead of when playback reaches the
+     * lost packet, and repair packets that are not needed anymore are released
+     * immediately. This applies to all blocks waiting in the receiver queue,
+     * not only to the block being played.
+     */
+    unsigned int fec_early_repair;
 } roc_receiver_config;
 
 #ifdef __cplusplus
@@ -19,6 +19,7 @@
 #include "roc/context.h"
 #include "roc/frame.h"
 #include "roc/platform.h"
+#include "roc/stats.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -57,6 +58,11 @@ extern "C" {
  * to the employed FEC code. Otherwise, the sender needs to be connected to a single
  * @c ROC_PORT_AUDIO_SOURCE port.
  *
+ * Receiver may also be bound to a single @c ROC_PORT_CONTROL port. It receives RTCP
+ * sender reports, and every session then periodically sends RTCP receiver reports back
+ * to the address from which its sender reports came, from a separate randomly chosen
+ * local port.
+ *
  * @b Sessions
  *
  * Receiver creates a session object for every sender connected to it. Sessions can appear
@@ -111,6 +117,14 @@ extern "C" {
  *    CPU might have slightly different clocks, and the difference will eventually lead
  *    to an underrun or an overrun.
  *
+ * Alternatively, the receiver can drive the timing itself. After roc_receiver_start(),
+ * the receiver decodes frames in its own timer thread and passes them to a user
+ * callback. Frames are scheduled at absolute deadlines derived from the sample rate,
+ * and the thread busy-waits for a short interval before every deadline to avoid
+ * scheduler wakeup latency. This mode is useful when the user passes samples to a
+ * software mixer that has no clock of its own but needs accurate pacing. Wakeup
+ * jitter of the timer thread is reported by roc_receiver_get_stats().
+ *
  * @b Thread-safety
  *  - can be used concurrently
  */
@@ -135,7 +149,7 @@ ROC_API roc_receiver* roc_receiver_open(roc_context* context,
 /** Bind the receiver to a local port.
  *
  * Binds the receiver to a local port. May be called multiple times to bind multiple
- * port. May be called at any time.
+ * port. May be called at any time. At most one @c ROC_PORT_CONTROL port may be bound.
  *
  * If @p address has zero port, the receiver is bound to a randomly chosen ephemeral
  * port. If the function succeeds, the actual port to which the receiver was bound
@@ -179,10 +193,104 @@ ROC_API int roc_receiver_bind(roc_receiver* receiver,
  */
 ROC_API int roc_receiver_read(roc_receiver* receiver, roc_frame* frame);
 
+/** Receiver frame callback.
+ *
+ * Invoked by the receiver timer thread for every decoded frame. The frame and its
+ * samples are valid only during the call. The callback should return quickly, since
+ * the next frame is not decoded until it returns.
+ *
+ * @b Parameters
+ *  - @p arg is the argument passed to roc_receiver_start()
+ *  - @p frame points to the decoded frame
+ */
+typedef void (*roc_receiver_callback)(void* arg, const roc_frame* frame);
+
+/** Start pushing frames to a callback.
+ *
+ * Starts a timer thread that decodes frames of @p frame_size bytes at the rate
+ * defined by the @c frame_sample_rate parameter and passes them to @p callback.
+ * While the receiver is started, roc_receiver_read() should not be used.
+ *
+ * The automatic timing feature should be disabled in the receiver config, since
+ * the timer thread already paces the reads.
+ *
+ * @b Parameters
+ *  - @p receiver should point to an opened receiver
+ *  - @p frame_size defines the size of every frame in bytes; should be a multiple of
+ *    the size of one sample for all channels
+ *  - @p callback should point to a function invoked for every frame
+ *  - @p arg is passed to @p callback as is
+ *
+ * @b Returns
+ *  - returns zero if the timer thread was successfully started
+ *  - returns a negative value if the arguments are invalid
+ *  - returns a negative value if the receiver is already started
+ *  - returns a negative value if automatic timing is enabled
+ *  - returns a negative value if there are not enough resources
+ */
+ROC_API int roc_receiver_start(roc_receiver* receiver,
+                               size_t frame_size,
+                               roc_receiver_callback callback,
+                               void* arg);
+
+/** Stop pushing frames to a callback.
+ *
+ * Stops the timer thread started by roc_receiver_start(). Blocks until the thread
+ * finishes; the callback is not invoked after this function returns. It's allowed
+ * to start the receiver again later.
+ *
+ * @b Parameters
+ *  - @p receiver should point to an opened receiver
+ *
+ * @b Returns
+ *  - returns zero if the timer thread was successfully stopped
+ *  - returns a negative value if the arguments are invalid
+ *  - returns a negative value if the receiver is not started
+ */
+ROC_API int roc_receiver_stop(roc_receiver* receiver);
+
+/** Get receiver statistics.
+ *
+ * Fills @p stats with packet counters summed over all bound ports and all sessions,
+ * including sessions that were already removed. Session counters are updated every
+ * time roc_receiver_read() is called.
+ *
+ * @b Parameters
+ *  - @p receiver should point to an opened receiver
+ *  - @p stats should point to a structure to be filled
+ *
+ * @b Returns
+ *  - returns zero if the statistics were successfully retrieved
+ *  - returns a negative value if the arguments are invalid
+ */
+ROC_API int roc_receiver_get_stats(roc_receiver* receiver, roc_receiver_stats* stats);
+
+/** Get statistics of a single receiver session.
+ *
+ * Fills @p stats with statistics of the session with the given index. Indices are in
+ * range [0; num_sessions), where num_sessions is reported by roc_receiver_get_stats().
+ * Since sessions may be created and removed at any time, the same index may refer to
+ * different sessions in subsequent calls.
+ *
+ * @b Parameters
+ *  - @p receiver should point to an opened receiver
+ *  - @p index defines the session index
+ *  - @p stats should point to a structure to be filled
+ *
+ * @b Returns
+ *  - returns zero if the statistics were successfully retrieved
+ *  - returns a negative value if the arguments are invalid
+ *  - returns a negative value if there is no session with the given index
+ */
+ROC_API int roc_receiver_get_session_stats(roc_receiver* receiver,
+                                           unsigned int index,
+                                           roc_session_stats* stats);
+
 /** Close the receiver.
  *
- * Deinitializes and deallocates the receiver, and detaches it from the context. The user
- * should ensure that nobody uses the receiver during and after this call. If this
+ * Deinitializes and deallocates the receiver, and detaches it from the context. Stops
+ * the timer thread if the receiver was started. The user should ensure that nobody uses
+ * the receiver during and after this call. If this
  * function fails, the receiver is kept opened and attached to the context.
  *
  * @b Parameters
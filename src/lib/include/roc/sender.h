@@ -19,6 +19,7 @@
 #include "roc/context.h"
 #include "roc/frame.h"
 #include "roc/platform.h"
+#include "roc/stats.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -64,6 +65,11 @@ extern "C" {
  *    @c ROC_FEC_RS8M is used, the corresponding protocols would be
  *    @c ROC_PROTO_RTP_RSM8_SOURCE and @c ROC_PROTO_RSM8_REPAIR.
  *
+ * In addition, a port of type @c ROC_PORT_CONTROL may be connected. The sender then
+ * periodically sends RTCP sender reports to it from a separate randomly chosen local
+ * port, and receives RTCP receiver reports sent back to that port. They are used to
+ * update link metrics reported by roc_sender_get_stats().
+ *
  * @b Resampling
  *
  * If the sample rate of the user frames and the sample rate of the network packets are
@@ -139,6 +145,12 @@ ROC_API int roc_sender_bind(roc_sender* sender, roc_address* address);
  * before calling roc_sender_write() first time. The @p type and @p proto should be
  * the same as they are set at the receiver for this port.
  *
+ * If a port of the given @p type is already connected, another destination is added
+ * for this port type. The @p proto should be the same as for the first destination.
+ * The stream is encoded once and the same packets are sent to every destination,
+ * which makes sending to many receivers much cheaper than using many senders.
+ * Control ports support only a single destination.
+ *
  * @b Parameters
  *  - @p sender should point to an opened sender
  *  - @p type specifies the receiver port type
@@ -149,6 +161,7 @@ ROC_API int roc_sender_bind(roc_sender* sender, roc_address* address);
  *  - returns zero if the sender was successfully connected to a port
  *  - returns a negative value if the arguments are invalid
  *  - returns a negative value if roc_sender_write() was already called
+ *  - returns a negative value if the port is already connected with another protocol
  */
 ROC_API int roc_sender_connect(roc_sender* sender,
                                roc_port_type type,
@@ -176,6 +189,43 @@ ROC_API int roc_sender_connect(roc_sender* sender,
  */
 ROC_API int roc_sender_write(roc_sender* sender, const roc_frame* frame);
 
+/** Report packet loss observed by the receiver.
+ *
+ * Updates the loss ratio used to adjust the number of FEC repair packets per block.
+ * The new block size is applied at the next FEC block boundary. Should be called
+ * after roc_sender_write() was called at least once. Requires the sender to be
+ * opened with a FEC code and @c fec_adaptive_repair enabled.
+ *
+ * The loss ratio is typically obtained from the receiver via some feedback channel.
+ *
+ * @b Parameters
+ *  - @p sender should point to an opened sender
+ *  - @p loss_ratio should be a fraction of lost packets, in range [0; 1]
+ *
+ * @b Returns
+ *  - returns zero if the loss ratio was successfully reported
+ *  - returns a negative value if the arguments are invalid
+ *  - returns a negative value if roc_sender_write() was not called yet
+ *  - returns a negative value if adaptive FEC is not enabled
+ */
+ROC_API int roc_sender_report_loss(roc_sender* sender, float loss_ratio);
+
+/** Get sender statistics.
+ *
+ * Fills @p stats with packet counters of the sender pipeline and the bound port, and
+ * link metrics reported by the receiver. Pipeline counters are zero until
+ * roc_sender_write() is called for the first time.
+ *
+ * @b Parameters
+ *  - @p sender should point to an opened sender
+ *  - @p stats should point to a structure to be filled
+ *
+ * @b Returns
+ *  - returns zero if the statistics were successfully retrieved
+ *  - returns a negative value if the arguments are invalid
+ */
+ROC_API int roc_sender_get_stats(roc_sender* sender, roc_sender_stats* stats);
+
 /** Close the sender.
  *
  * Deinitializes and deallocates the sender, and detaches it from the context. The user
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * @file roc/stats.h
+ * @brief Sender and receiver statistics.
+ */
+
+#ifndef ROC_STATS_H_
+#define ROC_STATS_H_
+
+#include "roc/platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Receiver statistics.
+ *
+ * Filled by roc_receiver_get_stats(). All counters are cumulative since the receiver
+ * was opened and include sessions that were already removed.
+ *
+ * @b Thread-safety
+ *  - should not be used concurrently
+ */
+typedef struct roc_receiver_stats {
+    /** Number of currently active sessions.
+     */
+    unsigned int num_sessions;
+
+    /** Number of packets received on all bound ports.
+     */
+    unsigned long long packets_received;
+
+    /** Number of bytes received on all bound ports.
+     */
+    unsigned long long bytes_received;
+
+    /** Number of packets that could not be received because of network errors.
+     */
+    unsigned long long network_errors;
+
+    /** Number of packets dropped because they arrived too late to be played.
+     */
+    unsigned long long packets_late;
+
+    /** Number of packets dropped because the session queue was full.
+     */
+    unsigned long long packets_dropped;
+
+    /** Number of packets dropped because they were duplicates.
+     */
+    unsigned long long packets_duplicated;
+
+    /** Number of lost packets recovered using FEC.
+     */
+    unsigned long long packets_recovered;
+
+    /** Number of frames passed to the callback since roc_receiver_start().
+     * Zero if the receiver is not started.
+     */
+    unsigned long long timer_frames;
+
+    /** Mean wakeup jitter of the timer thread, in nanoseconds.
+     * The distance between frame deadlines and actual wakeup times.
+     * Zero if the receiver is not started.
+     */
+    long long timer_mean_jitter;
+
+    /** Maximum wakeup jitter of the timer thread, in nanoseconds.
+     * Zero if the receiver is not started.
+     */
+    long long timer_max_jitter;
+} roc_receiver_stats;
+
+/** Receiver session statistics.
+ *
+ * Filled by roc_receiver_get_session_stats(). Counters are cumulative since the
+ * session was created.
+ *
+ * @b Thread-safety
+ *  - should not be used concurrently
+ */
+typedef struct roc_session_stats {
+    /** Number of packets received from the sender.
+     */
+    unsigned long long packets_received;
+
+    /** Number of packets dropped because they arrived too late to be played.
+     */
+    unsigned long long packets_late;
+
+    /** Number of packets dropped because the session queue was full.
+     */
+    unsigned long long packets_dropped;
+
+    /** Number of packets dropped because they were duplicates.
+     */
+    unsigned long long packets_duplicated;
+
+    /** Number of lost packets recovered using FEC.
+     */
+    unsigned long long packets_recovered;
+
+    /** Number of packets in the session queue.
+     */
+    unsigned int queue_size;
+
+    /** Current session latency, in nanoseconds.
+     * The distance between the last received packet and the playback position.
+     */
+    long long latency;
+
+    /** Current resampler scaling factor.
+     * Equal to 1 if resampling is disabled.
+     */
+    float resampler_scaling;
+
+    /** Fraction of packets lost during the last RTCP report interval, in range [0; 1].
+     */
+    float fraction_lost;
+
+    /** Cumulative number of packets lost in network, before FEC recovery.
+     */
+    long long cumulative_lost;
+
+    /** Interarrival jitter, in nanoseconds.
+     */
+    long long jitter;
+} roc_session_stats;
+
+/** Sender statistics.
+ *
+ * Filled by roc_sender_get_stats(). All counters are cumulative since the sender
+ * was opened.
+ *
+ * @b Thread-safety
+ *  - should not be used concurrently
+ */
+typedef struct roc_sender_stats {
+    /** Number of source packets produced, summed over all connected source ports.
+     */
+    unsigned long long source_packets;
+
+    /** Number of repair packets produced, summed over all connected repair ports.
+     */
+    unsigned long long repair_packets;
+
+    /** Number of control packets produced.
+     */
+    unsigned long long control_packets;
+
+    /** Number of packets actually sent from the bound port.
+     */
+    unsigned long long packets_sent;
+
+    /** Number of bytes actually sent from the bound port.
+     */
+    unsigned long long bytes_sent;
+
+    /** Number of packets that could not be sent because of network errors.
+     */
+    unsigned long long network_errors;
+
+    /** Number of source packets in the current FEC block.
+     * Zero if FEC is disabled.
+     */
+    unsigned int fec_block_source_packets;
+
+    /** Number of repair packets in the current FEC block.
+     * Zero if FEC is disabled.
+     */
+    unsigned int fec_block_repair_packets;
+
+    /** Fraction of packets lost, as reported by the receiver via RTCP.
+     * Zero if the control port is not connected.
+     */
+    float fraction_lost;
+
+    /** Interarrival jitter in nanoseconds, as reported by the receiver via RTCP.
+     * Zero if the control port is not connected.
+     */
+    long long jitter;
+
+    /** Round-trip time in nanoseconds, calculated from RTCP reports.
+     * Zero if the control port is not connected or RTT is not known yet.
+     */
+    long long rtt;
+} roc_sender_stats;
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* ROC_STATS_H_ */
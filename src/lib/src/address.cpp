@@ -118,3 +118,55 @@ int roc_address_port(const roc_address* address) {
 
     return port;
 }
+
+int roc_address_set_multicast_interface(roc_address* address, const char* ip) {
+    if (!address) {
+        return -1;
+    }
+
+    if (!ip) {
+        return -1;
+    }
+
+    packet::Address& pa = get_address(address);
+
+    if (!pa.set_miface(ip)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int roc_address_set_multicast_ttl(roc_address* address, int ttl) {
+    if (!address) {
+        return -1;
+    }
+
+    packet::Address& pa = get_address(address);
+
+    if (!pa.valid()) {
+        return -1;
+    }
+
+    if (!pa.set_multicast_ttl(ttl)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int roc_address_set_multicast_loop(roc_address* address, int enabled) {
+    if (!address) {
+        return -1;
+    }
+
+    packet::Address& pa = get_address(address);
+
+    if (!pa.valid()) {
+        return -1;
+    }
+
+    pa.set_multicast_loop(enabled != 0);
+
+    return 0;
+}
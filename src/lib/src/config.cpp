@@ -27,6 +27,27 @@ bool make_context_config(roc_context_config& out, const roc_context_config& in)
         out.max_frame_size = 4096;
     }
 
+    out.socket_recv_buffer_size = in.socket_recv_buffer_size;
+    out.socket_send_buffer_size = in.socket_send_buffer_size;
+
+    switch ((int)in.network_thread_policy) {
+    case ROC_THREAD_POLICY_DEFAULT:
+    case ROC_THREAD_POLICY_FIFO:
+    case ROC_THREAD_POLICY_RR:
+        break;
+
+    default:
+        roc_log(LogError, "roc_config: invalid network_thread_policy");
+        return false;
+    }
+
+    out.network_threads = in.network_threads;
+    out.network_reuse_port = in.network_reuse_port;
+
+    out.network_thread_policy = in.network_thread_policy;
+    out.network_thread_priority = in.network_thread_priority;
+    out.network_thread_cpu_mask = in.network_thread_cpu_mask;
+
     return true;
 }
 
@@ -113,6 +134,18 @@ bool make_sender_config(pipeline::SenderConfig& out, const roc_sender_config& in
         out.fec_writer.n_repair_packets = in.fec_block_repair_packets;
     }
 
+    if (in.fec_adaptive_repair) {
+        out.adaptive_fec = true;
+        out.fec_controller.max_repair_packets = out.fec_writer.n_repair_packets;
+        if (out.fec_controller.min_repair_packets > out.fec_writer.n_repair_packets) {
+            out.fec_controller.min_repair_packets = out.fec_writer.n_repair_packets;
+        }
+    }
+
+    if (in.report_interval != 0) {
+        out.report_interval = (core::nanoseconds_t)in.report_interval;
+    }
+
     return true;
 }
 
@@ -136,6 +169,12 @@ bool make_receiver_config(pipeline::ReceiverConfig& out, const roc_receiver_conf
 
     out.common.timing = in.automatic_timing;
 
+    if (in.timer_spin_time < 0) {
+        out.common.timer_spin_time = 0;
+    } else if (in.timer_spin_time > 0) {
+        out.common.timer_spin_time = in.timer_spin_time;
+    }
+
     out.common.resampling = (in.resampler_profile != ROC_RESAMPLER_DISABLE);
 
     switch ((int)in.resampler_profile) {
@@ -210,6 +249,12 @@ bool make_receiver_config(pipeline::ReceiverConfig& out, const roc_receiver_conf
             (core::nanoseconds_t)in.breakage_detection_window;
     }
 
+    if (in.report_interval != 0) {
+        out.common.report_interval = (core::nanoseconds_t)in.report_interval;
+    }
+
+    out.default_session.fec_reader.early_repair = (in.fec_early_repair != 0);
+
     return true;
 }
 
@@ -249,6 +294,17 @@ bool make_port_config(pipeline::PortConfig& out,
         }
         break;
 
+    case ROC_PORT_CONTROL:
+        switch ((int)proto) {
+        case ROC_PROTO_RTCP:
+            out.protocol = pipeline::Proto_RTCP;
+            break;
+        default:
+            roc_log(LogError, "roc_config: invalid protocol for control port");
+            return false;
+        }
+        break;
+
     default:
         roc_log(LogError, "roc_config: invalid port type");
         return false;
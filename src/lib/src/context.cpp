@@ -12,11 +12,40 @@
 
 using namespace roc;
 
+namespace {
+
+netio::TransceiverConfig make_transceiver_config(const roc_context_config& cfg) {
+    netio::TransceiverConfig trx_config;
+    trx_config.recv_buffer_size = cfg.socket_recv_buffer_size;
+    trx_config.send_buffer_size = cfg.socket_send_buffer_size;
+
+    trx_config.num_loops = cfg.network_threads;
+    trx_config.reuse_port = cfg.network_reuse_port != 0;
+
+    switch ((int)cfg.network_thread_policy) {
+    case ROC_THREAD_POLICY_FIFO:
+        trx_config.thread_params.policy = core::ThreadPolicyFifo;
+        break;
+    case ROC_THREAD_POLICY_RR:
+        trx_config.thread_params.policy = core::ThreadPolicyRoundRobin;
+        break;
+    default:
+        break;
+    }
+
+    trx_config.thread_params.priority = cfg.network_thread_priority;
+    trx_config.thread_params.cpu_mask = cfg.network_thread_cpu_mask;
+
+    return trx_config;
+}
+
+} // namespace
+
 roc_context::roc_context(const roc_context_config& cfg)
-    : packet_pool(allocator, false)
+    : packet_pool(allocator, false, cfg.max_packet_size)
     , byte_buffer_pool(allocator, cfg.max_packet_size, false)
     , sample_buffer_pool(allocator, cfg.max_frame_size / sizeof(audio::sample_t), false)
-    , trx(packet_pool, byte_buffer_pool, allocator)
+    , trx(make_transceiver_config(cfg), packet_pool, byte_buffer_pool, allocator)
     , counter(0) {
 }
 
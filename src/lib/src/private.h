@@ -16,6 +16,7 @@
 
 #include "roc_audio/units.h"
 #include "roc_core/atomic.h"
+#include "roc_core/array.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
 #include "roc_core/mutex.h"
@@ -27,6 +28,7 @@
 #include "roc_pipeline/receiver.h"
 #include "roc_pipeline/sender.h"
 #include "roc_rtp/format_map.h"
+#include "roc_sndio/frame_timer.h"
 
 const roc::packet::Address& get_address(const roc_address* address);
 roc::packet::Address& get_address(roc_address* address);
@@ -68,12 +70,18 @@ struct roc_sender {
 
     roc::pipeline::PortConfig source_port;
     roc::pipeline::PortConfig repair_port;
+    roc::pipeline::PortConfig control_port;
+
+    roc::core::Array<roc::pipeline::PortConfig> extra_ports;
 
     roc::core::UniquePtr<roc::pipeline::Sender> sender;
     roc::packet::IWriter* writer;
 
     roc::packet::Address address;
 
+    roc::packet::IWriter* control_writer;
+    roc::packet::Address control_address;
+
     roc::core::Mutex mutex;
 
     size_t num_channels;
@@ -90,6 +98,19 @@ struct roc_receiver {
     roc::pipeline::Receiver receiver;
 
     size_t num_channels;
+
+    roc::core::nanoseconds_t timer_spin_time;
+
+    roc::packet::IWriter* control_writer;
+    roc::packet::Address control_address;
+
+    roc::core::UniquePtr<roc::sndio::FrameTimer> timer;
+
+    roc_receiver_callback callback;
+    void* callback_arg;
+
+    roc::core::Atomic started;
+    roc::core::Mutex timer_mutex;
 };
 
 #endif // ROC_PRIVATE_H_
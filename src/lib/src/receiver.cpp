@@ -9,6 +9,7 @@
 #include "private.h"
 
 #include "roc_core/log.h"
+#include "roc_core/stddefs.h"
 #include "roc_pipeline/port_to_str.h"
 
 using namespace roc;
@@ -22,6 +23,91 @@ void receiver_close_port(void* arg, const pipeline::PortConfig& port) {
     receiver->context.trx.remove_port(port.address);
 }
 
+struct ReceiverPortStats {
+    roc_receiver* receiver;
+    netio::PortStats total;
+};
+
+void receiver_add_port_stats(void* arg, const pipeline::PortConfig& port) {
+    roc_panic_if_not(arg);
+    ReceiverPortStats& port_stats = *(ReceiverPortStats*)arg;
+
+    netio::PortStats stats;
+    if (!port_stats.receiver->context.trx.get_port_stats(port.address, stats)) {
+        return;
+    }
+
+    port_stats.total.packets += stats.packets;
+    port_stats.total.bytes += stats.bytes;
+    port_stats.total.errors += stats.errors;
+}
+
+struct ReceiverSessionLookup {
+    size_t index;
+    size_t current;
+    roc_session_stats* result;
+};
+
+void receiver_find_session_stats(void* arg, const pipeline::ReceiverSessionStats& stats) {
+    roc_panic_if_not(arg);
+    ReceiverSessionLookup& lookup = *(ReceiverSessionLookup*)arg;
+
+    if (lookup.current++ != lookup.index) {
+        return;
+    }
+
+    roc_session_stats& out = *lookup.result;
+
+    out.packets_received = stats.packets.received;
+    out.packets_late = stats.packets.late;
+    out.packets_dropped = stats.packets.dropped;
+    out.packets_duplicated = stats.packets.duplicated;
+    out.packets_recovered = stats.packets.restored;
+    out.queue_size = (unsigned int)stats.queue_size;
+    out.latency = stats.latency;
+    out.resampler_scaling = stats.scaling;
+    out.fraction_lost = stats.link.fraction_lost;
+    out.cumulative_lost = stats.link.cumulative_lost;
+    out.jitter = stats.link.jitter;
+}
+
+// Opens a socket for outgoing receiver reports. It is bound to a random port,
+// since reports are sent to the address from which sender packets came.
+bool receiver_open_control_writer(roc_receiver* receiver,
+                                  const packet::Address& control_address) {
+    packet::Address& addr = receiver->control_address;
+
+    if (control_address.version() == 6) {
+        if (!addr.set_ipv6("::", 0)) {
+            return false;
+        }
+    } else {
+        if (!addr.set_ipv4("0.0.0.0", 0)) {
+            return false;
+        }
+    }
+
+    receiver->control_writer = receiver->context.trx.add_udp_sender(addr);
+    if (!receiver->control_writer) {
+        return false;
+    }
+
+    receiver->receiver.set_control_writer(receiver->control_writer);
+
+    return true;
+}
+
+void receiver_push_frame(void* arg, audio::Frame& frame) {
+    roc_panic_if_not(arg);
+    roc_receiver* receiver = (roc_receiver*)arg;
+
+    roc_frame out;
+    out.samples = frame.data();
+    out.samples_size = frame.size() * sizeof(float);
+
+    receiver->callback(receiver->callback_arg, &out);
+}
+
 } // namespace
 
 roc_receiver::roc_receiver(roc_context& ctx, pipeline::ReceiverConfig& cfg)
@@ -33,7 +119,11 @@ roc_receiver::roc_receiver(roc_context& ctx, pipeline::ReceiverConfig& cfg)
                context.byte_buffer_pool,
                context.sample_buffer_pool,
                context.allocator)
-    , num_channels(packet::num_channels(cfg.common.output_channels)) {
+    , num_channels(packet::num_channels(cfg.common.output_channels))
+    , timer_spin_time(cfg.common.timer_spin_time)
+    , control_writer(NULL)
+    , callback(NULL)
+    , callback_arg(NULL) {
 }
 
 roc_receiver* roc_receiver_open(roc_context* context, const roc_receiver_config* config) {
@@ -94,6 +184,11 @@ int roc_receiver_bind(roc_receiver* receiver,
         return -1;
     }
 
+    if (type == ROC_PORT_CONTROL && receiver->control_writer) {
+        roc_log(LogError, "roc_receiver_bind: control port is already bound");
+        return -1;
+    }
+
     if (!receiver->context.trx.add_udp_receiver(addr, receiver->receiver)) {
         roc_log(LogError, "roc_receiver_bind: bind failed");
         return -1;
@@ -110,6 +205,13 @@ int roc_receiver_bind(roc_receiver* receiver,
         return -1;
     }
 
+    if (type == ROC_PORT_CONTROL) {
+        if (!receiver_open_control_writer(receiver, addr)) {
+            roc_log(LogError, "roc_receiver_bind: can't open port for receiver reports");
+            return -1;
+        }
+    }
+
     roc_log(LogInfo, "roc_receiver: bound to %s",
             pipeline::port_to_str(port_config).c_str());
 
@@ -127,6 +229,11 @@ int roc_receiver_read(roc_receiver* receiver, roc_frame* frame) {
         return -1;
     }
 
+    if (receiver->started) {
+        roc_log(LogError, "roc_receiver_read: receiver is started");
+        return -1;
+    }
+
     if (frame->samples_size == 0) {
         return 0;
     }
@@ -152,6 +259,179 @@ int roc_receiver_read(roc_receiver* receiver, roc_frame* frame) {
     return 0;
 }
 
+int roc_receiver_start(roc_receiver* receiver,
+                       size_t frame_size,
+                       roc_receiver_callback callback,
+                       void* arg) {
+    if (!receiver) {
+        roc_log(LogError, "roc_receiver_start: invalid arguments: receiver is null");
+        return -1;
+    }
+
+    if (!callback) {
+        roc_log(LogError, "roc_receiver_start: invalid arguments: callback is null");
+        return -1;
+    }
+
+    const size_t step = receiver->num_channels * sizeof(float);
+
+    if (frame_size == 0 || frame_size % step != 0) {
+        roc_log(LogError,
+                "roc_receiver_start: invalid arguments: frame size should be "
+                "non-zero multiple of %u",
+                (unsigned)step);
+        return -1;
+    }
+
+    core::Mutex::Lock lock(receiver->timer_mutex);
+
+    if (receiver->timer) {
+        roc_log(LogError, "roc_receiver_start: receiver is already started");
+        return -1;
+    }
+
+    if (receiver->receiver.has_clock()) {
+        roc_log(LogError,
+                "roc_receiver_start: automatic timing should be disabled in config");
+        return -1;
+    }
+
+    receiver->callback = callback;
+    receiver->callback_arg = arg;
+
+    core::UniquePtr<sndio::FrameTimer> timer(
+        new (receiver->context.allocator) sndio::FrameTimer(
+            receiver->receiver, receiver->context.allocator, receiver->num_channels,
+            frame_size / sizeof(float), receiver->timer_spin_time, receiver_push_frame,
+            receiver),
+        receiver->context.allocator);
+
+    if (!timer) {
+        roc_log(LogError, "roc_receiver_start: can't allocate timer");
+        return -1;
+    }
+
+    if (!timer->valid()) {
+        roc_log(LogError, "roc_receiver_start: can't initialize timer");
+        return -1;
+    }
+
+    receiver->started = true;
+
+    if (!timer->start()) {
+        roc_log(LogError, "roc_receiver_start: can't start timer thread");
+        receiver->started = false;
+        return -1;
+    }
+
+    receiver->timer.reset(timer.release(), receiver->context.allocator);
+
+    roc_log(LogInfo, "roc_receiver: started timer thread: frame_size=%lu",
+            (unsigned long)frame_size);
+
+    return 0;
+}
+
+int roc_receiver_stop(roc_receiver* receiver) {
+    if (!receiver) {
+        roc_log(LogError, "roc_receiver_stop: invalid arguments: receiver is null");
+        return -1;
+    }
+
+    core::Mutex::Lock lock(receiver->timer_mutex);
+
+    if (!receiver->timer) {
+        roc_log(LogError, "roc_receiver_stop: receiver is not started");
+        return -1;
+    }
+
+    receiver->timer->stop();
+    receiver->timer.reset();
+
+    receiver->started = false;
+
+    roc_log(LogInfo, "roc_receiver: stopped timer thread");
+
+    return 0;
+}
+
+int roc_receiver_get_stats(roc_receiver* receiver, roc_receiver_stats* stats) {
+    if (!receiver) {
+        roc_log(LogError, "roc_receiver_get_stats: invalid arguments: receiver is null");
+        return -1;
+    }
+
+    if (!stats) {
+        roc_log(LogError, "roc_receiver_get_stats: invalid arguments: stats is null");
+        return -1;
+    }
+
+    ReceiverPortStats port_stats;
+    port_stats.receiver = receiver;
+
+    receiver->receiver.iterate_ports(receiver_add_port_stats, &port_stats);
+
+    pipeline::ReceiverStats pipeline_stats;
+    receiver->receiver.get_stats(pipeline_stats);
+
+    memset(stats, 0, sizeof(*stats));
+
+    stats->num_sessions = (unsigned int)pipeline_stats.num_sessions;
+    stats->packets_received = port_stats.total.packets;
+    stats->bytes_received = port_stats.total.bytes;
+    stats->network_errors = port_stats.total.errors;
+    stats->packets_late = pipeline_stats.packets.late;
+    stats->packets_dropped = pipeline_stats.packets.dropped;
+    stats->packets_duplicated = pipeline_stats.packets.duplicated;
+    stats->packets_recovered = pipeline_stats.packets.restored;
+
+    core::Mutex::Lock lock(receiver->timer_mutex);
+
+    if (receiver->timer) {
+        core::DeadlineTimerStats timer_stats;
+        receiver->timer->get_stats(timer_stats);
+
+        stats->timer_frames = timer_stats.num_waits;
+        stats->timer_mean_jitter = timer_stats.mean_jitter;
+        stats->timer_max_jitter = timer_stats.max_jitter;
+    }
+
+    return 0;
+}
+
+int roc_receiver_get_session_stats(roc_receiver* receiver,
+                                   unsigned int index,
+                                   roc_session_stats* stats) {
+    if (!receiver) {
+        roc_log(LogError,
+                "roc_receiver_get_session_stats: invalid arguments: receiver is null");
+        return -1;
+    }
+
+    if (!stats) {
+        roc_log(LogError,
+                "roc_receiver_get_session_stats: invalid arguments: stats is null");
+        return -1;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+
+    ReceiverSessionLookup lookup;
+    lookup.index = index;
+    lookup.current = 0;
+    lookup.result = stats;
+
+    receiver->receiver.iterate_sessions(receiver_find_session_stats, &lookup);
+
+    if (lookup.current <= index) {
+        roc_log(LogDebug, "roc_receiver_get_session_stats: no session with index %u",
+                index);
+        return -1;
+    }
+
+    return 0;
+}
+
 int roc_receiver_close(roc_receiver* receiver) {
     if (!receiver) {
         roc_log(LogError, "roc_receiver_close: invalid arguments: receiver is null");
@@ -160,7 +440,20 @@ int roc_receiver_close(roc_receiver* receiver) {
 
     roc_context& context = receiver->context;
 
+    {
+        core::Mutex::Lock lock(receiver->timer_mutex);
+
+        if (receiver->timer) {
+            receiver->timer->stop();
+            receiver->timer.reset();
+        }
+    }
+
     receiver->receiver.iterate_ports(receiver_close_port, receiver);
+
+    if (receiver->control_writer) {
+        context.trx.remove_port(receiver->control_address);
+    }
     receiver->context.allocator.destroy(*receiver);
     --context.counter;
 
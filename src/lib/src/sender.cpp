@@ -9,6 +9,7 @@
 #include "private.h"
 
 #include "roc_core/log.h"
+#include "roc_core/stddefs.h"
 #include "roc_packet/address_to_str.h"
 #include "roc_pipeline/port_to_str.h"
 #include "roc_pipeline/port_utils.h"
@@ -17,13 +18,57 @@ using namespace roc;
 
 namespace {
 
+// Opens a socket for control packets. It is bound to the same IP as the sender
+// and to a random port. Receivers send reports back to the address from which
+// sender reports came, so the socket is also used to receive them.
+bool sender_open_control_writer(roc_sender* sender) {
+    char ip[64];
+    if (!sender->address.get_ip(ip, sizeof(ip))) {
+        return false;
+    }
+
+    packet::Address& addr = sender->control_address;
+
+    if (sender->address.version() == 6) {
+        if (!addr.set_ipv6(ip, 0)) {
+            return false;
+        }
+    } else {
+        if (!addr.set_ipv4(ip, 0)) {
+            return false;
+        }
+    }
+
+    sender->control_writer = sender->context.trx.add_udp_sender(addr);
+    if (!sender->control_writer) {
+        return false;
+    }
+
+    roc_log(LogInfo, "roc_sender: bound control port to %s",
+            packet::address_to_str(addr).c_str());
+
+    return true;
+}
+
 bool sender_init_pipeline(roc_sender* sender) {
+    if (sender->control_port.protocol != pipeline::Proto_None
+        && !sender->control_writer) {
+        if (!sender_open_control_writer(sender)) {
+            roc_log(LogError, "roc_sender: can't open control port");
+            return false;
+        }
+    }
+
+    packet::IWriter* control_writer =
+        sender->control_writer ? sender->control_writer : sender->writer;
+
     sender->sender.reset(
         new (sender->context.allocator) pipeline::Sender(
             sender->config, sender->source_port, *sender->writer, sender->repair_port,
-            *sender->writer, sender->codec_map, sender->format_map,
-            sender->context.packet_pool, sender->context.byte_buffer_pool,
-            sender->context.sample_buffer_pool, sender->context.allocator),
+            *sender->writer, sender->control_port, *control_writer, sender->codec_map,
+            sender->format_map, sender->context.packet_pool,
+            sender->context.byte_buffer_pool, sender->context.sample_buffer_pool,
+            sender->context.allocator),
         sender->context.allocator);
 
     if (!sender->sender) {
@@ -36,6 +81,45 @@ bool sender_init_pipeline(roc_sender* sender) {
         return false;
     }
 
+    for (size_t n = 0; n < sender->extra_ports.size(); n++) {
+        if (!sender->sender->add_destination(sender->extra_ports[n])) {
+            roc_log(LogError, "roc_sender: can't add destination to sender pipeline");
+            return false;
+        }
+    }
+
+    if (sender->control_writer) {
+        if (!sender->context.trx.start_receiving(sender->control_address,
+                                                 *sender->sender)) {
+            roc_log(LogError, "roc_sender: can't receive control packets");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool sender_add_extra_port(roc_sender* sender,
+                           const pipeline::PortConfig& current_port,
+                           const pipeline::PortConfig& port_config) {
+    if (current_port.protocol != port_config.protocol) {
+        roc_log(LogError,
+                "roc_sender: port is already set to %s, additional destinations"
+                " should use the same protocol",
+                pipeline::port_to_str(current_port).c_str());
+        return false;
+    }
+
+    if (!sender->extra_ports.grow(sender->extra_ports.size() + 1)) {
+        roc_log(LogError, "roc_sender: can't allocate port");
+        return false;
+    }
+
+    sender->extra_ports.push_back(port_config);
+
+    roc_log(LogInfo, "roc_sender: added destination %s",
+            pipeline::port_to_str(port_config).c_str());
+
     return true;
 }
 
@@ -45,8 +129,7 @@ bool sender_set_port(roc_sender* sender,
     switch ((int)type) {
     case ROC_PORT_AUDIO_SOURCE:
         if (sender->source_port.protocol != pipeline::Proto_None) {
-            roc_log(LogError, "roc_sender: audio source port is already set");
-            return false;
+            return sender_add_extra_port(sender, sender->source_port, port_config);
         }
 
         if (!pipeline::validate_port(sender->config.fec_encoder.scheme,
@@ -71,8 +154,7 @@ bool sender_set_port(roc_sender* sender,
 
     case ROC_PORT_AUDIO_REPAIR:
         if (sender->repair_port.protocol != pipeline::Proto_None) {
-            roc_log(LogError, "roc_sender: audio repair port is already set");
-            return false;
+            return sender_add_extra_port(sender, sender->repair_port, port_config);
         }
 
         if (!pipeline::validate_port(sender->config.fec_encoder.scheme,
@@ -94,6 +176,24 @@ bool sender_set_port(roc_sender* sender,
                 pipeline::port_to_str(port_config).c_str());
 
         return true;
+
+    case ROC_PORT_CONTROL:
+        if (sender->control_port.protocol != pipeline::Proto_None) {
+            roc_log(LogError, "roc_sender: control port is already set");
+            return false;
+        }
+
+        if (port_config.protocol != pipeline::Proto_RTCP) {
+            roc_log(LogError, "roc_sender: control port requires rtcp protocol");
+            return false;
+        }
+
+        sender->control_port = port_config;
+
+        roc_log(LogInfo, "roc_sender: set control port to %s",
+                pipeline::port_to_str(port_config).c_str());
+
+        return true;
     }
 
     roc_log(LogError, "roc_sender: invalid protocol");
@@ -120,7 +220,9 @@ bool sender_check_connected(roc_sender* sender) {
 roc_sender::roc_sender(roc_context& ctx, pipeline::SenderConfig& cfg)
     : context(ctx)
     , config(cfg)
+    , extra_ports(ctx.allocator)
     , writer(NULL)
+    , control_writer(NULL)
     , num_channels(packet::num_channels(cfg.input_channels)) {
 }
 
@@ -297,12 +399,88 @@ int roc_sender_write(roc_sender* sender, const roc_frame* frame) {
     return 0;
 }
 
+int roc_sender_report_loss(roc_sender* sender, float loss_ratio) {
+    if (!sender) {
+        roc_log(LogError, "roc_sender_report_loss: invalid arguments: sender is null");
+        return -1;
+    }
+
+    if (!(loss_ratio >= 0 && loss_ratio <= 1)) {
+        roc_log(LogError,
+                "roc_sender_report_loss: invalid arguments: loss ratio out of range");
+        return -1;
+    }
+
+    core::Mutex::Lock lock(sender->mutex);
+
+    if (!sender->sender || !sender->sender->valid()) {
+        roc_log(LogError, "roc_sender_report_loss: sender is not initialized");
+        return -1;
+    }
+
+    if (!sender->sender->report_loss(loss_ratio)) {
+        roc_log(LogError, "roc_sender_report_loss: adaptive fec is not enabled");
+        return -1;
+    }
+
+    return 0;
+}
+
+int roc_sender_get_stats(roc_sender* sender, roc_sender_stats* stats) {
+    if (!sender) {
+        roc_log(LogError, "roc_sender_get_stats: invalid arguments: sender is null");
+        return -1;
+    }
+
+    if (!stats) {
+        roc_log(LogError, "roc_sender_get_stats: invalid arguments: stats is null");
+        return -1;
+    }
+
+    core::Mutex::Lock lock(sender->mutex);
+
+    memset(stats, 0, sizeof(*stats));
+
+    if (sender->writer) {
+        netio::PortStats port_stats;
+        if (sender->context.trx.get_port_stats(sender->address, port_stats)) {
+            stats->packets_sent = port_stats.packets;
+            stats->bytes_sent = port_stats.bytes;
+            stats->network_errors = port_stats.errors;
+        }
+    }
+
+    if (sender->sender && sender->sender->valid()) {
+        pipeline::SenderStats pipeline_stats;
+        sender->sender->get_stats(pipeline_stats);
+
+        stats->source_packets = pipeline_stats.source_packets;
+        stats->repair_packets = pipeline_stats.repair_packets;
+        stats->control_packets = pipeline_stats.control_packets;
+        stats->fec_block_source_packets =
+            (unsigned int)pipeline_stats.fec_block_source_packets;
+        stats->fec_block_repair_packets =
+            (unsigned int)pipeline_stats.fec_block_repair_packets;
+        stats->fraction_lost = pipeline_stats.link.fraction_lost;
+        stats->jitter = pipeline_stats.link.jitter;
+        stats->rtt = pipeline_stats.link.rtt;
+    }
+
+    return 0;
+}
+
 int roc_sender_close(roc_sender* sender) {
     if (!sender) {
         roc_log(LogError, "roc_sender_close: invalid arguments: sender is null");
         return -1;
     }
 
+    // control port passes incoming packets to the pipeline, so it should be
+    // removed before the pipeline is destroyed
+    if (sender->control_writer) {
+        sender->context.trx.remove_port(sender->control_address);
+    }
+
     if (sender->writer) {
         sender->context.trx.remove_port(sender->address);
     }
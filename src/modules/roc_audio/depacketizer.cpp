@@ -10,6 +10,7 @@
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/trace.h"
 
 namespace roc {
 namespace audio {
@@ -61,7 +62,13 @@ packet::timestamp_t Depacketizer::timestamp() const {
     return timestamp_;
 }
 
+size_t Depacketizer::num_late_packets() const {
+    return dropped_packets_;
+}
+
 void Depacketizer::read(Frame& frame) {
+    roc_trace_scope("depacketizer.read");
+
     const size_t prev_dropped_packets = dropped_packets_;
     const packet::timestamp_t prev_packet_samples = packet_samples_;
 
@@ -51,6 +51,9 @@ public:
     //!  started() should return true
     packet::timestamp_t timestamp() const;
 
+    //! Get number of packets dropped because they were late.
+    size_t num_late_packets() const;
+
 private:
     void read_frame_(Frame& frame);
 
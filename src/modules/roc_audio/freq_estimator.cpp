@@ -17,25 +17,32 @@ namespace {
 const float P = 100e-8f; // Proportional gain of PI-controller.
 const float I = 0.5e-8f; // Integral gain of PI-controller.
 
-// Calculates dot product of arrays IR of filter (@p coeff) and input array (@p samples).
+// Calculates dot product of arrays IR of filter (@p coeff) and last fe_decim_len
+// samples of input array (@p samples).
 //
-// - @p coeff Filter impulse response.
-// - @p samples Array with sample values.
-// - @p sample_ind index in input array to start from.
-// - @p len How many samples do we need at output.
-// - @p len_mask Bit mask of input array length.
-float dot_prod(const float* coeff,
-               const float* samples,
-               const size_t sample_ind,
-               const size_t len,
-               const size_t len_mask) {
-    double accum = 0;
-
-    for (size_t i = sample_ind, j = 0; j < len; i = (i - 1) & len_mask, ++j) {
-        accum += (double)coeff[j] * (double)samples[i];
+// - @p coeff Filter impulse response, should be symmetric.
+// - @p samples Array with sample values, each stored at ind and ind + fe_decim_len.
+// - @p sample_ind index of the last sample in input array.
+float dot_prod(const float* coeff, const float* samples, const size_t sample_ind) {
+    const float* first = samples + sample_ind + 1;
+    const float* last = samples + sample_ind + fe_decim_len;
+
+    double accum[4] = { 0, 0, 0, 0 };
+
+    // Samples at the same distance from both ends of the window are multiplied
+    // by the same coefficient. Independent accumulators allow the compiler to
+    // vectorize the loop.
+    for (size_t j = 0; j < fe_decim_len / 2; j += 4) {
+        accum[0] += (double)coeff[j] * ((double)first[j] + (double)*(last - j));
+        accum[1] +=
+            (double)coeff[j + 1] * ((double)first[j + 1] + (double)*(last - j - 1));
+        accum[2] +=
+            (double)coeff[j + 2] * ((double)first[j + 2] + (double)*(last - j - 2));
+        accum[3] +=
+            (double)coeff[j + 3] * ((double)first[j + 3] + (double)*(last - j - 3));
     }
 
-    return (float)accum;
+    return (float)((accum[0] + accum[1]) + (accum[2] + accum[3]));
 }
 
 } // namespace
@@ -47,10 +54,15 @@ FreqEstimator::FreqEstimator(packet::timestamp_t target_latency)
     , samples_counter_(0)
     , accum_(0)
     , coeff_(1) {
-    if (fe_decim_len % 2 != 0) {
-        roc_panic("freq estimator: decim_len should be power of two");
+    if ((fe_decim_len & fe_decim_len_mask) != 0 || fe_decim_len < 8) {
+        roc_panic("freq estimator: decim_len should be power of two, at least 8");
     }
-    for (size_t i = 0; i < fe_decim_len; i++) {
+    for (size_t i = 0; i < fe_decim_len / 2; i++) {
+        if (fe_decim_h[i] != fe_decim_h[fe_decim_len - 1 - i]) {
+            roc_panic("freq estimator: decimation filter should be symmetric");
+        }
+    }
+    for (size_t i = 0; i < fe_decim_len * 2; i++) {
         dec1_casc_buff_[i] = target_;
         dec2_casc_buff_[i] = target_;
     }
@@ -72,20 +84,20 @@ bool FreqEstimator::run_decimators_(packet::timestamp_t current, float& filtered
     samples_counter_++;
 
     dec1_casc_buff_[dec1_ind_] = (float)current;
+    dec1_casc_buff_[dec1_ind_ + fe_decim_len] = (float)current;
 
     if ((samples_counter_ % fe_decim_factor) == 0) {
         // Time to calculate first decimator's samples.
-        dec2_casc_buff_[dec2_ind_] = dot_prod(fe_decim_h, dec1_casc_buff_, dec1_ind_,
-                                              fe_decim_len, fe_decim_len_mask)
-            / fe_decim_h_gain;
+        dec2_casc_buff_[dec2_ind_] =
+            dot_prod(fe_decim_h, dec1_casc_buff_, dec1_ind_) / fe_decim_h_gain;
+        dec2_casc_buff_[dec2_ind_ + fe_decim_len] = dec2_casc_buff_[dec2_ind_];
 
         if (((samples_counter_ % (fe_decim_factor * fe_decim_factor)) == 0)) {
             samples_counter_ = 0;
 
             // Time to calculate second decimator (and freq estimator's) output.
-            filtered = dot_prod(fe_decim_h, dec2_casc_buff_, dec2_ind_, fe_decim_len,
-                                fe_decim_len_mask)
-                / fe_decim_h_gain;
+            filtered =
+                dot_prod(fe_decim_h, dec2_casc_buff_, dec2_ind_) / fe_decim_h_gain;
 
             return true;
         }
@@ -41,10 +41,12 @@ private:
 
     const float target_; // Target latency.
 
-    float dec1_casc_buff_[fe_decim_len];
+    // Every sample is stored twice, at ind and ind + fe_decim_len, so that
+    // the last fe_decim_len samples are always contiguous.
+    float dec1_casc_buff_[fe_decim_len * 2];
     size_t dec1_ind_;
 
-    float dec2_casc_buff_[fe_decim_len];
+    float dec2_casc_buff_[fe_decim_len * 2];
     size_t dec2_ind_;
 
     size_t samples_counter_; // Input samples counter.
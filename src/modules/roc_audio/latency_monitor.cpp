@@ -6,6 +6,8 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <algorithm>
+
 #include "roc_audio/latency_monitor.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
@@ -40,8 +42,13 @@ LatencyMonitor::LatencyMonitor(const packet::SortedQueue& queue,
                                                                      input_sample_rate))
     , min_latency_(packet::timestamp_from_ns(config.min_latency, input_sample_rate))
     , max_latency_(packet::timestamp_from_ns(config.max_latency, input_sample_rate))
+    , max_sink_latency_(0)
     , max_scaling_delta_(config.max_scaling_delta)
+    , input_sample_rate_(input_sample_rate)
     , sample_rate_coeff_(0.f)
+    , latency_(0)
+    , scaling_(1.f)
+    , sink_latency_exceeded_(false)
     , valid_(false) {
     roc_log(LogDebug,
             "latency monitor: initializing: target_latency=%lu in_rate=%lu out_rate=%lu",
@@ -63,6 +70,15 @@ LatencyMonitor::LatencyMonitor(const packet::SortedQueue& queue,
         return;
     }
 
+    // the queue should keep some margin above the minimum latency even if the
+    // sink latency is large, otherwise FreqEstimator would drain it out of bounds
+    const packet::timestamp_diff_t min_queue_latency =
+        (std::max(min_latency_, (packet::timestamp_diff_t)0)
+         + (packet::timestamp_diff_t)target_latency_)
+        / 2;
+
+    max_sink_latency_ = (packet::timestamp_diff_t)target_latency_ - min_queue_latency;
+
     if (resampler_) {
         if (!init_resampler_(input_sample_rate, output_sample_rate)) {
             return;
@@ -84,17 +100,30 @@ bool LatencyMonitor::valid() const {
     return valid_;
 }
 
-bool LatencyMonitor::update(packet::timestamp_t pos) {
+bool LatencyMonitor::update(packet::timestamp_t pos, core::nanoseconds_t sink_latency) {
     packet::timestamp_diff_t latency = 0;
 
     if (!get_latency_(latency)) {
         return true;
     }
 
+    // bounds are checked against the queue latency only, since the sink
+    // latency is not under our control and may exceed the whole range
     if (!check_latency_(latency)) {
+        latency_ = latency;
         return false;
     }
 
+    packet::timestamp_diff_t sink_latency_ts = 0;
+    if (sink_latency > 0) {
+        sink_latency_ts = packet::timestamp_from_ns(sink_latency, input_sample_rate_);
+    }
+
+    check_sink_latency_(sink_latency_ts);
+
+    latency_ = latency + sink_latency_ts;
+    latency += std::min(sink_latency_ts, max_sink_latency_);
+
     if (resampler_) {
         if (latency < 0) {
             latency = 0;
@@ -109,6 +138,14 @@ bool LatencyMonitor::update(packet::timestamp_t pos) {
     return true;
 }
 
+packet::timestamp_diff_t LatencyMonitor::latency() const {
+    return latency_;
+}
+
+float LatencyMonitor::scaling() const {
+    return scaling_;
+}
+
 bool LatencyMonitor::get_latency_(packet::timestamp_diff_t& latency) const {
     if (!depacketizer_.started()) {
         return false;
@@ -124,6 +161,7 @@ bool LatencyMonitor::get_latency_(packet::timestamp_diff_t& latency) const {
     const packet::timestamp_t tail = latest->end();
 
     latency = packet::timestamp_diff(tail, head);
+
     return true;
 }
 
@@ -143,6 +181,20 @@ bool LatencyMonitor::check_latency_(packet::timestamp_diff_t latency) const {
     return true;
 }
 
+void LatencyMonitor::check_sink_latency_(packet::timestamp_diff_t sink_latency) {
+    const bool exceeded = sink_latency >= (packet::timestamp_diff_t)target_latency_;
+
+    if (exceeded && !sink_latency_exceeded_) {
+        roc_log(LogInfo,
+                "latency monitor: sink latency exceeds target latency,"
+                " compensating only part of it: sink=%ld target=%lu max_compensated=%ld",
+                (long)sink_latency, (unsigned long)target_latency_,
+                (long)max_sink_latency_);
+    }
+
+    sink_latency_exceeded_ = exceeded;
+}
+
 float LatencyMonitor::trim_scaling_(float freq_coeff) const {
     const float min_coeff = 1.0f - max_scaling_delta_;
     const float max_coeff = 1.0f + max_scaling_delta_;
@@ -174,6 +226,8 @@ bool LatencyMonitor::init_resampler_(size_t input_sample_rate,
         return false;
     }
 
+    scaling_ = sample_rate_coeff_;
+
     return true;
 }
 
@@ -208,6 +262,8 @@ bool LatencyMonitor::update_resampler_(packet::timestamp_t pos,
         return false;
     }
 
+    scaling_ = adjusted_coeff;
+
     return true;
 }
 
@@ -30,12 +30,14 @@ struct LatencyMonitorConfig {
     //! How often to run FreqEstimator and update Resampler scaling.
     core::nanoseconds_t fe_update_interval;
 
-    //! Minimum allowed latency, nanoseconds.
+    //! Minimum allowed queue latency, nanoseconds.
     //! If the latency goes out of bounds, the session is terminated.
+    //! Sink latency is not included.
     core::nanoseconds_t min_latency;
 
-    //! Maximum allowed latency, nanoseconds.
+    //! Maximum allowed queue latency, nanoseconds.
     //! If the latency goes out of bounds, the session is terminated.
+    //! Sink latency is not included.
     core::nanoseconds_t max_latency;
 
     //! Maximum allowed freq_coeff delta around one.
@@ -52,7 +54,7 @@ struct LatencyMonitorConfig {
 };
 
 //! Session latency monitor.
-//!  - calculates session latency
+//!  - calculates session latency, including playback latency of the sink
 //!  - calculates session scaling factor
 //!  - trims scaling factor to the allowed range
 //!  - updates resampler scaling
@@ -80,13 +82,30 @@ public:
     bool valid() const;
 
     //! Update latency.
+    //! @remarks
+    //!  @p sink_latency is the playback latency of the sink, which is added to
+    //!  the latency of the session queue, so that the FreqEstimator targets the
+    //!  end-to-end latency. Zero if it is not known. Latency bounds are
+    //!  checked against the queue latency only. The sink latency passed to the
+    //!  FreqEstimator is capped, so that the queue latency it aims for never
+    //!  goes below the middle between the target and the minimum latency (or
+    //!  zero, if the minimum is negative).
     //! @returns
     //!  false if the session should be terminated.
-    bool update(packet::timestamp_t time);
+    bool update(packet::timestamp_t time, core::nanoseconds_t sink_latency);
+
+    //! Get latency measured during last update, in samples.
+    packet::timestamp_diff_t latency() const;
+
+    //! Get resampler scaling factor set during last update.
+    //! @remarks
+    //!  Returns 1 if resampler is not used.
+    float scaling() const;
 
 private:
     bool get_latency_(packet::timestamp_diff_t& latency) const;
     bool check_latency_(packet::timestamp_diff_t latency) const;
+    void check_sink_latency_(packet::timestamp_diff_t sink_latency);
 
     float trim_scaling_(float scaling) const;
 
@@ -109,10 +128,16 @@ private:
     const packet::timestamp_t target_latency_;
     const packet::timestamp_diff_t min_latency_;
     const packet::timestamp_diff_t max_latency_;
+    packet::timestamp_diff_t max_sink_latency_;
 
     const float max_scaling_delta_;
+    const size_t input_sample_rate_;
     float sample_rate_coeff_;
 
+    packet::timestamp_diff_t latency_;
+    float scaling_;
+    bool sink_latency_exceeded_;
+
     bool valid_;
 };
 
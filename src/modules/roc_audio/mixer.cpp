@@ -10,6 +10,7 @@
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/trace.h"
 
 namespace roc {
 namespace audio {
@@ -64,6 +65,8 @@ void Mixer::remove(IReader& reader) {
 }
 
 void Mixer::read(Frame& frame) {
+    roc_trace_scope("mixer.read");
+
     roc_panic_if(!valid_);
 
     if (readers_.size() == 1) {
@@ -10,6 +10,7 @@
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/random.h"
+#include "roc_core/trace.h"
 
 namespace roc {
 namespace audio {
@@ -43,6 +44,8 @@ Packetizer::Packetizer(packet::IWriter& writer,
 }
 
 void Packetizer::write(Frame& frame) {
+    roc_trace_scope("packetizer.write");
+
     if (frame.size() % num_channels_ != 0) {
         roc_panic("packetizer: unexpected frame size");
     }
@@ -146,7 +149,7 @@ packet::PacketPtr Packetizer::create_packet_() {
 
     packet->add_flags(packet::Packet::FlagAudio);
 
-    core::Slice<uint8_t> data = new (buffer_pool_) core::Buffer<uint8_t>(buffer_pool_);
+    core::Slice<uint8_t> data = packet->alloc_buffer(buffer_pool_);
     if (!data) {
         roc_log(LogError, "packetizer: can't allocate buffer");
         return NULL;
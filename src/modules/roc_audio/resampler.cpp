@@ -171,17 +171,10 @@ bool Resampler::resample_buff(Frame& out) {
     roc_panic_if(!next_frame_);
 
     for (; out_frame_pos_ < out.size(); out_frame_pos_ += channels_num_) {
-        if (qt_sample_ >= qt_frame_size_) {
+        if (!next_sample_()) {
             return false;
         }
 
-        if ((qt_sample_ & FRACT_PART_MASK) < qt_epsilon_) {
-            qt_sample_ &= INTEGER_PART_MASK;
-        } else if ((qt_one - (qt_sample_ & FRACT_PART_MASK)) < qt_epsilon_) {
-            qt_sample_ &= INTEGER_PART_MASK;
-            qt_sample_ += qt_one;
-        }
-
         sample_t* out_data = out.data();
         for (size_t channel = 0; channel < channels_num_; ++channel) {
             out_data[out_frame_pos_ + channel] = resample_(channel);
@@ -192,6 +185,52 @@ bool Resampler::resample_buff(Frame& out) {
     return true;
 }
 
+uint32_t Resampler::position() const {
+    return qt_sample_;
+}
+
+void Resampler::set_position(uint32_t position) {
+    qt_sample_ = position;
+}
+
+size_t Resampler::skip_frame() {
+    roc_panic_if(window_size_ * scaling_ >= frame_size_ch_);
+
+    renew_position_();
+
+    size_t n_samples = 0;
+    while (next_sample_()) {
+        qt_sample_ += qt_dt_;
+        n_samples += channels_num_;
+    }
+
+    return n_samples;
+}
+
+void Resampler::renew_position_() {
+    if (qt_sample_ >= qt_frame_size_) {
+        qt_sample_ -= qt_frame_size_;
+    }
+
+    // scaling_ may change every frame so it have to be smooth
+    qt_dt_ = float_to_fixedpoint(scaling_);
+}
+
+bool Resampler::next_sample_() {
+    if (qt_sample_ >= qt_frame_size_) {
+        return false;
+    }
+
+    if ((qt_sample_ & FRACT_PART_MASK) < qt_epsilon_) {
+        qt_sample_ &= INTEGER_PART_MASK;
+    } else if ((qt_one - (qt_sample_ & FRACT_PART_MASK)) < qt_epsilon_) {
+        qt_sample_ &= INTEGER_PART_MASK;
+        qt_sample_ += qt_one;
+    }
+
+    return true;
+}
+
 bool Resampler::check_config_() const {
     if (channels_num_ < 1) {
         roc_log(LogError, "resampler: invalid num_channels: num_channels=%lu",
@@ -237,12 +276,7 @@ void Resampler::renew_buffers(core::Slice<sample_t>& prev,
     roc_panic_if(cur.size() != frame_size_);
     roc_panic_if(next.size() != frame_size_);
 
-    if (qt_sample_ >= qt_frame_size_) {
-        qt_sample_ -= qt_frame_size_;
-    }
-
-    // scaling_ may change every frame so it have to be smooth
-    qt_dt_ = float_to_fixedpoint(scaling_);
+    renew_position_();
 
     prev_frame_ = prev.data();
     curr_frame_ = cur.data();
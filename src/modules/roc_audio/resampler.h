@@ -73,6 +73,28 @@ public:
                        core::Slice<sample_t>& cur,
                        core::Slice<sample_t>& next);
 
+    //! Get position of the next output sample.
+    //! @remarks
+    //!  The position is relative to the beginning of the last input frame.
+    //!  Given the same config and scaling, the output for a sequence of input
+    //!  frames depends only on the position before the first of them.
+    uint32_t position() const;
+
+    //! Set position of the next output sample.
+    //! @remarks
+    //!  Allows another resampler to continue from the position returned by
+    //!  position() of this one.
+    void set_position(uint32_t position);
+
+    //! Skip input frame.
+    //! @remarks
+    //!  Updates position in the same way as renew_buffers() followed by
+    //!  resample_buff() calls until the frame is exhausted, but doesn't
+    //!  compute any samples.
+    //! @returns
+    //!  the number of output samples (for all channels) that would be produced.
+    size_t skip_frame();
+
 private:
     typedef uint32_t fixedpoint_t;
     typedef uint64_t long_fixedpoint_t;
@@ -92,6 +114,9 @@ private:
     //!  (e.g. left -- 0, right -- 1, etc.).
     sample_t resample_(size_t channel_offset);
 
+    void renew_position_();
+    bool next_sample_();
+
     bool check_config_() const;
 
     bool fill_sinc_();
@@ -11,6 +11,7 @@
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/trace.h"
 
 namespace roc {
 namespace audio {
@@ -46,6 +47,8 @@ bool ResamplerReader::set_scaling(float scaling) {
 }
 
 void ResamplerReader::read(Frame& frame) {
+    roc_trace_scope("resampler_reader.read");
+
     roc_panic_if_not(valid());
 
     if (frames_empty_) {
@@ -11,6 +11,7 @@
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/trace.h"
 
 namespace roc {
 namespace audio {
@@ -46,6 +47,8 @@ bool ResamplerWriter::set_scaling(float scaling) {
 }
 
 void ResamplerWriter::write(Frame& input) {
+    roc_trace_scope("resampler_writer.write");
+
     roc_panic_if_not(valid());
 
     const sample_t* input_data = input.data();
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/arena_allocator.h"
+#include "roc_core/alignment.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace core {
+
+ArenaAllocator::ArenaAllocator(IAllocator& parent, size_t block_size)
+    : parent_(parent)
+    , block_(NULL)
+    , block_size_(max_align(block_size))
+    , block_pos_(0)
+    , num_block_allocations_(0)
+    , num_parent_allocations_(0) {
+    if (block_size_ != 0) {
+        block_ = (char*)parent_.allocate(block_size_);
+    }
+}
+
+ArenaAllocator::~ArenaAllocator() {
+    if (num_block_allocations_ != 0 || num_parent_allocations_ != 0) {
+        roc_panic("arena allocator: detected leak: block=%lu parent=%lu",
+                  (unsigned long)num_block_allocations_,
+                  (unsigned long)num_parent_allocations_);
+    }
+
+    if (block_) {
+        parent_.deallocate(block_);
+    }
+}
+
+bool ArenaAllocator::valid() const {
+    return block_ != NULL || block_size_ == 0;
+}
+
+void* ArenaAllocator::allocate(size_t size) {
+    Mutex::Lock lock(mutex_);
+
+    const size_t aligned_size = max_align(size);
+
+    if (block_ && aligned_size <= block_size_ - block_pos_) {
+        void* ptr = block_ + block_pos_;
+
+        block_pos_ += aligned_size;
+        num_block_allocations_++;
+
+        return ptr;
+    }
+
+    void* ptr = parent_.allocate(size);
+    if (ptr) {
+        num_parent_allocations_++;
+    }
+
+    return ptr;
+}
+
+void ArenaAllocator::deallocate(void* ptr) {
+    if (ptr == NULL) {
+        roc_panic("arena allocator: deallocating null pointer");
+    }
+
+    Mutex::Lock lock(mutex_);
+
+    if (owns_(ptr)) {
+        if (num_block_allocations_ == 0) {
+            roc_panic("arena allocator: unpaired deallocate");
+        }
+        if (--num_block_allocations_ == 0) {
+            block_pos_ = 0;
+        }
+    } else {
+        if (num_parent_allocations_ == 0) {
+            roc_panic("arena allocator: unpaired deallocate");
+        }
+        num_parent_allocations_--;
+        parent_.deallocate(ptr);
+    }
+}
+
+size_t ArenaAllocator::block_used() const {
+    Mutex::Lock lock(mutex_);
+
+    return block_pos_;
+}
+
+size_t ArenaAllocator::num_parent_allocations() const {
+    Mutex::Lock lock(mutex_);
+
+    return num_parent_allocations_;
+}
+
+bool ArenaAllocator::owns_(void* ptr) const {
+    return block_ && (char*)ptr >= block_ && (char*)ptr < block_ + block_size_;
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/arena_allocator.h
+//! @brief Arena allocator.
+
+#ifndef ROC_CORE_ARENA_ALLOCATOR_H_
+#define ROC_CORE_ARENA_ALLOCATOR_H_
+
+#include "roc_core/iallocator.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+
+namespace roc {
+namespace core {
+
+//! Arena allocator.
+//!
+//! Places allocations one after another in a single block obtained from the
+//! parent allocator, so that objects created together share cache lines and
+//! pages. Deallocating memory from the block doesn't make it available again
+//! until all allocations from the block are deallocated. When the block is
+//! exhausted, requests are forwarded to the parent allocator.
+//!
+//! The memory is always maximum aligned. Thread-safe.
+class ArenaAllocator : public IAllocator, public NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  Allocates a block of @p block_size bytes from @p parent.
+    ArenaAllocator(IAllocator& parent, size_t block_size);
+
+    ~ArenaAllocator();
+
+    //! Check if the block was successfully allocated.
+    bool valid() const;
+
+    //! Allocate memory.
+    virtual void* allocate(size_t size);
+
+    //! Deallocate previously allocated memory.
+    virtual void deallocate(void*);
+
+    //! Get number of bytes allocated from the block.
+    size_t block_used() const;
+
+    //! Get number of allocations forwarded to the parent allocator.
+    size_t num_parent_allocations() const;
+
+private:
+    bool owns_(void* ptr) const;
+
+    IAllocator& parent_;
+
+    char* block_;
+    size_t block_size_;
+    size_t block_pos_;
+
+    size_t num_block_allocations_;
+    size_t num_parent_allocations_;
+
+    Mutex mutex_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_ARENA_ALLOCATOR_H_
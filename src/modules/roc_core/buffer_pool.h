@@ -25,7 +25,20 @@ public:
     //! Initialization.
     BufferPool(IAllocator& allocator, size_t buff_size, bool poison)
         : Pool<Buffer<T> >(allocator, sizeof(Buffer<T>) + sizeof(T) * buff_size, poison)
-        , buff_size_(buff_size) {
+        , buff_size_(buff_size)
+        , owner_(NULL) {
+    }
+
+    //! Initialization for embedded buffers.
+    //! @remarks
+    //!  Such pool never allocates memory itself. Buffers are constructed by
+    //!  @p owner inside objects allocated elsewhere, using embedded_size() bytes
+    //!  per buffer. When a buffer is destroyed, its memory is passed back to
+    //!  @p owner.deallocate().
+    BufferPool(size_t buff_size, IAllocator& owner)
+        : Pool<Buffer<T> >(owner, sizeof(Buffer<T>) + sizeof(T) * buff_size, false)
+        , buff_size_(buff_size)
+        , owner_(&owner) {
     }
 
     //! Get buffer size (number of elements in buffer).
@@ -33,8 +46,24 @@ public:
         return buff_size_;
     }
 
+    //! Get number of bytes occupied by a buffer, including its header.
+    size_t embedded_size() const {
+        return sizeof(Buffer<T>) + sizeof(T) * buff_size_;
+    }
+
+    //! Destroy buffer and deallocate its memory.
+    void destroy(Buffer<T>& buffer) {
+        if (owner_) {
+            buffer.~Buffer<T>();
+            owner_->deallocate(&buffer);
+        } else {
+            Pool<Buffer<T> >::destroy(buffer);
+        }
+    }
+
 private:
     size_t buff_size_;
+    IAllocator* owner_;
 };
 
 } // namespace core
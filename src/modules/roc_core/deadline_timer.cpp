@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/deadline_timer.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+long clamp_to_long(nanoseconds_t value) {
+    return value < (nanoseconds_t)LONG_MAX ? (long)value : LONG_MAX;
+}
+
+} // namespace
+
+DeadlineTimer::DeadlineTimer(nanoseconds_t spin_time)
+    : spin_time_(spin_time)
+    , n_waits_(0)
+    , jitter_sum_(0)
+    , num_waits_(0)
+    , mean_jitter_(0)
+    , max_jitter_(0) {
+    if (spin_time < 0) {
+        roc_panic("deadline timer: spin time should be non-negative");
+    }
+}
+
+nanoseconds_t DeadlineTimer::wait(nanoseconds_t deadline) {
+    nanoseconds_t now = timestamp();
+
+    if (deadline - spin_time_ > now) {
+        sleep_until(deadline - spin_time_);
+        now = timestamp();
+    }
+
+    while (now < deadline) {
+        now = timestamp();
+    }
+
+    const nanoseconds_t jitter = now - deadline;
+    report_(jitter);
+
+    return jitter;
+}
+
+void DeadlineTimer::get_stats(DeadlineTimerStats& stats) const {
+    stats.num_waits = (size_t)(long)num_waits_;
+    stats.mean_jitter = (long)mean_jitter_;
+    stats.max_jitter = (long)max_jitter_;
+}
+
+// Called on the timer thread for every wait, so it doesn't take locks. The sum
+// is kept privately as a 64-bit value, and only the derived values, which fit
+// into a machine word, are published via atomics. The fields are published
+// independently, so get_stats() may see a mean from a neighbouring wait.
+void DeadlineTimer::report_(nanoseconds_t jitter) {
+    n_waits_++;
+    jitter_sum_ += jitter;
+
+    mean_jitter_.exchange(clamp_to_long(jitter_sum_ / nanoseconds_t(n_waits_)));
+
+    if (clamp_to_long(jitter) > max_jitter_.load_relaxed()) {
+        max_jitter_.exchange(clamp_to_long(jitter));
+    }
+
+    num_waits_.exchange((long)n_waits_);
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/deadline_timer.h
+//! @brief Deadline timer.
+
+#ifndef ROC_CORE_DEADLINE_TIMER_H_
+#define ROC_CORE_DEADLINE_TIMER_H_
+
+#include "roc_core/atomic.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace core {
+
+//! Deadline timer statistics.
+struct DeadlineTimerStats {
+    //! Number of completed waits.
+    size_t num_waits;
+
+    //! Mean wakeup jitter, nanoseconds.
+    //! @remarks
+    //!  Jitter is the distance between the deadline and the actual wakeup time.
+    nanoseconds_t mean_jitter;
+
+    //! Maximum wakeup jitter, nanoseconds.
+    nanoseconds_t max_jitter;
+
+    DeadlineTimerStats()
+        : num_waits(0)
+        , mean_jitter(0)
+        , max_jitter(0) {
+    }
+};
+
+//! Deadline timer.
+//! @remarks
+//!  Waits until absolute time points. Sleeps until the deadline minus the spin
+//!  time, and then busy-waits for the rest of the interval, trading some CPU time
+//!  for a wakeup that is not subject to scheduler latency. Measures wakeup jitter.
+class DeadlineTimer : public NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  @p spin_time defines the interval before the deadline during which the
+    //!  timer busy-waits instead of sleeping. Zero disables busy-waiting.
+    explicit DeadlineTimer(nanoseconds_t spin_time);
+
+    //! Wait until the given absolute timestamp.
+    //! @returns
+    //!  wakeup jitter in nanoseconds; if the deadline has already passed,
+    //!  returns immediately and reports how late the call is.
+    nanoseconds_t wait(nanoseconds_t deadline);
+
+    //! Get statistics.
+    //! @remarks
+    //!  May be called from any thread. Doesn't block the thread calling wait().
+    void get_stats(DeadlineTimerStats& stats) const;
+
+private:
+    void report_(nanoseconds_t jitter);
+
+    const nanoseconds_t spin_time_;
+
+    // accessed only from the thread calling wait()
+    size_t n_waits_;
+    nanoseconds_t jitter_sum_;
+
+    // published for get_stats()
+    Atomic num_waits_;
+    Atomic mean_jitter_;
+    Atomic max_jitter_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_DEADLINE_TIMER_H_
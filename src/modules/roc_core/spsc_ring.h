@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/spsc_ring.h
+//! @brief Single-producer single-consumer ring buffer.
+
+#ifndef ROC_CORE_SPSC_RING_H_
+#define ROC_CORE_SPSC_RING_H_
+
+#include "roc_core/atomic.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/log.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Single-producer single-consumer lock-free ring buffer.
+//!
+//! @tparam T defines element type. Elements are copied with memcpy, so
+//! it should be a POD type.
+//!
+//! @remarks
+//!  write() may be called from one thread and read() from another one, at
+//!  the same time and without any locks. Neither of them ever blocks; they
+//!  copy as many elements as possible and return the number of copied ones.
+//!  Read and write positions are only incremented, and every increment is
+//!  a full memory barrier that publishes copied elements to the other side.
+template <class T> class SpscRing : public NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  Allocates storage for @p capacity elements.
+    SpscRing(IAllocator& allocator, size_t capacity)
+        : allocator_(allocator)
+        , data_(NULL)
+        , capacity_(capacity) {
+        if (capacity_ == 0) {
+            roc_log(LogError, "spsc ring: capacity should be positive");
+            return;
+        }
+        data_ = (T*)allocator_.allocate(capacity_ * sizeof(T));
+        if (!data_) {
+            roc_log(LogError, "spsc ring: can't allocate memory: capacity=%lu",
+                    (unsigned long)capacity_);
+        }
+    }
+
+    ~SpscRing() {
+        if (data_) {
+            allocator_.deallocate(data_);
+        }
+    }
+
+    //! Check if the ring was successfully constructed.
+    bool valid() const {
+        return data_;
+    }
+
+    //! Get maximum number of elements.
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    //! Get number of elements in ring.
+    //! @remarks
+    //!  May be called from any thread. The returned value may be outdated
+    //!  if the other side modifies the ring concurrently.
+    size_t size() const {
+        const long rd = read_pos_;
+        const long wr = write_pos_;
+        return size_t(wr - rd);
+    }
+
+    //! Append elements to ring.
+    //! @remarks
+    //!  Should be called only from producer thread.
+    //! @returns
+    //!  number of appended elements, which is less than @p n if the ring
+    //!  hasn't enough free space.
+    size_t write(const T* data, size_t n) {
+        roc_panic_if(!valid());
+
+        const long wr = write_pos_;
+        const long rd = read_pos_;
+
+        const size_t avail = capacity_ - size_t(wr - rd);
+        if (n > avail) {
+            n = avail;
+        }
+
+        const size_t pos = size_t(wr) % capacity_;
+        const size_t n1 = std::min(n, capacity_ - pos);
+
+        memcpy(data_ + pos, data, n1 * sizeof(T));
+        memcpy(data_, data + n1, (n - n1) * sizeof(T));
+
+        write_pos_ += (long)n;
+
+        return n;
+    }
+
+    //! Remove elements from ring.
+    //! @remarks
+    //!  Should be called only from consumer thread.
+    //! @returns
+    //!  number of removed elements, which is less than @p n if the ring
+    //!  hasn't enough elements.
+    size_t read(T* data, size_t n) {
+        roc_panic_if(!valid());
+
+        const long rd = read_pos_;
+        const long wr = write_pos_;
+
+        const size_t avail = size_t(wr - rd);
+        if (n > avail) {
+            n = avail;
+        }
+
+        const size_t pos = size_t(rd) % capacity_;
+        const size_t n1 = std::min(n, capacity_ - pos);
+
+        memcpy(data, data_ + pos, n1 * sizeof(T));
+        memcpy(data + n1, data_, (n - n1) * sizeof(T));
+
+        read_pos_ += (long)n;
+
+        return n;
+    }
+
+private:
+    IAllocator& allocator_;
+
+    T* data_;
+    const size_t capacity_;
+
+    Atomic read_pos_;
+    Atomic write_pos_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_SPSC_RING_H_
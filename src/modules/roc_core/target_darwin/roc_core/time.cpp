@@ -66,6 +66,14 @@ nanoseconds_t timestamp() {
     return nanoseconds_t(mach_absolute_time() * steady_factor);
 }
 
+nanoseconds_t timestamp_realtime() {
+    struct timeval tv;
+    if (gettimeofday(&tv, NULL) == -1) {
+        roc_panic("time: gettimeofday(): %s", errno_to_str().c_str());
+    }
+    return nanoseconds_t(tv.tv_sec) * 1000000000 + nanoseconds_t(tv.tv_usec) * 1000;
+}
+
 void sleep_until(nanoseconds_t ns) {
     mach_timespec_t ts;
     ts.tv_sec = (unsigned int)(ns / 1000000000);
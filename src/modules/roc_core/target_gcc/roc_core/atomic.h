@@ -30,6 +30,16 @@ public:
         return __sync_add_and_fetch(&value_, 0);
     }
 
+    //! Load without memory barrier.
+    //! @remarks
+    //!  Aligned loads of machine words are atomic on all supported platforms,
+    //!  but unlike the regular load, this one doesn't order other memory accesses
+    //!  and doesn't write the cache line. Should be used only for values that
+    //!  are read frequently and don't guard other data.
+    long load_relaxed() const {
+        return *(const volatile long*)&value_;
+    }
+
     //! Atomic store.
     //! @remarks
     //!  Only boolean values may be implemented in a cross-platform way
@@ -53,6 +63,32 @@ public:
         return __sync_sub_and_fetch(&value_, 1);
     }
 
+    //! Atomic addition.
+    long operator+=(long delta) {
+        return __sync_add_and_fetch(&value_, delta);
+    }
+
+    //! Atomic compare-and-swap.
+    //! @returns
+    //!  true if the value was equal to @p expected and was replaced with @p desired.
+    bool compare_exchange(long expected, long desired) {
+        return __sync_bool_compare_and_swap(&value_, expected, desired);
+    }
+
+    //! Atomic exchange.
+    //! @returns
+    //!  previous value.
+    //! @remarks
+    //!  Implemented using compare-and-swap loop since __sync_lock_test_and_set
+    //!  may only store 1 on some platforms.
+    long exchange(long desired) {
+        long old;
+        do {
+            old = __sync_add_and_fetch(&value_, 0);
+        } while (!__sync_bool_compare_and_swap(&value_, old, desired));
+        return old;
+    }
+
 private:
     mutable long value_;
 };
@@ -17,6 +17,7 @@
 #include "roc_core/mutex.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/panic.h"
+#include "roc_core/time.h"
 
 namespace roc {
 namespace core {
@@ -42,6 +43,16 @@ public:
         uv_cond_wait(&cond_, &mutex_);
     }
 
+    //! Wait with timeout.
+    //! @returns
+    //!  false if @p timeout expired.
+    bool timed_wait(nanoseconds_t timeout) const {
+        if (timeout < 0) {
+            timeout = 0;
+        }
+        return uv_cond_timedwait(&cond_, &mutex_, (uint64_t)timeout) == 0;
+    }
+
     //! Wake up all pending waits.
     void broadcast() const {
         uv_cond_broadcast(&cond_);
@@ -29,6 +29,16 @@ bool Thread::joinable() const {
     return joinable_;
 }
 
+void Thread::set_params(const ThreadParams& params) {
+    Mutex::Lock lock(mutex_);
+
+    if (started_) {
+        roc_panic("thread: can't set params after thread was started");
+    }
+
+    params_ = params;
+}
+
 bool Thread::start() {
     Mutex::Lock lock(mutex_);
 
@@ -65,7 +75,11 @@ void Thread::join() {
 }
 
 void Thread::thread_runner_(void* ptr) {
-    static_cast<Thread*>(ptr)->run();
+    Thread& self = *static_cast<Thread*>(ptr);
+
+    set_thread_params(self.params_);
+
+    self.run();
 }
 
 } // namespace core
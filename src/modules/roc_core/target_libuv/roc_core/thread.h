@@ -17,6 +17,7 @@
 #include "roc_core/atomic.h"
 #include "roc_core/mutex.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/thread_params.h"
 
 namespace roc {
 namespace core {
@@ -29,6 +30,13 @@ public:
     //!  true if start() was called and join() was not called yet.
     bool joinable() const;
 
+    //! Set thread parameters.
+    //! @remarks
+    //!  Should be called before start(). Parameters are applied by the new thread
+    //!  before executing run(). If some of them can't be applied, e.g. because
+    //!  of missing permissions, the thread still runs with default ones.
+    void set_params(const ThreadParams& params);
+
     //! Start thread.
     //! @remarks
     //!  Executes run() in new thread.
@@ -51,6 +59,7 @@ private:
     static void thread_runner_(void* ptr);
 
     uv_thread_t thread_;
+    ThreadParams params_;
 
     int started_;
     Atomic joinable_;
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/tracer.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace core {
+
+Tracer::Tracer() {
+    if (int err = uv_key_create(&key_)) {
+        roc_panic("tracer: uv_key_create(): [%s] %s", uv_err_name(err),
+                  uv_strerror(err));
+    }
+}
+
+void Tracer::add_event(const char* name, nanoseconds_t begin, nanoseconds_t end) {
+    Ring* ring = get_ring_();
+    if (!ring) {
+        ++num_dropped_;
+        return;
+    }
+
+    const size_t pos = (size_t)long(ring->pos);
+
+    TraceEvent& event = ring->events[pos % MaxEvents];
+    event.name = name;
+    event.begin = begin;
+    event.end = end;
+
+    ++ring->pos;
+}
+
+void Tracer::iterate_events(EventHandler handler, void* arg) const {
+    roc_panic_if(!handler);
+
+    size_t n_threads = (size_t)long(num_threads_);
+    if (n_threads > MaxThreads) {
+        n_threads = MaxThreads;
+    }
+
+    for (size_t n = 0; n < n_threads; n++) {
+        const Ring& ring = rings_[n];
+
+        const size_t end = (size_t)long(ring.pos);
+        const size_t begin = end > MaxEvents ? end - MaxEvents : 0;
+
+        for (size_t pos = begin; pos < end; pos++) {
+            handler(arg, n, ring.events[pos % MaxEvents]);
+        }
+    }
+}
+
+size_t Tracer::num_dropped() const {
+    return (size_t)long(num_dropped_);
+}
+
+Tracer::Ring* Tracer::get_ring_() {
+    void* ptr = uv_key_get(&key_);
+
+    if (!ptr) {
+        const size_t n = (size_t)(++num_threads_ - 1);
+
+        // store tracer itself as a marker for threads that didn't get a ring
+        if (n < MaxThreads) {
+            ptr = &rings_[n];
+        } else {
+            ptr = this;
+        }
+
+        uv_key_set(&key_, ptr);
+    }
+
+    if (ptr == this) {
+        return NULL;
+    }
+
+    return (Ring*)ptr;
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/target_libuv/roc_core/tracer.h
+//! @brief Tracer.
+
+#ifndef ROC_CORE_TRACER_H_
+#define ROC_CORE_TRACER_H_
+
+#include <uv.h>
+
+#include "roc_core/atomic.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/singleton.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace core {
+
+//! Trace event.
+struct TraceEvent {
+    //! Stage name.
+    //! @remarks
+    //!  Points to a string literal.
+    const char* name;
+
+    //! Timestamp when the stage was entered, nanoseconds.
+    nanoseconds_t begin;
+
+    //! Timestamp when the stage was left, nanoseconds.
+    nanoseconds_t end;
+};
+
+//! Tracer.
+//!
+//! Collects trace events into per-thread ring buffers. Each thread gets its
+//! own ring on first event, so recording an event never takes a lock and
+//! never allocates. When the ring is full, the oldest events are overwritten.
+class Tracer : public NonCopyable<> {
+public:
+    enum {
+        //! Maximum number of threads that may record events.
+        //! @remarks
+        //!  Events from other threads are dropped.
+        MaxThreads = 16,
+
+        //! Number of events kept per thread.
+        MaxEvents = 8192
+    };
+
+    //! Event handler.
+    //! @remarks
+    //!  @p thread is the index of the thread that recorded the event.
+    typedef void (*EventHandler)(void* arg, size_t thread, const TraceEvent& event);
+
+    //! Get tracer instance.
+    static Tracer& instance() {
+        return Singleton<Tracer>::instance();
+    }
+
+    //! Record event for the calling thread.
+    void add_event(const char* name, nanoseconds_t begin, nanoseconds_t end);
+
+    //! Iterate recorded events.
+    //! @remarks
+    //!  Events of every thread are passed to @p handler from oldest to newest.
+    //!  Should be called when traced threads are idle, otherwise events that
+    //!  are being overwritten concurrently may be reported inconsistently.
+    void iterate_events(EventHandler handler, void* arg) const;
+
+    //! Get number of events dropped because there were too many threads.
+    size_t num_dropped() const;
+
+private:
+    friend class Singleton<Tracer>;
+
+    struct Ring {
+        Atomic pos;
+        TraceEvent events[MaxEvents];
+    };
+
+    Tracer();
+
+    Ring* get_ring_();
+
+    uv_key_t key_;
+
+    Atomic num_threads_;
+    Atomic num_dropped_;
+
+    Ring rings_[MaxThreads];
+};
+
+//! Scoped trace event.
+//! @remarks
+//!  Records timestamps when constructed and destroyed and adds the event
+//!  to the tracer. Usually used via roc_trace_scope() macro.
+class TraceScope : public NonCopyable<> {
+public:
+    //! Enter stage.
+    explicit TraceScope(const char* name)
+        : name_(name)
+        , begin_(timestamp()) {
+    }
+
+    //! Leave stage.
+    ~TraceScope() {
+        Tracer::instance().add_event(name_, begin_, timestamp());
+    }
+
+private:
+    const char* name_;
+    const nanoseconds_t begin_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_TRACER_H_
@@ -7,7 +7,6 @@
  */
 
 #include <stdio.h>
-#include <sys/time.h>
 #include <time.h>
 
 #include "roc_core/format_time.h"
@@ -15,14 +14,16 @@
 namespace roc {
 namespace core {
 
-bool format_time(char* buf, size_t bufsz) {
-    timeval tv;
-    if (gettimeofday(&tv, NULL) == -1) {
+bool format_time(char* buf, size_t bufsz, nanoseconds_t unix_time) {
+    if (unix_time < 0) {
         return false;
     }
 
+    const time_t sec = (time_t)(unix_time / Second);
+    const unsigned long msec = (unsigned long)(unix_time % Second / Millisecond);
+
     tm t;
-    if (!localtime_r(&tv.tv_sec, &t)) {
+    if (!localtime_r(&sec, &t)) {
         return false;
     }
 
@@ -36,7 +37,7 @@ bool format_time(char* buf, size_t bufsz) {
     }
 
     int ret =
-        snprintf(buf + off, bufsz - off, ".%03lu", (unsigned long)tv.tv_usec / 1000);
+        snprintf(buf + off, bufsz - off, ".%03lu", msec);
     if (ret <= 0 || (size_t)ret >= (bufsz - off)) {
         return false;
     }
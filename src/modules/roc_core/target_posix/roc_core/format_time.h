@@ -7,20 +7,23 @@
  */
 
 //! @file roc_core/target_posix/roc_core/format_time.h
-//! @brief Retrieve and format current time.
+//! @brief Format wall-clock time.
 
 #ifndef ROC_CORE_FORMAT_TIME_H_
 #define ROC_CORE_FORMAT_TIME_H_
 
 #include "roc_core/stddefs.h"
+#include "roc_core/time.h"
 
 namespace roc {
 namespace core {
 
-//! Retrieve and format current time.
+//! Format wall-clock time.
 //
 //! @remarks
-//!  The time is printed in the format "13:10:05.123".
+//!  @p unix_time is the number of nanoseconds since Unix epoch, as returned
+//!  by timestamp_realtime(). The local time is printed in the format
+//!  "13:10:05.123".
 //!
 //! @returns
 //!  false if an error occured or buffer is too small.
@@ -28,7 +31,7 @@ namespace core {
 //! @note
 //!  This function should not log anything because it is used
 //!  in the logger implementation.
-bool format_time(char* buf, size_t bufsz);
+bool format_time(char* buf, size_t bufsz, nanoseconds_t unix_time);
 
 } // namespace core
 } // namespace roc
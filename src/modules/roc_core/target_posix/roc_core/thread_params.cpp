@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // Needed for pthread_setaffinity_np() and pthread_setname_np().
+#endif
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/thread_params.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+const char* policy_to_str(ThreadPolicy policy) {
+    switch (policy) {
+    case ThreadPolicyDefault:
+        return "default";
+    case ThreadPolicyFifo:
+        return "fifo";
+    case ThreadPolicyRoundRobin:
+        return "rr";
+    }
+    return "<invalid>";
+}
+
+bool set_policy(ThreadPolicy policy, int priority) {
+    int os_policy = 0;
+
+    switch (policy) {
+    case ThreadPolicyDefault:
+        return true;
+    case ThreadPolicyFifo:
+        os_policy = SCHED_FIFO;
+        break;
+    case ThreadPolicyRoundRobin:
+        os_policy = SCHED_RR;
+        break;
+    }
+
+    const int min_priority = sched_get_priority_min(os_policy);
+    const int max_priority = sched_get_priority_max(os_policy);
+
+    if (priority < min_priority || priority > max_priority) {
+        roc_log(LogError,
+                "thread params: priority out of range:"
+                " policy=%s priority=%d range=[%d;%d]",
+                policy_to_str(policy), priority, min_priority, max_priority);
+        return false;
+    }
+
+    sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = priority;
+
+    if (int err = pthread_setschedparam(pthread_self(), os_policy, &param)) {
+        roc_log(LogError,
+                "thread params: can't set scheduling policy, using default:"
+                " policy=%s priority=%d: %s",
+                policy_to_str(policy), priority, errno_to_str(err).c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool set_affinity(uint64_t cpu_mask) {
+    if (cpu_mask == 0) {
+        return true;
+    }
+
+#if defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+
+    for (size_t n = 0; n < 64 && n < CPU_SETSIZE; n++) {
+        if (cpu_mask & ((uint64_t)1 << n)) {
+            CPU_SET(n, &cpu_set);
+        }
+    }
+
+    if (int err = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set)) {
+        roc_log(LogError, "thread params: can't set cpu affinity: mask=0x%llx: %s",
+                (unsigned long long)cpu_mask, errno_to_str(err).c_str());
+        return false;
+    }
+
+    return true;
+#else
+    roc_log(LogError, "thread params: cpu affinity is not supported on this platform");
+    return false;
+#endif
+}
+
+bool set_name(const char* name) {
+    if (!*name) {
+        return true;
+    }
+
+#if defined(__linux__)
+    if (int err = pthread_setname_np(pthread_self(), name)) {
+        roc_log(LogError, "thread params: can't set thread name: name=%s: %s", name,
+                errno_to_str(err).c_str());
+        return false;
+    }
+#elif defined(__APPLE__)
+    if (int err = pthread_setname_np(name)) {
+        roc_log(LogError, "thread params: can't set thread name: name=%s: %s", name,
+                errno_to_str(err).c_str());
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+} // namespace
+
+void ThreadParams::set_name(const char* str) {
+    if (!str) {
+        name[0] = '\0';
+        return;
+    }
+
+    strncpy(name, str, MaxNameLen - 1);
+    name[MaxNameLen - 1] = '\0';
+}
+
+bool set_thread_params(const ThreadParams& params) {
+    bool ok = true;
+
+    if (!set_name(params.name)) {
+        ok = false;
+    }
+
+    if (!set_affinity(params.cpu_mask)) {
+        ok = false;
+    }
+
+    if (!set_policy(params.policy, params.priority)) {
+        ok = false;
+    }
+
+    if (ok && (params.policy != ThreadPolicyDefault || params.cpu_mask != 0)) {
+        roc_log(LogDebug,
+                "thread params: applied: name=%s policy=%s priority=%d mask=0x%llx",
+                params.name, policy_to_str(params.policy), params.priority,
+                (unsigned long long)params.cpu_mask);
+    }
+
+    return ok;
+}
+
+} // namespace core
+} // namespace roc
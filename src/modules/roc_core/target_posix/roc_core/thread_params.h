@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/target_posix/roc_core/thread_params.h
+//! @brief Thread scheduling parameters.
+
+#ifndef ROC_CORE_THREAD_PARAMS_H_
+#define ROC_CORE_THREAD_PARAMS_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Thread scheduling policy.
+enum ThreadPolicy {
+    ThreadPolicyDefault,   //!< Don't change scheduling policy.
+    ThreadPolicyFifo,      //!< SCHED_FIFO realtime policy.
+    ThreadPolicyRoundRobin //!< SCHED_RR realtime policy.
+};
+
+//! Thread scheduling parameters.
+struct ThreadParams {
+    enum {
+        //! Maximum length of thread name, including terminating zero.
+        MaxNameLen = 16
+    };
+
+    //! Scheduling policy.
+    ThreadPolicy policy;
+
+    //! Scheduling priority.
+    //! @remarks
+    //!  Used only with realtime policies. Should be in range allowed by the OS
+    //!  for the policy, e.g. [1; 99] on Linux.
+    int priority;
+
+    //! CPU affinity mask.
+    //! @remarks
+    //!  Bit N allows the thread to run on CPU N. If zero, affinity isn't changed.
+    //!  Ignored on platforms without affinity support.
+    uint64_t cpu_mask;
+
+    //! Thread name.
+    //! @remarks
+    //!  If empty, name isn't changed. Longer names are truncated.
+    char name[MaxNameLen];
+
+    ThreadParams()
+        : policy(ThreadPolicyDefault)
+        , priority(0)
+        , cpu_mask(0) {
+        name[0] = '\0';
+    }
+
+    //! Set thread name.
+    void set_name(const char* str);
+};
+
+//! Apply parameters to the calling thread.
+//! @remarks
+//!  Tries to apply every parameter even if some of them fail, e.g. because of
+//!  missing permissions for realtime scheduling. Failures are logged.
+//! @returns
+//!  false if some of the parameters were not applied.
+bool set_thread_params(const ThreadParams& params);
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_THREAD_PARAMS_H_
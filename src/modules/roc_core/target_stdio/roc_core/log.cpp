@@ -8,29 +8,48 @@
 
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "roc_core/colors.h"
 #include "roc_core/format_time.h"
 #include "roc_core/log.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
 
 namespace roc {
 namespace core {
 
+namespace {
+
+// Call sites are identified by the addresses of their format string and module.
+// Pointers are aligned, so high bits are mixed into low bits before the hash is
+// reduced to a bucket index.
+size_t hash_site(const char* module, const char* format) {
+    size_t h = (size_t)format ^ ((size_t)module << 7);
+    h ^= h >> 16;
+    h *= 0x45d9f3b;
+    h ^= h >> 16;
+    return h;
+}
+
+} // namespace
+
 Logger::Logger()
     : level_(DefaultLogLevel)
     , handler_(NULL)
-    , colors_(DefaultColorsMode) {
+    , colors_(DefaultColorsMode)
+    , write_pos_(0)
+    , read_pos_(0) {
+    for (size_t n = 0; n < QueueSize; n++) {
+        slots_[n].seq.exchange((long)n);
+    }
 }
 
 LogLevel Logger::level() {
-    Mutex::Lock lock(mutex_);
-
-    return level_;
+    return (LogLevel)(long)level_;
 }
 
 void Logger::set_level(LogLevel level) {
-    Mutex::Lock lock(mutex_);
-
     if ((int)level < LogNone) {
         level = LogNone;
     }
@@ -39,7 +58,7 @@ void Logger::set_level(LogLevel level) {
         level = LogTrace;
     }
 
-    level_ = level;
+    level_.exchange(level);
 }
 
 void Logger::set_handler(LogHandler handler) {
@@ -54,26 +73,236 @@ void Logger::set_colors(ColorsMode colors) {
     colors_ = colors;
 }
 
-void Logger::print(const char* module, LogLevel level, const char* format, ...) {
-    Mutex::Lock lock(mutex_);
+bool Logger::set_async(AsyncMode mode) {
+    Mutex::Lock lock(async_mutex_);
+
+    if (mode == AsyncEnabled) {
+        if (!joinable()) {
+            ThreadParams params;
+            params.set_name("roc-log");
+            set_params(params);
 
-    if (level > level_ || level == LogNone) {
+            if (stop_ || !start()) {
+                return false;
+            }
+            atexit(flush_at_exit_);
+        }
+
+        async_ = true;
+    } else {
+        async_ = false;
+
+        flush_();
+    }
+
+    return true;
+}
+
+void Logger::print(const char* module, LogLevel level, const char* format, ...) {
+    if (level > (long)level_ || level == LogNone) {
         return;
     }
 
-    char message[256] = {};
     va_list args;
     va_start(args, format);
+
+    if (async_) {
+        print_async_(module, level, format, args);
+    } else {
+        print_sync_(module, level, format, args);
+    }
+
+    va_end(args);
+}
+
+void Logger::print_sync_(const char* module,
+                         LogLevel level,
+                         const char* format,
+                         va_list args) {
+    const nanoseconds_t time = timestamp_realtime();
+
+    char message[MaxMessageLen] = {};
     if (vsnprintf(message, sizeof(message) - 1, format, args) < 0) {
         message[0] = '\0';
     }
-    va_end(args);
 
+    Mutex::Lock lock(mutex_);
+
+    write_(time, level, module, message);
+}
+
+void Logger::print_async_(const char* module,
+                          LogLevel level,
+                          const char* format,
+                          va_list args) {
+    const nanoseconds_t time = timestamp_realtime();
+
+    if (!check_rate_(level, module, format)) {
+        return;
+    }
+
+    unsigned long pos = 0;
+    Slot* slot = claim_slot_(pos);
+    if (!slot) {
+        ++num_dropped_;
+        return;
+    }
+
+    slot->time = time;
+    slot->level = level;
+    slot->module = module;
+    if (vsnprintf(slot->message, sizeof(slot->message) - 1, format, args) < 0) {
+        slot->message[0] = '\0';
+    }
+
+    publish_slot_(*slot, pos);
+}
+
+bool Logger::check_rate_(LogLevel level, const char* module, const char* format) {
+    if (level == LogError) {
+        return true;
+    }
+
+    const long site_format = (long)(size_t)format;
+    const long site_module = (long)(size_t)module;
+
+    Site& site = sites_[hash_site(module, format) % NumSites];
+
+    const long second = (long)(timestamp() / Second);
+    const long prev_second = site.second;
+
+    if (second != prev_second && site.second.compare_exchange(prev_second, second)) {
+        // report messages suppressed during the previous second on behalf of the
+        // call site that owned the bucket, and then take the bucket over
+        if (const long n_suppressed = site.suppressed.exchange(0)) {
+            report_suppressed_(site, n_suppressed);
+        }
+
+        site.count.exchange(0);
+        site.format.exchange(site_format);
+        site.module.exchange(site_module);
+        site.level.exchange(level);
+    }
+
+    if (site.format != site_format || site.module != site_module) {
+        // bucket is owned by another call site during this second
+        return true;
+    }
+
+    if (++site.count > MaxMessagesPerSecond) {
+        ++site.suppressed;
+        return false;
+    }
+
+    return true;
+}
+
+void Logger::report_suppressed_(Site& site, long n_suppressed) {
+    unsigned long pos = 0;
+    Slot* slot = claim_slot_(pos);
+    if (!slot) {
+        ++num_dropped_;
+        return;
+    }
+
+    slot->time = timestamp_realtime();
+    slot->level = (LogLevel)(long)site.level;
+    slot->module = (const char*)(size_t)(long)site.module;
+    snprintf(slot->message, sizeof(slot->message) - 1,
+             "suppressed %ld messages from call site \"%s\"", n_suppressed,
+             (const char*)(size_t)(long)site.format);
+
+    publish_slot_(*slot, pos);
+}
+
+// Bounded multi-producer single-consumer queue. Every slot has a sequence number.
+// A slot at position pos is free for writing if its sequence is pos, and is ready
+// for reading if its sequence is pos + 1. After reading, the sequence is advanced
+// by QueueSize, so that the slot becomes free for the next round.
+Logger::Slot* Logger::claim_slot_(unsigned long& pos) {
+    for (;;) {
+        pos = (unsigned long)(long)write_pos_;
+
+        Slot& slot = slots_[pos % QueueSize];
+        const long diff = (long)((unsigned long)(long)slot.seq - pos);
+
+        if (diff == 0) {
+            if (write_pos_.compare_exchange((long)pos, (long)(pos + 1))) {
+                return &slot;
+            }
+        } else if (diff < 0) {
+            return NULL;
+        }
+    }
+}
+
+void Logger::publish_slot_(Slot& slot, unsigned long pos) {
+    slot.seq.exchange((long)(pos + 1));
+}
+
+bool Logger::flush_() {
+    Mutex::Lock lock(flush_mutex_);
+
+    bool flushed = false;
+
+    for (;;) {
+        Slot& slot = slots_[read_pos_ % QueueSize];
+        if ((unsigned long)(long)slot.seq != read_pos_ + 1) {
+            break;
+        }
+
+        {
+            Mutex::Lock lock(mutex_);
+            write_(slot.time, slot.level, slot.module, slot.message);
+        }
+
+        slot.seq.exchange((long)(read_pos_ + QueueSize));
+        read_pos_++;
+
+        flushed = true;
+    }
+
+    if (const long n_dropped = num_dropped_.exchange(0)) {
+        char message[MaxMessageLen] = {};
+        snprintf(message, sizeof(message) - 1,
+                 "dropped %ld messages because log queue was full", n_dropped);
+
+        Mutex::Lock lock(mutex_);
+        write_(timestamp_realtime(), LogError, "roc_core", message);
+    }
+
+    return flushed;
+}
+
+void Logger::run() {
+    while (!stop_) {
+        if (!flush_()) {
+            sleep_for(PollIntervalMs * Millisecond);
+        }
+    }
+}
+
+void Logger::flush_at_exit_() {
+    Logger& logger = Logger::instance();
+
+    Mutex::Lock lock(logger.async_mutex_);
+
+    logger.async_ = false;
+    logger.stop_ = true;
+    logger.join();
+
+    logger.flush_();
+}
+
+void Logger::write_(nanoseconds_t time,
+                    LogLevel level,
+                    const char* module,
+                    const char* message) {
     if (handler_) {
         handler_(level, module, message);
     } else {
         char timestamp[64] = {};
-        if (!format_time(timestamp, sizeof(timestamp))) {
+        if (!format_time(timestamp, sizeof(timestamp), time)) {
             timestamp[0] = '\0';
         }
 
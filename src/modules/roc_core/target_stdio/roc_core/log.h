@@ -12,18 +12,31 @@
 #ifndef ROC_CORE_LOG_H_
 #define ROC_CORE_LOG_H_
 
+#include <stdarg.h>
+
+#include "roc_core/atomic.h"
 #include "roc_core/attributes.h"
 #include "roc_core/mutex.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/singleton.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
 
 #ifndef ROC_MODULE
 #error "ROC_MODULE not defined"
 #endif
 
 //! Print message to log.
-#define roc_log(...)                                                                     \
-    ::roc::core::Logger::instance().print(ROC_STRINGIZE(ROC_MODULE), __VA_ARGS__)
+//! @remarks
+//!  Arguments are not evaluated if the message level is disabled, so that
+//!  disabled messages on hot paths don't format addresses and so on.
+#define roc_log(level, ...)                                                              \
+    do {                                                                                 \
+        if (::roc::core::Logger::instance().enabled(level)) {                            \
+            ::roc::core::Logger::instance().print(ROC_STRINGIZE(ROC_MODULE), (level),    \
+                                                  __VA_ARGS__);                          \
+        }                                                                                \
+    } while (0)
 
 namespace roc {
 
@@ -50,11 +63,33 @@ enum ColorsMode {
 //! Default colors mode.
 const ColorsMode DefaultColorsMode = ColorsDisabled;
 
+//! Async mode.
+enum AsyncMode {
+    AsyncDisabled, //!< Write messages on the calling thread.
+    AsyncEnabled   //!< Write messages on a background thread.
+};
+
+//! Default async mode.
+const AsyncMode DefaultAsyncMode = AsyncDisabled;
+
 //! Log handler.
 typedef void (*LogHandler)(LogLevel level, const char* module, const char* message);
 
 //! Logger.
-class Logger : public NonCopyable<> {
+//!
+//! By default, messages are formatted and written on the calling thread under
+//! a mutex. In async mode, the calling thread only formats the message into a
+//! preallocated slot of a lock-free queue, and a background thread writes
+//! queued messages. Logging in async mode never blocks and never allocates;
+//! if the queue is full, the message is dropped and the number of dropped
+//! messages is reported later.
+//!
+//! In async mode, messages are also rate-limited per call site: every call site
+//! may emit at most MaxMessagesPerSecond messages per second, and the number of
+//! suppressed messages is reported with the level and module of that call site
+//! when it logs again. Error messages are never rate-limited. Timestamps of
+//! messages are taken when they're queued, not when they're written.
+class Logger : public NonCopyable<>, private Thread {
 public:
     //! Get logger instance.
     static Logger& instance() {
@@ -68,6 +103,13 @@ public:
     //! Get current maximum log level.
     LogLevel level();
 
+    //! Check if messages of given level are enabled.
+    //! @remarks
+    //!  Cheap enough to be called for every message on hot paths.
+    bool enabled(LogLevel level) const {
+        return level != LogNone && (long)level <= level_.load_relaxed();
+    }
+
     //! Set maximum log level.
     //!
     //! @remarks
@@ -90,16 +132,94 @@ public:
     //!  Default colors mode is ColorsAuto.
     void set_colors(ColorsMode mode);
 
+    //! Set async mode.
+    //!
+    //! @remarks
+    //!  When async mode is enabled for the first time, the background writer
+    //!  thread is started, and log handler is invoked from that thread from now
+    //!  on. When async mode is disabled, all pending messages are written before
+    //!  returning. Pending messages are also written when the process exits
+    //!  normally.
+    //!
+    //! @returns
+    //!  false if async mode can't be enabled.
+    //!
+    //! @note
+    //!  Default async mode is AsyncDisabled.
+    bool set_async(AsyncMode mode);
+
+    enum {
+        //! Maximum number of messages per second from one call site in async mode.
+        MaxMessagesPerSecond = 50
+    };
+
 private:
     friend class Singleton<Logger>;
 
+    enum {
+        MaxMessageLen = 256,
+        QueueSize = 512,
+        NumSites = 256,
+        PollIntervalMs = 5
+    };
+
+    struct Slot {
+        Atomic seq;
+        nanoseconds_t time;
+        LogLevel level;
+        const char* module;
+        char message[MaxMessageLen];
+    };
+
+    // Rate limiting state of a call site. The bucket is owned by one call site
+    // during one second; format, module and level identify the owner.
+    struct Site {
+        Atomic second;
+        Atomic format;
+        Atomic module;
+        Atomic level;
+        Atomic count;
+        Atomic suppressed;
+    };
+
     Logger();
 
+    virtual void run();
+
+    void print_sync_(const char* module, LogLevel level, const char* format, va_list);
+    void print_async_(const char* module, LogLevel level, const char* format, va_list);
+
+    bool check_rate_(LogLevel level, const char* module, const char* format);
+    void report_suppressed_(Site& site, long n_suppressed);
+
+    Slot* claim_slot_(unsigned long& pos);
+    void publish_slot_(Slot& slot, unsigned long pos);
+
+    bool flush_();
+    void write_(nanoseconds_t time,
+                LogLevel level,
+                const char* module,
+                const char* message);
+
+    static void flush_at_exit_();
+
     Mutex mutex_;
+    Mutex async_mutex_;
+    Mutex flush_mutex_;
 
-    LogLevel level_;
+    Atomic level_;
     LogHandler handler_;
     ColorsMode colors_;
+
+    Atomic async_;
+    Atomic stop_;
+
+    Slot slots_[QueueSize];
+    Atomic write_pos_;
+    unsigned long read_pos_;
+    Atomic num_dropped_;
+
+    Site sites_[NumSites];
 };
 
 } // namespace core
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/trace_dump.h"
+#include "roc_core/tracer.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+enum {
+    // maximum number of distinct stages in histogram
+    MaxStages = 64,
+
+    // bucket 0 is below 1us, bucket N is [2^(N-1)us; 2^N us),
+    // and the last bucket also includes all larger durations
+    NumBuckets = 24
+};
+
+struct JsonState {
+    FILE* fp;
+    size_t n_events;
+};
+
+struct Stage {
+    const char* name;
+    size_t count;
+    nanoseconds_t min;
+    nanoseconds_t max;
+    nanoseconds_t sum;
+    size_t buckets[NumBuckets];
+};
+
+struct HistogramState {
+    Stage stages[MaxStages];
+    size_t n_stages;
+    size_t n_skipped;
+};
+
+double to_us(nanoseconds_t ns) {
+    return double(ns) / Microsecond;
+}
+
+void write_json_event(void* arg, size_t thread, const TraceEvent& event) {
+    JsonState& state = *(JsonState*)arg;
+
+    fprintf(state.fp,
+            "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%lu,"
+            "\"ts\":%.3f,\"dur\":%.3f}",
+            state.n_events == 0 ? "" : ",", event.name, (unsigned long)thread + 1,
+            to_us(event.begin), to_us(event.end - event.begin));
+
+    state.n_events++;
+}
+
+size_t bucket_index(nanoseconds_t duration) {
+    size_t n = 0;
+    nanoseconds_t limit = Microsecond;
+
+    while (duration >= limit && n < NumBuckets - 1) {
+        limit *= 2;
+        n++;
+    }
+
+    return n;
+}
+
+Stage* find_stage(HistogramState& state, const char* name) {
+    for (size_t n = 0; n < state.n_stages; n++) {
+        if (strcmp(state.stages[n].name, name) == 0) {
+            return &state.stages[n];
+        }
+    }
+
+    if (state.n_stages == MaxStages) {
+        return NULL;
+    }
+
+    Stage& stage = state.stages[state.n_stages++];
+    memset(&stage, 0, sizeof(stage));
+    stage.name = name;
+
+    return &stage;
+}
+
+void add_histogram_event(void* arg, size_t, const TraceEvent& event) {
+    HistogramState& state = *(HistogramState*)arg;
+
+    Stage* stage = find_stage(state, event.name);
+    if (!stage) {
+        state.n_skipped++;
+        return;
+    }
+
+    const nanoseconds_t duration = event.end - event.begin;
+
+    if (stage->count == 0 || duration < stage->min) {
+        stage->min = duration;
+    }
+    if (stage->count == 0 || duration > stage->max) {
+        stage->max = duration;
+    }
+
+    stage->count++;
+    stage->sum += duration;
+    stage->buckets[bucket_index(duration)]++;
+}
+
+void print_stage(const Stage& stage) {
+    fprintf(stderr, "%s: count=%lu min=%.3fus avg=%.3fus max=%.3fus\n", stage.name,
+            (unsigned long)stage.count, to_us(stage.min),
+            to_us(stage.sum) / stage.count, to_us(stage.max));
+
+    for (size_t n = 0; n < NumBuckets; n++) {
+        if (stage.buckets[n] == 0) {
+            continue;
+        }
+
+        const unsigned long lo = n == 0 ? 0 : 1ul << (n - 1);
+        const unsigned long hi = 1ul << n;
+
+        if (n == NumBuckets - 1) {
+            fprintf(stderr, "  [%8lu; ...     ) us %lu\n", lo,
+                    (unsigned long)stage.buckets[n]);
+        } else {
+            fprintf(stderr, "  [%8lu; %8lu) us %lu\n", lo, hi,
+                    (unsigned long)stage.buckets[n]);
+        }
+    }
+}
+
+} // namespace
+
+bool dump_trace_json(const char* path) {
+    roc_panic_if(!path);
+
+    JsonState state;
+    state.n_events = 0;
+
+    if (!(state.fp = fopen(path, "w"))) {
+        roc_log(LogError, "trace dump: can't open %s: %s", path,
+                errno_to_str().c_str());
+        return false;
+    }
+
+    fprintf(state.fp, "{\"traceEvents\":[");
+    Tracer::instance().iterate_events(write_json_event, &state);
+    fprintf(state.fp, "\n]}\n");
+
+    bool ok = !ferror(state.fp);
+
+    if (fclose(state.fp) != 0) {
+        ok = false;
+    }
+
+    if (!ok) {
+        roc_log(LogError, "trace dump: can't write %s", path);
+        return false;
+    }
+
+    roc_log(LogInfo, "trace dump: wrote %lu events to %s", (unsigned long)state.n_events,
+            path);
+
+    if (size_t n_dropped = Tracer::instance().num_dropped()) {
+        roc_log(LogInfo, "trace dump: %lu events were dropped (too many threads)",
+                (unsigned long)n_dropped);
+    }
+
+    return true;
+}
+
+void print_trace_histogram() {
+    // too large for the stack of some threads
+    static HistogramState state;
+
+    state.n_stages = 0;
+    state.n_skipped = 0;
+
+    Tracer::instance().iterate_events(add_histogram_event, &state);
+
+    for (size_t n = 0; n < state.n_stages; n++) {
+        print_stage(state.stages[n]);
+    }
+
+    if (state.n_skipped != 0) {
+        fprintf(stderr, "skipped %lu events (too many stages)\n",
+                (unsigned long)state.n_skipped);
+    }
+}
+
+} // namespace core
+} // namespace roc
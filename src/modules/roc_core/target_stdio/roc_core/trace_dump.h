@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/target_stdio/roc_core/trace_dump.h
+//! @brief Dump trace events.
+
+#ifndef ROC_CORE_TRACE_DUMP_H_
+#define ROC_CORE_TRACE_DUMP_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Write events recorded by tracer to a file.
+//! @remarks
+//!  Uses Chrome trace event format, which can be opened in chrome://tracing
+//!  or Perfetto UI. Each thread of the tracer becomes a separate track.
+//! @returns
+//!  false if the file can't be written.
+bool dump_trace_json(const char* path);
+
+//! Print per-stage latency histogram of events recorded by tracer.
+//! @remarks
+//!  For every stage, prints number of events, minimum, average, and maximum
+//!  duration, and the distribution of durations using power-of-two buckets.
+void print_trace_histogram();
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_TRACE_DUMP_H_
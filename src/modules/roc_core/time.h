@@ -41,6 +41,11 @@ const nanoseconds_t Hour = 60 * Minute;
 //! Get current timestamp in nanoseconds.
 nanoseconds_t timestamp();
 
+//! Get current wall clock time in nanoseconds since Unix epoch.
+//! @remarks
+//!  May jump when system time is adjusted. Use timestamp() to measure intervals.
+nanoseconds_t timestamp_realtime();
+
 //! Sleep until the specified absolute time point has been reached.
 //! @remarks
 //!  @p timestamp specifies absolute time point in nanoseconds.
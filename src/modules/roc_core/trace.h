@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/trace.h
+//! @brief Hot-path tracing.
+
+#ifndef ROC_CORE_TRACE_H_
+#define ROC_CORE_TRACE_H_
+
+#ifdef ROC_ENABLE_TRACING
+
+#include "roc_core/tracer.h"
+
+//! Concatenate two tokens after macro expansion.
+#define ROC_TRACE_CONCAT(a, b) ROC_TRACE_CONCAT_IMPL(a, b)
+
+//! Concatenate two tokens.
+#define ROC_TRACE_CONCAT_IMPL(a, b) a##b
+
+//! Measure time spent in the enclosing scope.
+//! @remarks
+//!  @p name should be a string literal identifying the pipeline stage.
+//!  The measured interval is recorded into the per-thread ring buffer of
+//!  the tracer when the scope is left.
+#define roc_trace_scope(name)                                                            \
+    ::roc::core::TraceScope ROC_TRACE_CONCAT(roc_trace_scope_, __LINE__)(name)
+
+#else // !ROC_ENABLE_TRACING
+
+//! Measure time spent in the enclosing scope.
+//! @remarks
+//!  Expands to nothing because tracing is disabled at build time.
+#define roc_trace_scope(name) ((void)0)
+
+#endif // ROC_ENABLE_TRACING
+
+#endif // ROC_CORE_TRACE_H_
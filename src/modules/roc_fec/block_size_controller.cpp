@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/block_size_controller.h"
+#include "roc_core/log.h"
+
+namespace roc {
+namespace fec {
+
+BlockSizeController::BlockSizeController(const BlockSizeControllerConfig& config,
+                                         size_t n_source_packets)
+    : n_source_packets_(n_source_packets)
+    , min_repair_packets_(config.min_repair_packets)
+    , max_repair_packets_(config.max_repair_packets)
+    , redundancy_(config.redundancy)
+    , decay_(config.decay)
+    , loss_ratio_(0)
+    , n_repair_packets_(config.max_repair_packets)
+    , valid_(false) {
+    if (n_source_packets_ == 0 || min_repair_packets_ > max_repair_packets_
+        || redundancy_ < 0 || decay_ <= 0 || decay_ > 1) {
+        roc_log(LogError,
+                "fec controller: invalid config:"
+                " sbl=%lu min_rbl=%lu max_rbl=%lu redundancy=%.3f decay=%.3f",
+                (unsigned long)n_source_packets_, (unsigned long)min_repair_packets_,
+                (unsigned long)max_repair_packets_, (double)redundancy_,
+                (double)decay_);
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool BlockSizeController::valid() const {
+    return valid_;
+}
+
+void BlockSizeController::report_loss(float loss_ratio) {
+    if (!(loss_ratio > 0)) {
+        loss_ratio = 0;
+    }
+    if (loss_ratio > 1) {
+        loss_ratio = 1;
+    }
+
+    core::Mutex::Lock lock(mutex_);
+
+    if (loss_ratio >= loss_ratio_) {
+        loss_ratio_ = loss_ratio;
+    } else {
+        loss_ratio_ += (loss_ratio - loss_ratio_) * decay_;
+    }
+
+    const size_t n_repair_packets = compute_repair_packets_(loss_ratio_);
+
+    if (n_repair_packets != n_repair_packets_) {
+        roc_log(LogDebug,
+                "fec controller: updating block size:"
+                " loss=%.5f sbl=%lu cur_rbl=%lu new_rbl=%lu",
+                (double)loss_ratio_, (unsigned long)n_source_packets_,
+                (unsigned long)n_repair_packets_, (unsigned long)n_repair_packets);
+
+        n_repair_packets_ = n_repair_packets;
+    }
+}
+
+size_t BlockSizeController::n_source_packets() const {
+    return n_source_packets_;
+}
+
+size_t BlockSizeController::n_repair_packets() const {
+    core::Mutex::Lock lock(mutex_);
+
+    return n_repair_packets_;
+}
+
+size_t BlockSizeController::compute_repair_packets_(float loss_ratio) const {
+    const float expected_losses = loss_ratio * (float)n_source_packets_ * redundancy_;
+
+    size_t n_repair_packets = (size_t)expected_losses;
+    if ((float)n_repair_packets < expected_losses) {
+        n_repair_packets++;
+    }
+
+    n_repair_packets += min_repair_packets_;
+
+    if (n_repair_packets > max_repair_packets_) {
+        n_repair_packets = max_repair_packets_;
+    }
+
+    return n_repair_packets;
+}
+
+} // namespace fec
+} // namespace roc
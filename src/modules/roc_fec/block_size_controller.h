@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/block_size_controller.h
+//! @brief FEC block size controller.
+
+#ifndef ROC_FEC_BLOCK_SIZE_CONTROLLER_H_
+#define ROC_FEC_BLOCK_SIZE_CONTROLLER_H_
+
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace fec {
+
+//! FEC block size controller parameters.
+struct BlockSizeControllerConfig {
+    //! Minimum number of repair packets per block.
+    size_t min_repair_packets;
+
+    //! Maximum number of repair packets per block.
+    size_t max_repair_packets;
+
+    //! Number of repair packets per expected lost packet.
+    //! Values above one leave a margin for loss bursts.
+    float redundancy;
+
+    //! Weight of a new loss report when the loss is decreasing.
+    //! The loss increase is applied immediately, while the decrease is
+    //! smoothed to avoid oscillations. Should be in range (0; 1].
+    float decay;
+
+    BlockSizeControllerConfig()
+        : min_repair_packets(1)
+        , max_repair_packets(10)
+        , redundancy(2.0f)
+        , decay(0.25f) {
+    }
+};
+
+//! FEC block size controller.
+//! @remarks
+//!  Computes the number of repair packets per block from the loss ratio
+//!  reported by the receiver side. The number of source packets is fixed.
+//!  Until the first report, the maximum number of repair packets is used.
+//!  The computed block size is intended to be passed to fec::Writer::resize(),
+//!  which applies it at the next block boundary.
+//!  Methods are thread-safe.
+class BlockSizeController : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p config defines controller parameters
+    //!  - @p n_source_packets defines the number of source packets per block
+    BlockSizeController(const BlockSizeControllerConfig& config,
+                        size_t n_source_packets);
+
+    //! Check if object is successfully constructed.
+    bool valid() const;
+
+    //! Report observed loss ratio.
+    //! @remarks
+    //!  @p loss_ratio is a fraction of lost packets, in range [0; 1].
+    //!  Out of range values are clamped.
+    void report_loss(float loss_ratio);
+
+    //! Get number of source packets per block.
+    size_t n_source_packets() const;
+
+    //! Get number of repair packets per block.
+    size_t n_repair_packets() const;
+
+private:
+    size_t compute_repair_packets_(float loss_ratio) const;
+
+    const size_t n_source_packets_;
+    const size_t min_repair_packets_;
+    const size_t max_repair_packets_;
+    const float redundancy_;
+    const float decay_;
+
+    float loss_ratio_;
+    size_t n_repair_packets_;
+
+    core::Mutex mutex_;
+
+    bool valid_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_BLOCK_SIZE_CONTROLLER_H_
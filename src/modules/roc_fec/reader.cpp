@@ -9,6 +9,7 @@
 #include "roc_fec/reader.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/trace.h"
 #include "roc_packet/fec_scheme_to_str.h"
 
 namespace roc {
@@ -31,10 +32,18 @@ Reader::Reader(const ReaderConfig& config,
     , repair_queue_(0)
     , source_block_(allocator)
     , repair_block_(allocator)
+    , upcoming_source_queue_(0)
+    , upcoming_repair_queue_(0)
+    , upcoming_source_block_(allocator)
+    , upcoming_repair_block_(allocator)
+    , upcoming_payload_size_(0)
+    , has_upcoming_packets_(false)
+    , upcoming_sbn_(0)
     , valid_(false)
     , alive_(true)
     , started_(false)
     , can_repair_(false)
+    , repair_released_(false)
     , next_packet_(0)
     , cur_sbn_(0)
     , payload_size_(0)
@@ -42,7 +51,9 @@ Reader::Reader(const ReaderConfig& config,
     , repair_block_resized_(false)
     , payload_resized_(false)
     , n_packets_(0)
+    , n_restored_(0)
     , max_sbn_jump_(config.max_sbn_jump)
+    , early_repair_(config.early_repair)
     , fec_scheme_(fec_scheme) {
     valid_ = true;
 }
@@ -59,7 +70,13 @@ bool Reader::alive() const {
     return alive_;
 }
 
+size_t Reader::num_restored() const {
+    return n_restored_;
+}
+
 packet::PacketPtr Reader::read() {
+    roc_trace_scope("fec_reader.read");
+
     roc_panic_if_not(valid());
     if (!alive_) {
         return NULL;
@@ -176,6 +193,7 @@ void Reader::next_block_() {
     payload_resized_ = false;
 
     can_repair_ = false;
+    repair_released_ = false;
 
     fill_block_();
 }
@@ -189,7 +207,7 @@ void Reader::try_repair_() {
         return;
     }
 
-    if (!decoder_.begin(source_block_.size(), repair_block_.size(), payload_size_)) {
+    if (!decode_block_(source_block_, repair_block_, payload_size_)) {
         roc_log(LogDebug,
                 "fec reader: can't begin decoder block, shutting down:"
                 " sbl=%lu rbl=%lu payload_size=%lu",
@@ -199,22 +217,32 @@ void Reader::try_repair_() {
         return;
     }
 
-    for (size_t n = 0; n < source_block_.size(); n++) {
-        if (!source_block_[n]) {
+    can_repair_ = false;
+}
+
+bool Reader::decode_block_(core::Array<packet::PacketPtr>& source_block,
+                           const core::Array<packet::PacketPtr>& repair_block,
+                           size_t payload_size) {
+    if (!decoder_.begin(source_block.size(), repair_block.size(), payload_size)) {
+        return false;
+    }
+
+    for (size_t n = 0; n < source_block.size(); n++) {
+        if (!source_block[n]) {
             continue;
         }
-        decoder_.set(n, source_block_[n]->fec()->payload);
+        decoder_.set(n, source_block[n]->fec()->payload);
     }
 
-    for (size_t n = 0; n < repair_block_.size(); n++) {
-        if (!repair_block_[n]) {
+    for (size_t n = 0; n < repair_block.size(); n++) {
+        if (!repair_block[n]) {
             continue;
         }
-        decoder_.set(source_block_.size() + n, repair_block_[n]->fec()->payload);
+        decoder_.set(source_block.size() + n, repair_block[n]->fec()->payload);
     }
 
-    for (size_t n = 0; n < source_block_.size(); n++) {
-        if (source_block_[n]) {
+    for (size_t n = 0; n < source_block.size(); n++) {
+        if (source_block[n]) {
             continue;
         }
 
@@ -228,11 +256,271 @@ void Reader::try_repair_() {
             continue;
         }
 
-        source_block_[n] = pp;
+        source_block[n] = pp;
+        n_restored_++;
     }
 
     decoder_.end();
+
+    return true;
+}
+
+void Reader::try_repair_early_() {
+    if (!can_repair_) {
+        return;
+    }
+
+    size_t n_source = 0;
+    for (size_t n = 0; n < source_block_.size(); n++) {
+        if (source_block_[n]) {
+            n_source++;
+        }
+    }
+
+    if (n_source == source_block_.size()) {
+        release_repair_block_();
+        return;
+    }
+
+    size_t n_repair = 0;
+    for (size_t n = 0; n < repair_block_.size(); n++) {
+        if (repair_block_[n]) {
+            n_repair++;
+        }
+    }
+
+    if (n_source + n_repair < source_block_.size()) {
+        // decoder can't repair anything until more packets arrive
+        can_repair_ = false;
+        return;
+    }
+
+    try_repair_();
+
+    for (size_t n = 0; n < source_block_.size(); n++) {
+        if (!source_block_[n]) {
+            return;
+        }
+    }
+
+    release_repair_block_();
+}
+
+void Reader::release_repair_block_() {
+    unsigned n_released = 0;
+
+    for (size_t n = 0; n < repair_block_.size(); n++) {
+        if (repair_block_[n]) {
+            repair_block_[n] = NULL;
+            n_released++;
+        }
+    }
+
+    if (n_released != 0) {
+        roc_log(LogTrace, "fec reader: releasing repair packets: sbn=%lu released=%u",
+                (unsigned long)cur_sbn_, n_released);
+    }
+
     can_repair_ = false;
+    repair_released_ = true;
+}
+
+// Packets of the blocks following the current one stay in the queues until
+// next_block_() reaches them. Walk through these blocks, repair the ones that
+// have enough packets, and put the restored packets back to the source queue,
+// so that they're already in place when the reader reaches them.
+void Reader::repair_upcoming_blocks_() {
+    if (!has_upcoming_packets_ || !alive_) {
+        return;
+    }
+
+    for (;;) {
+        packet::PacketPtr source_pp = source_queue_.head();
+        packet::PacketPtr repair_pp = repair_queue_.head();
+
+        packet::blknum_t sbn;
+
+        if (source_pp
+            && (!repair_pp
+                || packet::blknum_le(source_pp->fec()->source_block_number,
+                                     repair_pp->fec()->source_block_number))) {
+            sbn = source_pp->fec()->source_block_number;
+        } else if (repair_pp) {
+            sbn = repair_pp->fec()->source_block_number;
+        } else {
+            break;
+        }
+
+        if (!packet::blknum_lt(cur_sbn_, sbn)) {
+            // should not happen: fill_block_() has fetched these packets
+            break;
+        }
+
+        repair_upcoming_block_(sbn, !packet::blknum_lt(sbn, upcoming_sbn_));
+    }
+
+    // packets are read in order, so every write appends to the queue tail
+    while (packet::PacketPtr pp = upcoming_source_queue_.read()) {
+        source_queue_.write(pp);
+    }
+
+    while (packet::PacketPtr pp = upcoming_repair_queue_.read()) {
+        repair_queue_.write(pp);
+    }
+
+    has_upcoming_packets_ = false;
+}
+
+void Reader::repair_upcoming_block_(packet::blknum_t sbn, bool has_new_packets) {
+    upcoming_source_block_.resize(0);
+    upcoming_repair_block_.resize(0);
+
+    bool block_valid = true;
+    size_t n_source = 0, n_repair = 0;
+
+    while (packet::PacketPtr pp = source_queue_.head()) {
+        const packet::FEC& fec = *pp->fec();
+
+        if (fec.source_block_number != sbn) {
+            break;
+        }
+
+        (void)source_queue_.read();
+        upcoming_source_queue_.write(pp);
+
+        // invalid packets are left for fill_source_block_(), which drops them
+        if (!validate_incoming_source_packet_(pp)) {
+            continue;
+        }
+
+        if (!update_upcoming_block_(fec, false)) {
+            block_valid = false;
+            continue;
+        }
+
+        if (!upcoming_source_block_[fec.encoding_symbol_id]) {
+            upcoming_source_block_[fec.encoding_symbol_id] = pp;
+            n_source++;
+        }
+    }
+
+    while (packet::PacketPtr pp = repair_queue_.head()) {
+        const packet::FEC& fec = *pp->fec();
+
+        if (fec.source_block_number != sbn) {
+            break;
+        }
+
+        (void)repair_queue_.read();
+
+        if (!validate_incoming_repair_packet_(pp)) {
+            upcoming_repair_queue_.write(pp);
+            continue;
+        }
+
+        if (!update_upcoming_block_(fec, true)) {
+            upcoming_repair_queue_.write(pp);
+            block_valid = false;
+            continue;
+        }
+
+        const size_t p_num = fec.encoding_symbol_id - fec.source_block_length;
+
+        if (!upcoming_repair_block_[p_num]) {
+            upcoming_repair_block_[p_num] = pp;
+            n_repair++;
+        }
+    }
+
+    const size_t sblen = upcoming_source_block_.size();
+
+    if (block_valid && has_new_packets && n_source < sblen && n_repair != 0
+        && n_source + n_repair >= sblen) {
+        if (decode_block_(upcoming_source_block_, upcoming_repair_block_,
+                          upcoming_payload_size_)) {
+            for (size_t n = 0; n < sblen; n++) {
+                packet::PacketPtr& pp = upcoming_source_block_[n];
+
+                if (!pp || pp->fec()) {
+                    continue;
+                }
+
+                // restored packet is written to the source queue, so it needs
+                // the same FEC fields as a received one
+                pp->add_flags(packet::Packet::FlagFEC);
+
+                packet::FEC& fec = *pp->fec();
+                fec.fec_scheme = fec_scheme_;
+                fec.source_block_number = sbn;
+                fec.encoding_symbol_id = n;
+                fec.source_block_length = sblen;
+                fec.block_length = sblen + upcoming_repair_block_.size();
+                fec.payload = pp->data();
+
+                upcoming_source_queue_.write(pp);
+                n_source++;
+            }
+        }
+    }
+
+    const bool block_complete = block_valid && sblen != 0 && n_source == sblen;
+
+    if (block_complete && n_repair != 0) {
+        roc_log(LogTrace,
+                "fec reader: releasing repair packets of upcoming block:"
+                " sbn=%lu released=%lu",
+                (unsigned long)sbn, (unsigned long)n_repair);
+    }
+
+    for (size_t n = 0; n < upcoming_repair_block_.size(); n++) {
+        if (upcoming_repair_block_[n] && !block_complete) {
+            upcoming_repair_queue_.write(upcoming_repair_block_[n]);
+        }
+    }
+
+    upcoming_source_block_.resize(0);
+    upcoming_repair_block_.resize(0);
+}
+
+bool Reader::update_upcoming_block_(const packet::FEC& fec, bool is_repair) {
+    if (upcoming_source_block_.size() == 0) {
+        if (fec.source_block_length > decoder_.max_block_length()) {
+            return false;
+        }
+        if (!upcoming_source_block_.resize(fec.source_block_length)) {
+            return false;
+        }
+        upcoming_payload_size_ = fec.payload.size();
+    } else if (fec.source_block_length != upcoming_source_block_.size()
+               || fec.payload.size() != upcoming_payload_size_) {
+        return false;
+    }
+
+    if (!is_repair) {
+        return true;
+    }
+
+    if (fec.block_length == 0 || fec.block_length > decoder_.max_block_length()) {
+        return false;
+    }
+
+    const size_t rblen = fec.block_length - fec.source_block_length;
+
+    if (upcoming_repair_block_.size() == 0) {
+        return upcoming_repair_block_.resize(rblen);
+    }
+
+    return upcoming_repair_block_.size() == rblen;
+}
+
+void Reader::note_upcoming_packet_(const packet::PacketPtr& pp) {
+    const packet::blknum_t sbn = pp->fec()->source_block_number;
+
+    if (!has_upcoming_packets_ || packet::blknum_lt(sbn, upcoming_sbn_)) {
+        upcoming_sbn_ = sbn;
+    }
+
+    has_upcoming_packets_ = true;
 }
 
 packet::PacketPtr Reader::parse_repaired_packet_(const core::Slice<uint8_t>& buffer) {
@@ -259,6 +547,9 @@ void Reader::fetch_packets_() {
             if (!validate_fec_packet_(pp)) {
                 return;
             }
+            if (early_repair_) {
+                note_upcoming_packet_(pp);
+            }
             source_queue_.write(pp);
         } else {
             break;
@@ -270,6 +561,9 @@ void Reader::fetch_packets_() {
             if (!validate_fec_packet_(pp)) {
                 return;
             }
+            if (early_repair_) {
+                note_upcoming_packet_(pp);
+            }
             repair_queue_.write(pp);
         } else {
             break;
@@ -280,6 +574,11 @@ void Reader::fetch_packets_() {
 void Reader::fill_block_() {
     fill_source_block_();
     fill_repair_block_();
+
+    if (early_repair_) {
+        try_repair_early_();
+        repair_upcoming_blocks_();
+    }
 }
 
 void Reader::fill_source_block_() {
@@ -348,7 +647,7 @@ void Reader::fill_source_block_() {
 }
 
 void Reader::fill_repair_block_() {
-    unsigned n_fetched = 0, n_added = 0, n_dropped = 0;
+    unsigned n_fetched = 0, n_added = 0, n_dropped = 0, n_released = 0;
 
     for (;;) {
         packet::PacketPtr pp = repair_queue_.head();
@@ -398,6 +697,12 @@ void Reader::fill_repair_block_() {
         roc_panic_if_not(fec.encoding_symbol_id
                          < source_block_.size() + repair_block_.size());
 
+        if (repair_released_) {
+            // all source packets of the block are already in place
+            n_released++;
+            continue;
+        }
+
         const size_t p_num = fec.encoding_symbol_id - fec.source_block_length;
 
         if (!repair_block_[p_num]) {
@@ -407,7 +712,7 @@ void Reader::fill_repair_block_() {
         }
     }
 
-    if (n_dropped != 0 || n_fetched != n_added) {
+    if (n_dropped != 0 || n_fetched != n_added + n_released) {
         roc_log(LogDebug, "fec reader: repair queue: fetched=%u added=%u dropped=%u",
                 n_fetched, n_added, n_dropped);
     }
@@ -31,8 +31,23 @@ struct ReaderConfig {
     //! Maximum allowed source block number jump.
     size_t max_sbn_jump;
 
+    //! Repair packets as soon as possible.
+    //! @remarks
+    //!  If enabled, reader tries to repair lost packets as soon as the block
+    //!  has enough source and repair packets, instead of waiting until it
+    //!  reaches the lost packet. This applies both to the block being read
+    //!  and to the following blocks waiting in the queues; packets restored
+    //!  in the following blocks are put back to the source queue. Repair
+    //!  packets of blocks that don't need repairing anymore are released
+    //!  immediately.
+    //! @note
+    //!  Every read that brings new packets walks through the queued packets,
+    //!  so the cost grows with the receiver latency.
+    bool early_repair;
+
     ReaderConfig()
-        : max_sbn_jump(100) {
+        : max_sbn_jump(100)
+        , early_repair(false) {
     }
 };
 
@@ -66,6 +81,9 @@ public:
     //! Is decoder alive?
     bool alive() const;
 
+    //! Get number of source packets restored from repair packets.
+    size_t num_restored() const;
+
     //! Read packet.
     //! @remarks
     //!  When a packet loss is detected, try to restore it from repair packets.
@@ -79,6 +97,16 @@ private:
 
     void next_block_();
     void try_repair_();
+    void try_repair_early_();
+    void release_repair_block_();
+    bool decode_block_(core::Array<packet::PacketPtr>& source_block,
+                       const core::Array<packet::PacketPtr>& repair_block,
+                       size_t payload_size);
+
+    void repair_upcoming_blocks_();
+    void repair_upcoming_block_(packet::blknum_t sbn, bool has_new_packets);
+    bool update_upcoming_block_(const packet::FEC& fec, bool is_repair);
+    void note_upcoming_packet_(const packet::PacketPtr&);
 
     packet::PacketPtr parse_repaired_packet_(const core::Slice<uint8_t>& buffer);
 
@@ -120,11 +148,22 @@ private:
     core::Array<packet::PacketPtr> source_block_;
     core::Array<packet::PacketPtr> repair_block_;
 
+    packet::SortedQueue upcoming_source_queue_;
+    packet::SortedQueue upcoming_repair_queue_;
+
+    core::Array<packet::PacketPtr> upcoming_source_block_;
+    core::Array<packet::PacketPtr> upcoming_repair_block_;
+    size_t upcoming_payload_size_;
+
+    bool has_upcoming_packets_;
+    packet::blknum_t upcoming_sbn_;
+
     bool valid_;
 
     bool alive_;
     bool started_;
     bool can_repair_;
+    bool repair_released_;
 
     size_t next_packet_;
     packet::blknum_t cur_sbn_;
@@ -136,8 +175,10 @@ private:
     bool payload_resized_;
 
     unsigned n_packets_;
+    size_t n_restored_;
 
     const size_t max_sbn_jump_;
+    const bool early_repair_;
     const packet::FECScheme fec_scheme_;
 };
 
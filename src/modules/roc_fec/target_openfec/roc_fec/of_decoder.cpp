@@ -94,8 +94,9 @@ bool OFDecoder::begin(size_t sblen, size_t rblen, size_t payload_size) {
     payload_size_ = payload_size;
     max_index_ = 0;
 
+    // session is created lazily, when a lost packet is requested for the first
+    // time; blocks without losses never pay for session creation
     update_session_params_(sblen, rblen, payload_size);
-    reset_session_();
 
     return true;
 }
@@ -127,18 +128,16 @@ void OFDecoder::set(size_t index, const core::Slice<uint8_t>& buffer) {
     data_tab_[index] = buffer.data();
     recv_tab_[index] = true;
 
-    // register new packet and try to repair more packets
-    roc_log(LogTrace, "of decoder: of_decode_with_new_symbol(): index=%lu",
-            (unsigned long)index);
-
-    if (of_decode_with_new_symbol(of_sess_, data_tab_[index], (unsigned int)index)
-        != OF_STATUS_OK) {
-        roc_panic("of decoder: can't add packet to OF session");
-    }
-
     if (max_index_ < index) {
         max_index_ = index;
     }
+
+    if (of_sess_ == NULL) {
+        // packet will be passed to session when it is created
+        return;
+    }
+
+    decode_with_new_symbol_(index);
 }
 
 core::Slice<uint8_t> OFDecoder::repair(size_t index) {
@@ -153,8 +152,11 @@ core::Slice<uint8_t> OFDecoder::repair(size_t index) {
 }
 
 void OFDecoder::end() {
-    if (of_sess_ != NULL) {
+    if (buff_tab_.size() != 0) {
         report_();
+    }
+
+    if (of_sess_ != NULL) {
         destroy_session_();
     }
 
@@ -196,14 +198,16 @@ bool OFDecoder::resize_tabs_(size_t size) {
 }
 
 void OFDecoder::update_() {
-    roc_panic_if(of_sess_ == NULL);
-
     if (!has_new_packets_) {
         return;
     }
 
     decode_();
 
+    if (of_sess_ == NULL) {
+        return;
+    }
+
     roc_log(LogTrace, "of decoder: of_get_source_symbols_tab()");
 
     of_get_source_symbols_tab(of_sess_, &data_tab_[0]);
@@ -216,12 +220,27 @@ void OFDecoder::decode_() {
         return;
     }
 
+    if (of_sess_ == NULL && !is_optimal_()) {
+        // non-optimal codecs may iteratively repair some packets even if there
+        // are less than sblen packets, so the session is created right away and
+        // all packets received so far are fed one by one, as if they were passed
+        // to the session from set()
+        reset_session_();
+
+        for (size_t i = 0; i < data_tab_.size(); i++) {
+            if (recv_tab_[i]) {
+                decode_with_new_symbol_(i);
+            }
+        }
+    }
+
     if (!has_n_packets_(sblen_)) {
         return;
     }
 
-    if (decoding_finished_) {
-        // it's not allowed to decode twice, so we recreate the session
+    if (of_sess_ == NULL || decoding_finished_) {
+        // session is created on first decoding attempt; it's also not allowed
+        // to decode twice, so in this case we recreate the session
         reset_session_();
 
         roc_log(LogTrace, "of decoder: of_set_available_symbols()");
@@ -242,6 +261,17 @@ void OFDecoder::decode_() {
     decoding_finished_ = true;
 }
 
+void OFDecoder::decode_with_new_symbol_(size_t index) {
+    // register new packet and try to repair more packets
+    roc_log(LogTrace, "of decoder: of_decode_with_new_symbol(): index=%lu",
+            (unsigned long)index);
+
+    if (of_decode_with_new_symbol(of_sess_, data_tab_[index], (unsigned int)index)
+        != OF_STATUS_OK) {
+        roc_panic("of decoder: can't add packet to OF session");
+    }
+}
+
 // note: we have to calculate this every time because OpenFEC
 // doesn't always report to us when it repairs a packet
 bool OFDecoder::has_n_packets_(size_t n_packets) const {
@@ -80,6 +80,7 @@ private:
 
     void update_();
     void decode_();
+    void decode_with_new_symbol_(size_t index);
 
     bool has_n_packets_(size_t n_packets) const;
     bool is_optimal_() const;
@@ -106,7 +107,10 @@ private:
         of_ldpc_parameters ldpc_params_;
     } codec_params_;
 
-    // session is recreated for every new block
+    // session is recreated for every block that needs decoding
+    // and is not created at all for blocks without losses;
+    // for LDPC, it's created on the first repair request and then
+    // receives every new packet, to repair packets iteratively
     of_session_t* of_sess_;
     of_parameters_t* of_sess_params_;
 
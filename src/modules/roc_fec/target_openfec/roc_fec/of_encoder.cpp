@@ -20,6 +20,7 @@ OFEncoder::OFEncoder(const CodecConfig& config,
     , rblen_(0)
     , payload_size_(0)
     , of_sess_(NULL)
+    , use_counter_(0)
     , buff_tab_(allocator)
     , data_tab_(allocator)
     , valid_(false) {
@@ -54,8 +55,10 @@ OFEncoder::OFEncoder(const CodecConfig& config,
 }
 
 OFEncoder::~OFEncoder() {
-    if (of_sess_) {
-        of_release_codec_instance(of_sess_);
+    for (size_t n = 0; n < MaxSessions; n++) {
+        if (sessions_[n].of_sess) {
+            of_release_codec_instance(sessions_[n].of_sess);
+        }
     }
 }
 
@@ -88,8 +91,7 @@ bool OFEncoder::begin(size_t sblen, size_t rblen, size_t payload_size) {
     rblen_ = rblen;
     payload_size_ = payload_size;
 
-    update_session_params_(sblen, rblen, payload_size);
-    reset_session_();
+    of_sess_ = get_session_(sblen, rblen, payload_size);
 
     return true;
 }
@@ -161,21 +163,60 @@ void OFEncoder::update_session_params_(size_t sblen, size_t rblen, size_t payloa
     of_sess_params_->encoding_symbol_length = (uint32_t)payload_size;
 }
 
-void OFEncoder::reset_session_() {
-    if (of_sess_ != NULL) {
+of_session_t*
+OFEncoder::get_session_(size_t sblen, size_t rblen, size_t payload_size) {
+    use_counter_++;
+
+    Session* victim = &sessions_[0];
+
+    for (size_t n = 0; n < MaxSessions; n++) {
+        Session& sess = sessions_[n];
+
+        if (sess.of_sess && sess.sblen == sblen && sess.rblen == rblen
+            && sess.payload_size == payload_size) {
+            roc_log(LogTrace,
+                    "of encoder: reusing session: nb_src=%lu nb_rpr=%lu symbol_len=%lu",
+                    (unsigned long)sblen, (unsigned long)rblen,
+                    (unsigned long)payload_size);
+
+            sess.last_use = use_counter_;
+            return sess.of_sess;
+        }
+
+        // prefer empty slot, otherwise evict least recently used session
+        if (victim->of_sess && (!sess.of_sess || sess.last_use < victim->last_use)) {
+            victim = &sess;
+        }
+    }
+
+    if (victim->of_sess) {
         roc_log(LogTrace, "of encoder: of_release_codec_instance()");
 
-        of_release_codec_instance(of_sess_);
-        of_sess_ = NULL;
+        of_release_codec_instance(victim->of_sess);
+        victim->of_sess = NULL;
     }
 
+    update_session_params_(sblen, rblen, payload_size);
+
+    victim->of_sess = create_session_();
+    victim->sblen = sblen;
+    victim->rblen = rblen;
+    victim->payload_size = payload_size;
+    victim->last_use = use_counter_;
+
+    return victim->of_sess;
+}
+
+of_session_t* OFEncoder::create_session_() {
+    of_session_t* of_sess = NULL;
+
     roc_log(LogTrace, "of encoder: of_create_codec_instance()");
 
-    if (OF_STATUS_OK != of_create_codec_instance(&of_sess_, codec_id_, OF_ENCODER, 0)) {
+    if (OF_STATUS_OK != of_create_codec_instance(&of_sess, codec_id_, OF_ENCODER, 0)) {
         roc_panic("of encoder: of_create_codec_instance() failed");
     }
 
-    roc_panic_if(of_sess_ == NULL);
+    roc_panic_if(of_sess == NULL);
 
     roc_log(LogTrace,
             "of encoder: of_set_fec_parameters(): nb_src=%lu nb_rpr=%lu symbol_len=%lu",
@@ -183,9 +224,11 @@ void OFEncoder::reset_session_() {
             (unsigned long)of_sess_params_->nb_repair_symbols,
             (unsigned long)of_sess_params_->encoding_symbol_length);
 
-    if (OF_STATUS_OK != of_set_fec_parameters(of_sess_, of_sess_params_)) {
+    if (OF_STATUS_OK != of_set_fec_parameters(of_sess, of_sess_params_)) {
         roc_panic("of encoder: of_set_fec_parameters() failed");
     }
+
+    return of_sess;
 }
 
 } // namespace fec
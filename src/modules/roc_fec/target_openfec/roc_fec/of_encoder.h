@@ -77,19 +77,49 @@ public:
 
 private:
     bool resize_tabs_(size_t size);
-    void reset_session_();
+    of_session_t* get_session_(size_t sblen, size_t rblen, size_t payload_size);
+    of_session_t* create_session_();
     void update_session_params_(size_t sblen, size_t rblen, size_t payload_size);
 
     enum { Alignment = 8 };
 
+    // number of sessions with different block geometry kept alive at the same time
+    enum { MaxSessions = 4 };
+
+    // OpenFEC session prepared for particular block geometry
+    struct Session {
+        of_session_t* of_sess;
+
+        size_t sblen;
+        size_t rblen;
+        size_t payload_size;
+
+        // value of use_counter_ when session was used last time
+        unsigned long last_use;
+
+        Session()
+            : of_sess(NULL)
+            , sblen(0)
+            , rblen(0)
+            , payload_size(0)
+            , last_use(0) {
+        }
+    };
+
     size_t sblen_;
     size_t rblen_;
 
     size_t payload_size_;
 
+    // session for current block, points to one of sessions_
     of_session_t* of_sess_;
     of_parameters_t* of_sess_params_;
 
+    // sessions are reused by blocks with the same geometry; creating a session
+    // is expensive, e.g. for LDPC it generates the parity check matrix
+    Session sessions_[MaxSessions];
+    unsigned long use_counter_;
+
     of_codec_id_t codec_id_;
     union {
         of_ldpc_parameters ldpc_params_;
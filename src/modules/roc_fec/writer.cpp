@@ -10,6 +10,7 @@
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/random.h"
+#include "roc_core/trace.h"
 #include "roc_packet/fec_scheme_to_str.h"
 
 namespace roc {
@@ -57,6 +58,14 @@ bool Writer::alive() const {
     return alive_;
 }
 
+size_t Writer::source_block_size() const {
+    return cur_sblen_;
+}
+
+size_t Writer::repair_block_size() const {
+    return cur_rblen_;
+}
+
 bool Writer::resize(size_t sblen, size_t rblen) {
     if (next_sblen_ == sblen && next_rblen_ == rblen) {
         return true;
@@ -92,6 +101,8 @@ bool Writer::resize(size_t sblen, size_t rblen) {
 }
 
 void Writer::write(const packet::PacketPtr& pp) {
+    roc_trace_scope("fec_writer.write");
+
     roc_panic_if_not(valid());
     roc_panic_if_not(pp);
 
@@ -214,7 +225,7 @@ packet::PacketPtr Writer::make_repair_packet_(packet::seqnum_t pack_n) {
         return NULL;
     }
 
-    core::Slice<uint8_t> data = new (buffer_pool_) core::Buffer<uint8_t>(buffer_pool_);
+    core::Slice<uint8_t> data = packet->alloc_buffer(buffer_pool_);
     if (!data) {
         roc_log(LogError, "fec writer: can't allocate buffer");
         return NULL;
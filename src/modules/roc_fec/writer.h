@@ -73,6 +73,12 @@ public:
     //! Set number of source packets per block.
     bool resize(size_t sblen, size_t rblen);
 
+    //! Get number of source packets in current block.
+    size_t source_block_size() const;
+
+    //! Get number of repair packets in current block.
+    size_t repair_block_size() const;
+
     //! Write packet.
     //! @remarks
     //!  - writes the given source packet to the output writer
@@ -7,6 +7,8 @@
  */
 
 #include "roc_netio/basic_port.h"
+#include "roc_core/log.h"
+#include "roc_packet/address_to_str.h"
 
 namespace roc {
 namespace netio {
@@ -18,6 +20,12 @@ BasicPort::BasicPort(core::IAllocator& allocator)
 BasicPort::~BasicPort() {
 }
 
+bool BasicPort::start_receiving(packet::IWriter&) {
+    roc_log(LogError, "port: can't start receiving on port %s: not supported",
+            packet::address_to_str(address()).c_str());
+    return false;
+}
+
 void BasicPort::destroy() {
     allocator_.destroy(*this);
 }
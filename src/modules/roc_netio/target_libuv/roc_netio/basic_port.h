@@ -13,13 +13,33 @@
 #define ROC_NETIO_BASIC_PORT_H_
 
 #include "roc_core/iallocator.h"
+#include "roc_core/stddefs.h"
 #include "roc_core/list_node.h"
 #include "roc_core/refcnt.h"
 #include "roc_packet/address.h"
+#include "roc_packet/iwriter.h"
 
 namespace roc {
 namespace netio {
 
+//! Port statistics.
+struct PortStats {
+    //! Number of packets received or sent.
+    size_t packets;
+
+    //! Number of bytes received or sent.
+    size_t bytes;
+
+    //! Number of packets that were dropped because of errors.
+    size_t errors;
+
+    PortStats()
+        : packets(0)
+        , bytes(0)
+        , errors(0) {
+    }
+};
+
 //! Basic port interface.
 class BasicPort : public core::RefCnt<BasicPort>, public core::ListNode {
 public:
@@ -32,6 +52,12 @@ public:
     //! Get bind address.
     virtual const packet::Address& address() const = 0;
 
+    //! Get port statistics.
+    //!
+    //! @remarks
+    //!  May be called from any thread.
+    virtual PortStats stats() const = 0;
+
     //! Open port.
     //!
     //! @remarks
@@ -44,6 +70,15 @@ public:
     //!  Should be called from the event loop thread.
     virtual void async_close() = 0;
 
+    //! Start passing incoming datagrams to @p writer.
+    //!
+    //! @remarks
+    //!  Should be called from the event loop thread.
+    //!
+    //! @returns
+    //!  false if the port can't receive datagrams.
+    virtual bool start_receiving(packet::IWriter& writer);
+
 private:
     friend class core::RefCnt<BasicPort>;
 
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_libuv/roc_netio/config.h
+//! @brief Network I/O config.
+
+#ifndef ROC_NETIO_CONFIG_H_
+#define ROC_NETIO_CONFIG_H_
+
+#include "roc_core/stddefs.h"
+#include "roc_core/thread_params.h"
+
+namespace roc {
+namespace netio {
+
+//! Transceiver config.
+struct TransceiverConfig {
+    //! Socket receive buffer size (SO_RCVBUF), in bytes.
+    //! @remarks
+    //!  Applied to receiver ports. If zero, the OS default is used.
+    size_t recv_buffer_size;
+
+    //! Socket send buffer size (SO_SNDBUF), in bytes.
+    //! @remarks
+    //!  Applied to sender ports. If zero, the OS default is used.
+    size_t send_buffer_size;
+
+    //! Number of event loops.
+    //! @remarks
+    //!  Every loop runs in its own thread. New ports are assigned to loops
+    //!  round-robin. If zero, one loop is used.
+    size_t num_loops;
+
+    //! Bind every receiver port in all event loops.
+    //! @remarks
+    //!  If enabled and there are several loops, every unicast receiver port is
+    //!  bound in every loop with SO_REUSEPORT, and the kernel distributes
+    //!  incoming flows between the sockets by hash of source and destination
+    //!  addresses. Packets of a single flow are always handled by one loop.
+    bool reuse_port;
+
+    //! Network thread parameters.
+    //! @remarks
+    //!  Scheduling policy, priority, and CPU affinity of event loop threads.
+    //!  If name is empty, "roc-netio" is used, followed by loop index if there
+    //!  are several loops.
+    core::ThreadParams thread_params;
+
+    TransceiverConfig()
+        : recv_buffer_size(0)
+        , send_buffer_size(0)
+        , num_loops(1)
+        , reuse_port(false) {
+    }
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_CONFIG_H_
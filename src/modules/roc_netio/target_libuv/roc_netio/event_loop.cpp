@@ -0,0 +1,431 @@
+/*
+ * Copyright (c) 2015 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_netio/event_loop.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_packet/address_to_str.h"
+
+namespace roc {
+namespace netio {
+
+EventLoop::EventLoop(const TransceiverConfig& config,
+                     packet::PacketPool& packet_pool,
+                     core::BufferPool<uint8_t>& buffer_pool,
+                     core::IAllocator& allocator)
+    : config_(config)
+    , packet_pool_(packet_pool)
+    , buffer_pool_(buffer_pool)
+    , allocator_(allocator)
+    , started_(false)
+    , loop_initialized_(false)
+    , stop_sem_initialized_(false)
+    , task_sem_initialized_(false)
+    , cond_(mutex_) {
+    if (int err = uv_loop_init(&loop_)) {
+        roc_log(LogError, "event loop: uv_loop_init(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return;
+    }
+    loop_initialized_ = true;
+
+    if (int err = uv_async_init(&loop_, &stop_sem_, stop_sem_cb_)) {
+        roc_log(LogError, "event loop: uv_async_init(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return;
+    }
+    stop_sem_.data = this;
+    stop_sem_initialized_ = true;
+
+    if (int err = uv_async_init(&loop_, &task_sem_, task_sem_cb_)) {
+        roc_log(LogError, "event loop: uv_async_init(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return;
+    }
+    task_sem_.data = this;
+    task_sem_initialized_ = true;
+
+    Thread::set_params(config.thread_params);
+
+    started_ = Thread::start();
+}
+
+EventLoop::~EventLoop() {
+    if (started_) {
+        if (int err = uv_async_send(&stop_sem_)) {
+            roc_panic("event loop: uv_async_send(): [%s] %s", uv_err_name(err),
+                      uv_strerror(err));
+        }
+    } else {
+        close_sems_();
+    }
+
+    if (loop_initialized_) {
+        if (started_) {
+            Thread::join();
+        } else {
+            // If the thread was never started we should manually run the loop to
+            // wait all opened handles to be closed. Otherwise, uv_loop_close()
+            // will fail with EBUSY.
+            EventLoop::run(); // non-virtual call from dtor
+        }
+
+        if (int err = uv_loop_close(&loop_)) {
+            roc_panic("event loop: uv_loop_close(): [%s] %s", uv_err_name(err),
+                      uv_strerror(err));
+        }
+    }
+
+    roc_panic_if(joinable());
+    roc_panic_if(open_ports_.size());
+    roc_panic_if(closing_ports_.size());
+    roc_panic_if(task_sem_initialized_);
+    roc_panic_if(stop_sem_initialized_);
+}
+
+bool EventLoop::valid() const {
+    return started_;
+}
+
+size_t EventLoop::num_ports() const {
+    core::Mutex::Lock lock(mutex_);
+
+    return open_ports_.size();
+}
+
+bool EventLoop::get_port_stats(const packet::Address& bind_address,
+                               PortStats& stats) const {
+    core::Mutex::Lock lock(mutex_);
+
+    core::SharedPtr<BasicPort> port;
+
+    for (port = open_ports_.front(); port; port = open_ports_.nextof(*port)) {
+        if (port->address() == bind_address) {
+            stats = port->stats();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool EventLoop::has_port(const packet::Address& bind_address) const {
+    core::Mutex::Lock lock(mutex_);
+
+    core::SharedPtr<BasicPort> port;
+
+    for (port = open_ports_.front(); port; port = open_ports_.nextof(*port)) {
+        if (port->address() == bind_address) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool EventLoop::add_udp_receiver(packet::Address& bind_address,
+                                 packet::IWriter& writer,
+                                 bool reuse_port) {
+    if (!valid()) {
+        roc_panic("event loop: can't use invalid event loop");
+    }
+
+    Task task;
+    task.fn = &EventLoop::add_udp_receiver_;
+    task.address = &bind_address;
+    task.writer = &writer;
+    task.reuse_port = reuse_port;
+
+    run_task_(task);
+
+    if (!task.result) {
+        if (task.port) {
+            wait_port_closed_(*task.port);
+        }
+    }
+
+    return task.result;
+}
+
+packet::IWriter* EventLoop::add_udp_sender(packet::Address& bind_address) {
+    if (!valid()) {
+        roc_panic("event loop: can't use invalid event loop");
+    }
+
+    Task task;
+    task.fn = &EventLoop::add_udp_sender_;
+    task.address = &bind_address;
+    task.writer = NULL;
+
+    run_task_(task);
+
+    if (!task.result) {
+        if (task.port) {
+            wait_port_closed_(*task.port);
+        }
+    }
+
+    return task.writer;
+}
+
+bool EventLoop::start_receiving(packet::Address bind_address, packet::IWriter& writer) {
+    if (!valid()) {
+        roc_panic("event loop: can't use invalid event loop");
+    }
+
+    Task task;
+    task.fn = &EventLoop::start_receiving_;
+    task.address = &bind_address;
+    task.writer = &writer;
+
+    run_task_(task);
+
+    return task.result;
+}
+
+void EventLoop::remove_port(packet::Address bind_address) {
+    if (!valid()) {
+        roc_panic("event loop: can't use invalid event loop");
+    }
+
+    Task task;
+    task.fn = &EventLoop::remove_port_;
+    task.address = &bind_address;
+    task.writer = NULL;
+
+    run_task_(task);
+
+    if (!task.result) {
+        roc_panic("event loop: can't remove port %s: unknown port",
+                  packet::address_to_str(bind_address).c_str());
+    } else {
+        roc_panic_if_not(task.port);
+        wait_port_closed_(*task.port);
+    }
+}
+
+void EventLoop::handle_closed(BasicPort& port) {
+    core::Mutex::Lock lock(mutex_);
+
+    for (core::SharedPtr<BasicPort> pp = closing_ports_.front(); pp;
+         pp = closing_ports_.nextof(*pp)) {
+        if (pp.get() != &port) {
+            continue;
+        }
+
+        roc_log(LogDebug, "event loop: asynchronous close finished: port %s",
+                packet::address_to_str(port.address()).c_str());
+
+        closing_ports_.remove(*pp);
+        cond_.broadcast();
+
+        break;
+    }
+}
+
+void EventLoop::run() {
+    roc_log(LogDebug, "event loop: starting event loop");
+
+    int err = uv_run(&loop_, UV_RUN_DEFAULT);
+    if (err != 0) {
+        roc_log(LogInfo, "event loop: uv_run() returned non-zero");
+    }
+
+    roc_log(LogDebug, "event loop: finishing event loop");
+}
+
+void EventLoop::task_sem_cb_(uv_async_t* handle) {
+    roc_panic_if_not(handle);
+
+    EventLoop& self = *(EventLoop*)handle->data;
+    self.process_tasks_();
+}
+
+void EventLoop::stop_sem_cb_(uv_async_t* handle) {
+    roc_panic_if_not(handle);
+
+    EventLoop& self = *(EventLoop*)handle->data;
+    self.async_close_ports_();
+    self.close_sems_();
+    self.process_tasks_();
+}
+
+void EventLoop::async_close_ports_() {
+    core::Mutex::Lock lock(mutex_);
+
+    while (core::SharedPtr<BasicPort> port = open_ports_.front()) {
+        open_ports_.remove(*port);
+        closing_ports_.push_back(*port);
+
+        port->async_close();
+    }
+}
+
+void EventLoop::close_sems_() {
+    if (task_sem_initialized_) {
+        uv_close((uv_handle_t*)&task_sem_, NULL);
+        task_sem_initialized_ = false;
+    }
+
+    if (stop_sem_initialized_) {
+        uv_close((uv_handle_t*)&stop_sem_, NULL);
+        stop_sem_initialized_ = false;
+    }
+}
+
+void EventLoop::run_task_(Task& task) {
+    core::Mutex::Lock lock(mutex_);
+
+    tasks_.push_back(task);
+
+    if (int err = uv_async_send(&task_sem_)) {
+        roc_panic("event loop: uv_async_send(): [%s] %s", uv_err_name(err),
+                  uv_strerror(err));
+    }
+
+    while (!task.done) {
+        cond_.wait();
+    }
+}
+
+void EventLoop::process_tasks_() {
+    core::Mutex::Lock lock(mutex_);
+
+    while (Task* task = tasks_.front()) {
+        tasks_.remove(*task);
+
+        task->result = (this->*(task->fn))(*task);
+        task->done = true;
+    }
+
+    cond_.broadcast();
+}
+
+bool EventLoop::add_udp_receiver_(Task& task) {
+    core::SharedPtr<BasicPort> rp =
+        new (allocator_) UDPReceiverPort(*this, *task.address, loop_, *task.writer,
+                                         config_.recv_buffer_size, task.reuse_port,
+                                         packet_pool_, buffer_pool_, allocator_);
+
+    if (!rp) {
+        roc_log(LogError, "event loop: can't add port %s: can't allocate receiver",
+                packet::address_to_str(*task.address).c_str());
+
+        return false;
+    }
+
+    task.port = rp.get();
+
+    if (!rp->open()) {
+        roc_log(LogError, "event loop: can't add port %s: can't start receiver",
+                packet::address_to_str(*task.address).c_str());
+
+        closing_ports_.push_back(*rp);
+        rp->async_close();
+
+        return false;
+    }
+
+    *task.address = rp->address();
+    open_ports_.push_back(*rp);
+
+    return true;
+}
+
+bool EventLoop::add_udp_sender_(Task& task) {
+    core::SharedPtr<UDPSenderPort> sp =
+        new (allocator_) UDPSenderPort(*this, *task.address, loop_,
+                                       config_.send_buffer_size, packet_pool_,
+                                       buffer_pool_, allocator_);
+    if (!sp) {
+        roc_log(LogError, "event loop: can't add port %s: can't allocate sender",
+                packet::address_to_str(*task.address).c_str());
+
+        return false;
+    }
+
+    task.port = sp.get();
+
+    if (!sp->open()) {
+        roc_log(LogError, "event loop: can't add port %s: can't start sender",
+                packet::address_to_str(*task.address).c_str());
+
+        closing_ports_.push_back(*sp);
+        sp->async_close();
+
+        return false;
+    }
+
+    task.writer = sp.get();
+    *task.address = sp->address();
+
+    open_ports_.push_back(*sp);
+
+    return true;
+}
+
+bool EventLoop::start_receiving_(Task& task) {
+    for (core::SharedPtr<BasicPort> port = open_ports_.front(); port;
+         port = open_ports_.nextof(*port)) {
+        if (port->address() == *task.address) {
+            return port->start_receiving(*task.writer);
+        }
+    }
+
+    roc_log(LogError, "event loop: can't start receiving on port %s: unknown port",
+            packet::address_to_str(*task.address).c_str());
+
+    return false;
+}
+
+bool EventLoop::remove_port_(Task& task) {
+    roc_log(LogDebug, "event loop: removing port %s",
+            packet::address_to_str(*task.address).c_str());
+
+    core::SharedPtr<BasicPort> curr = open_ports_.front();
+    while (curr) {
+        core::SharedPtr<BasicPort> next = open_ports_.nextof(*curr);
+
+        if (curr->address() == *task.address) {
+            open_ports_.remove(*curr);
+            closing_ports_.push_back(*curr);
+
+            task.port = curr.get();
+            curr->async_close();
+
+            return true;
+        }
+
+        curr = next;
+    }
+
+    return false;
+}
+
+void EventLoop::wait_port_closed_(const BasicPort& port) {
+    core::Mutex::Lock lock(mutex_);
+
+    while (port_is_closing_(port)) {
+        cond_.wait();
+    }
+}
+
+bool EventLoop::port_is_closing_(const BasicPort& port) {
+    for (core::SharedPtr<BasicPort> pp = closing_ports_.front(); pp;
+         pp = closing_ports_.nextof(*pp)) {
+        if (pp.get() == &port) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace netio
+} // namespace roc
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2015 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_libuv/roc_netio/event_loop.h
+//! @brief Network event loop.
+
+#ifndef ROC_NETIO_EVENT_LOOP_H_
+#define ROC_NETIO_EVENT_LOOP_H_
+
+#include <uv.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/cond.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/list.h"
+#include "roc_core/list_node.h"
+#include "roc_core/mutex.h"
+#include "roc_core/thread.h"
+#include "roc_netio/basic_port.h"
+#include "roc_netio/config.h"
+#include "roc_netio/iclose_handler.h"
+#include "roc_netio/udp_receiver_port.h"
+#include "roc_netio/udp_sender_port.h"
+#include "roc_packet/address.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet_pool.h"
+
+namespace roc {
+namespace netio {
+
+//! Network event loop.
+//!
+//! Runs libuv event loop in a separate thread and services UDP ports
+//! bound in this loop.
+class EventLoop : private ICloseHandler, private core::Thread {
+public:
+    //! Initialize.
+    //!
+    //! @remarks
+    //!  Start background thread if the object was successfully constructed.
+    EventLoop(const TransceiverConfig& config,
+              packet::PacketPool& packet_pool,
+              core::BufferPool<uint8_t>& buffer_pool,
+              core::IAllocator& allocator);
+
+    //! Destroy. Stop all receivers and senders.
+    //!
+    //! @remarks
+    //!  Wait until background thread finishes.
+    virtual ~EventLoop();
+
+    //! Check if event loop was successfully constructed.
+    bool valid() const;
+
+    //! Get number of receiver and sender ports.
+    size_t num_ports() const;
+
+    //! Add UDP datagram receiver port.
+    //!
+    //! Creates a new UDP receiver and bind it to @p bind_address. The receiver
+    //! will pass packets to @p writer. Writer will be called from the network
+    //! thread. It should not block.
+    //!
+    //! If IP is zero, INADDR_ANY is used, i.e. the socket is bound to all network
+    //! interfaces. If port is zero, a random free port is selected and written
+    //! back to @p bind_address.
+    //!
+    //! If IP is a multicast group, the receiver joins this group on the interface
+    //! specified by multicast interface of @p bind_address, or on the interface
+    //! selected by the OS if it's not set.
+    //!
+    //! If @p reuse_port is true, SO_REUSEPORT is enabled on the socket, so that
+    //! the same address may be bound in several event loops.
+    //!
+    //! @returns
+    //!  true on success or false if error occurred
+    bool add_udp_receiver(packet::Address& bind_address,
+                          packet::IWriter& writer,
+                          bool reuse_port);
+
+    //! Add UDP datagram sender port.
+    //!
+    //! Creates a new UDP sender, bind to @p bind_address, and returns a writer
+    //! that may be used to send packets from this address. Writer may be called
+    //! from any thread. It will not block the caller.
+    //!
+    //! If IP is zero, INADDR_ANY is used, i.e. the socket is bound to all network
+    //! interfaces. If port is zero, a random free port is selected and written
+    //! back to @p bind_address.
+    //!
+    //! Multicast interface, TTL and loopback options of @p bind_address are
+    //! applied to the socket and affect packets sent to multicast destinations.
+    //!
+    //! @returns
+    //!  a new packet writer on success or null if error occurred
+    packet::IWriter* add_udp_sender(packet::Address& bind_address);
+
+    //! Start receiving on UDP sender port.
+    //!
+    //! Makes the sender port bound to @p bind_address also pass datagrams sent
+    //! to this address to @p writer. Writer will be called from the network
+    //! thread. It should not block.
+    //!
+    //! @returns
+    //!  false if there is no such sender port or error occurred.
+    bool start_receiving(packet::Address bind_address, packet::IWriter& writer);
+
+    //! Check if there is an open port with given @p bind_address.
+    bool has_port(const packet::Address& bind_address) const;
+
+    //! Remove sender or receiver port. Wait until port will be removed.
+    void remove_port(packet::Address bind_address);
+
+    //! Get statistics of sender or receiver port.
+    //!
+    //! @returns
+    //!  false if there is no open port with given @p bind_address.
+    bool get_port_stats(const packet::Address& bind_address, PortStats& stats) const;
+
+private:
+    struct Task : core::ListNode {
+        bool (EventLoop::*fn)(Task&);
+
+        packet::Address* address;
+        packet::IWriter* writer;
+        BasicPort* port;
+
+        bool reuse_port;
+        bool result;
+        bool done;
+
+        Task()
+            : fn(NULL)
+            , address(NULL)
+            , writer(NULL)
+            , port(NULL)
+            , reuse_port(false)
+            , result(false)
+            , done(false) {
+        }
+    };
+
+    static void task_sem_cb_(uv_async_t* handle);
+    static void stop_sem_cb_(uv_async_t* handle);
+
+    virtual void handle_closed(BasicPort&);
+    virtual void run();
+
+    void close_sems_();
+    void async_close_ports_();
+
+    void process_tasks_();
+    void run_task_(Task&);
+
+    bool add_udp_receiver_(Task&);
+    bool add_udp_sender_(Task&);
+    bool start_receiving_(Task&);
+
+    bool remove_port_(Task&);
+    void wait_port_closed_(const BasicPort& port);
+    bool port_is_closing_(const BasicPort& port);
+
+    const TransceiverConfig config_;
+
+    packet::PacketPool& packet_pool_;
+    core::BufferPool<uint8_t>& buffer_pool_;
+    core::IAllocator& allocator_;
+
+    bool started_;
+
+    uv_loop_t loop_;
+    bool loop_initialized_;
+
+    uv_async_t stop_sem_;
+    bool stop_sem_initialized_;
+
+    uv_async_t task_sem_;
+    bool task_sem_initialized_;
+
+    core::List<Task, core::NoOwnership> tasks_;
+
+    core::List<BasicPort> open_ports_;
+    core::List<BasicPort> closing_ports_;
+
+    core::Mutex mutex_;
+    core::Cond cond_;
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_EVENT_LOOP_H_
@@ -6,93 +6,86 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <stdio.h>
+
 #include "roc_netio/transceiver.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
-#include "roc_core/shared_ptr.h"
 #include "roc_packet/address_to_str.h"
 
 namespace roc {
 namespace netio {
 
-Transceiver::Transceiver(packet::PacketPool& packet_pool,
+Transceiver::Transceiver(const TransceiverConfig& config,
+                         packet::PacketPool& packet_pool,
                          core::BufferPool<uint8_t>& buffer_pool,
                          core::IAllocator& allocator)
-    : packet_pool_(packet_pool)
-    , buffer_pool_(buffer_pool)
-    , allocator_(allocator)
-    , started_(false)
-    , loop_initialized_(false)
-    , stop_sem_initialized_(false)
-    , task_sem_initialized_(false)
-    , cond_(mutex_) {
-    if (int err = uv_loop_init(&loop_)) {
-        roc_log(LogError, "transceiver: uv_loop_init(): [%s] %s", uv_err_name(err),
-                uv_strerror(err));
+    : allocator_(allocator)
+    , n_loops_(0)
+    , next_loop_idx_(0)
+    , n_ports_(0)
+    , reuse_port_(config.reuse_port)
+    , valid_(false) {
+    const size_t num_loops = config.num_loops != 0 ? config.num_loops : 1;
+
+    if (num_loops > MaxLoops) {
+        roc_log(LogError, "transceiver: too many event loops: requested=%lu max=%lu",
+                (unsigned long)num_loops, (unsigned long)MaxLoops);
         return;
     }
-    loop_initialized_ = true;
 
-    if (int err = uv_async_init(&loop_, &stop_sem_, stop_sem_cb_)) {
-        roc_log(LogError, "transceiver: uv_async_init(): [%s] %s", uv_err_name(err),
-                uv_strerror(err));
-        return;
-    }
-    stop_sem_.data = this;
-    stop_sem_initialized_ = true;
+    for (size_t n = 0; n < num_loops; n++) {
+        TransceiverConfig loop_config = config;
 
-    if (int err = uv_async_init(&loop_, &task_sem_, task_sem_cb_)) {
-        roc_log(LogError, "transceiver: uv_async_init(): [%s] %s", uv_err_name(err),
-                uv_strerror(err));
-        return;
-    }
-    task_sem_.data = this;
-    task_sem_initialized_ = true;
-
-    started_ = Thread::start();
-}
-
-Transceiver::~Transceiver() {
-    if (started_) {
-        if (int err = uv_async_send(&stop_sem_)) {
-            roc_panic("transceiver: uv_async_send(): [%s] %s", uv_err_name(err),
-                      uv_strerror(err));
+        if (!loop_config.thread_params.name[0]) {
+            char name[core::ThreadParams::MaxNameLen] = {};
+            if (num_loops == 1) {
+                snprintf(name, sizeof(name), "roc-netio");
+            } else {
+                snprintf(name, sizeof(name), "roc-netio-%lu", (unsigned long)n);
+            }
+            loop_config.thread_params.set_name(name);
         }
-    } else {
-        close_sems_();
-    }
 
-    if (loop_initialized_) {
-        if (started_) {
-            Thread::join();
-        } else {
-            // If the thread was never started we should manually run the loop to
-            // wait all opened handles to be closed. Otherwise, uv_loop_close()
-            // will fail with EBUSY.
-            Transceiver::run(); // non-virtual call from dtor
+        EventLoop* loop =
+            new (allocator_) EventLoop(loop_config, packet_pool, buffer_pool, allocator_);
+        if (!loop) {
+            roc_log(LogError, "transceiver: can't allocate event loop");
+            return;
         }
 
-        if (int err = uv_loop_close(&loop_)) {
-            roc_panic("transceiver: uv_loop_close(): [%s] %s", uv_err_name(err),
-                      uv_strerror(err));
+        loops_[n_loops_++] = loop;
+
+        if (!loop->valid()) {
+            roc_log(LogError, "transceiver: can't start event loop");
+            return;
         }
     }
 
-    roc_panic_if(joinable());
-    roc_panic_if(open_ports_.size());
-    roc_panic_if(closing_ports_.size());
-    roc_panic_if(task_sem_initialized_);
-    roc_panic_if(stop_sem_initialized_);
+    roc_log(LogDebug, "transceiver: started %lu event loop(s): reuse_port=%d",
+            (unsigned long)n_loops_, (int)reuse_port_);
+
+    valid_ = true;
+}
+
+Transceiver::~Transceiver() {
+    while (n_loops_ > 0) {
+        allocator_.destroy(*loops_[--n_loops_]);
+    }
 }
 
 bool Transceiver::valid() const {
-    return started_;
+    return valid_;
+}
+
+size_t Transceiver::num_loops() const {
+    return n_loops_;
 }
 
 size_t Transceiver::num_ports() const {
     core::Mutex::Lock lock(mutex_);
 
-    return open_ports_.size();
+    return n_ports_;
 }
 
 bool Transceiver::add_udp_receiver(packet::Address& bind_address,
@@ -101,20 +94,20 @@ bool Transceiver::add_udp_receiver(packet::Address& bind_address,
         roc_panic("transceiver: can't use invalid transceiver");
     }
 
-    Task task;
-    task.fn = &Transceiver::add_udp_receiver_;
-    task.address = &bind_address;
-    task.writer = &writer;
+    core::Mutex::Lock lock(mutex_);
 
-    run_task_(task);
+    bool ok;
+    if (reuse_port_ && n_loops_ > 1 && !bind_address.multicast()) {
+        ok = add_shared_udp_receiver_(bind_address, writer);
+    } else {
+        ok = next_loop_().add_udp_receiver(bind_address, writer, false);
+    }
 
-    if (!task.result) {
-        if (task.port) {
-            wait_port_closed_(*task.port);
-        }
+    if (ok) {
+        n_ports_++;
     }
 
-    return task.result;
+    return ok;
 }
 
 packet::IWriter* Transceiver::add_udp_sender(packet::Address& bind_address) {
@@ -122,241 +115,120 @@ packet::IWriter* Transceiver::add_udp_sender(packet::Address& bind_address) {
         roc_panic("transceiver: can't use invalid transceiver");
     }
 
-    Task task;
-    task.fn = &Transceiver::add_udp_sender_;
-    task.address = &bind_address;
-    task.writer = NULL;
+    core::Mutex::Lock lock(mutex_);
 
-    run_task_(task);
+    packet::IWriter* writer = next_loop_().add_udp_sender(bind_address);
 
-    if (!task.result) {
-        if (task.port) {
-            wait_port_closed_(*task.port);
-        }
+    if (writer) {
+        n_ports_++;
     }
 
-    return task.writer;
+    return writer;
 }
 
-void Transceiver::remove_port(packet::Address bind_address) {
+bool Transceiver::start_receiving(const packet::Address& bind_address,
+                                  packet::IWriter& writer) {
     if (!valid()) {
         roc_panic("transceiver: can't use invalid transceiver");
     }
 
-    Task task;
-    task.fn = &Transceiver::remove_port_;
-    task.address = &bind_address;
-    task.writer = NULL;
-
-    run_task_(task);
-
-    if (!task.result) {
-        roc_panic("transceiver: can't remove port %s: unknown port",
-                  packet::address_to_str(bind_address).c_str());
-    } else {
-        roc_panic_if_not(task.port);
-        wait_port_closed_(*task.port);
-    }
-}
-
-void Transceiver::handle_closed(BasicPort& port) {
     core::Mutex::Lock lock(mutex_);
 
-    for (core::SharedPtr<BasicPort> pp = closing_ports_.front(); pp;
-         pp = closing_ports_.nextof(*pp)) {
-        if (pp.get() != &port) {
-            continue;
+    for (size_t n = 0; n < n_loops_; n++) {
+        if (loops_[n]->has_port(bind_address)) {
+            return loops_[n]->start_receiving(bind_address, writer);
         }
-
-        roc_log(LogDebug, "transceiver: asynchronous close finished: port %s",
-                packet::address_to_str(port.address()).c_str());
-
-        closing_ports_.remove(*pp);
-        cond_.broadcast();
-
-        break;
-    }
-}
-
-void Transceiver::run() {
-    roc_log(LogDebug, "transceiver: starting event loop");
-
-    int err = uv_run(&loop_, UV_RUN_DEFAULT);
-    if (err != 0) {
-        roc_log(LogInfo, "transceiver: uv_run() returned non-zero");
     }
 
-    roc_log(LogDebug, "transceiver: finishing event loop");
-}
-
-void Transceiver::task_sem_cb_(uv_async_t* handle) {
-    roc_panic_if_not(handle);
-
-    Transceiver& self = *(Transceiver*)handle->data;
-    self.process_tasks_();
-}
-
-void Transceiver::stop_sem_cb_(uv_async_t* handle) {
-    roc_panic_if_not(handle);
-
-    Transceiver& self = *(Transceiver*)handle->data;
-    self.async_close_ports_();
-    self.close_sems_();
-    self.process_tasks_();
-}
-
-void Transceiver::async_close_ports_() {
-    core::Mutex::Lock lock(mutex_);
-
-    while (core::SharedPtr<BasicPort> port = open_ports_.front()) {
-        open_ports_.remove(*port);
-        closing_ports_.push_back(*port);
+    roc_log(LogError, "transceiver: can't start receiving on port %s: unknown port",
+            packet::address_to_str(bind_address).c_str());
 
-        port->async_close();
-    }
+    return false;
 }
 
-void Transceiver::close_sems_() {
-    if (task_sem_initialized_) {
-        uv_close((uv_handle_t*)&task_sem_, NULL);
-        task_sem_initialized_ = false;
+void Transceiver::remove_port(packet::Address bind_address) {
+    if (!valid()) {
+        roc_panic("transceiver: can't use invalid transceiver");
     }
 
-    if (stop_sem_initialized_) {
-        uv_close((uv_handle_t*)&stop_sem_, NULL);
-        stop_sem_initialized_ = false;
-    }
-}
-
-void Transceiver::run_task_(Task& task) {
     core::Mutex::Lock lock(mutex_);
 
-    tasks_.push_back(task);
+    bool found = false;
 
-    if (int err = uv_async_send(&task_sem_)) {
-        roc_panic("transceiver: uv_async_send(): [%s] %s", uv_err_name(err),
-                  uv_strerror(err));
+    for (size_t n = 0; n < n_loops_; n++) {
+        if (loops_[n]->has_port(bind_address)) {
+            loops_[n]->remove_port(bind_address);
+            found = true;
+        }
     }
 
-    while (!task.done) {
-        cond_.wait();
+    if (!found) {
+        roc_panic("transceiver: can't remove port %s: unknown port",
+                  packet::address_to_str(bind_address).c_str());
     }
+
+    n_ports_--;
 }
 
-void Transceiver::process_tasks_() {
+bool Transceiver::get_port_stats(const packet::Address& bind_address,
+                                 PortStats& stats) const {
     core::Mutex::Lock lock(mutex_);
 
-    while (Task* task = tasks_.front()) {
-        tasks_.remove(*task);
-
-        task->result = (this->*(task->fn))(*task);
-        task->done = true;
-    }
-
-    cond_.broadcast();
-}
+    PortStats total;
+    bool found = false;
 
-bool Transceiver::add_udp_receiver_(Task& task) {
-    core::SharedPtr<BasicPort> rp =
-        new (allocator_) UDPReceiverPort(*this, *task.address, loop_, *task.writer,
-                                         packet_pool_, buffer_pool_, allocator_);
+    for (size_t n = 0; n < n_loops_; n++) {
+        PortStats loop_stats;
+        if (!loops_[n]->get_port_stats(bind_address, loop_stats)) {
+            continue;
+        }
 
-    if (!rp) {
-        roc_log(LogError, "transceiver: can't add port %s: can't allocate receiver",
-                packet::address_to_str(*task.address).c_str());
+        total.packets += loop_stats.packets;
+        total.bytes += loop_stats.bytes;
+        total.errors += loop_stats.errors;
 
-        return false;
+        found = true;
     }
 
-    task.port = rp.get();
-
-    if (!rp->open()) {
-        roc_log(LogError, "transceiver: can't add port %s: can't start receiver",
-                packet::address_to_str(*task.address).c_str());
-
-        closing_ports_.push_back(*rp);
-        rp->async_close();
-
-        return false;
+    if (found) {
+        stats = total;
     }
 
-    *task.address = rp->address();
-    open_ports_.push_back(*rp);
-
-    return true;
+    return found;
 }
 
-bool Transceiver::add_udp_sender_(Task& task) {
-    core::SharedPtr<UDPSenderPort> sp =
-        new (allocator_) UDPSenderPort(*this, *task.address, loop_, allocator_);
-    if (!sp) {
-        roc_log(LogError, "transceiver: can't add port %s: can't allocate sender",
-                packet::address_to_str(*task.address).c_str());
-
-        return false;
-    }
-
-    task.port = sp.get();
-
-    if (!sp->open()) {
-        roc_log(LogError, "transceiver: can't add port %s: can't start sender",
-                packet::address_to_str(*task.address).c_str());
-
-        closing_ports_.push_back(*sp);
-        sp->async_close();
+EventLoop& Transceiver::next_loop_() {
+    EventLoop& loop = *loops_[next_loop_idx_];
+    next_loop_idx_ = (next_loop_idx_ + 1) % n_loops_;
+    return loop;
+}
 
+bool Transceiver::add_shared_udp_receiver_(packet::Address& bind_address,
+                                           packet::IWriter& writer) {
+    // the first loop resolves zero port, others bind to the same address
+    if (!loops_[0]->add_udp_receiver(bind_address, writer, true)) {
         return false;
     }
 
-    task.writer = sp.get();
-    *task.address = sp->address();
+    for (size_t n = 1; n < n_loops_; n++) {
+        packet::Address address = bind_address;
 
-    open_ports_.push_back(*sp);
+        if (!loops_[n]->add_udp_receiver(address, writer, true)) {
+            roc_log(LogError, "transceiver: can't bind port %s in event loop %lu",
+                    packet::address_to_str(bind_address).c_str(), (unsigned long)n);
 
-    return true;
-}
-
-bool Transceiver::remove_port_(Task& task) {
-    roc_log(LogDebug, "transceiver: removing port %s",
-            packet::address_to_str(*task.address).c_str());
-
-    core::SharedPtr<BasicPort> curr = open_ports_.front();
-    while (curr) {
-        core::SharedPtr<BasicPort> next = open_ports_.nextof(*curr);
+            while (n > 0) {
+                loops_[--n]->remove_port(bind_address);
+            }
 
-        if (curr->address() == *task.address) {
-            open_ports_.remove(*curr);
-            closing_ports_.push_back(*curr);
-
-            task.port = curr.get();
-            curr->async_close();
-
-            return true;
+            return false;
         }
-
-        curr = next;
     }
 
-    return false;
-}
-
-void Transceiver::wait_port_closed_(const BasicPort& port) {
-    core::Mutex::Lock lock(mutex_);
-
-    while (port_is_closing_(port)) {
-        cond_.wait();
-    }
-}
-
-bool Transceiver::port_is_closing_(const BasicPort& port) {
-    for (core::SharedPtr<BasicPort> pp = closing_ports_.front(); pp;
-         pp = closing_ports_.nextof(*pp)) {
-        if (pp.get() == &port) {
-            return true;
-        }
-    }
+    roc_log(LogDebug, "transceiver: bound port %s in %lu event loops",
+            packet::address_to_str(bind_address).c_str(), (unsigned long)n_loops_);
 
-    return false;
+    return true;
 }
 
 } // namespace netio
@@ -12,19 +12,13 @@
 #ifndef ROC_NETIO_TRANSCEIVER_H_
 #define ROC_NETIO_TRANSCEIVER_H_
 
-#include <uv.h>
-
 #include "roc_core/buffer_pool.h"
-#include "roc_core/cond.h"
 #include "roc_core/iallocator.h"
-#include "roc_core/list.h"
-#include "roc_core/list_node.h"
 #include "roc_core/mutex.h"
-#include "roc_core/thread.h"
+#include "roc_core/noncopyable.h"
 #include "roc_netio/basic_port.h"
-#include "roc_netio/iclose_handler.h"
-#include "roc_netio/udp_receiver_port.h"
-#include "roc_netio/udp_sender_port.h"
+#include "roc_netio/config.h"
+#include "roc_netio/event_loop.h"
 #include "roc_packet/address.h"
 #include "roc_packet/iwriter.h"
 #include "roc_packet/packet_pool.h"
@@ -33,25 +27,32 @@ namespace roc {
 namespace netio {
 
 //! Network sender/receiver.
-class Transceiver : private ICloseHandler, private core::Thread {
+//!
+//! Owns one or several event loops, each running in its own thread, and
+//! distributes ports between them.
+class Transceiver : public core::NonCopyable<> {
 public:
     //! Initialize.
     //!
     //! @remarks
-    //!  Start background thread if the object was successfully constructed.
-    Transceiver(packet::PacketPool& packet_pool,
+    //!  Start background threads if the object was successfully constructed.
+    Transceiver(const TransceiverConfig& config,
+                packet::PacketPool& packet_pool,
                 core::BufferPool<uint8_t>& buffer_pool,
                 core::IAllocator& allocator);
 
     //! Destroy. Stop all receivers and senders.
     //!
     //! @remarks
-    //!  Wait until background thread finishes.
-    virtual ~Transceiver();
+    //!  Wait until background threads finish.
+    ~Transceiver();
 
     //! Check if transceiver was successfully constructed.
     bool valid() const;
 
+    //! Get number of event loops.
+    size_t num_loops() const;
+
     //! Get number of receiver and sender ports.
     size_t num_ports() const;
 
@@ -59,12 +60,18 @@ public:
     //!
     //! Creates a new UDP receiver and bind it to @p bind_address. The receiver
     //! will pass packets to @p writer. Writer will be called from the network
-    //! thread. It should not block.
+    //! thread. It should not block. If reuse_port is enabled in config and
+    //! there are several event loops, writer may be called from several
+    //! network threads concurrently.
     //!
     //! If IP is zero, INADDR_ANY is used, i.e. the socket is bound to all network
     //! interfaces. If port is zero, a random free port is selected and written
     //! back to @p bind_address.
     //!
+    //! If IP is a multicast group, the receiver joins this group on the interface
+    //! specified by multicast interface of @p bind_address, or on the interface
+    //! selected by the OS if it's not set.
+    //!
     //! @returns
     //!  true on success or false if error occurred
     bool add_udp_receiver(packet::Address& bind_address, packet::IWriter& writer);
@@ -79,75 +86,56 @@ public:
     //! interfaces. If port is zero, a random free port is selected and written
     //! back to @p bind_address.
     //!
+    //! Multicast interface, TTL and loopback options of @p bind_address are
+    //! applied to the socket and affect packets sent to multicast destinations.
+    //!
     //! @returns
     //!  a new packet writer on success or null if error occurred
     packet::IWriter* add_udp_sender(packet::Address& bind_address);
 
+    //! Start receiving on UDP sender port.
+    //!
+    //! Makes the sender port bound to @p bind_address also pass datagrams sent
+    //! to this address to @p writer, e.g. to receive feedback from the peers
+    //! to which the port sends packets. Writer will be called from the network
+    //! thread. It should not block.
+    //!
+    //! @returns
+    //!  false if there is no such sender port or error occurred.
+    bool start_receiving(const packet::Address& bind_address, packet::IWriter& writer);
+
     //! Remove sender or receiver port. Wait until port will be removed.
     void remove_port(packet::Address bind_address);
 
-private:
-    struct Task : core::ListNode {
-        bool (Transceiver::*fn)(Task&);
-
-        packet::Address* address;
-        packet::IWriter* writer;
-        BasicPort* port;
-
-        bool result;
-        bool done;
-
-        Task()
-            : fn(NULL)
-            , address(NULL)
-            , writer(NULL)
-            , port(NULL)
-            , result(false)
-            , done(false) {
-        }
-    };
-
-    static void task_sem_cb_(uv_async_t* handle);
-    static void stop_sem_cb_(uv_async_t* handle);
-
-    virtual void handle_closed(BasicPort&);
-    virtual void run();
-
-    void close_sems_();
-    void async_close_ports_();
+    //! Get statistics of sender or receiver port.
+    //!
+    //! @remarks
+    //!  If the port is bound in several event loops, statistics are summed.
+    //!
+    //! @returns
+    //!  false if there is no open port with given @p bind_address.
+    bool get_port_stats(const packet::Address& bind_address, PortStats& stats) const;
 
-    void process_tasks_();
-    void run_task_(Task&);
+private:
+    enum { MaxLoops = 64 };
 
-    bool add_udp_receiver_(Task&);
-    bool add_udp_sender_(Task&);
+    EventLoop& next_loop_();
 
-    bool remove_port_(Task&);
-    void wait_port_closed_(const BasicPort& port);
-    bool port_is_closing_(const BasicPort& port);
+    bool add_shared_udp_receiver_(packet::Address& bind_address,
+                                  packet::IWriter& writer);
 
-    packet::PacketPool& packet_pool_;
-    core::BufferPool<uint8_t>& buffer_pool_;
     core::IAllocator& allocator_;
 
-    bool started_;
-
-    uv_loop_t loop_;
-    bool loop_initialized_;
-
-    uv_async_t stop_sem_;
-    bool stop_sem_initialized_;
-
-    uv_async_t task_sem_;
-    bool task_sem_initialized_;
+    EventLoop* loops_[MaxLoops];
+    size_t n_loops_;
+    size_t next_loop_idx_;
 
-    core::List<Task, core::NoOwnership> tasks_;
+    size_t n_ports_;
 
-    core::List<BasicPort> open_ports_;
-    core::List<BasicPort> closing_ports_;
+    bool reuse_port_;
+    bool valid_;
 
     core::Mutex mutex_;
-    core::Cond cond_;
 };
 
 } // namespace netio
@@ -6,10 +6,15 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <sys/socket.h>
+
 #include "roc_netio/udp_receiver_port.h"
+#include "roc_core/errno_to_str.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/shared_ptr.h"
+#include "roc_core/time.h"
+#include "roc_core/trace.h"
 #include "roc_packet/address_to_str.h"
 
 namespace roc {
@@ -19,6 +24,8 @@ UDPReceiverPort::UDPReceiverPort(ICloseHandler& close_handler,
                                  const packet::Address& address,
                                  uv_loop_t& event_loop,
                                  packet::IWriter& writer,
+                                 size_t recv_buffer_size,
+                                 bool reuse_port,
                                  packet::PacketPool& packet_pool,
                                  core::BufferPool<uint8_t>& buffer_pool,
                                  core::IAllocator& allocator)
@@ -30,6 +37,8 @@ UDPReceiverPort::UDPReceiverPort(ICloseHandler& close_handler,
     , closed_(false)
     , address_(address)
     , writer_(writer)
+    , recv_buffer_size_(recv_buffer_size)
+    , reuse_port_(reuse_port)
     , packet_pool_(packet_pool)
     , buffer_pool_(buffer_pool)
     , packet_counter_(0) {
@@ -46,9 +55,22 @@ const packet::Address& UDPReceiverPort::address() const {
     return address_;
 }
 
+PortStats UDPReceiverPort::stats() const {
+    PortStats stats;
+
+    stats.packets = (size_t)(long)num_packets_;
+    stats.bytes = (size_t)(long)num_bytes_;
+    stats.errors = (size_t)(long)num_errors_;
+
+    return stats;
+}
+
 bool UDPReceiverPort::open() {
-    if (int err = uv_udp_init(&loop_, &handle_)) {
-        roc_log(LogError, "udp receiver: uv_udp_init(): [%s] %s", uv_err_name(err),
+    // if SO_REUSEPORT is needed, socket should be created before bind
+    const unsigned family = reuse_port_ ? address_.saddr()->sa_family : AF_UNSPEC;
+
+    if (int err = uv_udp_init_ex(&loop_, &handle_, family)) {
+        roc_log(LogError, "udp receiver: uv_udp_init_ex(): [%s] %s", uv_err_name(err),
                 uv_strerror(err));
         return false;
     }
@@ -56,6 +78,12 @@ bool UDPReceiverPort::open() {
     handle_.data = this;
     handle_initialized_ = true;
 
+    if (reuse_port_) {
+        if (!set_reuse_port_()) {
+            return false;
+        }
+    }
+
     unsigned flags = 0;
     if (address_.multicast() && address_.port() > 0) {
         flags |= UV_UDP_REUSEADDR;
@@ -89,6 +117,16 @@ bool UDPReceiverPort::open() {
         return false;
     }
 
+    if (!set_buffer_size_()) {
+        return false;
+    }
+
+    if (address_.multicast()) {
+        if (!join_multicast_group_()) {
+            return false;
+        }
+    }
+
     if (int err = uv_udp_recv_start(&handle_, alloc_cb_, recv_cb_)) {
         roc_log(LogError, "udp receiver: uv_udp_recv_start(): [%s] %s", uv_err_name(err),
                 uv_strerror(err));
@@ -132,6 +170,74 @@ void UDPReceiverPort::async_close() {
     }
 }
 
+bool UDPReceiverPort::set_reuse_port_() {
+#ifdef SO_REUSEPORT
+    uv_os_fd_t fd;
+    if (int err = uv_fileno((uv_handle_t*)&handle_, &fd)) {
+        roc_log(LogError, "udp receiver: uv_fileno(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
+    int opt = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) == -1) {
+        roc_log(LogError, "udp receiver: setsockopt(SO_REUSEPORT): %s",
+                core::errno_to_str().c_str());
+        return false;
+    }
+
+    return true;
+#else
+    roc_log(LogError, "udp receiver: SO_REUSEPORT is not supported on this platform");
+    return false;
+#endif
+}
+
+bool UDPReceiverPort::set_buffer_size_() {
+    if (recv_buffer_size_ == 0) {
+        return true;
+    }
+
+    int value = (int)recv_buffer_size_;
+    if (int err = uv_recv_buffer_size((uv_handle_t*)&handle_, &value)) {
+        roc_log(LogError, "udp receiver: uv_recv_buffer_size(): [%s] %s",
+                uv_err_name(err), uv_strerror(err));
+        return false;
+    }
+
+    value = 0;
+    if (uv_recv_buffer_size((uv_handle_t*)&handle_, &value) == 0) {
+        roc_log(LogDebug,
+                "udp receiver: set receive buffer size: requested=%lu actual=%d",
+                (unsigned long)recv_buffer_size_, value);
+    }
+
+    return true;
+}
+
+bool UDPReceiverPort::join_multicast_group_() {
+    char group[64];
+    if (!address_.get_ip(group, sizeof(group))) {
+        roc_log(LogError, "udp receiver: can't format multicast group address");
+        return false;
+    }
+
+    char iface[64];
+    const bool has_iface = address_.get_miface(iface, sizeof(iface));
+
+    if (int err = uv_udp_set_membership(&handle_, group, has_iface ? iface : NULL,
+                                        UV_JOIN_GROUP)) {
+        roc_log(LogError, "udp receiver: uv_udp_set_membership(): [%s] %s",
+                uv_err_name(err), uv_strerror(err));
+        return false;
+    }
+
+    roc_log(LogInfo, "udp receiver: joined multicast group %s on interface %s", group,
+            has_iface ? iface : "<default>");
+
+    return true;
+}
+
 void UDPReceiverPort::close_cb_(uv_handle_t* handle) {
     roc_panic_if_not(handle);
 
@@ -152,25 +258,38 @@ void UDPReceiverPort::alloc_cb_(uv_handle_t* handle, size_t size, uv_buf_t* buf)
 
     UDPReceiverPort& self = *(UDPReceiverPort*)handle->data;
 
-    core::SharedPtr<core::Buffer<uint8_t> > bp =
-        new (self.buffer_pool_) core::Buffer<uint8_t>(self.buffer_pool_);
+    // packet is allocated before reading, so that the datagram is received
+    // directly into its data buffer; it stays pending until a read succeeds
+    if (!self.recv_packet_) {
+        packet::PacketPtr pp = new (self.packet_pool_) packet::Packet(self.packet_pool_);
+        if (!pp) {
+            roc_log(LogError, "udp receiver: can't allocate packet");
+
+            buf->base = NULL;
+            buf->len = 0;
 
-    if (!bp) {
-        roc_log(LogError, "udp receiver: can't allocate buffer");
+            return;
+        }
 
-        buf->base = NULL;
-        buf->len = 0;
+        core::Slice<uint8_t> data = pp->alloc_buffer(self.buffer_pool_);
+        if (!data) {
+            roc_log(LogError, "udp receiver: can't allocate buffer");
 
-        return;
-    }
+            buf->base = NULL;
+            buf->len = 0;
+
+            return;
+        }
 
-    if (size > bp->size()) {
-        size = bp->size();
+        self.recv_packet_ = pp;
+        self.recv_data_ = data;
     }
 
-    bp->incref(); // will be decremented in recv_cb_()
+    if (size > self.recv_data_.size()) {
+        size = self.recv_data_.size();
+    }
 
-    buf->base = (char*)bp->data();
+    buf->base = (char*)self.recv_data_.data();
     buf->len = size;
 }
 
@@ -179,6 +298,8 @@ void UDPReceiverPort::recv_cb_(uv_udp_t* handle,
                                const uv_buf_t* buf,
                                const sockaddr* sockaddr,
                                unsigned flags) {
+    roc_trace_scope("udp_receiver.recv");
+
     roc_panic_if_not(handle);
     roc_panic_if_not(buf);
 
@@ -195,20 +316,11 @@ void UDPReceiverPort::recv_cb_(uv_udp_t* handle,
         }
     }
 
-    core::SharedPtr<core::Buffer<uint8_t> > bp =
-        core::Buffer<uint8_t>::container_of(buf->base);
-
-    // one reference for incref() called from alloc_cb_()
-    // one reference for the shared pointer above
-    roc_panic_if(bp->getref() != 2);
-
-    // decrement reference counter incremented in alloc_cb_()
-    bp->decref();
-
     if (nread < 0) {
         roc_log(LogError, "udp receiver: network error: num=%u src=%s dst=%s nread=%ld",
                 self.packet_counter_, packet::address_to_str(src_addr).c_str(),
                 packet::address_to_str(self.address_).c_str(), (long)nread);
+        ++self.num_errors_;
         return;
     }
 
@@ -233,6 +345,7 @@ void UDPReceiverPort::recv_cb_(uv_udp_t* handle,
                 " ignoring partial read: num=%u src=%s dst=%s nread=%ld",
                 self.packet_counter_, packet::address_to_str(src_addr).c_str(),
                 packet::address_to_str(self.address_).c_str(), (long)nread);
+        ++self.num_errors_;
         return;
     }
 
@@ -242,23 +355,31 @@ void UDPReceiverPort::recv_cb_(uv_udp_t* handle,
             self.packet_counter_, packet::address_to_str(src_addr).c_str(),
             packet::address_to_str(self.address_).c_str(), (long)nread);
 
-    if ((size_t)nread > bp->size()) {
-        roc_panic("udp receiver: unexpected buffer size: got %ld, max %ld", (long)nread,
-                  (long)bp->size());
+    if (!self.recv_packet_ || buf->base != (char*)self.recv_data_.data()) {
+        roc_panic("udp receiver: unexpected buffer");
     }
 
-    packet::PacketPtr pp = new (self.packet_pool_) packet::Packet(self.packet_pool_);
-    if (!pp) {
-        roc_log(LogError, "udp receiver: can't allocate packet");
-        return;
+    if ((size_t)nread > self.recv_data_.size()) {
+        roc_panic("udp receiver: unexpected buffer size: got %ld, max %ld", (long)nread,
+                  (long)self.recv_data_.size());
     }
 
+    packet::PacketPtr pp = self.recv_packet_;
+    core::Slice<uint8_t> data = self.recv_data_.range(0, (size_t)nread);
+
+    self.recv_packet_ = NULL;
+    self.recv_data_ = core::Slice<uint8_t>();
+
     pp->add_flags(packet::Packet::FlagUDP);
 
     pp->udp()->src_addr = src_addr;
     pp->udp()->dst_addr = self.address_;
+    pp->udp()->receive_timestamp = core::timestamp();
+
+    pp->set_data(data);
 
-    pp->set_data(core::Slice<uint8_t>(*bp, 0, (size_t)nread));
+    ++self.num_packets_;
+    self.num_bytes_ += (long)nread;
 
     self.writer_.write(pp);
 }
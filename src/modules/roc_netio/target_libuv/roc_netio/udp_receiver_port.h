@@ -14,11 +14,13 @@
 
 #include <uv.h>
 
+#include "roc_core/atomic.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/list.h"
 #include "roc_core/list_node.h"
 #include "roc_core/refcnt.h"
+#include "roc_core/slice.h"
 #include "roc_netio/basic_port.h"
 #include "roc_netio/iclose_handler.h"
 #include "roc_packet/address.h"
@@ -36,6 +38,8 @@ public:
                     const packet::Address&,
                     uv_loop_t& event_loop,
                     packet::IWriter& writer,
+                    size_t recv_buffer_size,
+                    bool reuse_port,
                     packet::PacketPool& packet_pool,
                     core::BufferPool<uint8_t>& buffer_pool,
                     core::IAllocator& allocator);
@@ -46,6 +50,9 @@ public:
     //! Get bind address.
     virtual const packet::Address& address() const;
 
+    //! Get port statistics.
+    virtual PortStats stats() const;
+
     //! Open receiver.
     virtual bool open();
 
@@ -61,6 +68,10 @@ private:
                          const sockaddr* addr,
                          unsigned flags);
 
+    bool set_reuse_port_();
+    bool set_buffer_size_();
+    bool join_multicast_group_();
+
     ICloseHandler& close_handler_;
 
     uv_loop_t& loop_;
@@ -74,10 +85,20 @@ private:
     packet::Address address_;
     packet::IWriter& writer_;
 
+    size_t recv_buffer_size_;
+    bool reuse_port_;
+
     packet::PacketPool& packet_pool_;
     core::BufferPool<uint8_t>& buffer_pool_;
 
+    packet::PacketPtr recv_packet_;
+    core::Slice<uint8_t> recv_data_;
+
     unsigned packet_counter_;
+
+    core::Atomic num_packets_;
+    core::Atomic num_bytes_;
+    core::Atomic num_errors_;
 };
 
 } // namespace netio
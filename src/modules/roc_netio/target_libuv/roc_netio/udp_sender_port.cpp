@@ -10,6 +10,9 @@
 #include "roc_core/helpers.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_core/time.h"
+#include "roc_core/trace.h"
 #include "roc_packet/address_to_str.h"
 
 namespace roc {
@@ -18,6 +21,9 @@ namespace netio {
 UDPSenderPort::UDPSenderPort(ICloseHandler& close_handler,
                              const packet::Address& address,
                              uv_loop_t& event_loop,
+                             size_t send_buffer_size,
+                             packet::PacketPool& packet_pool,
+                             core::BufferPool<uint8_t>& buffer_pool,
                              core::IAllocator& allocator)
     : BasicPort(allocator)
     , close_handler_(close_handler)
@@ -25,6 +31,11 @@ UDPSenderPort::UDPSenderPort(ICloseHandler& close_handler,
     , write_sem_initialized_(false)
     , handle_initialized_(false)
     , address_(address)
+    , send_buffer_size_(send_buffer_size)
+    , packet_pool_(packet_pool)
+    , buffer_pool_(buffer_pool)
+    , recv_writer_(NULL)
+    , recv_started_(false)
     , pending_(0)
     , stopped_(true)
     , closed_(false)
@@ -41,6 +52,16 @@ const packet::Address& UDPSenderPort::address() const {
     return address_;
 }
 
+PortStats UDPSenderPort::stats() const {
+    PortStats stats;
+
+    stats.packets = (size_t)(long)num_packets_;
+    stats.bytes = (size_t)(long)num_bytes_;
+    stats.errors = (size_t)(long)num_errors_;
+
+    return stats;
+}
+
 bool UDPSenderPort::open() {
     if (int err = uv_async_init(&loop_, &write_sem_, write_sem_cb_)) {
         roc_log(LogError, "udp sender: uv_async_init(): [%s] %s", uv_err_name(err),
@@ -92,6 +113,14 @@ bool UDPSenderPort::open() {
         return false;
     }
 
+    if (!set_buffer_size_()) {
+        return false;
+    }
+
+    if (!set_multicast_options_()) {
+        return false;
+    }
+
     roc_log(LogInfo, "udp sender: opened port %s",
             packet::address_to_str(address_).c_str());
 
@@ -105,11 +134,46 @@ void UDPSenderPort::async_close() {
 
     stopped_ = true;
 
+    stop_receiving_();
+
     if (pending_ == 0) {
         close_();
     }
 }
 
+bool UDPSenderPort::start_receiving(packet::IWriter& writer) {
+    core::Mutex::Lock lock(mutex_);
+
+    if (stopped_ || !handle_initialized_) {
+        roc_log(LogError, "udp sender: can't start receiving on port %s: port is closed",
+                packet::address_to_str(address_).c_str());
+        return false;
+    }
+
+    if (recv_started_) {
+        roc_log(LogError,
+                "udp sender: can't start receiving on port %s: already started",
+                packet::address_to_str(address_).c_str());
+        return false;
+    }
+
+    recv_writer_ = &writer;
+
+    if (int err = uv_udp_recv_start(&handle_, alloc_cb_, recv_cb_)) {
+        roc_log(LogError, "udp sender: uv_udp_recv_start(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        recv_writer_ = NULL;
+        return false;
+    }
+
+    recv_started_ = true;
+
+    roc_log(LogInfo, "udp sender: started receiving on port %s",
+            packet::address_to_str(address_).c_str());
+
+    return true;
+}
+
 void UDPSenderPort::write(const packet::PacketPtr& pp) {
     if (!pp) {
         roc_panic("udp sender: unexpected null packet");
@@ -140,6 +204,56 @@ void UDPSenderPort::write(const packet::PacketPtr& pp) {
     }
 }
 
+bool UDPSenderPort::set_buffer_size_() {
+    if (send_buffer_size_ == 0) {
+        return true;
+    }
+
+    int value = (int)send_buffer_size_;
+    if (int err = uv_send_buffer_size((uv_handle_t*)&handle_, &value)) {
+        roc_log(LogError, "udp sender: uv_send_buffer_size(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
+    value = 0;
+    if (uv_send_buffer_size((uv_handle_t*)&handle_, &value) == 0) {
+        roc_log(LogDebug, "udp sender: set send buffer size: requested=%lu actual=%d",
+                (unsigned long)send_buffer_size_, value);
+    }
+
+    return true;
+}
+
+bool UDPSenderPort::set_multicast_options_() {
+    char iface[64];
+    if (address_.get_miface(iface, sizeof(iface))) {
+        if (int err = uv_udp_set_multicast_interface(&handle_, iface)) {
+            roc_log(LogError, "udp sender: uv_udp_set_multicast_interface(): [%s] %s",
+                    uv_err_name(err), uv_strerror(err));
+            return false;
+        }
+    }
+
+    if (address_.multicast_ttl() >= 0) {
+        if (int err = uv_udp_set_multicast_ttl(&handle_, address_.multicast_ttl())) {
+            roc_log(LogError, "udp sender: uv_udp_set_multicast_ttl(): [%s] %s",
+                    uv_err_name(err), uv_strerror(err));
+            return false;
+        }
+    }
+
+    if (address_.multicast_loop() >= 0) {
+        if (int err = uv_udp_set_multicast_loop(&handle_, address_.multicast_loop())) {
+            roc_log(LogError, "udp sender: uv_udp_set_multicast_loop(): [%s] %s",
+                    uv_err_name(err), uv_strerror(err));
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void UDPSenderPort::close_cb_(uv_handle_t* handle) {
     roc_panic_if_not(handle);
 
@@ -163,35 +277,77 @@ void UDPSenderPort::close_cb_(uv_handle_t* handle) {
 }
 
 void UDPSenderPort::write_sem_cb_(uv_async_t* handle) {
+    roc_trace_scope("udp_sender.send");
+
     roc_panic_if_not(handle);
 
     UDPSenderPort& self = *(UDPSenderPort*)handle->data;
 
-    while (packet::PacketPtr pp = self.read_()) {
-        packet::UDP& udp = *pp->udp();
+    core::List<packet::Packet> list;
+    self.fetch_(list);
+
+    size_t n_completed = 0;
+
+    while (packet::PacketPtr pp = list.front()) {
+        list.remove(*pp);
 
         self.packet_counter_++;
 
         roc_log(LogTrace, "udp sender: sending packet: num=%u src=%s dst=%s sz=%ld",
                 self.packet_counter_, packet::address_to_str(self.address_).c_str(),
-                packet::address_to_str(udp.dst_addr).c_str(), (long)pp->data().size());
+                packet::address_to_str(pp->udp()->dst_addr).c_str(),
+                (long)pp->data().size());
+
+        if (!self.send_(*pp)) {
+            n_completed++;
+        }
+    }
 
-        uv_buf_t buf;
-        buf.base = (char*)pp->data().data();
-        buf.len = pp->data().size();
+    if (n_completed != 0) {
+        self.complete_(n_completed);
+    }
+}
 
-        udp.request.data = &self;
+bool UDPSenderPort::send_(packet::Packet& packet) {
+    packet::UDP& udp = *packet.udp();
 
-        if (int err = uv_udp_send(&udp.request, &self.handle_, &buf, 1,
-                                  udp.dst_addr.saddr(), send_cb_)) {
-            roc_log(LogError, "udp sender: uv_udp_send(): [%s] %s", uv_err_name(err),
-                    uv_strerror(err));
-            continue;
-        }
+    uv_buf_t buf;
+    buf.base = (char*)packet.data().data();
+    buf.len = packet.data().size();
 
-        // will be decremented in send_cb_()
-        pp->incref();
+    // Try to send the packet immediately, which is the common case. This avoids
+    // allocating a request and waiting for a completion callback for every packet.
+    // If the socket is not writable or there are queued requests, fall back to
+    // uv_udp_send() which preserves the order.
+    const int ret = uv_udp_try_send(&handle_, &buf, 1, udp.dst_addr.saddr());
+
+    if (ret >= 0) {
+        ++num_packets_;
+        num_bytes_ += (long)buf.len;
+        return false;
     }
+
+    if (ret != UV_EAGAIN && ret != UV_ENOSYS) {
+        roc_log(LogError, "udp sender: uv_udp_try_send(): [%s] %s", uv_err_name(ret),
+                uv_strerror(ret));
+        ++num_errors_;
+        return false;
+    }
+
+    udp.request.data = this;
+
+    if (int err = uv_udp_send(&udp.request, &handle_, &buf, 1, udp.dst_addr.saddr(),
+                              send_cb_)) {
+        roc_log(LogError, "udp sender: uv_udp_send(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        ++num_errors_;
+        return false;
+    }
+
+    // will be decremented in send_cb_()
+    packet.incref();
+
+    return true;
 }
 
 void UDPSenderPort::send_cb_(uv_udp_send_t* req, int status) {
@@ -216,26 +372,163 @@ void UDPSenderPort::send_cb_(uv_udp_send_t* req, int status) {
                 packet::address_to_str(self.address_).c_str(),
                 packet::address_to_str(pp->udp()->dst_addr).c_str(),
                 (long)pp->data().size(), uv_err_name(status), uv_strerror(status));
+        ++self.num_errors_;
+    } else {
+        ++self.num_packets_;
+        self.num_bytes_ += (long)pp->data().size();
     }
 
-    core::Mutex::Lock lock(self.mutex_);
+    self.complete_(1);
+}
+
+void UDPSenderPort::alloc_cb_(uv_handle_t* handle, size_t size, uv_buf_t* buf) {
+    roc_panic_if_not(handle);
+    roc_panic_if_not(buf);
+
+    UDPSenderPort& self = *(UDPSenderPort*)handle->data;
+
+    if (!self.recv_packet_) {
+        packet::PacketPtr pp = new (self.packet_pool_) packet::Packet(self.packet_pool_);
+        if (!pp) {
+            roc_log(LogError, "udp sender: can't allocate packet");
+
+            buf->base = NULL;
+            buf->len = 0;
+
+            return;
+        }
+
+        core::Slice<uint8_t> data = pp->alloc_buffer(self.buffer_pool_);
+        if (!data) {
+            roc_log(LogError, "udp sender: can't allocate buffer");
 
-    --self.pending_;
+            buf->base = NULL;
+            buf->len = 0;
 
-    if (self.stopped_ && self.pending_ == 0) {
-        self.close_();
+            return;
+        }
+
+        self.recv_packet_ = pp;
+        self.recv_data_ = data;
     }
+
+    if (size > self.recv_data_.size()) {
+        size = self.recv_data_.size();
+    }
+
+    buf->base = (char*)self.recv_data_.data();
+    buf->len = size;
 }
 
-packet::PacketPtr UDPSenderPort::read_() {
+void UDPSenderPort::recv_cb_(uv_udp_t* handle,
+                             ssize_t nread,
+                             const uv_buf_t* buf,
+                             const sockaddr* sockaddr,
+                             unsigned flags) {
+    roc_trace_scope("udp_sender.recv");
+
+    roc_panic_if_not(handle);
+    roc_panic_if_not(buf);
+
+    UDPSenderPort& self = *(UDPSenderPort*)handle->data;
+
+    packet::Address src_addr;
+    if (sockaddr) {
+        if (!src_addr.set_saddr(sockaddr)) {
+            roc_log(LogError, "udp sender: can't determine source address: dst=%s",
+                    packet::address_to_str(self.address_).c_str());
+        }
+    }
+
+    if (nread < 0) {
+        roc_log(LogError, "udp sender: network error: src=%s dst=%s nread=%ld",
+                packet::address_to_str(src_addr).c_str(),
+                packet::address_to_str(self.address_).c_str(), (long)nread);
+        ++self.num_errors_;
+        return;
+    }
+
+    if (nread == 0) {
+        return;
+    }
+
+    if (!sockaddr) {
+        roc_panic("udp sender: unexpected null source address");
+    }
+
+    if (flags & UV_UDP_PARTIAL) {
+        roc_log(LogDebug, "udp sender: ignoring partial read: src=%s dst=%s nread=%ld",
+                packet::address_to_str(src_addr).c_str(),
+                packet::address_to_str(self.address_).c_str(), (long)nread);
+        ++self.num_errors_;
+        return;
+    }
+
+    roc_log(LogTrace, "udp sender: received packet: src=%s dst=%s nread=%ld",
+            packet::address_to_str(src_addr).c_str(),
+            packet::address_to_str(self.address_).c_str(), (long)nread);
+
+    if (!self.recv_packet_ || buf->base != (char*)self.recv_data_.data()) {
+        roc_panic("udp sender: unexpected buffer");
+    }
+
+    if ((size_t)nread > self.recv_data_.size()) {
+        roc_panic("udp sender: unexpected buffer size: got %ld, max %ld", (long)nread,
+                  (long)self.recv_data_.size());
+    }
+
+    packet::PacketPtr pp = self.recv_packet_;
+    core::Slice<uint8_t> data = self.recv_data_.range(0, (size_t)nread);
+
+    self.recv_packet_ = NULL;
+    self.recv_data_ = core::Slice<uint8_t>();
+
+    pp->add_flags(packet::Packet::FlagUDP);
+
+    pp->udp()->src_addr = src_addr;
+    pp->udp()->dst_addr = self.address_;
+    pp->udp()->receive_timestamp = core::timestamp();
+
+    pp->set_data(data);
+
+    ++self.num_packets_;
+    self.num_bytes_ += (long)nread;
+
+    roc_panic_if_not(self.recv_writer_);
+    self.recv_writer_->write(pp);
+}
+
+void UDPSenderPort::fetch_(core::List<packet::Packet>& list) {
     core::Mutex::Lock lock(mutex_);
 
-    packet::PacketPtr pp = list_.front();
-    if (pp) {
+    while (packet::PacketPtr pp = list_.front()) {
         list_.remove(*pp);
+        list.push_back(*pp);
+    }
+}
+
+void UDPSenderPort::complete_(size_t n_packets) {
+    core::Mutex::Lock lock(mutex_);
+
+    roc_panic_if(pending_ < n_packets);
+    pending_ -= n_packets;
+
+    if (stopped_ && pending_ == 0) {
+        close_();
+    }
+}
+
+void UDPSenderPort::stop_receiving_() {
+    if (!recv_started_) {
+        return;
+    }
+
+    if (int err = uv_udp_recv_stop(&handle_)) {
+        roc_log(LogError, "udp sender: uv_udp_recv_stop(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
     }
 
-    return pp;
+    recv_started_ = false;
 }
 
 void UDPSenderPort::close_() {
@@ -14,24 +14,34 @@
 
 #include <uv.h>
 
+#include "roc_core/atomic.h"
+#include "roc_core/buffer_pool.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/mutex.h"
 #include "roc_core/refcnt.h"
+#include "roc_core/slice.h"
 #include "roc_netio/basic_port.h"
 #include "roc_netio/iclose_handler.h"
 #include "roc_packet/address.h"
 #include "roc_packet/iwriter.h"
+#include "roc_packet/packet_pool.h"
 
 namespace roc {
 namespace netio {
 
 //! UDP sender.
+//! @remarks
+//!  Sends packets from the bound address. Optionally, may also receive
+//!  datagrams sent back to this address, see start_receiving().
 class UDPSenderPort : public BasicPort, public packet::IWriter {
 public:
     //! Initialize.
     UDPSenderPort(ICloseHandler& close_handler,
                   const packet::Address&,
                   uv_loop_t& event_loop,
+                  size_t send_buffer_size,
+                  packet::PacketPool& packet_pool,
+                  core::BufferPool<uint8_t>& buffer_pool,
                   core::IAllocator& allocator);
 
     //! Destroy.
@@ -40,12 +50,20 @@ public:
     //! Get bind address.
     virtual const packet::Address& address() const;
 
+    //! Get port statistics.
+    virtual PortStats stats() const;
+
     //! Open sender.
     virtual bool open();
 
     //! Asynchronously close sender.
     virtual void async_close();
 
+    //! Start passing incoming datagrams to @p writer.
+    //! @remarks
+    //!  Writer will be called from the network thread. It should not block.
+    virtual bool start_receiving(packet::IWriter& writer);
+
     //! Write packet.
     //! @remarks
     //!  May be called from any thread.
@@ -55,10 +73,22 @@ private:
     static void close_cb_(uv_handle_t* handle);
     static void write_sem_cb_(uv_async_t* handle);
     static void send_cb_(uv_udp_send_t* req, int status);
-
-    packet::PacketPtr read_();
+    static void alloc_cb_(uv_handle_t* handle, size_t size, uv_buf_t* buf);
+    static void recv_cb_(uv_udp_t* handle,
+                         ssize_t nread,
+                         const uv_buf_t* buf,
+                         const sockaddr* addr,
+                         unsigned flags);
+
+    void fetch_(core::List<packet::Packet>& list);
+    bool send_(packet::Packet& packet);
+    void complete_(size_t n_packets);
+    void stop_receiving_();
     void close_();
 
+    bool set_buffer_size_();
+    bool set_multicast_options_();
+
     ICloseHandler& close_handler_;
 
     uv_loop_t& loop_;
@@ -71,6 +101,17 @@ private:
 
     packet::Address address_;
 
+    size_t send_buffer_size_;
+
+    packet::PacketPool& packet_pool_;
+    core::BufferPool<uint8_t>& buffer_pool_;
+
+    packet::IWriter* recv_writer_;
+    bool recv_started_;
+
+    packet::PacketPtr recv_packet_;
+    core::Slice<uint8_t> recv_data_;
+
     core::List<packet::Packet> list_;
     core::Mutex mutex_;
 
@@ -79,6 +120,10 @@ private:
     bool closed_;
 
     unsigned packet_counter_;
+
+    core::Atomic num_packets_;
+    core::Atomic num_bytes_;
+    core::Atomic num_errors_;
 };
 
 } // namespace netio
@@ -13,11 +13,11 @@ namespace roc {
 namespace packet {
 
 FEC::FEC()
-    : fec_scheme(FEC_None)
-    , encoding_symbol_id(0)
-    , source_block_number(0)
+    : encoding_symbol_id(0)
     , source_block_length(0)
-    , block_length(0) {
+    , block_length(0)
+    , fec_scheme(FEC_None)
+    , source_block_number(0) {
 }
 
 int FEC::compare(const FEC& other) const {
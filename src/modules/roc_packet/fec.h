@@ -33,12 +33,6 @@ enum FECScheme {
 
 //! FECFRAME packet.
 struct FEC {
-    //! The FEC scheme to which the packet belongs to.
-    //!
-    //! @remarks
-    //!  Defines both FEC header or footer format and FEC payalod format.
-    FECScheme fec_scheme;
-
     //! The index number of packet in a block.
     //!
     //! @remarks
@@ -48,14 +42,6 @@ struct FEC {
     //!  n is a number of repair packets per block.
     size_t encoding_symbol_id;
 
-    //! Number of a source block in a packet stream.
-    //!
-    //! @remarks
-    //!  Source block is formed from the source packets.
-    //!  Blocks are numbered sequentially starting from a random number.
-    //!  Block number can wrap.
-    blknum_t source_block_number;
-
     //! Number of source packets in the block to which this packet belongs to.
     //!
     //! @remarks
@@ -70,6 +56,20 @@ struct FEC {
     //!  This field is not supported on all FEC schemes.
     size_t block_length;
 
+    //! The FEC scheme to which the packet belongs to.
+    //!
+    //! @remarks
+    //!  Defines both FEC header or footer format and FEC payalod format.
+    FECScheme fec_scheme;
+
+    //! Number of a source block in a packet stream.
+    //!
+    //! @remarks
+    //!  Source block is formed from the source packets.
+    //!  Blocks are numbered sequentially starting from a random number.
+    //!  Block number can wrap.
+    blknum_t source_block_number;
+
     //! FECFRAME header or footer.
     core::Slice<uint8_t> payload_id;
 
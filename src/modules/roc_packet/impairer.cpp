@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_packet/impairer.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { MinHeapSize = 64 };
+
+bool valid_probability(float p) {
+    return p >= 0 && p <= 1;
+}
+
+} // namespace
+
+Impairer::Impairer(IWriter& writer,
+                   PacketPool& pool,
+                   const ImpairerConfig& config,
+                   core::IAllocator& allocator)
+    : writer_(writer)
+    , pool_(pool)
+    , config_(config)
+    , heap_(allocator)
+    , now_(0)
+    , link_free_(0)
+    , last_deadline_(0)
+    , seqnum_(0)
+    , rand_(config.seed * 2654435761u + 0x9e3779b9u)
+    , burst_(false)
+    , valid_(false) {
+    if (!valid_probability(config.loss) || !valid_probability(config.burst_start)
+        || !valid_probability(config.burst_end) || !valid_probability(config.burst_loss)
+        || !valid_probability(config.duplication)) {
+        roc_log(LogError,
+                "impairer: invalid config: probabilities should be in range [0; 1]:"
+                " loss=%f burst_start=%f burst_end=%f burst_loss=%f duplication=%f",
+                (double)config.loss, (double)config.burst_start,
+                (double)config.burst_end, (double)config.burst_loss,
+                (double)config.duplication);
+        return;
+    }
+
+    if (config.jitter < 0 || config.max_queue_delay < 0) {
+        roc_log(LogError,
+                "impairer: invalid config: jitter=%ld max_queue_delay=%ld",
+                (long)config.jitter, (long)config.max_queue_delay);
+        return;
+    }
+
+    if (rand_ == 0) {
+        rand_ = 1;
+    }
+
+    if (!heap_.grow(MinHeapSize)) {
+        roc_log(LogError, "impairer: can't allocate queue");
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool Impairer::valid() const {
+    return valid_;
+}
+
+void Impairer::write(const PacketPtr& packet) {
+    roc_panic_if(!valid());
+
+    if (!packet) {
+        roc_panic("impairer: null packet");
+    }
+
+    core::Mutex::Lock lock(mutex_);
+
+    if (config_.realtime) {
+        advance_(core::timestamp());
+    }
+
+    stats_.n_written++;
+
+    if (lose_()) {
+        stats_.n_lost++;
+        return;
+    }
+
+    const bool duplicate =
+        config_.duplication > 0 && random_() < config_.duplication;
+
+    for (size_t n = 0; n < (duplicate ? 2u : 1u); n++) {
+        PacketPtr pp = packet;
+
+        if (n != 0) {
+            if (!(pp = copy_(*packet))) {
+                roc_log(LogError, "impairer: can't allocate packet");
+                break;
+            }
+            stats_.n_duplicated++;
+        }
+
+        const core::nanoseconds_t departure = transmit_(*pp);
+        if (departure < 0) {
+            stats_.n_dropped++;
+            continue;
+        }
+
+        core::nanoseconds_t deadline = departure + delay_();
+
+        if (!config_.reordering) {
+            if (deadline < last_deadline_) {
+                deadline = last_deadline_;
+            }
+            last_deadline_ = deadline;
+        }
+
+        schedule_(pp, deadline);
+    }
+
+    deliver_(now_);
+}
+
+void Impairer::advance(core::nanoseconds_t now) {
+    roc_panic_if(!valid());
+
+    core::Mutex::Lock lock(mutex_);
+
+    advance_(now);
+}
+
+void Impairer::flush() {
+    roc_panic_if(!valid());
+
+    core::Mutex::Lock lock(mutex_);
+
+    while (heap_.size() != 0) {
+        deliver_(heap_[0].deadline);
+    }
+}
+
+size_t Impairer::num_pending() const {
+    core::Mutex::Lock lock(mutex_);
+
+    return heap_.size();
+}
+
+ImpairerStats Impairer::stats() const {
+    core::Mutex::Lock lock(mutex_);
+
+    return stats_;
+}
+
+void Impairer::advance_(core::nanoseconds_t now) {
+    if (now > now_) {
+        now_ = now;
+    }
+
+    deliver_(now_);
+}
+
+bool Impairer::lose_() {
+    if (burst_) {
+        if (random_() < config_.burst_end) {
+            burst_ = false;
+        }
+    } else {
+        if (config_.burst_start > 0 && random_() < config_.burst_start) {
+            burst_ = true;
+        }
+    }
+
+    const float p = burst_ ? config_.burst_loss : config_.loss;
+
+    return p > 0 && random_() < p;
+}
+
+// Returns time when the packet leaves the link, or -1 if it's dropped.
+core::nanoseconds_t Impairer::transmit_(const Packet& packet) {
+    if (config_.rate == 0) {
+        return now_;
+    }
+
+    const core::nanoseconds_t start = link_free_ > now_ ? link_free_ : now_;
+
+    if (config_.max_queue_delay > 0 && start - now_ > config_.max_queue_delay) {
+        return -1;
+    }
+
+    link_free_ = start
+        + core::nanoseconds_t(packet.data().size()) * core::Second
+            / core::nanoseconds_t(config_.rate);
+
+    return link_free_;
+}
+
+core::nanoseconds_t Impairer::delay_() {
+    if (config_.jitter == 0) {
+        return 0;
+    }
+
+    return core::nanoseconds_t(double(random_()) * config_.jitter);
+}
+
+void Impairer::schedule_(const PacketPtr& packet, core::nanoseconds_t deadline) {
+    if (heap_.size() == heap_.max_size()) {
+        if (!heap_.grow(heap_.max_size() * 2)) {
+            roc_log(LogError, "impairer: can't grow queue, dropping packet");
+            stats_.n_dropped++;
+            return;
+        }
+    }
+
+    Entry entry;
+    entry.packet = packet;
+    entry.deadline = deadline;
+    entry.seqnum = seqnum_++;
+
+    heap_push_(entry);
+}
+
+void Impairer::deliver_(core::nanoseconds_t deadline) {
+    while (heap_.size() != 0 && heap_[0].deadline <= deadline) {
+        PacketPtr pp = heap_[0].packet;
+        heap_pop_();
+
+        stats_.n_delivered++;
+        writer_.write(pp);
+    }
+}
+
+PacketPtr Impairer::copy_(const Packet& packet) {
+    PacketPtr pp = new (pool_) Packet(pool_);
+    if (!pp) {
+        return NULL;
+    }
+
+    if (packet.udp()) {
+        pp->add_flags(Packet::FlagUDP);
+        pp->udp()->src_addr = packet.udp()->src_addr;
+        pp->udp()->dst_addr = packet.udp()->dst_addr;
+        pp->udp()->receive_timestamp = packet.udp()->receive_timestamp;
+    }
+
+    pp->set_data(packet.data());
+
+    return pp;
+}
+
+// Packets with equal deadlines are delivered in the order they were written.
+bool Impairer::before_(const Entry& a, const Entry& b) {
+    if (a.deadline != b.deadline) {
+        return a.deadline < b.deadline;
+    }
+    return int32_t(a.seqnum - b.seqnum) < 0;
+}
+
+void Impairer::heap_push_(const Entry& entry) {
+    heap_.push_back(entry);
+
+    size_t pos = heap_.size() - 1;
+
+    while (pos > 0) {
+        const size_t parent = (pos - 1) / 2;
+        if (!before_(heap_[pos], heap_[parent])) {
+            break;
+        }
+
+        const Entry tmp = heap_[pos];
+        heap_[pos] = heap_[parent];
+        heap_[parent] = tmp;
+
+        pos = parent;
+    }
+}
+
+void Impairer::heap_pop_() {
+    const size_t last = heap_.size() - 1;
+
+    heap_[0] = heap_[last];
+    heap_.resize(last);
+
+    size_t pos = 0;
+
+    for (;;) {
+        const size_t left = pos * 2 + 1;
+        const size_t right = left + 1;
+
+        size_t best = pos;
+        if (left < heap_.size() && before_(heap_[left], heap_[best])) {
+            best = left;
+        }
+        if (right < heap_.size() && before_(heap_[right], heap_[best])) {
+            best = right;
+        }
+        if (best == pos) {
+            break;
+        }
+
+        const Entry tmp = heap_[pos];
+        heap_[pos] = heap_[best];
+        heap_[best] = tmp;
+
+        pos = best;
+    }
+}
+
+// Xorshift generator, so that results depend only on the seed.
+float Impairer::random_() {
+    rand_ ^= rand_ << 13;
+    rand_ ^= rand_ >> 17;
+    rand_ ^= rand_ << 5;
+
+    return float(rand_ >> 8) / float(1 << 24);
+}
+
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/impairer.h
+//! @brief Network impairment simulator.
+
+#ifndef ROC_PACKET_IMPAIRER_H_
+#define ROC_PACKET_IMPAIRER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/time.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet_pool.h"
+
+namespace roc {
+namespace packet {
+
+//! Impairer parameters.
+//! @remarks
+//!  Losses follow the Gilbert-Elliott model. The link is either in good or in
+//!  bad state, and the state may change before every packet. Every packet is
+//!  lost with a probability that depends on the state. With zero burst_start,
+//!  the link always stays in good state, which gives the Bernoulli model.
+struct ImpairerConfig {
+    //! Seed for random number generator.
+    //! @remarks
+    //!  Impairer with the same seed and input always produces the same output.
+    unsigned seed;
+
+    //! Packet loss probability in good state, from 0 to 1.
+    float loss;
+
+    //! Probability of transition from good to bad state, from 0 to 1.
+    float burst_start;
+
+    //! Probability of transition from bad to good state, from 0 to 1.
+    //! @remarks
+    //!  Average burst length is 1 / burst_end packets.
+    float burst_end;
+
+    //! Packet loss probability in bad state, from 0 to 1.
+    float burst_loss;
+
+    //! Packet duplication probability, from 0 to 1.
+    //! @remarks
+    //!  Duplicate gets its own jitter delay.
+    float duplication;
+
+    //! Maximum jitter, nanoseconds.
+    //! @remarks
+    //!  Every packet is delayed by a random value from zero to jitter.
+    core::nanoseconds_t jitter;
+
+    //! Allow reordering.
+    //! @remarks
+    //!  If false, a packet is never delivered before the previous one, so that
+    //!  jitter only causes delay bursts.
+    bool reordering;
+
+    //! Link rate, bytes per second.
+    //! @remarks
+    //!  If non-zero, packets are serialized over a link of this rate and wait
+    //!  in a queue while the link is busy. Set to zero to disable.
+    size_t rate;
+
+    //! Maximum queueing delay, nanoseconds.
+    //! @remarks
+    //!  If the link is rate limited, packets that would wait in the queue
+    //!  longer are dropped. Set to zero for unlimited queue.
+    core::nanoseconds_t max_queue_delay;
+
+    //! Take current time from the system clock.
+    //! @remarks
+    //!  If true, every write() first advances time to core::timestamp(), so
+    //!  that delayed packets are delivered during subsequent writes. If false,
+    //!  time is changed only by advance(). In both cases, delayed packets are
+    //!  delivered only from write() and advance(), so the user should call
+    //!  advance() periodically to deliver them on time.
+    bool realtime;
+
+    //! Initialize config with default values.
+    ImpairerConfig()
+        : seed(0)
+        , loss(0)
+        , burst_start(0)
+        , burst_end(1)
+        , burst_loss(1)
+        , duplication(0)
+        , jitter(0)
+        , reordering(false)
+        , rate(0)
+        , max_queue_delay(0)
+        , realtime(false) {
+    }
+};
+
+//! Impairer statistics.
+struct ImpairerStats {
+    //! Number of written packets.
+    size_t n_written;
+
+    //! Number of packets lost according to the loss model.
+    size_t n_lost;
+
+    //! Number of packets dropped because of queue overflow.
+    size_t n_dropped;
+
+    //! Number of added duplicates.
+    size_t n_duplicated;
+
+    //! Number of packets delivered to the next writer.
+    size_t n_delivered;
+
+    ImpairerStats()
+        : n_written(0)
+        , n_lost(0)
+        , n_dropped(0)
+        , n_duplicated(0)
+        , n_delivered(0) {
+    }
+};
+
+//! Network impairment simulator.
+//! @remarks
+//!  Passes packets to the next writer, applying packet losses, duplication,
+//!  rate limit and jitter, which may reorder packets. Delayed packets are kept
+//!  until advance() is called with a time after their delivery time. Methods
+//!  may be called from different threads, e.g. advance() may be called from a
+//!  timer thread while packets are written from the pipeline thread.
+class Impairer : public IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  Duplicates are allocated from @p pool and share data with the original
+    //!  packet.
+    Impairer(IWriter& writer,
+             PacketPool& pool,
+             const ImpairerConfig& config,
+             core::IAllocator& allocator);
+
+    //! Check if the object was successfully constructed.
+    bool valid() const;
+
+    //! Write packet.
+    //! @remarks
+    //!  Packet is scheduled for delivery relative to the current time. Packets
+    //!  that are not delayed are delivered immediately.
+    virtual void write(const PacketPtr& packet);
+
+    //! Advance current time and deliver all packets which are due.
+    //! @remarks
+    //!  Time should not decrease.
+    void advance(core::nanoseconds_t now);
+
+    //! Deliver all pending packets regardless of their delivery time.
+    void flush();
+
+    //! Get number of pending packets.
+    size_t num_pending() const;
+
+    //! Get statistics.
+    ImpairerStats stats() const;
+
+private:
+    struct Entry {
+        PacketPtr packet;
+        core::nanoseconds_t deadline;
+        uint32_t seqnum;
+    };
+
+    void advance_(core::nanoseconds_t now);
+
+    bool lose_();
+    core::nanoseconds_t transmit_(const Packet& packet);
+    core::nanoseconds_t delay_();
+    void schedule_(const PacketPtr& packet, core::nanoseconds_t deadline);
+    void deliver_(core::nanoseconds_t deadline);
+    PacketPtr copy_(const Packet& packet);
+
+    static bool before_(const Entry& a, const Entry& b);
+    void heap_push_(const Entry& entry);
+    void heap_pop_();
+
+    float random_();
+
+    IWriter& writer_;
+    PacketPool& pool_;
+
+    const ImpairerConfig config_;
+
+    core::Array<Entry> heap_;
+
+    core::nanoseconds_t now_;
+    core::nanoseconds_t link_free_;
+    core::nanoseconds_t last_deadline_;
+
+    uint32_t seqnum_;
+    uint32_t rand_;
+    bool burst_;
+
+    ImpairerStats stats_;
+
+    core::Mutex mutex_;
+
+    bool valid_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_IMPAIRER_H_
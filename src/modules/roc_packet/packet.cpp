@@ -14,7 +14,8 @@ namespace packet {
 
 Packet::Packet(PacketPool& pool)
     : pool_(pool)
-    , flags_(0) {
+    , flags_(0)
+    , has_buffer_(false) {
 }
 
 void Packet::add_flags(unsigned fl) {
@@ -84,6 +85,20 @@ void Packet::set_data(const core::Slice<uint8_t>& d) {
     data_ = d;
 }
 
+core::Slice<uint8_t> Packet::alloc_buffer(core::BufferPool<uint8_t>& buffer_pool) {
+    if (pool_.payload_size() >= buffer_pool.buffer_size()) {
+        if (has_buffer_) {
+            roc_panic("packet: can't allocate co-allocated buffer more than once");
+        }
+        if (core::Buffer<uint8_t>* buffer = pool_.make_buffer_(*this)) {
+            has_buffer_ = true;
+            return buffer;
+        }
+    }
+
+    return new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+}
+
 source_t Packet::source() const {
     if (const RTP* r = rtp()) {
         return r->source;
@@ -12,6 +12,7 @@
 #ifndef ROC_PACKET_PACKET_H_
 #define ROC_PACKET_PACKET_H_
 
+#include "roc_core/buffer_pool.h"
 #include "roc_core/helpers.h"
 #include "roc_core/list_node.h"
 #include "roc_core/pool.h"
@@ -45,7 +46,8 @@ public:
         FlagAudio = (1 << 3),    //!< Packet contains audio samples.
         FlagRepair = (1 << 4),   //!< Packet contains repair FEC symbols.
         FlagComposed = (1 << 5), //!< Packet is already composed.
-        FlagRestored = (1 << 6)  //!< Packet was restored using FEC decoder.
+        FlagRestored = (1 << 6), //!< Packet was restored using FEC decoder.
+        FlagRTCP = (1 << 7)      //!< Packet contains RTCP compound packet.
     };
 
     //! Add flags.
@@ -78,6 +80,16 @@ public:
     //! Set packet data.
     void set_data(const core::Slice<uint8_t>& data);
 
+    //! Allocate buffer for packet data.
+    //! @remarks
+    //!  If the packet pool provides co-allocated payload storage not smaller than
+    //!  buffers from @p buffer_pool, returns it and doesn't allocate anything.
+    //!  Otherwise, allocates a new buffer from @p buffer_pool. Doesn't set packet
+    //!  data; the caller should call set_data() when the data is filled.
+    //! @returns
+    //!  slice covering the whole buffer, or empty slice if allocation failed.
+    core::Slice<uint8_t> alloc_buffer(core::BufferPool<uint8_t>& buffer_pool);
+
     //! Return packet stream identifier.
     //! @remarks
     //!  The returning value depends on packet type. For some packet types, may
@@ -115,18 +127,23 @@ public:
 
 private:
     friend class core::RefCnt<Packet>;
+    friend class PacketPool;
 
     void destroy();
 
     PacketPool& pool_;
 
     unsigned flags_;
+    bool has_buffer_;
 
-    UDP udp_;
+    // fields used on every pipeline stage go first, so that they share
+    // cache lines with the reference counter and list node
     RTP rtp_;
+    core::Slice<uint8_t> data_;
     FEC fec_;
 
-    core::Slice<uint8_t> data_;
+    // large and used only by network ports
+    UDP udp_;
 };
 
 } // namespace packet
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_packet/packet_pool.h"
+#include "roc_core/alignment.h"
+#include "roc_core/atomic.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+// Element layout: [Packet] [reference counter] [Buffer header] [payload].
+// The counter is shared by the packet and the buffer and lives outside both,
+// so that it survives destruction of whichever of them is destroyed first.
+
+size_t counter_offset() {
+    return core::max_align(sizeof(Packet));
+}
+
+size_t buffer_offset() {
+    return counter_offset() + core::max_align(sizeof(core::Atomic));
+}
+
+core::Atomic& element_counter(void* element) {
+    return *(core::Atomic*)((char*)element + counter_offset());
+}
+
+} // namespace
+
+PacketPool::PacketPool(core::IAllocator& allocator, bool poison, size_t payload_size)
+    : core::Pool<Packet>(allocator, element_size_(payload_size), poison)
+    , payload_size_(payload_size)
+    , buffer_owner_(*this)
+    , buffer_pool_(payload_size, buffer_owner_) {
+}
+
+size_t PacketPool::payload_size() const {
+    return payload_size_;
+}
+
+void PacketPool::destroy(Packet& packet) {
+    if (!packet.has_buffer_) {
+        core::Pool<Packet>::destroy(packet);
+        return;
+    }
+
+    // may also destroy the buffer if the packet holds the last reference to it
+    packet.~Packet();
+
+    release_(&packet);
+}
+
+size_t PacketPool::element_size_(size_t payload_size) {
+    if (payload_size == 0) {
+        return sizeof(Packet);
+    }
+    return buffer_offset() + sizeof(core::Buffer<uint8_t>) + payload_size;
+}
+
+core::Buffer<uint8_t>* PacketPool::make_buffer_(Packet& packet) {
+    roc_panic_if(&packet.pool_ != this);
+
+    if (payload_size_ == 0) {
+        return NULL;
+    }
+
+    // one reference for the packet and one for the buffer
+    new (&element_counter(&packet)) core::Atomic(2);
+
+    void* memory = (char*)&packet + buffer_offset();
+    return new (memory) core::Buffer<uint8_t>(buffer_pool_);
+}
+
+void PacketPool::release_(void* element) {
+    core::Atomic& counter = element_counter(element);
+
+    if (--counter == 0) {
+        counter.~Atomic();
+        deallocate(element);
+    }
+}
+
+PacketPool::BufferOwner::BufferOwner(PacketPool& pool)
+    : pool_(pool) {
+}
+
+void* PacketPool::BufferOwner::allocate(size_t) {
+    roc_panic("packet pool: embedded buffers can't be allocated separately");
+}
+
+void PacketPool::BufferOwner::deallocate(void* memory) {
+    pool_.release_((char*)memory - buffer_offset());
+}
+
+} // namespace packet
+} // namespace roc
@@ -12,6 +12,9 @@
 #ifndef ROC_PACKET_PACKET_POOL_H_
 #define ROC_PACKET_PACKET_POOL_H_
 
+#include "roc_core/buffer.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/iallocator.h"
 #include "roc_core/pool.h"
 #include "roc_packet/packet.h"
 
@@ -19,12 +22,47 @@ namespace roc {
 namespace packet {
 
 //! Packet pool.
+//! @remarks
+//!  If @p payload_size is non-zero, every pool element has room for a packet and
+//!  a payload buffer of @p payload_size bytes, so that a packet and its data are
+//!  allocated at once. See Packet::alloc_buffer(). The element is returned to the
+//!  pool when both the packet and the buffer are destroyed.
 class PacketPool : public core::Pool<Packet> {
 public:
     //! Constructor.
-    PacketPool(core::IAllocator& allocator, bool poison)
-        : core::Pool<Packet>(allocator, sizeof(Packet), poison) {
-    }
+    PacketPool(core::IAllocator& allocator, bool poison, size_t payload_size = 0);
+
+    //! Get size of payload buffer co-allocated with every packet.
+    //! @returns
+    //!  zero if packets don't have co-allocated buffers.
+    size_t payload_size() const;
+
+    //! Destroy packet and deallocate its memory.
+    void destroy(Packet& packet);
+
+private:
+    friend class Packet;
+
+    class BufferOwner : public core::IAllocator {
+    public:
+        explicit BufferOwner(PacketPool& pool);
+
+        virtual void* allocate(size_t size);
+        virtual void deallocate(void* memory);
+
+    private:
+        PacketPool& pool_;
+    };
+
+    static size_t element_size_(size_t payload_size);
+
+    core::Buffer<uint8_t>* make_buffer_(Packet& packet);
+    void release_(void* element);
+
+    const size_t payload_size_;
+
+    BufferOwner buffer_owner_;
+    core::BufferPool<uint8_t> buffer_pool_;
 };
 
 } // namespace packet
@@ -9,6 +9,7 @@
 #include "roc_packet/router.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/trace.h"
 
 namespace roc {
 namespace packet {
@@ -46,6 +47,8 @@ bool Router::add_route(IWriter& writer, unsigned flags) {
 }
 
 void Router::write(const PacketPtr& packet) {
+    roc_trace_scope("router.write");
+
     roc_panic_if_not(valid());
 
     if (!packet) {
@@ -13,9 +13,9 @@ namespace packet {
 
 RTP::RTP()
     : source(0)
-    , seqnum(0)
     , timestamp(0)
     , duration(0)
+    , seqnum(0)
     , marker(false)
     , payload_type(0) {
 }
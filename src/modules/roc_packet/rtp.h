@@ -27,12 +27,6 @@ struct RTP {
     //!  different packet streams.
     source_t source;
 
-    //! Packet sequence number in packet stream.
-    //! @remarks
-    //!  Packets are numbered sequentaly in every stream, starting from some
-    //!  random value. May overflow.
-    seqnum_t seqnum;
-
     //! Packet timestamp.
     //! @remarks
     //!  Timestamp units and exact meaning depends on packet type. For example,
@@ -45,6 +39,12 @@ struct RTP {
     //!  Duration is measured in the same units as timestamp.
     timestamp_t duration;
 
+    //! Packet sequence number in packet stream.
+    //! @remarks
+    //!  Packets are numbered sequentaly in every stream, starting from some
+    //!  random value. May overflow.
+    seqnum_t seqnum;
+
     //! Packet marker bit.
     //! @remarks
     //!  Marker bit meaning depends on packet type.
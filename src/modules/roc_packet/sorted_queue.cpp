@@ -14,7 +14,9 @@ namespace roc {
 namespace packet {
 
 SortedQueue::SortedQueue(size_t max_size)
-    : max_size_(max_size) {
+    : max_size_(max_size)
+    , num_dropped_(0)
+    , num_duplicates_(0) {
 }
 
 PacketPtr SortedQueue::read() {
@@ -36,6 +38,7 @@ void SortedQueue::write(const PacketPtr& packet) {
                 "sorted queue: queue is full, dropping packet:"
                 " max_size=%u",
                 (unsigned)max_size_);
+        num_dropped_++;
         return;
     }
 
@@ -54,6 +57,7 @@ void SortedQueue::write(const PacketPtr& packet) {
 
         if (cmp == 0) {
             roc_log(LogDebug, "sorted queue: dropping duplicate packet");
+            num_duplicates_++;
             return;
         }
 
@@ -83,5 +87,13 @@ PacketPtr SortedQueue::latest() const {
     return latest_;
 }
 
+size_t SortedQueue::num_dropped() const {
+    return num_dropped_;
+}
+
+size_t SortedQueue::num_duplicates() const {
+    return num_duplicates_;
+}
+
 } // namespace packet
 } // namespace roc
@@ -69,10 +69,19 @@ public:
     //!  in the queue. Returned packet is not removed from the queue.
     PacketPtr latest() const;
 
+    //! Get number of packets dropped because the queue was full.
+    size_t num_dropped() const;
+
+    //! Get number of packets dropped because they were duplicates.
+    size_t num_duplicates() const;
+
 private:
     core::List<Packet> list_;
     PacketPtr latest_;
     const size_t max_size_;
+
+    size_t num_dropped_;
+    size_t num_duplicates_;
 };
 
 } // namespace packet
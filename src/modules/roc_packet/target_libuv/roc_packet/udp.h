@@ -16,6 +16,7 @@
 
 #include "roc_core/slice.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/time.h"
 #include "roc_packet/address.h"
 
 namespace roc {
@@ -29,8 +30,18 @@ struct UDP {
     //! Destination address.
     Address dst_addr;
 
+    //! Packet receive time, nanoseconds.
+    //! @remarks
+    //!  Set by receiver to core::timestamp() when the packet is received.
+    //!  Zero for outgoing packets.
+    core::nanoseconds_t receive_timestamp;
+
     //! Sender request state.
     uv_udp_send_t request;
+
+    UDP()
+        : receive_timestamp(0) {
+    }
 };
 
 } // namespace packet
@@ -13,8 +13,12 @@
 namespace roc {
 namespace packet {
 
-Address::Address() {
+Address::Address()
+    : miface_family_(AF_UNSPEC)
+    , multicast_ttl_(-1)
+    , multicast_loop_(-1) {
     memset(&sa_, 0, sizeof(sa_));
+    memset(&miface_, 0, sizeof(miface_));
 }
 
 bool Address::valid() const {
@@ -124,6 +128,65 @@ bool Address::get_ip(char* buf, size_t bufsz) const {
     return true;
 }
 
+bool Address::set_miface(const char* ip_str) {
+    switch (family_()) {
+    case AF_INET:
+        if (inet_pton(AF_INET, ip_str, &miface_.addr4) != 1) {
+            return false;
+        }
+        break;
+
+    case AF_INET6:
+        if (inet_pton(AF_INET6, ip_str, &miface_.addr6) != 1) {
+            return false;
+        }
+        break;
+
+    default:
+        return false;
+    }
+
+    miface_family_ = family_();
+    return true;
+}
+
+bool Address::has_miface() const {
+    return miface_family_ != AF_UNSPEC && miface_family_ == family_();
+}
+
+bool Address::get_miface(char* buf, size_t bufsz) const {
+    if (!has_miface()) {
+        return false;
+    }
+
+    if (!inet_ntop(miface_family_, &miface_, buf, (socklen_t)bufsz)) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Address::set_multicast_ttl(int ttl) {
+    if (ttl < 0 || ttl > 255) {
+        return false;
+    }
+
+    multicast_ttl_ = ttl;
+    return true;
+}
+
+int Address::multicast_ttl() const {
+    return multicast_ttl_;
+}
+
+void Address::set_multicast_loop(bool enabled) {
+    multicast_loop_ = enabled ? 1 : 0;
+}
+
+int Address::multicast_loop() const {
+    return multicast_loop_;
+}
+
 bool Address::operator==(const Address& other) const {
     if (family_() != other.family_()) {
         return false;
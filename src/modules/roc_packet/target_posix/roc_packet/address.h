@@ -59,7 +59,43 @@ public:
     //! Get IP address.
     bool get_ip(char* buf, size_t bufsz) const;
 
+    //! Set multicast interface address.
+    //! @remarks
+    //!  @p ip should have the same family as the address itself, so this
+    //!  method should be called after the address is set. When the address
+    //!  is a multicast group used to bind a receiver, the group is joined on
+    //!  this interface. When the address is used to bind a sender, outgoing
+    //!  multicast packets are sent via this interface.
+    bool set_miface(const char* ip);
+
+    //! Check whether multicast interface address is set.
+    bool has_miface() const;
+
+    //! Get multicast interface address.
+    bool get_miface(char* buf, size_t bufsz) const;
+
+    //! Set TTL for outgoing multicast packets.
+    //! @remarks
+    //!  Should be in range [0; 255].
+    bool set_multicast_ttl(int ttl);
+
+    //! Get TTL for outgoing multicast packets.
+    //! @returns
+    //!  -1 if not set, in which case the OS default is used.
+    int multicast_ttl() const;
+
+    //! Enable or disable loopback of outgoing multicast packets.
+    void set_multicast_loop(bool enabled);
+
+    //! Get loopback mode for outgoing multicast packets.
+    //! @returns
+    //!  -1 if not set, in which case the OS default is used,
+    //!  and 0 or 1 otherwise.
+    int multicast_loop() const;
+
     //! Compare addresses.
+    //! @remarks
+    //!  Only IP and port are compared, multicast options are ignored.
     bool operator==(const Address& other) const;
 
     //! Compare addresses.
@@ -74,6 +110,16 @@ private:
         sockaddr_in addr4;
         sockaddr_in6 addr6;
     } sa_;
+
+    union {
+        in_addr addr4;
+        in6_addr addr6;
+    } miface_;
+
+    sa_family_t miface_family_;
+
+    int multicast_ttl_;
+    signed char multicast_loop_;
 };
 
 } // namespace packet
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/target_posix/roc_packet/pcap_format.h
+//! @brief Pcap file format constants.
+
+#ifndef ROC_PACKET_PCAP_FORMAT_H_
+#define ROC_PACKET_PCAP_FORMAT_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace packet {
+
+//! Pcap magic number, microsecond timestamps.
+const uint32_t PcapMagicMicro = 0xa1b2c3d4;
+
+//! Pcap magic number, nanosecond timestamps.
+const uint32_t PcapMagicNano = 0xa1b23c4d;
+
+//! Pcap link types.
+enum PcapLinkType {
+    PcapLinkEthernet = 1,   //!< Ethernet frames.
+    PcapLinkRaw = 101,      //!< Raw IPv4 or IPv6 datagrams.
+    PcapLinkLinuxSLL = 113, //!< Linux "cooked" capture.
+    PcapLinkIPv4 = 228,     //!< Raw IPv4 datagrams.
+    PcapLinkIPv6 = 229      //!< Raw IPv6 datagrams.
+};
+
+//! Pcap sizes.
+enum {
+    PcapFileHeaderSize = 24,   //!< Size of file header.
+    PcapRecordHeaderSize = 16, //!< Size of record header.
+    PcapSnapLen = 65535,       //!< Maximum size of captured record.
+    PcapIPv4HeaderSize = 20,   //!< Size of IPv4 header without options.
+    PcapIPv6HeaderSize = 40,   //!< Size of IPv6 header.
+    PcapUDPHeaderSize = 8      //!< Size of UDP header.
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_PCAP_FORMAT_H_
@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <netinet/in.h>
+
+#include "roc_packet/pcap_reader.h"
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_packet/pcap_format.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum {
+    EthernetHeaderSize = 14,
+    VlanTagSize = 4,
+    LinuxSLLHeaderSize = 16,
+
+    EtherTypeIPv4 = 0x0800,
+    EtherTypeIPv6 = 0x86DD,
+    EtherTypeVlan = 0x8100
+};
+
+uint16_t get16_be(const uint8_t* p) {
+    return uint16_t((p[0] << 8) | p[1]);
+}
+
+uint32_t swap32(uint32_t v) {
+    return ((v & 0xff) << 24) | ((v & 0xff00) << 8) | ((v >> 8) & 0xff00) | (v >> 24);
+}
+
+} // namespace
+
+PcapReader::PcapReader(PacketPool& packet_pool, core::BufferPool<uint8_t>& buffer_pool)
+    : packet_pool_(packet_pool)
+    , buffer_pool_(buffer_pool)
+    , file_(NULL)
+    , swapped_(false)
+    , nanosec_(false)
+    , link_type_(0) {
+}
+
+PcapReader::~PcapReader() {
+    if (file_) {
+        fclose(file_);
+    }
+}
+
+bool PcapReader::open(const char* path) {
+    if (file_) {
+        roc_panic("pcap reader: can't call open() more than once");
+    }
+
+    if (!(file_ = fopen(path, "rb"))) {
+        roc_log(LogError, "pcap reader: can't open %s: %s", path,
+                core::errno_to_str().c_str());
+        return false;
+    }
+
+    uint8_t hdr[PcapFileHeaderSize];
+    if (fread(hdr, sizeof(hdr), 1, file_) != 1) {
+        roc_log(LogError, "pcap reader: can't read header from %s", path);
+        return false;
+    }
+
+    uint32_t magic = 0;
+    memcpy(&magic, hdr, sizeof(magic));
+
+    if (magic == PcapMagicMicro || magic == PcapMagicNano) {
+        swapped_ = false;
+    } else if (swap32(magic) == PcapMagicMicro || swap32(magic) == PcapMagicNano) {
+        swapped_ = true;
+        magic = swap32(magic);
+    } else {
+        roc_log(LogError, "pcap reader: unsupported file format in %s: magic=0x%08x",
+                path, (unsigned)magic);
+        return false;
+    }
+
+    nanosec_ = (magic == PcapMagicNano);
+    link_type_ = get32_(hdr + 20) & 0xffff;
+
+    switch (link_type_) {
+    case PcapLinkEthernet:
+    case PcapLinkRaw:
+    case PcapLinkLinuxSLL:
+    case PcapLinkIPv4:
+    case PcapLinkIPv6:
+        break;
+    default:
+        roc_log(LogError, "pcap reader: unsupported link type in %s: %u", path,
+                (unsigned)link_type_);
+        return false;
+    }
+
+    roc_log(LogDebug, "pcap reader: opened %s: link_type=%u nanosec=%d swapped=%d",
+            path, (unsigned)link_type_, (int)nanosec_, (int)swapped_);
+
+    return true;
+}
+
+PacketPtr PcapReader::read() {
+    roc_panic_if(!file_);
+
+    for (;;) {
+        core::nanoseconds_t ts = 0;
+        size_t size = 0;
+
+        if (!read_record_(ts, size)) {
+            return NULL;
+        }
+
+        PacketPtr pp = new (packet_pool_) Packet(packet_pool_);
+        if (!pp) {
+            roc_log(LogError, "pcap reader: can't allocate packet");
+            return NULL;
+        }
+
+        core::Slice<uint8_t> buffer = pp->alloc_buffer(buffer_pool_);
+        if (!buffer) {
+            roc_log(LogError, "pcap reader: can't allocate buffer");
+            return NULL;
+        }
+
+        if (size > buffer.size()) {
+            roc_log(LogDebug,
+                    "pcap reader: record is too large, skipping: size=%lu max=%lu",
+                    (unsigned long)size, (unsigned long)buffer.size());
+            if (fseek(file_, (long)size, SEEK_CUR) != 0) {
+                return NULL;
+            }
+            continue;
+        }
+
+        buffer = buffer.range(0, size);
+
+        if (size != 0 && fread(buffer.data(), size, 1, file_) != 1) {
+            roc_log(LogDebug, "pcap reader: truncated record at end of file");
+            return NULL;
+        }
+
+        if (!parse_packet_(*pp, buffer)) {
+            continue;
+        }
+
+        pp->udp()->receive_timestamp = ts;
+
+        return pp;
+    }
+}
+
+uint32_t PcapReader::get32_(const uint8_t* p) const {
+    uint32_t v = 0;
+    memcpy(&v, p, sizeof(v));
+    return swapped_ ? swap32(v) : v;
+}
+
+bool PcapReader::read_record_(core::nanoseconds_t& ts, size_t& size) {
+    uint8_t hdr[PcapRecordHeaderSize];
+
+    if (fread(hdr, sizeof(hdr), 1, file_) != 1) {
+        if (ferror(file_)) {
+            roc_log(LogError, "pcap reader: can't read record: %s",
+                    core::errno_to_str().c_str());
+        }
+        return false;
+    }
+
+    const core::nanoseconds_t sec = get32_(hdr);
+    const core::nanoseconds_t frac = get32_(hdr + 4);
+
+    ts = sec * core::Second + (nanosec_ ? frac : frac * core::Microsecond);
+    size = get32_(hdr + 8);
+
+    return true;
+}
+
+bool PcapReader::parse_packet_(Packet& packet,
+                               const core::Slice<uint8_t>& buffer) const {
+    const uint8_t* data = buffer.data();
+    const size_t size = buffer.size();
+
+    size_t off = 0;
+    unsigned ether_type = 0;
+
+    switch (link_type_) {
+    case PcapLinkEthernet:
+        if (size < EthernetHeaderSize) {
+            return false;
+        }
+        ether_type = get16_be(data + 12);
+        off = EthernetHeaderSize;
+        if (ether_type == EtherTypeVlan) {
+            if (size < EthernetHeaderSize + VlanTagSize) {
+                return false;
+            }
+            ether_type = get16_be(data + 16);
+            off += VlanTagSize;
+        }
+        if (ether_type != EtherTypeIPv4 && ether_type != EtherTypeIPv6) {
+            return false;
+        }
+        break;
+
+    case PcapLinkLinuxSLL:
+        if (size < LinuxSLLHeaderSize) {
+            return false;
+        }
+        ether_type = get16_be(data + 14);
+        if (ether_type != EtherTypeIPv4 && ether_type != EtherTypeIPv6) {
+            return false;
+        }
+        off = LinuxSLLHeaderSize;
+        break;
+
+    default:
+        break;
+    }
+
+    if (off >= size) {
+        return false;
+    }
+
+    const uint8_t* ip = data + off;
+    const size_t ip_avail = size - off;
+
+    const int version = ip[0] >> 4;
+    size_t udp_off = 0;
+
+    if (version == 4) {
+        if (ip_avail < PcapIPv4HeaderSize) {
+            return false;
+        }
+        const size_t ihl = size_t(ip[0] & 0xf) * 4;
+        if (ihl < PcapIPv4HeaderSize || ihl > ip_avail) {
+            return false;
+        }
+        if (ip[9] != IPPROTO_UDP) {
+            return false;
+        }
+        // skip fragments, they can't be reassembled here
+        if ((get16_be(ip + 6) & 0x3fff) != 0) {
+            return false;
+        }
+        udp_off = off + ihl;
+    } else if (version == 6) {
+        if (ip_avail < PcapIPv6HeaderSize) {
+            return false;
+        }
+        // extension headers are not supported
+        if (ip[6] != IPPROTO_UDP) {
+            return false;
+        }
+        udp_off = off + PcapIPv6HeaderSize;
+    } else {
+        return false;
+    }
+
+    if (size - udp_off < PcapUDPHeaderSize) {
+        return false;
+    }
+
+    const uint8_t* uh = data + udp_off;
+
+    const size_t payload_off = udp_off + PcapUDPHeaderSize;
+    size_t payload_end = udp_off + get16_be(uh + 4);
+
+    if (payload_end < payload_off) {
+        return false;
+    }
+    if (payload_end > size) {
+        payload_end = size;
+    }
+
+    Address src_addr;
+    Address dst_addr;
+
+    if (version == 4) {
+        sockaddr_in sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sin_family = AF_INET;
+
+        memcpy(&sa.sin_addr, ip + 12, 4);
+        memcpy(&sa.sin_port, uh, 2);
+        src_addr.set_saddr((const sockaddr*)&sa);
+
+        memcpy(&sa.sin_addr, ip + 16, 4);
+        memcpy(&sa.sin_port, uh + 2, 2);
+        dst_addr.set_saddr((const sockaddr*)&sa);
+    } else {
+        sockaddr_in6 sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sin6_family = AF_INET6;
+
+        memcpy(&sa.sin6_addr, ip + 8, 16);
+        memcpy(&sa.sin6_port, uh, 2);
+        src_addr.set_saddr((const sockaddr*)&sa);
+
+        memcpy(&sa.sin6_addr, ip + 24, 16);
+        memcpy(&sa.sin6_port, uh + 2, 2);
+        dst_addr.set_saddr((const sockaddr*)&sa);
+    }
+
+    packet.add_flags(Packet::FlagUDP);
+
+    packet.udp()->src_addr = src_addr;
+    packet.udp()->dst_addr = dst_addr;
+
+    packet.set_data(buffer.range(payload_off, payload_end));
+
+    return true;
+}
+
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/target_posix/roc_packet/pcap_reader.h
+//! @brief Pcap reader.
+
+#ifndef ROC_PACKET_PCAP_READER_H_
+#define ROC_PACKET_PCAP_READER_H_
+
+#include <stdio.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_packet/ireader.h"
+#include "roc_packet/packet_pool.h"
+
+namespace roc {
+namespace packet {
+
+//! Pcap reader.
+//! @remarks
+//!  Reads UDP packets from a pcap file, e.g. recorded by PcapWriter or by
+//!  tcpdump. Supports microsecond and nanosecond timestamps, both byte orders,
+//!  and raw IP, Ethernet and Linux "cooked" link types. Records that are not
+//!  unfragmented UDP datagrams are skipped. Returned packets have UDP part with
+//!  source and destination addresses and receive timestamp set from the record.
+class PcapReader : public IReader, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    PcapReader(PacketPool& packet_pool, core::BufferPool<uint8_t>& buffer_pool);
+
+    ~PcapReader();
+
+    //! Open file and read pcap header.
+    bool open(const char* path);
+
+    //! Read next packet.
+    //! @returns
+    //!  next UDP packet or NULL if the end of file is reached or an error
+    //!  occurred.
+    virtual PacketPtr read();
+
+private:
+    uint32_t get32_(const uint8_t* p) const;
+
+    bool read_record_(core::nanoseconds_t& ts, size_t& size);
+    bool parse_packet_(Packet& packet, const core::Slice<uint8_t>& buffer) const;
+
+    PacketPool& packet_pool_;
+    core::BufferPool<uint8_t>& buffer_pool_;
+
+    FILE* file_;
+
+    bool swapped_;
+    bool nanosec_;
+    uint32_t link_type_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_PCAP_READER_H_
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <netinet/in.h>
+
+#include "roc_packet/pcap_writer.h"
+#include "roc_core/endian.h"
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/time.h"
+#include "roc_packet/pcap_format.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { MaxHeaderSize = PcapRecordHeaderSize + PcapIPv6HeaderSize + PcapUDPHeaderSize };
+
+void put16(uint8_t* p, uint16_t v) {
+    v = core::hton16(v);
+    memcpy(p, &v, sizeof(v));
+}
+
+// Record and file headers are written in host byte order, as required by pcap.
+void put32_host(uint8_t* p, uint32_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+void put16_host(uint8_t* p, uint16_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+uint16_t ipv4_checksum(const uint8_t* hdr) {
+    uint32_t sum = 0;
+    for (size_t n = 0; n < PcapIPv4HeaderSize; n += 2) {
+        sum += uint32_t(hdr[n] << 8) | hdr[n + 1];
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return uint16_t(~sum);
+}
+
+size_t write_ipv4(uint8_t* p, const sockaddr_in& src, const sockaddr_in& dst,
+                  size_t payload_size) {
+    memset(p, 0, PcapIPv4HeaderSize);
+
+    p[0] = 0x45; // version 4, header length 5 words
+    put16(p + 2, uint16_t(PcapIPv4HeaderSize + PcapUDPHeaderSize + payload_size));
+    put16(p + 6, 0x4000); // don't fragment
+    p[8] = 64;            // ttl
+    p[9] = IPPROTO_UDP;
+    memcpy(p + 12, &src.sin_addr, 4);
+    memcpy(p + 16, &dst.sin_addr, 4);
+    put16(p + 10, ipv4_checksum(p));
+
+    return PcapIPv4HeaderSize;
+}
+
+size_t write_ipv6(uint8_t* p, const sockaddr_in6& src, const sockaddr_in6& dst,
+                  size_t payload_size) {
+    memset(p, 0, PcapIPv6HeaderSize);
+
+    p[0] = 0x60; // version 6
+    put16(p + 4, uint16_t(PcapUDPHeaderSize + payload_size));
+    p[6] = IPPROTO_UDP;
+    p[7] = 64; // hop limit
+    memcpy(p + 8, &src.sin6_addr, 16);
+    memcpy(p + 24, &dst.sin6_addr, 16);
+
+    return PcapIPv6HeaderSize;
+}
+
+} // namespace
+
+PcapWriter::PcapWriter(IWriter& writer)
+    : writer_(writer)
+    , file_(NULL)
+    , n_packets_(0)
+    , failed_(false) {
+}
+
+PcapWriter::~PcapWriter() {
+    close_();
+}
+
+bool PcapWriter::open(const char* path) {
+    core::Mutex::Lock lock(mutex_);
+
+    if (file_) {
+        roc_panic("pcap writer: can't call open() more than once");
+    }
+
+    if (!(file_ = fopen(path, "wb"))) {
+        roc_log(LogError, "pcap writer: can't open %s: %s", path,
+                core::errno_to_str().c_str());
+        return false;
+    }
+
+    uint8_t hdr[PcapFileHeaderSize] = {};
+
+    put32_host(hdr, PcapMagicNano);
+    put16_host(hdr + 4, 2); // version major
+    put16_host(hdr + 6, 4); // version minor
+    put32_host(hdr + 16, PcapSnapLen);
+    put32_host(hdr + 20, PcapLinkRaw);
+
+    if (fwrite(hdr, sizeof(hdr), 1, file_) != 1) {
+        roc_log(LogError, "pcap writer: can't write header to %s: %s", path,
+                core::errno_to_str().c_str());
+        close_();
+        return false;
+    }
+
+    roc_log(LogInfo, "pcap writer: recording packets to %s", path);
+
+    return true;
+}
+
+void PcapWriter::write(const PacketPtr& packet) {
+    if (!packet) {
+        roc_panic("pcap writer: null packet");
+    }
+
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        if (file_ && !failed_ && packet->udp()) {
+            if (write_packet_(*packet)) {
+                n_packets_++;
+            } else {
+                failed_ = true;
+            }
+        }
+    }
+
+    writer_.write(packet);
+}
+
+size_t PcapWriter::num_packets() const {
+    core::Mutex::Lock lock(mutex_);
+
+    return n_packets_;
+}
+
+bool PcapWriter::write_packet_(const Packet& packet) {
+    const UDP& udp = *packet.udp();
+    const core::Slice<uint8_t>& data = packet.data();
+
+    if (data.size() > PcapSnapLen - MaxHeaderSize) {
+        roc_log(LogDebug, "pcap writer: packet is too large, skipping: size=%lu",
+                (unsigned long)data.size());
+        return true;
+    }
+
+    if (udp.src_addr.version() != udp.dst_addr.version()) {
+        roc_log(LogDebug,
+                "pcap writer: source and destination address families differ,"
+                " skipping packet");
+        return true;
+    }
+
+    uint8_t hdr[MaxHeaderSize];
+    uint8_t* ip = hdr + PcapRecordHeaderSize;
+    size_t ip_size = 0;
+
+    if (udp.src_addr.version() == 4) {
+        ip_size = write_ipv4(ip, *(const sockaddr_in*)udp.src_addr.saddr(),
+                             *(const sockaddr_in*)udp.dst_addr.saddr(), data.size());
+    } else if (udp.src_addr.version() == 6) {
+        ip_size = write_ipv6(ip, *(const sockaddr_in6*)udp.src_addr.saddr(),
+                             *(const sockaddr_in6*)udp.dst_addr.saddr(), data.size());
+    } else {
+        roc_log(LogDebug, "pcap writer: packet has no address, skipping");
+        return true;
+    }
+
+    uint8_t* uh = ip + ip_size;
+    put16(uh, uint16_t(udp.src_addr.port()));
+    put16(uh + 2, uint16_t(udp.dst_addr.port()));
+    put16(uh + 4, uint16_t(PcapUDPHeaderSize + data.size()));
+    put16(uh + 6, 0); // no checksum
+
+    const size_t rec_size = ip_size + PcapUDPHeaderSize + data.size();
+
+    core::nanoseconds_t ts = udp.receive_timestamp;
+    if (ts == 0) {
+        ts = core::timestamp();
+    }
+
+    put32_host(hdr, uint32_t(ts / core::Second));
+    put32_host(hdr + 4, uint32_t(ts % core::Second));
+    put32_host(hdr + 8, uint32_t(rec_size));
+    put32_host(hdr + 12, uint32_t(rec_size));
+
+    const size_t hdr_size = PcapRecordHeaderSize + ip_size + PcapUDPHeaderSize;
+
+    if (fwrite(hdr, hdr_size, 1, file_) != 1
+        || (data.size() != 0 && fwrite(data.data(), data.size(), 1, file_) != 1)) {
+        roc_log(LogError, "pcap writer: can't write packet, stopping recording: %s",
+                core::errno_to_str().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void PcapWriter::close_() {
+    if (!file_) {
+        return;
+    }
+
+    if (fclose(file_) != 0) {
+        roc_log(LogError, "pcap writer: fclose(): %s", core::errno_to_str().c_str());
+    }
+    file_ = NULL;
+
+    roc_log(LogDebug, "pcap writer: recorded %lu packets", (unsigned long)n_packets_);
+}
+
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/target_posix/roc_packet/pcap_writer.h
+//! @brief Pcap writer.
+
+#ifndef ROC_PACKET_PCAP_WRITER_H_
+#define ROC_PACKET_PCAP_WRITER_H_
+
+#include <stdio.h>
+
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_packet/iwriter.h"
+
+namespace roc {
+namespace packet {
+
+//! Pcap writer.
+//! @remarks
+//!  Records every UDP packet to a pcap file and passes it to the next writer.
+//!  Packets are stored as raw IPv4 or IPv6 datagrams with synthesized IP and
+//!  UDP headers and with their receive timestamps, so that the file can be
+//!  inspected with tcpdump or Wireshark and replayed with PcapReader.
+//!  Receive timestamps come from a monotonic clock, so only the intervals
+//!  between them are meaningful. May be used from multiple threads.
+class PcapWriter : public IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit PcapWriter(IWriter& writer);
+
+    ~PcapWriter();
+
+    //! Create file and write pcap header.
+    bool open(const char* path);
+
+    //! Record packet and pass it to the next writer.
+    //! @remarks
+    //!  Packets without UDP part are passed without recording.
+    virtual void write(const PacketPtr& packet);
+
+    //! Get number of recorded packets.
+    size_t num_packets() const;
+
+private:
+    bool write_packet_(const Packet& packet);
+    void close_();
+
+    IWriter& writer_;
+
+    FILE* file_;
+    size_t n_packets_;
+    bool failed_;
+
+    core::Mutex mutex_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_PCAP_WRITER_H_
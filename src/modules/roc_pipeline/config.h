@@ -17,6 +17,7 @@
 #include "roc_audio/watchdog.h"
 #include "roc_core/stddefs.h"
 #include "roc_core/time.h"
+#include "roc_fec/block_size_controller.h"
 #include "roc_fec/codec_config.h"
 #include "roc_fec/reader.h"
 #include "roc_fec/writer.h"
@@ -43,6 +44,33 @@ const core::nanoseconds_t DefaultLatency = 200 * core::Millisecond;
 //! Default internal frame size.
 const size_t DefaultInternalFrameSize = 640;
 
+//! Default number of internal frames per chunk in parallel conversion.
+const size_t DefaultConverterChunkFrames = 256;
+
+//! Default RTCP report interval.
+const core::nanoseconds_t DefaultReportInterval = core::Second;
+
+//! Default busy-wait interval before frame deadlines when frames are pushed by timer.
+const core::nanoseconds_t DefaultTimerSpinTime = 200 * core::Microsecond;
+
+//! Low-latency profile packet length.
+//! @remarks
+//!  Low-latency profile targets about 10ms end-to-end latency. Packets and
+//!  frames are small, and FEC blocks are short enough to be repaired in time.
+const core::nanoseconds_t LowLatencyPacketLength = 2 * core::Millisecond;
+
+//! Low-latency profile internal frame size, number of samples for all channels.
+const size_t LowLatencyInternalFrameSize = 128;
+
+//! Low-latency profile target latency.
+const core::nanoseconds_t LowLatencyTargetLatency = 10 * core::Millisecond;
+
+//! Low-latency profile number of source packets per FEC block.
+const size_t LowLatencyFecSourcePackets = 4;
+
+//! Low-latency profile number of repair packets per FEC block.
+const size_t LowLatencyFecRepairPackets = 2;
+
 //! Default minum latency relative to target latency.
 const int DefaultMinLatencyFactor = -1;
 
@@ -76,6 +104,10 @@ struct SenderConfig {
     //! FEC encoder parameters.
     fec::CodecConfig fec_encoder;
 
+    //! FEC block size controller parameters.
+    //! Used only when adaptive FEC is enabled.
+    fec::BlockSizeControllerConfig fec_controller;
+
     //! Number of samples per second per channel.
     size_t input_sample_rate;
 
@@ -88,6 +120,10 @@ struct SenderConfig {
     //! Packet length, in nanoseconds.
     core::nanoseconds_t packet_length;
 
+    //! RTCP sender report interval, in nanoseconds.
+    //! Used only if control port is set.
+    core::nanoseconds_t report_interval;
+
     //! RTP payload type for audio packets.
     rtp::PayloadType payload_type;
 
@@ -103,16 +139,21 @@ struct SenderConfig {
     //! Fill unitialized data with large values to make them more noticable.
     bool poisoning;
 
+    //! Adjust the number of FEC repair packets according to reported losses.
+    bool adaptive_fec;
+
     SenderConfig()
         : input_sample_rate(DefaultSampleRate)
         , input_channels(DefaultChannelMask)
         , internal_frame_size(DefaultInternalFrameSize)
         , packet_length(DefaultPacketLength)
+        , report_interval(DefaultReportInterval)
         , payload_type(rtp::PayloadType_L16_Stereo)
         , resampling(false)
         , interleaving(false)
         , timing(false)
-        , poisoning(false) {
+        , poisoning(false)
+        , adaptive_fec(false) {
     }
 };
 
@@ -169,12 +210,20 @@ struct ReceiverCommonConfig {
     //! Number of samples for internal frames.
     size_t internal_frame_size;
 
+    //! RTCP receiver report interval, in nanoseconds.
+    //! Used only if control writer is set.
+    core::nanoseconds_t report_interval;
+
     //! Perform resampling to compensate sender and receiver frequency difference.
     bool resampling;
 
     //! Constrain receiver speed using a CPU timer according to the sample rate.
     bool timing;
 
+    //! Busy-wait interval before every frame deadline, in nanoseconds.
+    //! Used when frames are pushed to the user from a timer thread.
+    core::nanoseconds_t timer_spin_time;
+
     //! Fill uninitialized data with large values to make them more noticeable.
     bool poisoning;
 
@@ -185,8 +234,10 @@ struct ReceiverCommonConfig {
         : output_sample_rate(DefaultSampleRate)
         , output_channels(DefaultChannelMask)
         , internal_frame_size(DefaultInternalFrameSize)
+        , report_interval(DefaultReportInterval)
         , resampling(false)
         , timing(false)
+        , timer_spin_time(DefaultTimerSpinTime)
         , poisoning(false)
         , beeping(false) {
     }
@@ -227,6 +278,15 @@ struct ConverterConfig {
     //! Fill unitialized data with large values to make them more noticable.
     bool poisoning;
 
+    //! Number of resampling threads for parallel conversion.
+    size_t num_threads;
+
+    //! Number of internal frames per chunk for parallel conversion.
+    //! @remarks
+    //!  Every chunk is resampled by one thread and additionally holds two
+    //!  frames of the next chunk needed for the resampler window.
+    size_t chunk_frames;
+
     ConverterConfig()
         : input_sample_rate(DefaultSampleRate)
         , output_sample_rate(DefaultSampleRate)
@@ -234,7 +294,9 @@ struct ConverterConfig {
         , output_channels(DefaultChannelMask)
         , internal_frame_size(DefaultInternalFrameSize)
         , resampling(false)
-        , poisoning(false) {
+        , poisoning(false)
+        , num_threads(1)
+        , chunk_frames(DefaultConverterChunkFrames) {
     }
 };
 
@@ -79,6 +79,10 @@ bool Converter::has_clock() const {
     return false;
 }
 
+core::nanoseconds_t Converter::latency() const {
+    return 0;
+}
+
 void Converter::write(audio::Frame& frame) {
     roc_panic_if(!valid());
 
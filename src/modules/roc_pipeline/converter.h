@@ -43,6 +43,9 @@ public:
     //! Check if the sink has own clock.
     virtual bool has_clock() const;
 
+    //! Get current playback latency of the sink.
+    virtual core::nanoseconds_t latency() const;
+
     //! Write audio frame.
     virtual void write(audio::Frame& frame);
 
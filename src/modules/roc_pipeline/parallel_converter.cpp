@@ -0,0 +1,390 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_pipeline/parallel_converter.h"
+#include "roc_audio/null_writer.h"
+#include "roc_audio/profiling_writer.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/thread.h"
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+// Resampler needs previous and next frame for every input frame.
+enum { OverlapFrames = 2 };
+
+// Number of chunks per thread that may be in flight.
+enum { ChunksPerThread = 2 };
+
+} // namespace
+
+class ParallelConverter::Worker : public core::Thread {
+public:
+    Worker(ParallelConverter& converter,
+           const ConverterConfig& config,
+           core::IAllocator& allocator)
+        : converter_(converter)
+        , resampler_(allocator,
+                     config.resampler,
+                     config.output_channels,
+                     config.internal_frame_size) {
+    }
+
+    bool init(float scaling) {
+        return resampler_.valid() && resampler_.set_scaling(scaling);
+    }
+
+private:
+    virtual void run() {
+        while (Chunk* chunk = converter_.take_chunk_()) {
+            resample_(*chunk);
+            converter_.finish_chunk_(*chunk);
+        }
+    }
+
+    void resample_(Chunk& chunk) {
+        if (chunk.output.size() == 0) {
+            return;
+        }
+
+        resampler_.set_position(chunk.position);
+
+        audio::Frame out(&chunk.output[0], chunk.output.size());
+
+        const size_t n_steps = chunk.frames.size() - OverlapFrames;
+
+        for (size_t n = 0; n < n_steps; n++) {
+            resampler_.renew_buffers(chunk.frames[n], chunk.frames[n + 1],
+                                     chunk.frames[n + 2]);
+
+            if (resampler_.resample_buff(out) != (n + 1 == n_steps)) {
+                roc_panic("parallel converter: unexpected number of resampled samples:"
+                          " step=%lu num_steps=%lu",
+                          (unsigned long)n, (unsigned long)n_steps);
+            }
+        }
+    }
+
+    ParallelConverter& converter_;
+    audio::Resampler resampler_;
+};
+
+ParallelConverter::ParallelConverter(const ConverterConfig& config,
+                                     core::BufferPool<audio::sample_t>& pool,
+                                     core::IAllocator& allocator)
+    : config_(config)
+    , pool_(pool)
+    , allocator_(allocator)
+    , tracker_(allocator,
+               config.resampler,
+               config.output_channels,
+               config.internal_frame_size)
+    , chunks_(allocator)
+    , workers_(allocator)
+    , out_pos_(0)
+    , cond_(mutex_)
+    , stop_(false)
+    , valid_(false) {
+    if (config.num_threads == 0 || config.chunk_frames == 0) {
+        roc_log(LogError,
+                "parallel converter: invalid config: num_threads=%lu chunk_frames=%lu",
+                (unsigned long)config.num_threads, (unsigned long)config.chunk_frames);
+        return;
+    }
+
+    if (config.input_channels != config.output_channels) {
+        roc_log(LogError, "parallel converter: channel mapping is not supported");
+        return;
+    }
+
+    if (pool.buffer_size() < config.internal_frame_size) {
+        roc_log(LogError,
+                "parallel converter: buffer size is too small: required=%lu actual=%lu",
+                (unsigned long)config.internal_frame_size,
+                (unsigned long)pool.buffer_size());
+        return;
+    }
+
+    const float scaling = float(config.input_sample_rate) / config.output_sample_rate;
+
+    if (!tracker_.valid() || !tracker_.set_scaling(scaling)) {
+        return;
+    }
+
+    out_frame_ = new (pool) core::Buffer<audio::sample_t>(pool);
+    if (!out_frame_) {
+        roc_log(LogError, "parallel converter: can't allocate buffer");
+        return;
+    }
+    out_frame_.resize(config.internal_frame_size);
+
+    const size_t num_chunks = config.num_threads * ChunksPerThread;
+
+    if (!chunks_.grow(num_chunks)) {
+        return;
+    }
+
+    for (size_t n = 0; n < num_chunks; n++) {
+        Chunk* chunk = new (allocator) Chunk(allocator);
+        if (!chunk) {
+            roc_log(LogError, "parallel converter: can't allocate chunk");
+            return;
+        }
+        chunks_.push_back(chunk);
+
+        if (!chunk->frames.grow(config.chunk_frames + OverlapFrames)) {
+            return;
+        }
+    }
+
+    if (!workers_.grow(config.num_threads)) {
+        return;
+    }
+
+    for (size_t n = 0; n < config.num_threads; n++) {
+        Worker* worker = new (allocator) Worker(*this, config, allocator);
+        if (!worker) {
+            roc_log(LogError, "parallel converter: can't allocate worker");
+            return;
+        }
+        workers_.push_back(worker);
+
+        if (!worker->init(scaling)) {
+            return;
+        }
+    }
+
+    valid_ = true;
+}
+
+ParallelConverter::~ParallelConverter() {
+    stop_workers_();
+
+    for (size_t n = 0; n < workers_.size(); n++) {
+        allocator_.destroy(*workers_[n]);
+    }
+
+    for (size_t n = 0; n < chunks_.size(); n++) {
+        allocator_.destroy(*chunks_[n]);
+    }
+}
+
+bool ParallelConverter::valid() const {
+    return valid_;
+}
+
+bool ParallelConverter::run(sndio::ISource& source, audio::IWriter* output_writer) {
+    roc_panic_if(!valid());
+
+    audio::NullWriter null_writer;
+    audio::ProfilingWriter profiler(output_writer ? *output_writer : null_writer,
+                                    config_.output_channels,
+                                    config_.output_sample_rate);
+
+    if (!start_workers_()) {
+        stop_workers_();
+        return false;
+    }
+
+    roc_log(LogDebug,
+            "parallel converter: starting: num_threads=%lu chunk_frames=%lu",
+            (unsigned long)config_.num_threads, (unsigned long)config_.chunk_frames);
+
+    size_t n_read = 0;
+    size_t n_written = 0;
+
+    bool eof = false;
+    bool ok = true;
+
+    for (;;) {
+        while (!eof && n_read - n_written < chunks_.size()) {
+            Chunk& chunk = *chunks_[n_read % chunks_.size()];
+
+            if (!read_chunk_(source, chunk, eof)) {
+                ok = false;
+                break;
+            }
+
+            if (chunk.frames.size() <= OverlapFrames) {
+                break;
+            }
+
+            core::Mutex::Lock lock(mutex_);
+
+            chunk.state = ChunkPending;
+            cond_.broadcast();
+
+            n_read++;
+        }
+
+        if (!ok || n_written == n_read) {
+            break;
+        }
+
+        Chunk& chunk = *chunks_[n_written % chunks_.size()];
+
+        {
+            core::Mutex::Lock lock(mutex_);
+
+            while (chunk.state != ChunkDone) {
+                cond_.wait();
+            }
+        }
+
+        write_chunk_(chunk, profiler);
+
+        {
+            core::Mutex::Lock lock(mutex_);
+
+            chunk.state = ChunkFree;
+        }
+
+        n_written++;
+    }
+
+    stop_workers_();
+
+    roc_log(LogDebug, "parallel converter: exiting: wrote %lu chunks",
+            (unsigned long)n_written);
+
+    return ok;
+}
+
+bool ParallelConverter::read_chunk_(sndio::ISource& source, Chunk& chunk, bool& eof) {
+    chunk.frames.resize(0);
+
+    for (size_t n = 0; n < OverlapFrames; n++) {
+        if (tail_[n]) {
+            chunk.frames.push_back(tail_[n]);
+        }
+    }
+
+    while (chunk.frames.size() < config_.chunk_frames + OverlapFrames) {
+        core::Slice<audio::sample_t> buffer =
+            new (pool_) core::Buffer<audio::sample_t>(pool_);
+
+        if (!buffer) {
+            roc_log(LogError, "parallel converter: can't allocate buffer");
+            return false;
+        }
+
+        buffer.resize(config_.internal_frame_size);
+
+        audio::Frame frame(buffer.data(), buffer.size());
+        if (!source.read(frame)) {
+            roc_log(LogDebug, "parallel converter: got eof from source");
+            eof = true;
+            break;
+        }
+
+        chunk.frames.push_back(buffer);
+    }
+
+    if (chunk.frames.size() <= OverlapFrames) {
+        return true;
+    }
+
+    for (size_t n = 0; n < OverlapFrames; n++) {
+        tail_[n] = chunk.frames[chunk.frames.size() - OverlapFrames + n];
+    }
+
+    chunk.position = tracker_.position();
+
+    size_t n_samples = 0;
+    for (size_t n = 0; n < chunk.frames.size() - OverlapFrames; n++) {
+        n_samples += tracker_.skip_frame();
+    }
+
+    if (!chunk.output.resize(n_samples)) {
+        return false;
+    }
+
+    return true;
+}
+
+void ParallelConverter::write_chunk_(Chunk& chunk, audio::IWriter& writer) {
+    const size_t frame_size = out_frame_.size();
+
+    for (size_t n = 0; n < chunk.output.size();) {
+        size_t n_samples = chunk.output.size() - n;
+        if (n_samples > frame_size - out_pos_) {
+            n_samples = frame_size - out_pos_;
+        }
+
+        memcpy(out_frame_.data() + out_pos_, &chunk.output[n],
+               n_samples * sizeof(audio::sample_t));
+
+        out_pos_ += n_samples;
+        n += n_samples;
+
+        if (out_pos_ == frame_size) {
+            audio::Frame frame(out_frame_.data(), frame_size);
+            writer.write(frame);
+
+            out_pos_ = 0;
+        }
+    }
+
+    chunk.frames.resize(0);
+}
+
+ParallelConverter::Chunk* ParallelConverter::take_chunk_() {
+    core::Mutex::Lock lock(mutex_);
+
+    while (!stop_) {
+        for (size_t n = 0; n < chunks_.size(); n++) {
+            if (chunks_[n]->state == ChunkPending) {
+                chunks_[n]->state = ChunkProcessing;
+                return chunks_[n];
+            }
+        }
+
+        cond_.wait();
+    }
+
+    return NULL;
+}
+
+void ParallelConverter::finish_chunk_(Chunk& chunk) {
+    core::Mutex::Lock lock(mutex_);
+
+    chunk.state = ChunkDone;
+    cond_.broadcast();
+}
+
+bool ParallelConverter::start_workers_() {
+    for (size_t n = 0; n < workers_.size(); n++) {
+        if (!workers_[n]->start()) {
+            roc_log(LogError, "parallel converter: can't start thread");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ParallelConverter::stop_workers_() {
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        stop_ = true;
+        cond_.broadcast();
+    }
+
+    for (size_t n = 0; n < workers_.size(); n++) {
+        if (workers_[n]->joinable()) {
+            workers_[n]->join();
+        }
+    }
+}
+
+} // namespace pipeline
+} // namespace roc
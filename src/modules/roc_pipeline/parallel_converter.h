@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_pipeline/parallel_converter.h
+//! @brief Parallel converter pipeline.
+
+#ifndef ROC_PIPELINE_PARALLEL_CONVERTER_H_
+#define ROC_PIPELINE_PARALLEL_CONVERTER_H_
+
+#include "roc_audio/iwriter.h"
+#include "roc_audio/resampler.h"
+#include "roc_core/array.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/cond.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_pipeline/config.h"
+#include "roc_sndio/isource.h"
+
+namespace roc {
+namespace pipeline {
+
+//! Parallel converter pipeline.
+//! @remarks
+//!  Reads the whole input stream, splits it into chunks of config.chunk_frames
+//!  internal frames and resamples chunks on config.num_threads threads. Every
+//!  chunk also holds two frames of the next chunk, needed for the resampler
+//!  window, and the resampler position at its beginning, which is computed in
+//!  advance without resampling. Chunks are written to the output in order, and
+//!  the output is bit-identical to the output of Converter with resampling.
+class ParallelConverter : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    ParallelConverter(const ConverterConfig& config,
+                      core::BufferPool<audio::sample_t>& pool,
+                      core::IAllocator& allocator);
+
+    ~ParallelConverter();
+
+    //! Check if the pipeline was successfully constructed.
+    bool valid() const;
+
+    //! Convert the whole input.
+    //! @remarks
+    //!  Reads frames from @p source until EOF and writes resampled frames to
+    //!  @p output_writer, which may be NULL. Should be called only once.
+    //! @returns
+    //!  false if an error occurred.
+    bool run(sndio::ISource& source, audio::IWriter* output_writer);
+
+private:
+    class Worker;
+
+    enum ChunkState { ChunkFree, ChunkPending, ChunkProcessing, ChunkDone };
+
+    struct Chunk {
+        Chunk(core::IAllocator& allocator)
+            : frames(allocator)
+            , output(allocator)
+            , position(0)
+            , state(ChunkFree) {
+        }
+
+        core::Array<core::Slice<audio::sample_t> > frames;
+        core::Array<audio::sample_t> output;
+
+        uint32_t position;
+        ChunkState state;
+    };
+
+    bool read_chunk_(sndio::ISource& source, Chunk& chunk, bool& eof);
+    void write_chunk_(Chunk& chunk, audio::IWriter& writer);
+
+    Chunk* take_chunk_();
+    void finish_chunk_(Chunk& chunk);
+
+    bool start_workers_();
+    void stop_workers_();
+
+    const ConverterConfig config_;
+
+    core::BufferPool<audio::sample_t>& pool_;
+    core::IAllocator& allocator_;
+
+    audio::Resampler tracker_;
+
+    core::Array<Chunk*> chunks_;
+    core::Array<Worker*> workers_;
+
+    core::Slice<audio::sample_t> tail_[2];
+
+    core::Slice<audio::sample_t> out_frame_;
+    size_t out_pos_;
+
+    core::Mutex mutex_;
+    core::Cond cond_;
+    bool stop_;
+
+    bool valid_;
+};
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_PARALLEL_CONVERTER_H_
@@ -21,7 +21,10 @@ enum PortType {
     Port_AudioSource,
 
     //! Audio repair packets.
-    Port_AudioRepair
+    Port_AudioRepair,
+
+    //! Control packets.
+    Port_Control
 };
 
 //! Port protocol.
@@ -42,7 +45,10 @@ enum PortProtocol {
     Proto_RTP_LDPC_Source,
 
     //! FEC repair packet + FECFRAME LDPC header.
-    Proto_LDPC_Repair
+    Proto_LDPC_Repair,
+
+    //! RTCP compound packet.
+    Proto_RTCP
 };
 
 } // namespace pipeline
@@ -33,6 +33,9 @@ packet::FECScheme port_fec_scheme(PortProtocol proto) {
 
     case Proto_LDPC_Repair:
         return packet::FEC_LDPC_Staircase;
+
+    case Proto_RTCP:
+        return packet::FEC_None;
     }
 
     return packet::FEC_None;
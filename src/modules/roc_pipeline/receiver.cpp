@@ -10,12 +10,25 @@
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/shared_ptr.h"
+#include "roc_core/trace.h"
 #include "roc_packet/address_to_str.h"
 #include "roc_pipeline/port_to_str.h"
 
 namespace roc {
 namespace pipeline {
 
+namespace {
+
+void add_packet_stats(ReceiverPacketStats& total, const ReceiverPacketStats& stats) {
+    total.received += stats.received;
+    total.late += stats.late;
+    total.dropped += stats.dropped;
+    total.duplicated += stats.duplicated;
+    total.restored += stats.restored;
+}
+
+} // namespace
+
 Receiver::Receiver(const ReceiverConfig& config,
                    const fec::CodecMap& codec_map,
                    const rtp::FormatMap& format_map,
@@ -29,10 +42,12 @@ Receiver::Receiver(const ReceiverConfig& config,
     , byte_buffer_pool_(byte_buffer_pool)
     , sample_buffer_pool_(sample_buffer_pool)
     , allocator_(allocator)
+    , control_writer_(NULL)
     , ticker_(config.common.output_sample_rate)
     , audio_reader_(NULL)
     , config_(config)
     , timestamp_(0)
+    , sink_latency_(0)
     , num_channels_(packet::num_channels(config.common.output_channels))
     , active_cond_(control_mutex_) {
     mixer_.reset(new (allocator_)
@@ -75,6 +90,12 @@ bool Receiver::add_port(const PortConfig& config) {
     return true;
 }
 
+void Receiver::set_control_writer(packet::IWriter* writer) {
+    core::Mutex::Lock lock(control_mutex_);
+
+    control_writer_ = writer;
+}
+
 void Receiver::iterate_ports(void (*fn)(void*, const PortConfig&), void* arg) const {
     core::Mutex::Lock lock(control_mutex_);
 
@@ -91,6 +112,31 @@ size_t Receiver::num_sessions() const {
     return sessions_.size();
 }
 
+void Receiver::get_stats(ReceiverStats& stats) const {
+    core::Mutex::Lock lock(control_mutex_);
+
+    stats = ReceiverStats();
+    stats.num_sessions = sessions_.size();
+    stats.packets = removed_stats_;
+
+    core::SharedPtr<ReceiverSession> sess;
+
+    for (sess = sessions_.front(); sess; sess = sessions_.nextof(*sess)) {
+        add_packet_stats(stats.packets, sess->stats().packets);
+    }
+}
+
+void Receiver::iterate_sessions(void (*fn)(void*, const ReceiverSessionStats&),
+                                void* arg) const {
+    core::Mutex::Lock lock(control_mutex_);
+
+    core::SharedPtr<ReceiverSession> sess;
+
+    for (sess = sessions_.front(); sess; sess = sessions_.nextof(*sess)) {
+        fn(arg, sess->stats());
+    }
+}
+
 size_t Receiver::sample_rate() const {
     return config_.common.output_sample_rate;
 }
@@ -125,6 +171,12 @@ void Receiver::write(const packet::PacketPtr& packet) {
     }
 }
 
+void Receiver::set_sink_latency(core::nanoseconds_t latency) {
+    core::Mutex::Lock lock(pipeline_mutex_);
+
+    sink_latency_ = latency;
+}
+
 bool Receiver::read(audio::Frame& frame) {
     core::Mutex::Lock lock(pipeline_mutex_);
 
@@ -132,6 +184,8 @@ bool Receiver::read(audio::Frame& frame) {
         ticker_.wait(timestamp_);
     }
 
+    roc_trace_scope("receiver.read");
+
     prepare_();
 
     audio_reader_->read(frame);
@@ -166,6 +220,8 @@ sndio::ISource::State Receiver::state_() const {
 }
 
 void Receiver::fetch_packets_() {
+    roc_trace_scope("receiver.fetch_packets");
+
     for (;;) {
         packet::PacketPtr packet = packets_.front();
         if (!packet) {
@@ -220,6 +276,11 @@ bool Receiver::can_create_session_(const packet::PacketPtr& packet) {
         return false;
     }
 
+    if (packet->flags() & packet::Packet::FlagRTCP) {
+        roc_log(LogDebug, "receiver: ignoring control packet for unknown session");
+        return false;
+    }
+
     return true;
 }
 
@@ -244,8 +305,9 @@ bool Receiver::create_session_(const packet::PacketPtr& packet) {
             packet::address_to_str(dst_address).c_str());
 
     core::SharedPtr<ReceiverSession> sess = new (allocator_)
-        ReceiverSession(sess_config, config_.common, src_address, codec_map_, format_map_,
-                        packet_pool_, byte_buffer_pool_, sample_buffer_pool_, allocator_);
+        ReceiverSession(sess_config, config_.common, src_address, control_writer_,
+                        codec_map_, format_map_, packet_pool_, byte_buffer_pool_,
+                        sample_buffer_pool_, allocator_);
 
     if (!sess || !sess->valid()) {
         roc_log(LogError, "receiver: can't create session, initialization failed");
@@ -266,17 +328,21 @@ bool Receiver::create_session_(const packet::PacketPtr& packet) {
 void Receiver::remove_session_(ReceiverSession& sess) {
     roc_log(LogInfo, "receiver: removing session");
 
+    add_packet_stats(removed_stats_, sess.stats().packets);
+
     mixer_->remove(sess.reader());
     sessions_.remove(sess);
 }
 
 void Receiver::update_sessions_() {
+    roc_trace_scope("receiver.update_sessions");
+
     core::SharedPtr<ReceiverSession> curr, next;
 
     for (curr = sessions_.front(); curr; curr = next) {
         next = sessions_.nextof(*curr);
 
-        if (!curr->update(timestamp_)) {
+        if (!curr->update(timestamp_, sink_latency_)) {
             remove_session_(*curr);
         }
     }
@@ -29,6 +29,7 @@
 #include "roc_pipeline/config.h"
 #include "roc_pipeline/receiver_port.h"
 #include "roc_pipeline/receiver_session.h"
+#include "roc_pipeline/stats.h"
 #include "roc_rtp/format_map.h"
 #include "roc_sndio/isource.h"
 
@@ -55,18 +56,37 @@ public:
     //! Add receiving port.
     bool add_port(const PortConfig& config);
 
+    //! Set writer for outgoing control packets.
+    //! @remarks
+    //!  If set, sessions periodically send RTCP receiver reports using this
+    //!  writer, to the addresses from which their sender reports came.
+    //!  Affects sessions created after this call.
+    void set_control_writer(packet::IWriter* writer);
+
     //! Iterate added ports.
     void iterate_ports(void (*fn)(void*, const PortConfig&), void* arg) const;
 
     //! Get number of alive sessions.
     size_t num_sessions() const;
 
+    //! Get receiver statistics.
+    //! @remarks
+    //!  Packet counters include sessions that were already removed.
+    void get_stats(ReceiverStats& stats) const;
+
+    //! Iterate statistics of alive sessions.
+    void iterate_sessions(void (*fn)(void*, const ReceiverSessionStats&),
+                          void* arg) const;
+
     //! Get current receiver state.
     virtual State state() const;
 
     //! Wait until the receiver status becomes active.
     virtual void wait_active() const;
 
+    //! Set playback latency of the sink the source is read to.
+    virtual void set_sink_latency(core::nanoseconds_t latency);
+
     //! Get source sample rate.
     virtual size_t sample_rate() const;
 
@@ -111,6 +131,10 @@ private:
 
     core::List<packet::Packet> packets_;
 
+    packet::IWriter* control_writer_;
+
+    ReceiverPacketStats removed_stats_;
+
     core::Ticker ticker_;
 
     core::UniquePtr<audio::Mixer> mixer_;
@@ -121,6 +145,7 @@ private:
     ReceiverConfig config_;
 
     packet::timestamp_t timestamp_;
+    core::nanoseconds_t sink_latency_;
     size_t num_channels_;
 
     core::Mutex control_mutex_;
@@ -34,6 +34,13 @@ ReceiverPort::ReceiverPort(const PortConfig& config,
         }
         parser = rtp_parser_.get();
         break;
+    case Proto_RTCP:
+        rtcp_parser_.reset(new (allocator) rtcp::Parser(), allocator);
+        if (!rtcp_parser_) {
+            return;
+        }
+        parser = rtcp_parser_.get();
+        break;
     }
 
     switch ((unsigned)config.protocol) {
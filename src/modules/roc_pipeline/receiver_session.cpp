@@ -9,13 +9,27 @@
 #include "roc_pipeline/receiver_session.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/random.h"
+#include "roc_core/trace.h"
+#include "roc_packet/address_to_str.h"
+#include "roc_rtcp/builder.h"
 
 namespace roc {
 namespace pipeline {
 
+namespace {
+
+// Enough for all pipeline stages of a session with FEC and resampling enabled,
+// together with their small buffers. Large tables that don't fit are allocated
+// separately.
+const size_t ArenaSize = 8 * 1024;
+
+} // namespace
+
 ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
                                  const ReceiverCommonConfig& common_config,
                                  const packet::Address& src_address,
+                                 packet::IWriter* control_writer,
                                  const fec::CodecMap& codec_map,
                                  const rtp::FormatMap& format_map,
                                  packet::PacketPool& packet_pool,
@@ -23,19 +37,47 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
                                  core::BufferPool<audio::sample_t>& sample_buffer_pool,
                                  core::IAllocator& allocator)
     : src_address_(src_address)
+    , sample_rate_(0)
+    , control_writer_(control_writer)
+    , has_control_address_(false)
+    , packet_pool_(packet_pool)
+    , byte_buffer_pool_(byte_buffer_pool)
     , allocator_(allocator)
-    , audio_reader_(NULL) {
+    , arena_(allocator, ArenaSize)
+    , audio_reader_(NULL)
+    , report_interval_((packet::timestamp_t)packet::timestamp_from_ns(
+          common_config.report_interval, common_config.output_sample_rate))
+    , report_pos_(0)
+    , has_report_pos_(false)
+    , num_packets_(0) {
     const rtp::Format* format = format_map.format(session_config.payload_type);
     if (!format) {
         return;
     }
 
-    queue_router_.reset(new (allocator_) packet::Router(allocator_, 2), allocator_);
+    sample_rate_ = format->sample_rate;
+    stats_.src_address = src_address;
+
+    if (control_writer_ && report_interval_ == 0) {
+        roc_log(LogError, "receiver session: invalid config: report_interval=%ld",
+                (long)common_config.report_interval);
+        return;
+    }
+
+    rtcp_reporter_.reset(new (arena_) rtcp::ReceiverReporter(
+                             (packet::source_t)core::random(packet::source_t(-1)),
+                             format->sample_rate),
+                         arena_);
+    if (!rtcp_reporter_) {
+        return;
+    }
+
+    queue_router_.reset(new (arena_) packet::Router(arena_, 2), arena_);
     if (!queue_router_ || !queue_router_->valid()) {
         return;
     }
 
-    source_queue_.reset(new (allocator_) packet::SortedQueue(0), allocator_);
+    source_queue_.reset(new (arena_) packet::SortedQueue(0), arena_);
     if (!source_queue_) {
         return;
     }
@@ -48,25 +90,25 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
 
     packet::IReader* preader = source_queue_.get();
 
-    delayed_reader_.reset(
-        new (allocator_) packet::DelayedReader(*preader, session_config.target_latency,
-                                               format->sample_rate),
-        allocator_);
+    delayed_reader_.reset(new (arena_) packet::DelayedReader(
+                              *preader, session_config.target_latency,
+                              format->sample_rate),
+                          arena_);
     if (!delayed_reader_) {
         return;
     }
     preader = delayed_reader_.get();
 
-    validator_.reset(new (allocator_) rtp::Validator(
-                         *preader, session_config.rtp_validator, format->sample_rate),
-                     allocator_);
+    validator_.reset(new (arena_) rtp::Validator(*preader, session_config.rtp_validator,
+                                                 format->sample_rate),
+                     arena_);
     if (!validator_) {
         return;
     }
     preader = validator_.get();
 
     if (session_config.fec_decoder.scheme != packet::FEC_None) {
-        repair_queue_.reset(new (allocator_) packet::SortedQueue(0), allocator_);
+        repair_queue_.reset(new (arena_) packet::SortedQueue(0), arena_);
         if (!repair_queue_) {
             return;
         }
@@ -75,46 +117,46 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
         }
 
         fec_decoder_.reset(codec_map.new_decoder(session_config.fec_decoder,
-                                                 byte_buffer_pool, allocator_),
-                           allocator_);
+                                                 byte_buffer_pool, arena_),
+                           arena_);
         if (!fec_decoder_) {
             return;
         }
 
-        fec_parser_.reset(new (allocator_) rtp::Parser(format_map, NULL), allocator_);
+        fec_parser_.reset(new (arena_) rtp::Parser(format_map, NULL), arena_);
         if (!fec_parser_) {
             return;
         }
 
-        fec_reader_.reset(new (allocator_) fec::Reader(
+        fec_reader_.reset(new (arena_) fec::Reader(
                               session_config.fec_reader,
                               session_config.fec_decoder.scheme, *fec_decoder_, *preader,
-                              *repair_queue_, *fec_parser_, packet_pool, allocator_),
-                          allocator_);
+                              *repair_queue_, *fec_parser_, packet_pool, arena_),
+                          arena_);
         if (!fec_reader_ || !fec_reader_->valid()) {
             return;
         }
         preader = fec_reader_.get();
 
-        fec_validator_.reset(new (allocator_)
-                                 rtp::Validator(*preader, session_config.rtp_validator,
-                                                format->sample_rate),
-                             allocator_);
+        fec_validator_.reset(new (arena_) rtp::Validator(
+                                 *preader, session_config.rtp_validator,
+                                 format->sample_rate),
+                             arena_);
         if (!fec_validator_) {
             return;
         }
         preader = fec_validator_.get();
     }
 
-    payload_decoder_.reset(format->new_decoder(allocator_), allocator_);
+    payload_decoder_.reset(format->new_decoder(arena_), arena_);
     if (!payload_decoder_) {
         return;
     }
 
-    depacketizer_.reset(new (allocator_) audio::Depacketizer(*preader, *payload_decoder_,
-                                                             session_config.channels,
-                                                             common_config.beeping),
-                        allocator_);
+    depacketizer_.reset(new (arena_) audio::Depacketizer(*preader, *payload_decoder_,
+                                                         session_config.channels,
+                                                         common_config.beeping),
+                        arena_);
     if (!depacketizer_) {
         return;
     }
@@ -124,11 +166,11 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
     if (session_config.watchdog.no_playback_timeout != 0
         || session_config.watchdog.broken_playback_timeout != 0
         || session_config.watchdog.frame_status_window != 0) {
-        watchdog_.reset(new (allocator_) audio::Watchdog(
+        watchdog_.reset(new (arena_) audio::Watchdog(
                             *areader, packet::num_channels(session_config.channels),
                             session_config.watchdog, common_config.output_sample_rate,
-                            allocator_),
-                        allocator_);
+                            arena_),
+                        arena_);
         if (!watchdog_ || !watchdog_->valid()) {
             return;
         }
@@ -137,18 +179,17 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
 
     if (common_config.resampling) {
         if (common_config.poisoning) {
-            resampler_poisoner_.reset(new (allocator_) audio::PoisonReader(*areader),
-                                      allocator_);
+            resampler_poisoner_.reset(new (arena_) audio::PoisonReader(*areader), arena_);
             if (!resampler_poisoner_) {
                 return;
             }
             areader = resampler_poisoner_.get();
         }
-        resampler_.reset(new (allocator_) audio::ResamplerReader(
-                             *areader, sample_buffer_pool, allocator,
+        resampler_.reset(new (arena_) audio::ResamplerReader(
+                             *areader, sample_buffer_pool, arena_,
                              session_config.resampler, session_config.channels,
                              common_config.internal_frame_size),
-                         allocator_);
+                         arena_);
         if (!resampler_ || !resampler_->valid()) {
             return;
         }
@@ -156,24 +197,27 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
     }
 
     if (common_config.poisoning) {
-        session_poisoner_.reset(new (allocator_) audio::PoisonReader(*areader),
-                                allocator_);
+        session_poisoner_.reset(new (arena_) audio::PoisonReader(*areader), arena_);
         if (!session_poisoner_) {
             return;
         }
         areader = session_poisoner_.get();
     }
 
-    latency_monitor_.reset(new (allocator_) audio::LatencyMonitor(
+    latency_monitor_.reset(new (arena_) audio::LatencyMonitor(
                                *source_queue_, *depacketizer_, resampler_.get(),
                                session_config.latency_monitor,
                                session_config.target_latency, format->sample_rate,
                                common_config.output_sample_rate),
-                           allocator_);
+                           arena_);
     if (!latency_monitor_ || !latency_monitor_->valid()) {
         return;
     }
 
+    roc_log(LogDebug, "receiver session: arena: used=%lu/%lu extra_allocations=%lu",
+            (unsigned long)arena_.block_used(), (unsigned long)ArenaSize,
+            (unsigned long)arena_.num_parent_allocations());
+
     audio_reader_ = areader;
 }
 
@@ -193,17 +237,44 @@ bool ReceiverSession::handle(const packet::PacketPtr& packet) {
         return false;
     }
 
+    // sender reports come from the sender control port rather than from
+    // the source address, so they're matched by SSRC
+    if (packet->flags() & packet::Packet::FlagRTCP) {
+        if (!rtcp_reporter_->process_packet(*packet)) {
+            return false;
+        }
+
+        if (!has_control_address_ || control_address_ != udp->src_addr) {
+            roc_log(LogDebug, "receiver session: sending reports to %s",
+                    packet::address_to_str(udp->src_addr).c_str());
+
+            control_address_ = udp->src_addr;
+            has_control_address_ = true;
+        }
+
+        return true;
+    }
+
     if (udp->src_addr != src_address_) {
         return false;
     }
 
+    rtcp_reporter_->process_packet(*packet);
+
     queue_router_->write(packet);
+    num_packets_++;
+
     return true;
 }
 
-bool ReceiverSession::update(packet::timestamp_t time) {
+bool ReceiverSession::update(packet::timestamp_t time,
+                             core::nanoseconds_t sink_latency) {
+    roc_trace_scope("session.update");
+
     roc_panic_if(!valid());
 
+    update_stats_();
+
     if (watchdog_) {
         if (!watchdog_->update()) {
             return false;
@@ -211,11 +282,22 @@ bool ReceiverSession::update(packet::timestamp_t time) {
     }
 
     if (latency_monitor_) {
-        if (!latency_monitor_->update(time)) {
+        if (!latency_monitor_->update(time, sink_latency)) {
             return false;
         }
     }
 
+    if (control_writer_) {
+        if (!has_report_pos_) {
+            report_pos_ = time;
+            has_report_pos_ = true;
+        }
+        if (packet::timestamp_le(report_pos_, time)) {
+            report_pos_ = time + report_interval_;
+            send_report_();
+        }
+    }
+
     return true;
 }
 
@@ -225,5 +307,79 @@ audio::IReader& ReceiverSession::reader() {
     return *audio_reader_;
 }
 
+rtcp::LinkMetrics ReceiverSession::metrics() const {
+    roc_panic_if(!valid());
+
+    return rtcp_reporter_->metrics();
+}
+
+const ReceiverSessionStats& ReceiverSession::stats() const {
+    roc_panic_if(!valid());
+
+    return stats_;
+}
+
+void ReceiverSession::send_report_() {
+    rtcp::ReceptionReport report;
+    if (!rtcp_reporter_->build_report(report, core::timestamp())) {
+        return;
+    }
+
+    // report is still built to update local loss metrics, but it can't be
+    // sent until the sender control port is known
+    if (!has_control_address_) {
+        return;
+    }
+
+    packet::PacketPtr pp = new (packet_pool_) packet::Packet(packet_pool_);
+    if (!pp) {
+        roc_log(LogError, "receiver session: can't allocate rtcp packet");
+        return;
+    }
+
+    core::Slice<uint8_t> data = pp->alloc_buffer(byte_buffer_pool_);
+    if (!data) {
+        roc_log(LogError, "receiver session: can't allocate rtcp buffer");
+        return;
+    }
+    data.resize(0);
+
+    rtcp::Builder builder(data);
+    if (!builder.add_receiver_report(rtcp_reporter_->ssrc(), &report, 1)) {
+        roc_log(LogError, "receiver session: can't build rtcp packet");
+        return;
+    }
+
+    pp->add_flags(packet::Packet::FlagUDP | packet::Packet::FlagRTCP);
+    pp->udp()->dst_addr = control_address_;
+    pp->set_data(data);
+
+    control_writer_->write(pp);
+}
+
+void ReceiverSession::update_stats_() {
+    stats_.packets.received = num_packets_;
+    stats_.packets.late = depacketizer_->num_late_packets();
+
+    stats_.packets.dropped = source_queue_->num_dropped();
+    stats_.packets.duplicated = source_queue_->num_duplicates();
+
+    if (repair_queue_) {
+        stats_.packets.dropped += repair_queue_->num_dropped();
+        stats_.packets.duplicated += repair_queue_->num_duplicates();
+    }
+
+    if (fec_reader_) {
+        stats_.packets.restored = fec_reader_->num_restored();
+    }
+
+    stats_.queue_size = source_queue_->size();
+
+    stats_.latency = packet::timestamp_to_ns(latency_monitor_->latency(), sample_rate_);
+    stats_.scaling = latency_monitor_->scaling();
+
+    stats_.link = rtcp_reporter_->metrics();
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -19,6 +19,7 @@
 #include "roc_audio/poison_reader.h"
 #include "roc_audio/resampler_reader.h"
 #include "roc_audio/watchdog.h"
+#include "roc_core/arena_allocator.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/list_node.h"
@@ -36,6 +37,8 @@
 #include "roc_packet/router.h"
 #include "roc_packet/sorted_queue.h"
 #include "roc_pipeline/config.h"
+#include "roc_pipeline/stats.h"
+#include "roc_rtcp/receiver_reporter.h"
 #include "roc_rtp/format_map.h"
 #include "roc_rtp/parser.h"
 #include "roc_rtp/validator.h"
@@ -49,9 +52,14 @@ namespace pipeline {
 class ReceiverSession : public core::RefCnt<ReceiverSession>, public core::ListNode {
 public:
     //! Initialize.
+    //! @remarks
+    //!  If @p control_writer is not null, RTCP receiver reports are periodically
+    //!  written to it, addressed to the port from which sender reports came.
+    //!  Reports are not sent until the first sender report is received.
     ReceiverSession(const ReceiverSessionConfig& session_config,
                     const ReceiverCommonConfig& common_config,
                     const packet::Address& src_address,
+                    packet::IWriter* control_writer,
                     const fec::CodecMap& codec_map,
                     const rtp::FormatMap& format_map,
                     packet::PacketPool& packet_pool,
@@ -68,22 +76,49 @@ public:
     bool handle(const packet::PacketPtr& packet);
 
     //! Update session.
+    //! @remarks
+    //!  @p sink_latency is the current playback latency of the sink, which
+    //!  is included into the session latency.
     //! @returns
     //!  false if the session is terminated
-    bool update(packet::timestamp_t time);
+    bool update(packet::timestamp_t time, core::nanoseconds_t sink_latency);
 
     //! Get audio reader.
     audio::IReader& reader();
 
+    //! Get link metrics.
+    //! @remarks
+    //!  Loss and jitter observed by this session.
+    rtcp::LinkMetrics metrics() const;
+
+    //! Get session statistics.
+    //! @remarks
+    //!  Returns a snapshot taken during the last update().
+    const ReceiverSessionStats& stats() const;
+
 private:
     friend class core::RefCnt<ReceiverSession>;
 
     void destroy();
 
+    void send_report_();
+    void update_stats_();
+
     const packet::Address src_address_;
+    size_t sample_rate_;
+
+    packet::IWriter* control_writer_;
+    packet::Address control_address_;
+    bool has_control_address_;
 
+    packet::PacketPool& packet_pool_;
+    core::BufferPool<uint8_t>& byte_buffer_pool_;
     core::IAllocator& allocator_;
 
+    // pipeline stages and their buffers are allocated from a single block;
+    // should be declared before the stages to be destroyed after them
+    core::ArenaAllocator arena_;
+
     audio::IReader* audio_reader_;
 
     core::UniquePtr<packet::Router> queue_router_;
@@ -109,6 +144,15 @@ private:
     core::UniquePtr<audio::PoisonReader> session_poisoner_;
 
     core::UniquePtr<audio::LatencyMonitor> latency_monitor_;
+
+    core::UniquePtr<rtcp::ReceiverReporter> rtcp_reporter_;
+
+    packet::timestamp_t report_interval_;
+    packet::timestamp_t report_pos_;
+    bool has_report_pos_;
+
+    size_t num_packets_;
+    ReceiverSessionStats stats_;
 };
 
 } // namespace pipeline
@@ -9,8 +9,11 @@
 #include "roc_pipeline/sender.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/trace.h"
 #include "roc_pipeline/port_to_str.h"
 #include "roc_pipeline/port_utils.h"
+#include "roc_rtcp/builder.h"
+#include "roc_rtcp/ntp.h"
 
 namespace roc {
 namespace pipeline {
@@ -20,6 +23,8 @@ Sender::Sender(const SenderConfig& config,
                packet::IWriter& source_writer,
                const PortConfig& repair_port_config,
                packet::IWriter& repair_writer,
+               const PortConfig& control_port_config,
+               packet::IWriter& control_writer,
                const fec::CodecMap& codec_map,
                const rtp::FormatMap& format_map,
                packet::PacketPool& packet_pool,
@@ -27,13 +32,19 @@ Sender::Sender(const SenderConfig& config,
                core::BufferPool<audio::sample_t>& sample_buffer_pool,
                core::IAllocator& allocator)
     : audio_writer_(NULL)
+    , packet_pool_(packet_pool)
+    , byte_buffer_pool_(byte_buffer_pool)
     , config_(config)
     , timestamp_(0)
-    , num_channels_(packet::num_channels(config.input_channels)) {
+    , num_channels_(packet::num_channels(config.input_channels))
+    , report_interval_(0)
+    , report_pos_(0) {
     roc_log(LogInfo, "sender: using remote source port %s",
             port_to_str(source_port_config).c_str());
     roc_log(LogInfo, "sender: using remote repair port %s",
             port_to_str(repair_port_config).c_str());
+    roc_log(LogInfo, "sender: using remote control port %s",
+            port_to_str(control_port_config).c_str());
 
     if (!validate_ports(config.fec_encoder.scheme, source_port_config.protocol,
                         repair_port_config.protocol)) {
@@ -53,25 +64,61 @@ Sender::Sender(const SenderConfig& config,
     }
 
     source_port_.reset(new (allocator)
-                           SenderPort(source_port_config, source_writer, allocator),
+                           SenderPort(source_port_config, source_writer,
+                                      packet_pool, allocator),
                        allocator);
     if (!source_port_ || !source_port_->valid()) {
         return;
     }
 
+    packet::IWriter* source_writer_ptr = source_port_.get();
+
+    if (control_port_config.protocol != Proto_None) {
+        if (control_port_config.protocol != Proto_RTCP) {
+            roc_log(LogError, "sender: unsupported control port protocol %s",
+                    port_proto_to_str(control_port_config.protocol));
+            return;
+        }
+
+        report_interval_ = (packet::timestamp_t)packet::timestamp_from_ns(
+            config.report_interval, config.input_sample_rate);
+        if (report_interval_ == 0) {
+            roc_log(LogError, "sender: invalid config: report_interval=%ld",
+                    (long)config.report_interval);
+            return;
+        }
+
+        control_port_.reset(
+            new (allocator)
+                SenderPort(control_port_config, control_writer, packet_pool, allocator),
+            allocator);
+        if (!control_port_ || !control_port_->valid()) {
+            return;
+        }
+
+        rtcp_reporter_.reset(new (allocator) rtcp::SenderReporter(*source_port_,
+                                                                  format->sample_rate),
+                             allocator);
+        if (!rtcp_reporter_) {
+            return;
+        }
+        source_writer_ptr = rtcp_reporter_.get();
+    }
+
     router_.reset(new (allocator) packet::Router(allocator, 2), allocator);
     if (!router_ || !router_->valid()) {
         return;
     }
     packet::IWriter* pwriter = router_.get();
 
-    if (!router_->add_route(*source_port_, packet::Packet::FlagAudio)) {
+    if (!router_->add_route(*source_writer_ptr, packet::Packet::FlagAudio)) {
         return;
     }
 
     if (config.fec_encoder.scheme != packet::FEC_None) {
         repair_port_.reset(new (allocator)
-                               SenderPort(repair_port_config, repair_writer, allocator),
+                               SenderPort(repair_port_config, repair_writer,
+                                          packet_pool, allocator),
                            allocator);
         if (!repair_port_ || !repair_port_->valid()) {
             return;
@@ -110,6 +157,28 @@ Sender::Sender(const SenderConfig& config,
             return;
         }
         pwriter = fec_writer_.get();
+
+        if (config.adaptive_fec) {
+            if (config.fec_writer.n_source_packets
+                    + config.fec_controller.max_repair_packets
+                > fec_encoder_->max_block_length()) {
+                roc_log(LogError,
+                        "sender: max fec block length exceeded:"
+                        " sbl=%lu max_rbl=%lu max_blen=%lu",
+                        (unsigned long)config.fec_writer.n_source_packets,
+                        (unsigned long)config.fec_controller.max_repair_packets,
+                        (unsigned long)fec_encoder_->max_block_length());
+                return;
+            }
+
+            fec_controller_.reset(new (allocator) fec::BlockSizeController(
+                                      config.fec_controller,
+                                      config.fec_writer.n_source_packets),
+                                  allocator);
+            if (!fec_controller_ || !fec_controller_->valid()) {
+                return;
+            }
+        }
     }
 
     payload_encoder_.reset(format->new_encoder(allocator), allocator);
@@ -175,6 +244,10 @@ bool Sender::has_clock() const {
     return config_.timing;
 }
 
+core::nanoseconds_t Sender::latency() const {
+    return 0;
+}
+
 void Sender::write(audio::Frame& frame) {
     roc_panic_if(!valid());
 
@@ -182,8 +255,154 @@ void Sender::write(audio::Frame& frame) {
         ticker_->wait(timestamp_);
     }
 
+    roc_trace_scope("sender.write");
+
+    if (fec_controller_) {
+        update_fec_block_size_();
+    }
+
     audio_writer_->write(frame);
     timestamp_ += frame.size() / num_channels_;
+
+    if (control_port_ && packet::timestamp_le(report_pos_, timestamp_)) {
+        send_report_();
+    }
+}
+
+void Sender::write(const packet::PacketPtr& packet) {
+    roc_panic_if(!valid());
+
+    if (!rtcp_reporter_) {
+        roc_log(LogDebug, "sender: ignoring control packet, rtcp is disabled");
+        return;
+    }
+
+    if ((packet->flags() & packet::Packet::FlagRTCP) == 0) {
+        if (!rtcp_parser_.parse(*packet, packet->data())) {
+            return;
+        }
+    }
+
+    if (!rtcp_reporter_->process_packet(*packet)) {
+        return;
+    }
+
+    if (fec_controller_) {
+        fec_controller_->report_loss(rtcp_reporter_->metrics().fraction_lost);
+    }
+}
+
+bool Sender::add_destination(const PortConfig& port_config) {
+    roc_panic_if(!valid());
+
+    SenderPort* port = NULL;
+
+    if (port_config.protocol == source_port_->config().protocol) {
+        port = source_port_.get();
+    } else if (repair_port_ && port_config.protocol == repair_port_->config().protocol) {
+        port = repair_port_.get();
+    }
+
+    if (!port) {
+        roc_log(LogError,
+                "sender: can't add destination %s:"
+                " protocol should match source or repair port",
+                port_to_str(port_config).c_str());
+        return false;
+    }
+
+    if (!port->add_destination(port_config.address)) {
+        return false;
+    }
+
+    roc_log(LogInfo, "sender: added destination %s", port_to_str(port_config).c_str());
+
+    return true;
+}
+
+bool Sender::get_metrics(rtcp::LinkMetrics& metrics) const {
+    if (!rtcp_reporter_) {
+        return false;
+    }
+
+    metrics = rtcp_reporter_->metrics();
+    return true;
+}
+
+void Sender::get_stats(SenderStats& stats) const {
+    stats = SenderStats();
+
+    if (source_port_) {
+        stats.source_packets = source_port_->num_packets();
+    }
+
+    if (repair_port_) {
+        stats.repair_packets = repair_port_->num_packets();
+    }
+
+    if (control_port_) {
+        stats.control_packets = control_port_->num_packets();
+    }
+
+    if (fec_writer_) {
+        stats.fec_block_source_packets = fec_writer_->source_block_size();
+        stats.fec_block_repair_packets = fec_writer_->repair_block_size();
+    }
+
+    if (rtcp_reporter_) {
+        stats.link = rtcp_reporter_->metrics();
+    }
+}
+
+bool Sender::report_loss(float loss_ratio) {
+    roc_panic_if(!valid());
+
+    if (!fec_controller_) {
+        return false;
+    }
+
+    fec_controller_->report_loss(loss_ratio);
+    return true;
+}
+
+void Sender::send_report_() {
+    rtcp::SenderReport report;
+    if (!rtcp_reporter_->build_report(report, rtcp::ntp_now(), core::timestamp())) {
+        return;
+    }
+
+    report_pos_ = timestamp_ + report_interval_;
+
+    packet::PacketPtr pp = new (packet_pool_) packet::Packet(packet_pool_);
+    if (!pp) {
+        roc_log(LogError, "sender: can't allocate rtcp packet");
+        return;
+    }
+
+    core::Slice<uint8_t> data = pp->alloc_buffer(byte_buffer_pool_);
+    if (!data) {
+        roc_log(LogError, "sender: can't allocate rtcp buffer");
+        return;
+    }
+    data.resize(0);
+
+    rtcp::Builder builder(data);
+    if (!builder.add_sender_report(report, NULL, 0)) {
+        roc_log(LogError, "sender: can't build rtcp packet");
+        return;
+    }
+
+    pp->add_flags(packet::Packet::FlagRTCP);
+    pp->set_data(data);
+
+    control_port_->write(pp);
+}
+
+void Sender::update_fec_block_size_() {
+    if (!fec_writer_->resize(fec_controller_->n_source_packets(),
+                             fec_controller_->n_repair_packets())) {
+        roc_panic("sender: can't resize fec writer");
+    }
 }
 
 } // namespace pipeline
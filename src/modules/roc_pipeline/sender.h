@@ -21,6 +21,7 @@
 #include "roc_core/noncopyable.h"
 #include "roc_core/ticker.h"
 #include "roc_core/unique_ptr.h"
+#include "roc_fec/block_size_controller.h"
 #include "roc_fec/codec_map.h"
 #include "roc_fec/iblock_encoder.h"
 #include "roc_fec/writer.h"
@@ -29,6 +30,9 @@
 #include "roc_packet/router.h"
 #include "roc_pipeline/config.h"
 #include "roc_pipeline/sender_port.h"
+#include "roc_pipeline/stats.h"
+#include "roc_rtcp/parser.h"
+#include "roc_rtcp/sender_reporter.h"
 #include "roc_rtp/format_map.h"
 #include "roc_sndio/isink.h"
 
@@ -36,14 +40,24 @@ namespace roc {
 namespace pipeline {
 
 //! Sender pipeline.
-class Sender : public sndio::ISink, public core::NonCopyable<> {
+//! @remarks
+//!  Encodes audio frames written to the sink and sends packets to source, repair,
+//!  and control ports. Incoming control packets may be written to the sender
+//!  as well; they are used to update link metrics.
+class Sender : public sndio::ISink,
+               public packet::IWriter,
+               public core::NonCopyable<> {
 public:
     //! Initialize.
+    //! @remarks
+    //!  If @p control_port protocol is Proto_None, RTCP is disabled.
     Sender(const SenderConfig& config,
            const PortConfig& source_port,
            packet::IWriter& source_writer,
            const PortConfig& repair_port,
            packet::IWriter& repair_writer,
+           const PortConfig& control_port,
+           packet::IWriter& control_writer,
            const fec::CodecMap& codec_map,
            const rtp::FormatMap& format_map,
            packet::PacketPool& packet_pool,
@@ -60,12 +74,53 @@ public:
     //! Check if the sink has own clock.
     virtual bool has_clock() const;
 
+    //! Get current playback latency of the sink.
+    virtual core::nanoseconds_t latency() const;
+
     //! Write audio frame.
     virtual void write(audio::Frame& frame);
 
+    //! Write incoming control packet.
+    //! @remarks
+    //!  May be called from any thread.
+    virtual void write(const packet::PacketPtr& packet);
+
+    //! Add one more destination for source or repair packets.
+    //! @remarks
+    //!  @p port protocol should match the protocol of the source or repair
+    //!  port passed to constructor. Packets are encoded once and sent to every
+    //!  destination; only UDP headers differ. Should be called before the
+    //!  first write().
+    //! @returns
+    //!  false if the protocol doesn't match or the destination is already added.
+    bool add_destination(const PortConfig& port);
+
+    //! Get link metrics reported by receiver.
+    //! @returns
+    //!  false if RTCP is disabled.
+    bool get_metrics(rtcp::LinkMetrics& metrics) const;
+
+    //! Get sender statistics.
+    void get_stats(SenderStats& stats) const;
+
+    //! Report loss ratio observed by receiver.
+    //! @remarks
+    //!  Used to adjust FEC block size when adaptive FEC is enabled.
+    //!  @p loss_ratio is a fraction of lost packets, in range [0; 1].
+    //! @returns
+    //!  false if adaptive FEC is not enabled.
+    bool report_loss(float loss_ratio);
+
 private:
+    void update_fec_block_size_();
+    void send_report_();
+
     core::UniquePtr<SenderPort> source_port_;
     core::UniquePtr<SenderPort> repair_port_;
+    core::UniquePtr<SenderPort> control_port_;
+
+    core::UniquePtr<rtcp::SenderReporter> rtcp_reporter_;
+    rtcp::Parser rtcp_parser_;
 
     core::UniquePtr<packet::Router> router_;
 
@@ -73,6 +128,7 @@ private:
 
     core::UniquePtr<fec::IBlockEncoder> fec_encoder_;
     core::UniquePtr<fec::Writer> fec_writer_;
+    core::UniquePtr<fec::BlockSizeController> fec_controller_;
 
     core::UniquePtr<audio::IFrameEncoder> payload_encoder_;
     core::UniquePtr<audio::Packetizer> packetizer_;
@@ -86,10 +142,16 @@ private:
 
     audio::IWriter* audio_writer_;
 
+    packet::PacketPool& packet_pool_;
+    core::BufferPool<uint8_t>& byte_buffer_pool_;
+
     SenderConfig config_;
 
     packet::timestamp_t timestamp_;
     size_t num_channels_;
+
+    packet::timestamp_t report_interval_;
+    packet::timestamp_t report_pos_;
 };
 
 } // namespace pipeline
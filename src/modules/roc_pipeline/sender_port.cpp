@@ -11,16 +11,22 @@
 #include "roc_core/panic.h"
 #include "roc_fec/composer.h"
 #include "roc_fec/headers.h"
+#include "roc_packet/address_to_str.h"
 
 namespace roc {
 namespace pipeline {
 
 SenderPort::SenderPort(const PortConfig& config,
                        packet::IWriter& writer,
+                       packet::PacketPool& packet_pool,
                        core::IAllocator& allocator)
-    : dst_address_(config.address)
+    : config_(config)
+    , extra_addresses_(allocator)
+    , extra_packets_(allocator)
     , writer_(writer)
-    , composer_(NULL) {
+    , packet_pool_(packet_pool)
+    , composer_(NULL)
+    , num_packets_(0) {
     packet::IComposer* composer = NULL;
 
     switch ((unsigned)config.protocol) {
@@ -33,6 +39,13 @@ SenderPort::SenderPort(const PortConfig& config,
         }
         composer = rtp_composer_.get();
         break;
+    case Proto_RTCP:
+        rtcp_composer_.reset(new (allocator) rtcp::Composer(), allocator);
+        if (!rtcp_composer_) {
+            return;
+        }
+        composer = rtcp_composer_.get();
+        break;
     }
 
     switch ((unsigned)config.protocol) {
@@ -87,6 +100,49 @@ bool SenderPort::valid() const {
     return composer_;
 }
 
+const PortConfig& SenderPort::config() const {
+    return config_;
+}
+
+size_t SenderPort::num_destinations() const {
+    return extra_addresses_.size() + 1;
+}
+
+size_t SenderPort::num_packets() const {
+    return num_packets_;
+}
+
+bool SenderPort::add_destination(const packet::Address& address) {
+    roc_panic_if(!valid());
+
+    if (address == config_.address) {
+        roc_log(LogError, "sender port: duplicate destination %s",
+                packet::address_to_str(address).c_str());
+        return false;
+    }
+
+    for (size_t n = 0; n < extra_addresses_.size(); n++) {
+        if (address == extra_addresses_[n]) {
+            roc_log(LogError, "sender port: duplicate destination %s",
+                    packet::address_to_str(address).c_str());
+            return false;
+        }
+    }
+
+    if (!extra_addresses_.grow(extra_addresses_.size() + 1)
+        || !extra_packets_.grow(extra_addresses_.size() + 1)) {
+        roc_log(LogError, "sender port: can't allocate destination");
+        return false;
+    }
+
+    extra_addresses_.push_back(address);
+
+    roc_log(LogDebug, "sender port: added destination %s: num_destinations=%lu",
+            packet::address_to_str(address).c_str(), (unsigned long)num_destinations());
+
+    return true;
+}
+
 packet::IComposer& SenderPort::composer() {
     roc_panic_if(!valid());
 
@@ -100,7 +156,7 @@ void SenderPort::write(const packet::PacketPtr& packet) {
 
     packet::UDP& udp = *packet->udp();
 
-    udp.dst_addr = dst_address_;
+    udp.dst_addr = config_.address;
 
     if ((packet->flags() & packet::Packet::FlagComposed) == 0) {
         if (!composer_->compose(*packet)) {
@@ -109,7 +165,55 @@ void SenderPort::write(const packet::PacketPtr& packet) {
         packet->add_flags(packet::Packet::FlagComposed);
     }
 
+    // copies are made before the packet is passed to the writer, which may
+    // hand it over to another thread
+    for (size_t n = 0; n < extra_addresses_.size(); n++) {
+        packet::PacketPtr copy = copy_packet_(*packet, extra_addresses_[n]);
+        if (!copy) {
+            roc_log(LogError, "sender port: can't allocate packet");
+            continue;
+        }
+        extra_packets_.push_back(copy);
+    }
+
     writer_.write(packet);
+    num_packets_++;
+
+    for (size_t n = 0; n < extra_packets_.size(); n++) {
+        writer_.write(extra_packets_[n]);
+        num_packets_++;
+    }
+
+    extra_packets_.resize(0);
+}
+
+packet::PacketPtr SenderPort::copy_packet_(const packet::Packet& packet,
+                                           const packet::Address& dst_address) {
+    packet::PacketPtr copy = new (packet_pool_) packet::Packet(packet_pool_);
+    if (!copy) {
+        return NULL;
+    }
+
+    copy->add_flags(packet.flags());
+
+    // only addresses and timestamp are copied, the rest of UDP struct is
+    // owned by the network thread
+    copy->udp()->src_addr = packet.udp()->src_addr;
+    copy->udp()->dst_addr = dst_address;
+    copy->udp()->receive_timestamp = packet.udp()->receive_timestamp;
+
+    if (packet.rtp()) {
+        *copy->rtp() = *packet.rtp();
+    }
+
+    if (packet.fec()) {
+        *copy->fec() = *packet.fec();
+    }
+
+    // buffer is shared, only headers are copied
+    copy->set_data(packet.data());
+
+    return copy;
 }
 
 } // namespace pipeline
@@ -12,12 +12,15 @@
 #ifndef ROC_PIPELINE_SENDER_PORT_H_
 #define ROC_PIPELINE_SENDER_PORT_H_
 
+#include "roc_core/array.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_packet/icomposer.h"
 #include "roc_packet/iwriter.h"
+#include "roc_packet/packet_pool.h"
 #include "roc_pipeline/config.h"
+#include "roc_rtcp/composer.h"
 #include "roc_rtp/composer.h"
 
 namespace roc {
@@ -25,17 +28,36 @@ namespace pipeline {
 
 //! Sender port pipeline.
 //! @remarks
-//!  Created at the sender side for every sending port.
+//!  Created at the sender side for every sending port. A port may have several
+//!  destination addresses; packets are composed once and their buffers are
+//!  shared between destinations.
 class SenderPort : public packet::IWriter, public core::NonCopyable<> {
 public:
     //! Initialize.
     SenderPort(const PortConfig& config,
                packet::IWriter& writer,
+               packet::PacketPool& packet_pool,
                core::IAllocator& allocator);
 
     //! Check if the port pipeline was succefully constructed.
     bool valid() const;
 
+    //! Get port config.
+    //! @remarks
+    //!  Config address is the first destination address.
+    const PortConfig& config() const;
+
+    //! Get number of destination addresses.
+    size_t num_destinations() const;
+
+    //! Get number of packets written, summed over all destinations.
+    size_t num_packets() const;
+
+    //! Add one more destination address.
+    //! @remarks
+    //!  Should not be called concurrently with write().
+    bool add_destination(const packet::Address& address);
+
     //! Get packet composer.
     packet::IComposer& composer();
 
@@ -43,13 +65,23 @@ public:
     void write(const packet::PacketPtr& packet);
 
 private:
-    const packet::Address dst_address_;
+    packet::PacketPtr copy_packet_(const packet::Packet& packet,
+                                   const packet::Address& dst_address);
+
+    const PortConfig config_;
+
+    core::Array<packet::Address> extra_addresses_;
+    core::Array<packet::PacketPtr> extra_packets_;
 
     packet::IWriter& writer_;
+    packet::PacketPool& packet_pool_;
     packet::IComposer* composer_;
 
     core::UniquePtr<rtp::Composer> rtp_composer_;
+    core::UniquePtr<rtcp::Composer> rtcp_composer_;
     core::UniquePtr<packet::IComposer> fec_composer_;
+
+    size_t num_packets_;
 };
 
 } // namespace pipeline
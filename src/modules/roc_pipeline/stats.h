@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_pipeline/stats.h
+//! @brief Pipeline statistics.
+
+#ifndef ROC_PIPELINE_STATS_H_
+#define ROC_PIPELINE_STATS_H_
+
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_packet/address.h"
+#include "roc_rtcp/reports.h"
+
+namespace roc {
+namespace pipeline {
+
+//! Receiver packet counters.
+//! @remarks
+//!  All counters are cumulative.
+struct ReceiverPacketStats {
+    //! Number of source and repair packets routed to session.
+    size_t received;
+
+    //! Number of packets dropped by depacketizer because they were late.
+    size_t late;
+
+    //! Number of packets dropped because session queue was full.
+    size_t dropped;
+
+    //! Number of packets dropped because they were duplicates.
+    size_t duplicated;
+
+    //! Number of source packets restored using FEC.
+    size_t restored;
+
+    ReceiverPacketStats()
+        : received(0)
+        , late(0)
+        , dropped(0)
+        , duplicated(0)
+        , restored(0) {
+    }
+};
+
+//! Receiver session statistics.
+struct ReceiverSessionStats {
+    //! Sender address.
+    packet::Address src_address;
+
+    //! Packet counters.
+    ReceiverPacketStats packets;
+
+    //! Number of packets in session source queue.
+    size_t queue_size;
+
+    //! Current session latency, nanoseconds.
+    core::nanoseconds_t latency;
+
+    //! Current resampler scaling factor.
+    //! @remarks
+    //!  Equal to 1 if resampling is disabled.
+    float scaling;
+
+    //! Loss and jitter observed by session.
+    rtcp::LinkMetrics link;
+
+    ReceiverSessionStats()
+        : queue_size(0)
+        , latency(0)
+        , scaling(1.f) {
+    }
+};
+
+//! Receiver statistics.
+struct ReceiverStats {
+    //! Number of alive sessions.
+    size_t num_sessions;
+
+    //! Packet counters summed over all sessions, including removed ones.
+    ReceiverPacketStats packets;
+
+    ReceiverStats()
+        : num_sessions(0) {
+    }
+};
+
+//! Sender statistics.
+struct SenderStats {
+    //! Number of source packets sent, summed over all destinations.
+    size_t source_packets;
+
+    //! Number of repair packets sent, summed over all destinations.
+    size_t repair_packets;
+
+    //! Number of control packets sent.
+    size_t control_packets;
+
+    //! Number of source packets in current FEC block.
+    size_t fec_block_source_packets;
+
+    //! Number of repair packets in current FEC block.
+    size_t fec_block_repair_packets;
+
+    //! Link metrics reported by receiver via RTCP.
+    //! @remarks
+    //!  Zero if RTCP is disabled or no reports were received yet.
+    rtcp::LinkMetrics link;
+
+    SenderStats()
+        : source_packets(0)
+        , repair_packets(0)
+        , control_packets(0)
+        , fec_block_source_packets(0)
+        , fec_block_repair_packets(0) {
+    }
+};
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_STATS_H_
@@ -41,6 +41,16 @@ bool match_proto(PortType type, const char* str, PortProtocol& proto) {
             return false;
         }
         return true;
+
+    case Port_Control:
+        if (strcmp(str, "rtcp") == 0) {
+            proto = Proto_RTCP;
+        } else {
+            roc_log(LogError, "parse port: '%s' is not a valid control port protocol",
+                    str);
+            return false;
+        }
+        return true;
     }
 
     roc_log(LogError, "parse port: unsupported port type");
@@ -20,6 +20,8 @@ const char* port_type_to_str(PortType type) {
         return "source";
     case Port_AudioRepair:
         return "repair";
+    case Port_Control:
+        return "control";
     }
     return "?";
 }
@@ -38,6 +40,8 @@ const char* port_proto_to_str(PortProtocol proto) {
         return "rtp+ldpc";
     case Proto_LDPC_Repair:
         return "ldpc";
+    case Proto_RTCP:
+        return "rtcp";
     }
     return "?";
 }
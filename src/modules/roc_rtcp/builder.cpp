@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtcp/builder.h"
+#include "roc_core/log.h"
+
+namespace roc {
+namespace rtcp {
+
+namespace {
+
+uint8_t fraction_to_fixed(float fraction) {
+    if (!(fraction > 0)) {
+        return 0;
+    }
+    if (fraction >= 1) {
+        return 0xff;
+    }
+    return (uint8_t)(fraction * 256);
+}
+
+} // namespace
+
+Builder::Builder(core::Slice<uint8_t>& data)
+    : data_(data) {
+}
+
+bool Builder::add_sender_report(const SenderReport& sr,
+                                const ReceptionReport* blocks,
+                                size_t n_blocks) {
+    if (n_blocks > MaxReportBlocks) {
+        roc_log(LogDebug, "rtcp builder: too many report blocks: n=%lu max=%lu",
+                (unsigned long)n_blocks, (unsigned long)MaxReportBlocks);
+        return false;
+    }
+
+    const size_t size = sizeof(SenderReportPacket) + n_blocks * sizeof(ReportBlock);
+
+    uint8_t* data = append_(size);
+    if (!data) {
+        return false;
+    }
+
+    SenderReportPacket& packet = *(SenderReportPacket*)data;
+    packet.clear();
+
+    packet.header().set_version(V2);
+    packet.header().set_type(RTCP_SR);
+    packet.header().set_counter(n_blocks);
+    packet.header().set_size(size);
+
+    packet.set_ssrc(sr.ssrc);
+    packet.set_ntp_timestamp(sr.ntp_timestamp);
+    packet.set_rtp_timestamp(sr.rtp_timestamp);
+    packet.set_packet_count(sr.packet_count);
+    packet.set_byte_count(sr.byte_count);
+
+    write_blocks_(data + sizeof(SenderReportPacket), blocks, n_blocks);
+
+    return true;
+}
+
+bool Builder::add_receiver_report(packet::source_t ssrc,
+                                  const ReceptionReport* blocks,
+                                  size_t n_blocks) {
+    if (n_blocks > MaxReportBlocks) {
+        roc_log(LogDebug, "rtcp builder: too many report blocks: n=%lu max=%lu",
+                (unsigned long)n_blocks, (unsigned long)MaxReportBlocks);
+        return false;
+    }
+
+    const size_t size = sizeof(ReceiverReportPacket) + n_blocks * sizeof(ReportBlock);
+
+    uint8_t* data = append_(size);
+    if (!data) {
+        return false;
+    }
+
+    ReceiverReportPacket& packet = *(ReceiverReportPacket*)data;
+    packet.clear();
+
+    packet.header().set_version(V2);
+    packet.header().set_type(RTCP_RR);
+    packet.header().set_counter(n_blocks);
+    packet.header().set_size(size);
+
+    packet.set_ssrc(ssrc);
+
+    write_blocks_(data + sizeof(ReceiverReportPacket), blocks, n_blocks);
+
+    return true;
+}
+
+uint8_t* Builder::append_(size_t size) {
+    const size_t offset = data_.size();
+
+    if (data_.capacity() - offset < size) {
+        roc_log(LogDebug, "rtcp builder: not enough space: size=%lu avail=%lu",
+                (unsigned long)size, (unsigned long)(data_.capacity() - offset));
+        return NULL;
+    }
+
+    data_.resize(offset + size);
+
+    return data_.data() + offset;
+}
+
+void Builder::write_blocks_(uint8_t* data,
+                            const ReceptionReport* blocks,
+                            size_t n_blocks) {
+    for (size_t n = 0; n < n_blocks; n++) {
+        ReportBlock& block = ((ReportBlock*)data)[n];
+        block.clear();
+
+        block.set_ssrc(blocks[n].sender_ssrc);
+        block.set_fraction_lost(fraction_to_fixed(blocks[n].fraction_lost));
+        block.set_cumulative_lost(blocks[n].cumulative_lost);
+        block.set_last_seqnum(blocks[n].last_seqnum);
+        block.set_jitter(blocks[n].jitter);
+        block.set_last_sr(blocks[n].last_sr);
+        block.set_delay_last_sr(blocks[n].delay_last_sr);
+    }
+}
+
+} // namespace rtcp
+} // namespace roc
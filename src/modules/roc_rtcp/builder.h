@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtcp/builder.h
+//! @brief RTCP packet builder.
+
+#ifndef ROC_RTCP_BUILDER_H_
+#define ROC_RTCP_BUILDER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_packet/units.h"
+#include "roc_rtcp/headers.h"
+#include "roc_rtcp/reports.h"
+
+namespace roc {
+namespace rtcp {
+
+//! RTCP packet builder.
+//! @remarks
+//!  Appends SR and RR packets to a compound RTCP packet.
+class Builder : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  Packets are appended to @p data, which is resized accordingly,
+    //!  up to its capacity.
+    explicit Builder(core::Slice<uint8_t>& data);
+
+    //! Append sender report packet.
+    //! @returns
+    //!  false if there is not enough space or too many report blocks.
+    bool add_sender_report(const SenderReport& sr,
+                           const ReceptionReport* blocks,
+                           size_t n_blocks);
+
+    //! Append receiver report packet.
+    //! @returns
+    //!  false if there is not enough space or too many report blocks.
+    bool add_receiver_report(packet::source_t ssrc,
+                             const ReceptionReport* blocks,
+                             size_t n_blocks);
+
+private:
+    uint8_t* append_(size_t size);
+    void write_blocks_(uint8_t* data, const ReceptionReport* blocks, size_t n_blocks);
+
+    core::Slice<uint8_t>& data_;
+};
+
+} // namespace rtcp
+} // namespace roc
+
+#endif // ROC_RTCP_BUILDER_H_
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtcp/composer.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_rtcp/traverser.h"
+
+namespace roc {
+namespace rtcp {
+
+bool Composer::align(core::Slice<uint8_t>& buffer, size_t, size_t payload_alignment) {
+    if ((unsigned long)buffer.data() % payload_alignment != 0) {
+        roc_panic("rtcp composer: unexpected non-aligned buffer");
+    }
+
+    return true;
+}
+
+bool Composer::prepare(packet::Packet& packet,
+                       core::Slice<uint8_t>& buffer,
+                       size_t payload_size) {
+    if (buffer.capacity() < payload_size) {
+        roc_log(LogDebug,
+                "rtcp composer: not enough space for rtcp packet: size=%lu cap=%lu",
+                (unsigned long)payload_size, (unsigned long)buffer.capacity());
+        return false;
+    }
+
+    buffer.resize(payload_size);
+
+    packet.add_flags(packet::Packet::FlagRTCP);
+    packet.set_data(buffer);
+
+    return true;
+}
+
+bool Composer::pad(packet::Packet&, size_t) {
+    return false;
+}
+
+bool Composer::compose(packet::Packet& packet) {
+    if ((packet.flags() & packet::Packet::FlagRTCP) == 0) {
+        roc_panic("rtcp composer: unexpected non-rtcp packet");
+    }
+
+    Traverser traverser(packet.data());
+
+    if (!traverser.validate()) {
+        roc_log(LogDebug, "rtcp composer: bad compound packet");
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace rtcp
+} // namespace roc
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtcp/composer.h
+//! @brief RTCP packet composer.
+
+#ifndef ROC_RTCP_COMPOSER_H_
+#define ROC_RTCP_COMPOSER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_packet/icomposer.h"
+
+namespace roc {
+namespace rtcp {
+
+//! RTCP packet composer.
+//! @remarks
+//!  RTCP packet contents are formatted by Builder directly into the packet
+//!  buffer, so composer only reserves space and validates the result.
+class Composer : public packet::IComposer, public core::NonCopyable<> {
+public:
+    //! Adjust buffer to align payload.
+    virtual bool
+    align(core::Slice<uint8_t>& buffer, size_t header_size, size_t payload_alignment);
+
+    //! Prepare buffer for composing a packet.
+    virtual bool
+    prepare(packet::Packet& packet, core::Slice<uint8_t>& buffer, size_t payload_size);
+
+    //! Pad packet.
+    virtual bool pad(packet::Packet& packet, size_t padding_size);
+
+    //! Compose packet to buffer.
+    virtual bool compose(packet::Packet& packet);
+};
+
+} // namespace rtcp
+} // namespace roc
+
+#endif // ROC_RTCP_COMPOSER_H_
@@ -0,0 +1,426 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtcp/headers.h
+//! @brief RTCP headers.
+
+#ifndef ROC_RTCP_HEADERS_H_
+#define ROC_RTCP_HEADERS_H_
+
+#include "roc_core/attributes.h"
+#include "roc_core/endian.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace rtcp {
+
+//! RTCP protocol version.
+enum Version {
+    V2 = 2 //!< RTCP version 2.
+};
+
+//! RTCP packet type.
+enum PacketType {
+    RTCP_SR = 200,   //!< Sender report.
+    RTCP_RR = 201,   //!< Receiver report.
+    RTCP_SDES = 202, //!< Source description.
+    RTCP_BYE = 203,  //!< Goodbye.
+    RTCP_APP = 204   //!< Application-defined.
+};
+
+//! Maximum number of report blocks in one SR or RR packet.
+const size_t MaxReportBlocks = 31;
+
+//! RTCP common header.
+//! @remarks
+//!  Every RTCP packet in a compound packet starts with this header.
+//!
+//! @code
+//!    0             1               2               3               4
+//!    0 1 2 3 4 5 6 7 0 1 2 3 4 5 6 7 0 1 2 3 4 5 6 7 0 1 2 3 4 5 6 7
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |V=2|P|    RC   |       PT      |             length            |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+class ROC_ATTR_PACKED Header {
+private:
+    enum {
+        //! @name RTCP protocol version.
+        // @{
+        Flag_VersionShift = 6,
+        Flag_VersionMask = 0x3,
+        // @}
+
+        //! @name RTCP padding flag.
+        // @{
+        Flag_PaddingShift = 5,
+        Flag_PaddingMask = 0x1,
+        // @}
+
+        //! @name Number of report blocks or other items.
+        // @{
+        Flag_CounterShift = 0,
+        Flag_CounterMask = 0x1f
+        // @}
+    };
+
+    //! Packed flags (Flag_*).
+    uint8_t flags_;
+
+    //! Packet type.
+    uint8_t type_;
+
+    //! Packet length in 32-bit words minus one, including header.
+    uint16_t length_;
+
+public:
+    //! Clear header.
+    void clear() {
+        memset(this, 0, sizeof(*this));
+    }
+
+    //! Get version.
+    uint8_t version() const {
+        return ((flags_ >> Flag_VersionShift) & Flag_VersionMask);
+    }
+
+    //! Set version.
+    void set_version(Version v) {
+        roc_panic_if((v & Flag_VersionMask) != v);
+        flags_ &= ~(Flag_VersionMask << Flag_VersionShift);
+        flags_ |= (v << Flag_VersionShift);
+    }
+
+    //! Get padding flag.
+    bool has_padding() const {
+        return (flags_ & (Flag_PaddingMask << Flag_PaddingShift));
+    }
+
+    //! Get number of items (e.g. report blocks).
+    size_t counter() const {
+        return ((flags_ >> Flag_CounterShift) & Flag_CounterMask);
+    }
+
+    //! Set number of items.
+    void set_counter(size_t c) {
+        roc_panic_if((c & Flag_CounterMask) != c);
+        flags_ &= ~(Flag_CounterMask << Flag_CounterShift);
+        flags_ |= (uint8_t)(c << Flag_CounterShift);
+    }
+
+    //! Get packet type.
+    uint8_t type() const {
+        return type_;
+    }
+
+    //! Set packet type.
+    void set_type(PacketType t) {
+        type_ = (uint8_t)t;
+    }
+
+    //! Get packet size in bytes, including header.
+    size_t size() const {
+        return ((size_t)core::ntoh16(length_) + 1) * 4;
+    }
+
+    //! Set packet size in bytes, including header.
+    //! @remarks
+    //!  Size should be multiple of four.
+    void set_size(size_t sz) {
+        roc_panic_if(sz < 4 || sz % 4 != 0 || sz / 4 - 1 > 0xffff);
+        length_ = core::hton16((uint16_t)(sz / 4 - 1));
+    }
+};
+
+//! RTCP reception report block.
+//! @remarks
+//!  Included into SR and RR packets.
+//!
+//! @code
+//!    0             1               2               3               4
+//!    0 1 2 3 4 5 6 7 0 1 2 3 4 5 6 7 0 1 2 3 4 5 6 7 0 1 2 3 4 5 6 7
+//!   +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+//!   |                 SSRC_1 (SSRC of first source)                 |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   | fraction lost |       cumulative number of packets lost       |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |           extended highest sequence number received           |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                      interarrival jitter                      |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                         last SR (LSR)                         |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                   delay since last SR (DLSR)                  |
+//!   +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+//! @endcode
+class ROC_ATTR_PACKED ReportBlock {
+private:
+    enum {
+        Losses_FractionShift = 24,
+        Losses_FractionMask = 0xff,
+        Losses_CumulativeShift = 0,
+        Losses_CumulativeMask = 0xffffff
+    };
+
+    uint32_t ssrc_;
+    uint32_t losses_;
+    uint32_t last_seqnum_;
+    uint32_t jitter_;
+    uint32_t last_sr_;
+    uint32_t delay_last_sr_;
+
+public:
+    //! Clear block.
+    void clear() {
+        memset(this, 0, sizeof(*this));
+    }
+
+    //! Get SSRC of the reported source.
+    uint32_t ssrc() const {
+        return core::ntoh32(ssrc_);
+    }
+
+    //! Set SSRC of the reported source.
+    void set_ssrc(uint32_t s) {
+        ssrc_ = core::hton32(s);
+    }
+
+    //! Get fraction of lost packets, fixed point with 8 fractional bits.
+    uint8_t fraction_lost() const {
+        return (uint8_t)((core::ntoh32(losses_) >> Losses_FractionShift)
+                         & Losses_FractionMask);
+    }
+
+    //! Set fraction of lost packets, fixed point with 8 fractional bits.
+    void set_fraction_lost(uint8_t f) {
+        uint32_t losses = core::ntoh32(losses_);
+        losses &= ~((uint32_t)Losses_FractionMask << Losses_FractionShift);
+        losses |= ((uint32_t)f << Losses_FractionShift);
+        losses_ = core::hton32(losses);
+    }
+
+    //! Get cumulative number of lost packets.
+    //! @remarks
+    //!  May be negative if duplicates were received.
+    int32_t cumulative_lost() const {
+        uint32_t v = (core::ntoh32(losses_) >> Losses_CumulativeShift)
+            & Losses_CumulativeMask;
+        if (v & 0x800000) {
+            v |= 0xff000000;
+        }
+        return (int32_t)v;
+    }
+
+    //! Set cumulative number of lost packets.
+    //! @remarks
+    //!  The value is clamped to 24-bit signed range.
+    void set_cumulative_lost(int32_t l) {
+        if (l > 0x7fffff) {
+            l = 0x7fffff;
+        }
+        if (l < -0x800000) {
+            l = -0x800000;
+        }
+        uint32_t losses = core::ntoh32(losses_);
+        losses &= ~((uint32_t)Losses_CumulativeMask << Losses_CumulativeShift);
+        losses |= (((uint32_t)l & Losses_CumulativeMask) << Losses_CumulativeShift);
+        losses_ = core::hton32(losses);
+    }
+
+    //! Get extended highest sequence number received.
+    uint32_t last_seqnum() const {
+        return core::ntoh32(last_seqnum_);
+    }
+
+    //! Set extended highest sequence number received.
+    void set_last_seqnum(uint32_t sn) {
+        last_seqnum_ = core::hton32(sn);
+    }
+
+    //! Get interarrival jitter, in timestamp units.
+    uint32_t jitter() const {
+        return core::ntoh32(jitter_);
+    }
+
+    //! Set interarrival jitter, in timestamp units.
+    void set_jitter(uint32_t j) {
+        jitter_ = core::hton32(j);
+    }
+
+    //! Get middle 32 bits of the NTP timestamp of the last SR.
+    uint32_t last_sr() const {
+        return core::ntoh32(last_sr_);
+    }
+
+    //! Set middle 32 bits of the NTP timestamp of the last SR.
+    void set_last_sr(uint32_t t) {
+        last_sr_ = core::hton32(t);
+    }
+
+    //! Get delay since last SR, in 1/65536 seconds.
+    uint32_t delay_last_sr() const {
+        return core::ntoh32(delay_last_sr_);
+    }
+
+    //! Set delay since last SR, in 1/65536 seconds.
+    void set_delay_last_sr(uint32_t d) {
+        delay_last_sr_ = core::hton32(d);
+    }
+};
+
+//! RTCP sender report packet.
+//! @remarks
+//!  Followed by zero or more report blocks.
+//!
+//! @code
+//!    0             1               2               3               4
+//!    0 1 2 3 4 5 6 7 0 1 2 3 4 5 6 7 0 1 2 3 4 5 6 7 0 1 2 3 4 5 6 7
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |V=2|P|    RC   |   PT=SR=200   |             length            |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                         SSRC of sender                        |
+//!   +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+//!   |              NTP timestamp, most significant word             |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |             NTP timestamp, least significant word             |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                         RTP timestamp                         |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                     sender's packet count                     |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                      sender's octet count                     |
+//!   +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+//! @endcode
+class ROC_ATTR_PACKED SenderReportPacket {
+private:
+    Header header_;
+    uint32_t ssrc_;
+    uint32_t ntp_msw_;
+    uint32_t ntp_lsw_;
+    uint32_t rtp_timestamp_;
+    uint32_t packet_count_;
+    uint32_t byte_count_;
+
+public:
+    //! Clear packet.
+    void clear() {
+        memset(this, 0, sizeof(*this));
+    }
+
+    //! Get common header.
+    const Header& header() const {
+        return header_;
+    }
+
+    //! Get common header.
+    Header& header() {
+        return header_;
+    }
+
+    //! Get SSRC of sender.
+    uint32_t ssrc() const {
+        return core::ntoh32(ssrc_);
+    }
+
+    //! Set SSRC of sender.
+    void set_ssrc(uint32_t s) {
+        ssrc_ = core::hton32(s);
+    }
+
+    //! Get 64-bit NTP timestamp.
+    uint64_t ntp_timestamp() const {
+        return ((uint64_t)core::ntoh32(ntp_msw_) << 32) | core::ntoh32(ntp_lsw_);
+    }
+
+    //! Set 64-bit NTP timestamp.
+    void set_ntp_timestamp(uint64_t t) {
+        ntp_msw_ = core::hton32((uint32_t)(t >> 32));
+        ntp_lsw_ = core::hton32((uint32_t)t);
+    }
+
+    //! Get RTP timestamp corresponding to the NTP timestamp.
+    uint32_t rtp_timestamp() const {
+        return core::ntoh32(rtp_timestamp_);
+    }
+
+    //! Set RTP timestamp corresponding to the NTP timestamp.
+    void set_rtp_timestamp(uint32_t t) {
+        rtp_timestamp_ = core::hton32(t);
+    }
+
+    //! Get number of packets sent.
+    uint32_t packet_count() const {
+        return core::ntoh32(packet_count_);
+    }
+
+    //! Set number of packets sent.
+    void set_packet_count(uint32_t c) {
+        packet_count_ = core::hton32(c);
+    }
+
+    //! Get number of payload bytes sent.
+    uint32_t byte_count() const {
+        return core::ntoh32(byte_count_);
+    }
+
+    //! Set number of payload bytes sent.
+    void set_byte_count(uint32_t c) {
+        byte_count_ = core::hton32(c);
+    }
+};
+
+//! RTCP receiver report packet.
+//! @remarks
+//!  Followed by zero or more report blocks.
+//!
+//! @code
+//!    0             1               2               3               4
+//!    0 1 2 3 4 5 6 7 0 1 2 3 4 5 6 7 0 1 2 3 4 5 6 7 0 1 2 3 4 5 6 7
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |V=2|P|    RC   |   PT=RR=201   |             length            |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                     SSRC of packet sender                     |
+//!   +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+//! @endcode
+class ROC_ATTR_PACKED ReceiverReportPacket {
+private:
+    Header header_;
+    uint32_t ssrc_;
+
+public:
+    //! Clear packet.
+    void clear() {
+        memset(this, 0, sizeof(*this));
+    }
+
+    //! Get common header.
+    const Header& header() const {
+        return header_;
+    }
+
+    //! Get common header.
+    Header& header() {
+        return header_;
+    }
+
+    //! Get SSRC of packet sender.
+    uint32_t ssrc() const {
+        return core::ntoh32(ssrc_);
+    }
+
+    //! Set SSRC of packet sender.
+    void set_ssrc(uint32_t s) {
+        ssrc_ = core::hton32(s);
+    }
+};
+
+} // namespace rtcp
+} // namespace roc
+
+#endif // ROC_RTCP_HEADERS_H_
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtcp/ireport_handler.h
+//! @brief RTCP report handler interface.
+
+#ifndef ROC_RTCP_IREPORT_HANDLER_H_
+#define ROC_RTCP_IREPORT_HANDLER_H_
+
+#include "roc_rtcp/reports.h"
+
+namespace roc {
+namespace rtcp {
+
+//! RTCP report handler interface.
+class IReportHandler {
+public:
+    virtual ~IReportHandler();
+
+    //! Handle sender report.
+    virtual void handle_sender_report(const SenderReport& report) = 0;
+
+    //! Handle reception report.
+    virtual void handle_reception_report(const ReceptionReport& report) = 0;
+};
+
+} // namespace rtcp
+} // namespace roc
+
+#endif // ROC_RTCP_IREPORT_HANDLER_H_
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtcp/ntp.h
+//! @brief NTP timestamps.
+
+#ifndef ROC_RTCP_NTP_H_
+#define ROC_RTCP_NTP_H_
+
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace rtcp {
+
+//! 64-bit NTP timestamp.
+//! @remarks
+//!  High 32 bits contain seconds, low 32 bits contain fractions of second.
+typedef uint64_t ntp_timestamp_t;
+
+//! Number of seconds between NTP epoch (1900) and Unix epoch (1970).
+const uint32_t NtpUnixOffset = 2208988800u;
+
+//! Convert nanoseconds to NTP timestamp.
+inline ntp_timestamp_t ntp_from_ns(core::nanoseconds_t ns) {
+    const uint64_t sec = (uint64_t)(ns / core::Second);
+    const uint64_t frac = ((uint64_t)(ns % core::Second) << 32) / core::Second;
+    return (sec << 32) | frac;
+}
+
+//! Convert NTP timestamp to nanoseconds.
+inline core::nanoseconds_t ntp_to_ns(ntp_timestamp_t ntp) {
+    const core::nanoseconds_t sec = (core::nanoseconds_t)(ntp >> 32);
+    const core::nanoseconds_t frac =
+        (core::nanoseconds_t)(((ntp & 0xffffffff) * core::Second) >> 32);
+    return sec * core::Second + frac;
+}
+
+//! Convert Unix time in nanoseconds to NTP timestamp.
+inline ntp_timestamp_t ntp_from_unix_ns(core::nanoseconds_t unix_ns) {
+    return ntp_from_ns(unix_ns) + ((ntp_timestamp_t)NtpUnixOffset << 32);
+}
+
+//! Get current wall clock time as NTP timestamp.
+//! @remarks
+//!  Used for NTP fields of RTCP reports. Intervals, like RTT and DLSR, should
+//!  be measured using monotonic core::timestamp() instead.
+inline ntp_timestamp_t ntp_now() {
+    return ntp_from_unix_ns(core::timestamp_realtime());
+}
+
+//! Get middle 32 bits of NTP timestamp.
+//! @remarks
+//!  This compact form is used in LSR and DLSR fields of report blocks.
+inline uint32_t ntp_compact(ntp_timestamp_t ntp) {
+    return (uint32_t)(ntp >> 16);
+}
+
+//! Convert compact NTP timestamp or duration to nanoseconds.
+inline core::nanoseconds_t ntp_compact_to_ns(uint32_t compact) {
+    return (core::nanoseconds_t)(((uint64_t)compact * core::Second) >> 16);
+}
+
+//! Convert nanoseconds duration to compact NTP form.
+inline uint32_t ntp_compact_from_ns(core::nanoseconds_t ns) {
+    return ntp_compact(ntp_from_ns(ns));
+}
+
+} // namespace rtcp
+} // namespace roc
+
+#endif // ROC_RTCP_NTP_H_
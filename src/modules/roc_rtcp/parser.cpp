@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtcp/parser.h"
+#include "roc_core/log.h"
+#include "roc_rtcp/traverser.h"
+
+namespace roc {
+namespace rtcp {
+
+bool Parser::parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
+    Traverser traverser(buffer);
+
+    if (!traverser.validate()) {
+        roc_log(LogDebug, "rtcp parser: bad compound packet");
+        return false;
+    }
+
+    packet.add_flags(packet::Packet::FlagRTCP);
+
+    return true;
+}
+
+} // namespace rtcp
+} // namespace roc
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtcp/receiver_reporter.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_rtcp/ntp.h"
+#include "roc_rtcp/traverser.h"
+
+namespace roc {
+namespace rtcp {
+
+ReceiverReporter::ReceiverReporter(packet::source_t ssrc, size_t sample_rate)
+    : ssrc_(ssrc)
+    , sample_rate_(sample_rate)
+    , has_packets_(false)
+    , sender_ssrc_(0)
+    , base_seqnum_(0)
+    , max_seqnum_(0)
+    , seqnum_cycles_(0)
+    , received_(0)
+    , expected_prior_(0)
+    , received_prior_(0)
+    , fraction_lost_(0)
+    , first_arrival_(0)
+    , first_timestamp_(0)
+    , last_transit_(0)
+    , jitter_(0)
+    , got_sr_(false)
+    , has_sr_(false)
+    , last_sr_arrival_(0)
+    , arrival_(0) {
+    roc_panic_if(sample_rate == 0);
+}
+
+bool ReceiverReporter::process_packet(const packet::Packet& packet) {
+    core::nanoseconds_t arrival = 0;
+    if (packet.udp()) {
+        arrival = packet.udp()->receive_timestamp;
+    }
+    if (arrival == 0) {
+        arrival = core::timestamp();
+    }
+
+    if (packet.flags() & packet::Packet::FlagRTCP) {
+        arrival_ = arrival;
+        got_sr_ = false;
+
+        Traverser traverser(packet.data());
+        if (!traverser.traverse(*this)) {
+            roc_log(LogDebug, "rtcp receiver reporter: can't parse rtcp packet");
+        }
+        return got_sr_;
+    }
+
+    if (packet.rtp() && (packet.flags() & packet::Packet::FlagAudio)) {
+        process_rtp_(*packet.rtp(), arrival);
+    }
+
+    return false;
+}
+
+bool ReceiverReporter::build_report(ReceptionReport& report, core::nanoseconds_t now) {
+    if (!has_packets_) {
+        return false;
+    }
+
+    const int64_t expected = expected_packets_();
+
+    const int64_t expected_interval = expected - expected_prior_;
+    const int64_t received_interval = received_ - received_prior_;
+    const int64_t lost_interval = expected_interval - received_interval;
+
+    expected_prior_ = expected;
+    received_prior_ = received_;
+
+    if (expected_interval <= 0 || lost_interval <= 0) {
+        fraction_lost_ = 0;
+    } else {
+        fraction_lost_ = (float)lost_interval / (float)expected_interval;
+    }
+
+    report.receiver_ssrc = ssrc_;
+    report.sender_ssrc = sender_ssrc_;
+    report.fraction_lost = fraction_lost_;
+    report.cumulative_lost = (int32_t)(expected - received_);
+    report.last_seqnum = (seqnum_cycles_ << 16) | max_seqnum_;
+    report.jitter = (uint32_t)jitter_;
+
+    if (has_sr_) {
+        report.last_sr = ntp_compact(last_sr_.ntp_timestamp);
+        report.delay_last_sr = ntp_compact_from_ns(now - last_sr_arrival_);
+    } else {
+        report.last_sr = 0;
+        report.delay_last_sr = 0;
+    }
+
+    return true;
+}
+
+bool ReceiverReporter::has_sender_report() const {
+    return has_sr_;
+}
+
+const SenderReport& ReceiverReporter::last_sender_report() const {
+    return last_sr_;
+}
+
+LinkMetrics ReceiverReporter::metrics() const {
+    LinkMetrics metrics;
+
+    if (!has_packets_) {
+        return metrics;
+    }
+
+    metrics.fraction_lost = fraction_lost_;
+    metrics.cumulative_lost = (int32_t)(expected_packets_() - received_);
+    metrics.jitter = (core::nanoseconds_t)(jitter_ * core::Second / sample_rate_);
+
+    return metrics;
+}
+
+packet::source_t ReceiverReporter::ssrc() const {
+    return ssrc_;
+}
+
+void ReceiverReporter::handle_sender_report(const SenderReport& report) {
+    if (has_packets_ && report.ssrc != sender_ssrc_) {
+        roc_log(LogDebug,
+                "rtcp receiver reporter: ignoring sr for unknown source: ssrc=%lu",
+                (unsigned long)report.ssrc);
+        return;
+    }
+
+    last_sr_ = report;
+    last_sr_arrival_ = arrival_;
+    has_sr_ = true;
+    got_sr_ = true;
+}
+
+void ReceiverReporter::handle_reception_report(const ReceptionReport&) {
+    // reports about our own stream are not expected on receiver
+}
+
+void ReceiverReporter::process_rtp_(const packet::RTP& rtp,
+                                    core::nanoseconds_t arrival) {
+    if (!has_packets_) {
+        has_packets_ = true;
+
+        sender_ssrc_ = rtp.source;
+        base_seqnum_ = rtp.seqnum;
+        max_seqnum_ = rtp.seqnum;
+
+        first_arrival_ = arrival;
+        first_timestamp_ = rtp.timestamp;
+        last_transit_ = 0;
+
+        received_ = 1;
+        return;
+    }
+
+    if (rtp.source != sender_ssrc_) {
+        return;
+    }
+
+    received_++;
+
+    if (packet::seqnum_lt(max_seqnum_, rtp.seqnum)) {
+        if (rtp.seqnum < max_seqnum_) {
+            seqnum_cycles_++;
+        }
+        max_seqnum_ = rtp.seqnum;
+    }
+
+    update_jitter_(rtp.timestamp, arrival);
+}
+
+void ReceiverReporter::update_jitter_(packet::timestamp_t timestamp,
+                                      core::nanoseconds_t arrival) {
+    const int64_t arrival_ts =
+        (arrival - first_arrival_) * (int64_t)sample_rate_ / core::Second;
+
+    const int64_t transit =
+        arrival_ts - packet::timestamp_diff(timestamp, first_timestamp_);
+
+    int64_t d = transit - last_transit_;
+    if (d < 0) {
+        d = -d;
+    }
+
+    last_transit_ = transit;
+    jitter_ += ((float)d - jitter_) / 16;
+}
+
+int64_t ReceiverReporter::expected_packets_() const {
+    const int64_t ext_max = ((int64_t)seqnum_cycles_ << 16) | max_seqnum_;
+    return ext_max - base_seqnum_ + 1;
+}
+
+} // namespace rtcp
+} // namespace roc
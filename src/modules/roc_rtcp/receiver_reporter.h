@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtcp/receiver_reporter.h
+//! @brief Receiver-side RTCP reporter.
+
+#ifndef ROC_RTCP_RECEIVER_REPORTER_H_
+#define ROC_RTCP_RECEIVER_REPORTER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/time.h"
+#include "roc_packet/packet.h"
+#include "roc_packet/units.h"
+#include "roc_rtcp/ireport_handler.h"
+#include "roc_rtcp/reports.h"
+
+namespace roc {
+namespace rtcp {
+
+//! Receiver-side RTCP reporter.
+//! @remarks
+//!  Created for every receiver session.
+//!  - tracks received RTP packets and computes loss and interarrival jitter
+//!  - tracks received sender reports
+//!  - fills reception reports to be sent back to sender
+class ReceiverReporter : public IReportHandler, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p ssrc is the SSRC of this receiver, used in generated reports
+    //!  - @p sample_rate defines RTP timestamp units
+    ReceiverReporter(packet::source_t ssrc, size_t sample_rate);
+
+    //! Process incoming packet.
+    //! @remarks
+    //!  Accounts RTP packets and handles RTCP packets. Uses the packet
+    //!  receive timestamp if it is set, and current time otherwise.
+    //! @returns
+    //!  true if the packet contained a sender report for the tracked stream.
+    bool process_packet(const packet::Packet& packet);
+
+    //! Fill reception report for the sender.
+    //! @returns
+    //!  false if no RTP packets were received yet.
+    bool build_report(ReceptionReport& report, core::nanoseconds_t now);
+
+    //! Check if at least one sender report was received.
+    bool has_sender_report() const;
+
+    //! Get last received sender report.
+    //! @remarks
+    //!  Maps sender clock to stream timestamps.
+    const SenderReport& last_sender_report() const;
+
+    //! Get link metrics.
+    //! @remarks
+    //!  Loss and jitter are measured locally; RTT is not known on receiver.
+    LinkMetrics metrics() const;
+
+    //! Get SSRC of this receiver.
+    packet::source_t ssrc() const;
+
+private:
+    virtual void handle_sender_report(const SenderReport& report);
+    virtual void handle_reception_report(const ReceptionReport& report);
+
+    void process_rtp_(const packet::RTP& rtp, core::nanoseconds_t arrival);
+    void update_jitter_(packet::timestamp_t timestamp, core::nanoseconds_t arrival);
+
+    int64_t expected_packets_() const;
+
+    const packet::source_t ssrc_;
+    const size_t sample_rate_;
+
+    bool has_packets_;
+    packet::source_t sender_ssrc_;
+
+    packet::seqnum_t base_seqnum_;
+    packet::seqnum_t max_seqnum_;
+    uint32_t seqnum_cycles_;
+
+    int64_t received_;
+    int64_t expected_prior_;
+    int64_t received_prior_;
+    float fraction_lost_;
+
+    core::nanoseconds_t first_arrival_;
+    packet::timestamp_t first_timestamp_;
+    int64_t last_transit_;
+    float jitter_;
+
+    bool got_sr_;
+    bool has_sr_;
+    SenderReport last_sr_;
+    core::nanoseconds_t last_sr_arrival_;
+
+    core::nanoseconds_t arrival_;
+};
+
+} // namespace rtcp
+} // namespace roc
+
+#endif // ROC_RTCP_RECEIVER_REPORTER_H_
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtcp/reports.h
+//! @brief RTCP reports.
+
+#ifndef ROC_RTCP_REPORTS_H_
+#define ROC_RTCP_REPORTS_H_
+
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_packet/units.h"
+#include "roc_rtcp/ntp.h"
+
+namespace roc {
+namespace rtcp {
+
+//! Sender report.
+//! @remarks
+//!  Sender information from SR packet.
+struct SenderReport {
+    //! SSRC of the sender.
+    packet::source_t ssrc;
+
+    //! Sender clock at the moment of report.
+    ntp_timestamp_t ntp_timestamp;
+
+    //! Stream timestamp corresponding to the same moment.
+    packet::timestamp_t rtp_timestamp;
+
+    //! Number of packets sent.
+    uint32_t packet_count;
+
+    //! Number of payload bytes sent.
+    uint32_t byte_count;
+
+    SenderReport()
+        : ssrc(0)
+        , ntp_timestamp(0)
+        , rtp_timestamp(0)
+        , packet_count(0)
+        , byte_count(0) {
+    }
+};
+
+//! Reception report.
+//! @remarks
+//!  Report block from SR or RR packet.
+struct ReceptionReport {
+    //! SSRC of the report originator.
+    packet::source_t receiver_ssrc;
+
+    //! SSRC of the reported source.
+    packet::source_t sender_ssrc;
+
+    //! Fraction of packets lost since previous report, in range [0; 1].
+    float fraction_lost;
+
+    //! Cumulative number of packets lost.
+    int32_t cumulative_lost;
+
+    //! Extended highest sequence number received.
+    uint32_t last_seqnum;
+
+    //! Interarrival jitter, in timestamp units.
+    uint32_t jitter;
+
+    //! Compact NTP timestamp of the last SR received from the source.
+    uint32_t last_sr;
+
+    //! Delay since last SR, in compact NTP units.
+    uint32_t delay_last_sr;
+
+    ReceptionReport()
+        : receiver_ssrc(0)
+        , sender_ssrc(0)
+        , fraction_lost(0)
+        , cumulative_lost(0)
+        , last_seqnum(0)
+        , jitter(0)
+        , last_sr(0)
+        , delay_last_sr(0) {
+    }
+};
+
+//! Link metrics.
+//! @remarks
+//!  Computed from reports and incoming packets.
+struct LinkMetrics {
+    //! Fraction of packets lost during last report interval, in range [0; 1].
+    float fraction_lost;
+
+    //! Cumulative number of packets lost.
+    int32_t cumulative_lost;
+
+    //! Interarrival jitter, nanoseconds.
+    core::nanoseconds_t jitter;
+
+    //! Round-trip time, nanoseconds.
+    //! @remarks
+    //!  Zero if not known yet.
+    core::nanoseconds_t rtt;
+
+    LinkMetrics()
+        : fraction_lost(0)
+        , cumulative_lost(0)
+        , jitter(0)
+        , rtt(0) {
+    }
+};
+
+} // namespace rtcp
+} // namespace roc
+
+#endif // ROC_RTCP_REPORTS_H_
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtcp/sender_reporter.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_rtcp/ntp.h"
+#include "roc_rtcp/traverser.h"
+
+namespace roc {
+namespace rtcp {
+
+SenderReporter::SenderReporter(packet::IWriter& writer, size_t sample_rate)
+    : writer_(writer)
+    , sample_rate_(sample_rate)
+    , has_packets_(false)
+    , ssrc_(0)
+    , timestamp_(0)
+    , packet_count_(0)
+    , byte_count_(0)
+    , got_report_(false)
+    , arrival_(0)
+    , n_sent_reports_(0) {
+    roc_panic_if(sample_rate == 0);
+}
+
+void SenderReporter::write(const packet::PacketPtr& pp) {
+    if (!pp) {
+        roc_panic("rtcp sender reporter: unexpected null packet");
+    }
+
+    if (const packet::RTP* rtp = pp->rtp()) {
+        core::Mutex::Lock lock(mutex_);
+
+        has_packets_ = true;
+        ssrc_ = rtp->source;
+        timestamp_ = rtp->timestamp + rtp->duration;
+        packet_count_++;
+        byte_count_ += (uint32_t)rtp->payload.size();
+    }
+
+    writer_.write(pp);
+}
+
+bool SenderReporter::build_report(SenderReport& report,
+                                  ntp_timestamp_t ntp_time,
+                                  core::nanoseconds_t now) {
+    core::Mutex::Lock lock(mutex_);
+
+    if (!has_packets_) {
+        return false;
+    }
+
+    // receivers echo the wall clock time of the report in LSR field, so we
+    // remember when it was sent by monotonic clock
+    SentReport& sent = sent_reports_[n_sent_reports_ % MaxSentReports];
+    sent.ntp_compact = ntp_compact(ntp_time);
+    sent.time = now;
+    n_sent_reports_++;
+
+    report.ssrc = ssrc_;
+    report.ntp_timestamp = ntp_time;
+    report.rtp_timestamp = timestamp_;
+    report.packet_count = packet_count_;
+    report.byte_count = byte_count_;
+
+    return true;
+}
+
+bool SenderReporter::process_packet(const packet::Packet& packet) {
+    if ((packet.flags() & packet::Packet::FlagRTCP) == 0) {
+        return false;
+    }
+
+    core::nanoseconds_t arrival = 0;
+    if (packet.udp()) {
+        arrival = packet.udp()->receive_timestamp;
+    }
+    if (arrival == 0) {
+        arrival = core::timestamp();
+    }
+
+    core::Mutex::Lock lock(mutex_);
+
+    arrival_ = arrival;
+    got_report_ = false;
+
+    Traverser traverser(packet.data());
+    if (!traverser.traverse(*this)) {
+        roc_log(LogDebug, "rtcp sender reporter: can't parse rtcp packet");
+    }
+
+    return got_report_;
+}
+
+LinkMetrics SenderReporter::metrics() const {
+    core::Mutex::Lock lock(mutex_);
+
+    return metrics_;
+}
+
+void SenderReporter::handle_sender_report(const SenderReport&) {
+    // sender reports from other senders are not used
+}
+
+void SenderReporter::handle_reception_report(const ReceptionReport& report) {
+    if (!has_packets_ || report.sender_ssrc != ssrc_) {
+        return;
+    }
+
+    metrics_.fraction_lost = report.fraction_lost;
+    metrics_.cumulative_lost = report.cumulative_lost;
+    metrics_.jitter =
+        (core::nanoseconds_t)((int64_t)report.jitter * core::Second / sample_rate_);
+
+    if (report.last_sr != 0) {
+        update_rtt_(report.last_sr, report.delay_last_sr);
+    }
+
+    roc_log(LogTrace,
+            "rtcp sender reporter: got reception report:"
+            " ssrc=%lu loss=%.5f cum_loss=%ld jitter=%ldus rtt=%ldus",
+            (unsigned long)report.receiver_ssrc, (double)metrics_.fraction_lost,
+            (long)metrics_.cumulative_lost, (long)(metrics_.jitter / core::Microsecond),
+            (long)(metrics_.rtt / core::Microsecond));
+
+    got_report_ = true;
+}
+
+void SenderReporter::update_rtt_(uint32_t last_sr, uint32_t delay_last_sr) {
+    const size_t n_reports =
+        n_sent_reports_ < MaxSentReports ? n_sent_reports_ : MaxSentReports;
+
+    for (size_t n = 0; n < n_reports; n++) {
+        const SentReport& sent =
+            sent_reports_[(n_sent_reports_ - n - 1) % MaxSentReports];
+        if (sent.ntp_compact != last_sr) {
+            continue;
+        }
+
+        core::nanoseconds_t rtt =
+            arrival_ - sent.time - ntp_compact_to_ns(delay_last_sr);
+        if (rtt < 0) {
+            rtt = 0;
+        }
+
+        metrics_.rtt = rtt;
+        return;
+    }
+
+    roc_log(LogDebug, "rtcp sender reporter: reception report for unknown sr: lsr=%lu",
+            (unsigned long)last_sr);
+}
+
+} // namespace rtcp
+} // namespace roc
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtcp/sender_reporter.h
+//! @brief Sender-side RTCP reporter.
+
+#ifndef ROC_RTCP_SENDER_REPORTER_H_
+#define ROC_RTCP_SENDER_REPORTER_H_
+
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/time.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet.h"
+#include "roc_rtcp/ireport_handler.h"
+#include "roc_rtcp/ntp.h"
+#include "roc_rtcp/reports.h"
+
+namespace roc {
+namespace rtcp {
+
+//! Sender-side RTCP reporter.
+//! @remarks
+//!  - passes outgoing packets to the output writer and accounts RTP packets
+//!  - fills sender reports
+//!  - handles reception reports from receivers and computes link metrics
+//!
+//!  Methods are thread-safe.
+class SenderReporter : public packet::IWriter,
+                       public IReportHandler,
+                       public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p writer is used to write outgoing packets
+    //!  - @p sample_rate defines RTP timestamp units
+    SenderReporter(packet::IWriter& writer, size_t sample_rate);
+
+    //! Write outgoing packet.
+    virtual void write(const packet::PacketPtr& packet);
+
+    //! Fill sender report.
+    //! @remarks
+    //!  @p ntp_time is the wall clock time put into the report, and @p now is
+    //!  the monotonic time of the same moment, used to compute RTT when the
+    //!  report is echoed back by a receiver.
+    //! @returns
+    //!  false if no RTP packets were sent yet.
+    bool build_report(SenderReport& report,
+                      ntp_timestamp_t ntp_time,
+                      core::nanoseconds_t now);
+
+    //! Process incoming RTCP packet.
+    //! @remarks
+    //!  Uses the packet receive timestamp if it is set, and current time otherwise.
+    //! @returns
+    //!  true if the packet contained a reception report for our stream.
+    bool process_packet(const packet::Packet& packet);
+
+    //! Get link metrics from the last reception report.
+    LinkMetrics metrics() const;
+
+private:
+    enum { MaxSentReports = 8 };
+
+    struct SentReport {
+        uint32_t ntp_compact;
+        core::nanoseconds_t time;
+    };
+
+    virtual void handle_sender_report(const SenderReport& report);
+    virtual void handle_reception_report(const ReceptionReport& report);
+
+    void update_rtt_(uint32_t last_sr, uint32_t delay_last_sr);
+
+    packet::IWriter& writer_;
+
+    const size_t sample_rate_;
+
+    bool has_packets_;
+    packet::source_t ssrc_;
+    packet::timestamp_t timestamp_;
+    uint32_t packet_count_;
+    uint32_t byte_count_;
+
+    bool got_report_;
+    LinkMetrics metrics_;
+
+    core::nanoseconds_t arrival_;
+
+    SentReport sent_reports_[MaxSentReports];
+    size_t n_sent_reports_;
+
+    core::Mutex mutex_;
+};
+
+} // namespace rtcp
+} // namespace roc
+
+#endif // ROC_RTCP_SENDER_REPORTER_H_
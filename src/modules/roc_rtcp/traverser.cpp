@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtcp/traverser.h"
+#include "roc_core/log.h"
+#include "roc_rtcp/headers.h"
+
+namespace roc {
+namespace rtcp {
+
+Traverser::Traverser(const core::Slice<uint8_t>& data)
+    : data_(data) {
+}
+
+bool Traverser::validate() const {
+    return iterate_(NULL);
+}
+
+bool Traverser::traverse(IReportHandler& handler) const {
+    if (!iterate_(NULL)) {
+        return false;
+    }
+    return iterate_(&handler);
+}
+
+bool Traverser::iterate_(IReportHandler* handler) const {
+    if (!data_ || data_.size() < sizeof(Header)) {
+        roc_log(LogDebug, "rtcp traverser: bad packet, size < %d (rtcp header)",
+                (int)sizeof(Header));
+        return false;
+    }
+
+    if (data_.size() % 4 != 0) {
+        roc_log(LogDebug, "rtcp traverser: bad packet, size is not multiple of 4");
+        return false;
+    }
+
+    const uint8_t* data = data_.data();
+    size_t remaining = data_.size();
+
+    bool first = true;
+
+    while (remaining != 0) {
+        if (remaining < sizeof(Header)) {
+            roc_log(LogDebug, "rtcp traverser: bad packet, truncated header");
+            return false;
+        }
+
+        const Header& header = *(const Header*)data;
+
+        if (header.version() != V2) {
+            roc_log(LogDebug, "rtcp traverser: bad version, get %d, expected %d",
+                    (int)header.version(), (int)V2);
+            return false;
+        }
+
+        const size_t size = header.size();
+
+        if (size > remaining) {
+            roc_log(LogDebug, "rtcp traverser: bad packet, size > %lu (remaining)",
+                    (unsigned long)remaining);
+            return false;
+        }
+
+        if (first && header.type() != RTCP_SR && header.type() != RTCP_RR) {
+            roc_log(LogDebug,
+                    "rtcp traverser: bad packet, compound packet should start with"
+                    " sr or rr, got type %d",
+                    (int)header.type());
+            return false;
+        }
+
+        switch (header.type()) {
+        case RTCP_SR:
+            if (!parse_sr_(data, size, handler)) {
+                return false;
+            }
+            break;
+
+        case RTCP_RR:
+            if (!parse_rr_(data, size, handler)) {
+                return false;
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        first = false;
+
+        data += size;
+        remaining -= size;
+    }
+
+    return true;
+}
+
+bool Traverser::parse_sr_(const uint8_t* data,
+                          size_t size,
+                          IReportHandler* handler) const {
+    const SenderReportPacket& packet = *(const SenderReportPacket*)data;
+
+    const size_t n_blocks = packet.header().counter();
+
+    if (size < sizeof(SenderReportPacket) + n_blocks * sizeof(ReportBlock)) {
+        roc_log(LogDebug, "rtcp traverser: bad sr packet, size < %lu (sr + %lu blocks)",
+                (unsigned long)(sizeof(SenderReportPacket)
+                                + n_blocks * sizeof(ReportBlock)),
+                (unsigned long)n_blocks);
+        return false;
+    }
+
+    if (!handler) {
+        return true;
+    }
+
+    SenderReport sr;
+    sr.ssrc = packet.ssrc();
+    sr.ntp_timestamp = packet.ntp_timestamp();
+    sr.rtp_timestamp = packet.rtp_timestamp();
+    sr.packet_count = packet.packet_count();
+    sr.byte_count = packet.byte_count();
+
+    handler->handle_sender_report(sr);
+
+    parse_blocks_(packet.ssrc(), data + sizeof(SenderReportPacket), n_blocks,
+                  *handler);
+
+    return true;
+}
+
+bool Traverser::parse_rr_(const uint8_t* data,
+                          size_t size,
+                          IReportHandler* handler) const {
+    const ReceiverReportPacket& packet = *(const ReceiverReportPacket*)data;
+
+    const size_t n_blocks = packet.header().counter();
+
+    if (size < sizeof(ReceiverReportPacket) + n_blocks * sizeof(ReportBlock)) {
+        roc_log(LogDebug, "rtcp traverser: bad rr packet, size < %lu (rr + %lu blocks)",
+                (unsigned long)(sizeof(ReceiverReportPacket)
+                                + n_blocks * sizeof(ReportBlock)),
+                (unsigned long)n_blocks);
+        return false;
+    }
+
+    if (!handler) {
+        return true;
+    }
+
+    parse_blocks_(packet.ssrc(), data + sizeof(ReceiverReportPacket), n_blocks,
+                  *handler);
+
+    return true;
+}
+
+void Traverser::parse_blocks_(packet::source_t receiver_ssrc,
+                              const uint8_t* data,
+                              size_t n_blocks,
+                              IReportHandler& handler) const {
+    for (size_t n = 0; n < n_blocks; n++) {
+        const ReportBlock& block = ((const ReportBlock*)data)[n];
+
+        ReceptionReport report;
+        report.receiver_ssrc = receiver_ssrc;
+        report.sender_ssrc = block.ssrc();
+        report.fraction_lost = (float)block.fraction_lost() / 256;
+        report.cumulative_lost = block.cumulative_lost();
+        report.last_seqnum = block.last_seqnum();
+        report.jitter = block.jitter();
+        report.last_sr = block.last_sr();
+        report.delay_last_sr = block.delay_last_sr();
+
+        handler.handle_reception_report(report);
+    }
+}
+
+} // namespace rtcp
+} // namespace roc
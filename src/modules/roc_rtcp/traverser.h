@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtcp/traverser.h
+//! @brief RTCP compound packet traverser.
+
+#ifndef ROC_RTCP_TRAVERSER_H_
+#define ROC_RTCP_TRAVERSER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_rtcp/ireport_handler.h"
+
+namespace roc {
+namespace rtcp {
+
+//! RTCP compound packet traverser.
+//! @remarks
+//!  Iterates packets in a compound RTCP packet and passes SR and RR contents
+//!  to a report handler. Other packet types are skipped.
+class Traverser : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit Traverser(const core::Slice<uint8_t>& data);
+
+    //! Check that the compound packet is well-formed.
+    bool validate() const;
+
+    //! Pass reports to @p handler.
+    //! @returns
+    //!  false if the compound packet is malformed.
+    bool traverse(IReportHandler& handler) const;
+
+private:
+    bool iterate_(IReportHandler* handler) const;
+
+    bool parse_sr_(const uint8_t* data, size_t size, IReportHandler* handler) const;
+    bool parse_rr_(const uint8_t* data, size_t size, IReportHandler* handler) const;
+
+    void parse_blocks_(packet::source_t receiver_ssrc,
+                       const uint8_t* data,
+                       size_t n_blocks,
+                       IReportHandler& handler) const;
+
+    const core::Slice<uint8_t>& data_;
+};
+
+} // namespace rtcp
+} // namespace roc
+
+#endif // ROC_RTCP_TRAVERSER_H_
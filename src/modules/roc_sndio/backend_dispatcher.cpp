@@ -14,6 +14,14 @@
 #include "roc_sndio/pulseaudio_backend.h"
 #endif // ROC_TARGET_PULSEAUDIO
 
+#ifdef ROC_TARGET_ALSA
+#include "roc_sndio/alsa_backend.h"
+#endif // ROC_TARGET_ALSA
+
+#ifdef ROC_TARGET_POSIX
+#include "roc_sndio/wav_backend.h"
+#endif // ROC_TARGET_POSIX
+
 #ifdef ROC_TARGET_SOX
 #include "roc_sndio/sox_backend.h"
 #endif // ROC_TARGET_SOX
@@ -26,9 +34,15 @@ BackendDispatcher::BackendDispatcher()
 #ifdef ROC_TARGET_PULSEAUDIO
     add_backend_(PulseaudioBackend::instance());
 #endif // ROC_TARGET_PULSEAUDIO
+#ifdef ROC_TARGET_POSIX
+    add_backend_(WavBackend::instance());
+#endif // ROC_TARGET_POSIX
 #ifdef ROC_TARGET_SOX
     add_backend_(SoxBackend::instance());
 #endif // ROC_TARGET_SOX
+#ifdef ROC_TARGET_ALSA
+    add_backend_(AlsaBackend::instance());
+#endif // ROC_TARGET_ALSA
 }
 
 void BackendDispatcher::set_frame_size(size_t frame_size) {
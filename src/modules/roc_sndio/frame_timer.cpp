@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_sndio/frame_timer.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace sndio {
+
+FrameTimer::FrameTimer(ISource& source,
+                       core::IAllocator& allocator,
+                       size_t num_channels,
+                       size_t frame_size,
+                       core::nanoseconds_t spin_time,
+                       FrameHandler handler,
+                       void* handler_arg)
+    : source_(source)
+    , handler_(handler)
+    , handler_arg_(handler_arg)
+    , frame_buffer_(allocator)
+    , frame_duration_(0)
+    , num_channels_(num_channels)
+    , timer_(spin_time)
+    , stop_(0)
+    , valid_(false) {
+    roc_panic_if_not(handler);
+
+    if (source.has_clock()) {
+        roc_log(LogError, "frame timer: source should not have its own clock");
+        return;
+    }
+
+    if (num_channels == 0 || frame_size == 0 || frame_size % num_channels != 0) {
+        roc_log(LogError,
+                "frame timer: frame size should be a non-zero multiple of"
+                " number of channels: frame_size=%lu num_channels=%lu",
+                (unsigned long)frame_size, (unsigned long)num_channels);
+        return;
+    }
+
+    if (source.sample_rate() == 0) {
+        roc_log(LogError, "frame timer: source sample rate is zero");
+        return;
+    }
+
+    if (!frame_buffer_.resize(frame_size)) {
+        roc_log(LogError, "frame timer: can't allocate frame buffer");
+        return;
+    }
+
+    frame_duration_ = core::nanoseconds_t(frame_size / num_channels) * core::Second
+        / core::nanoseconds_t(source.sample_rate());
+
+    valid_ = true;
+}
+
+FrameTimer::~FrameTimer() {
+    stop();
+}
+
+bool FrameTimer::valid() const {
+    return valid_;
+}
+
+bool FrameTimer::start() {
+    roc_panic_if(!valid());
+
+    return Thread::start();
+}
+
+void FrameTimer::stop() {
+    stop_ = true;
+
+    if (joinable()) {
+        Thread::join();
+    }
+}
+
+void FrameTimer::get_stats(core::DeadlineTimerStats& stats) const {
+    timer_.get_stats(stats);
+}
+
+void FrameTimer::run() {
+    roc_log(LogDebug, "frame timer: starting thread: frame_duration=%.3fms",
+            double(frame_duration_) / core::Millisecond);
+
+    const size_t sample_rate = source_.sample_rate();
+
+    core::nanoseconds_t start_time = core::timestamp();
+    uint64_t n_samples = 0;
+
+    while (!stop_) {
+        core::nanoseconds_t deadline = start_time
+            + core::nanoseconds_t(double(n_samples) * core::Second / sample_rate);
+
+        if (core::timestamp() - deadline > frame_duration_) {
+            // We fell behind for more than a frame, probably because the handler
+            // or the source blocked. Don't try to catch up with a burst of frames
+            // and continue from the current time instead.
+            roc_log(LogDebug, "frame timer: missed deadline by %.3fms, resetting",
+                    double(core::timestamp() - deadline) / core::Millisecond);
+
+            start_time = core::timestamp();
+            n_samples = 0;
+            deadline = start_time;
+        }
+
+        timer_.wait(deadline);
+
+        audio::Frame frame(&frame_buffer_[0], frame_buffer_.size());
+
+        if (!source_.read(frame)) {
+            roc_log(LogDebug, "frame timer: got eof from source");
+            break;
+        }
+
+        handler_(handler_arg_, frame);
+
+        n_samples += frame.size() / num_channels_;
+    }
+
+    roc_log(LogDebug, "frame timer: exiting thread");
+}
+
+} // namespace sndio
+} // namespace roc
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_sndio/frame_timer.h
+//! @brief Frame timer.
+
+#ifndef ROC_SNDIO_FRAME_TIMER_H_
+#define ROC_SNDIO_FRAME_TIMER_H_
+
+#include "roc_audio/frame.h"
+#include "roc_audio/units.h"
+#include "roc_core/array.h"
+#include "roc_core/atomic.h"
+#include "roc_core/deadline_timer.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
+#include "roc_sndio/isource.h"
+
+namespace roc {
+namespace sndio {
+
+//! Frame timer.
+//! @remarks
+//!  Reads frames from source in a separate thread at the source sample rate
+//!  and passes every frame to a handler. Frames are scheduled at absolute
+//!  deadlines, so that wakeup errors do not accumulate.
+class FrameTimer : public core::NonCopyable<>, private core::Thread {
+public:
+    //! Frame handler.
+    //! @remarks
+    //!  Invoked from the timer thread for every frame read from the source.
+    typedef void (*FrameHandler)(void* arg, audio::Frame& frame);
+
+    //! Initialize.
+    //! @remarks
+    //!  @p frame_size defines the number of samples per frame for all channels.
+    //!  @p spin_time defines how long the timer busy-waits before every deadline.
+    FrameTimer(ISource& source,
+               core::IAllocator& allocator,
+               size_t num_channels,
+               size_t frame_size,
+               core::nanoseconds_t spin_time,
+               FrameHandler handler,
+               void* handler_arg);
+
+    virtual ~FrameTimer();
+
+    //! Check if the object was successfully constructed.
+    bool valid() const;
+
+    //! Start timer thread.
+    bool start();
+
+    //! Stop timer thread.
+    //! @remarks
+    //!  Blocks until the thread finishes. The handler is not invoked after
+    //!  this call returns.
+    void stop();
+
+    //! Get timer statistics.
+    //! @remarks
+    //!  May be called from any thread.
+    void get_stats(core::DeadlineTimerStats& stats) const;
+
+private:
+    virtual void run();
+
+    ISource& source_;
+
+    FrameHandler handler_;
+    void* handler_arg_;
+
+    core::Array<audio::sample_t> frame_buffer_;
+
+    core::nanoseconds_t frame_duration_;
+    const size_t num_channels_;
+
+    core::DeadlineTimer timer_;
+
+    core::Atomic stop_;
+    bool valid_;
+};
+
+} // namespace sndio
+} // namespace roc
+
+#endif // ROC_SNDIO_FRAME_TIMER_H_
@@ -13,6 +13,7 @@
 #define ROC_SNDIO_ISINK_H_
 
 #include "roc_audio/iwriter.h"
+#include "roc_core/time.h"
 
 namespace roc {
 namespace sndio {
@@ -27,6 +28,13 @@ public:
 
     //! Check if the sink has own clock.
     virtual bool has_clock() const = 0;
+
+    //! Get current playback latency of the sink.
+    //! @remarks
+    //!  Returns the time until a sample written now will be actually played,
+    //!  or zero if the sink doesn't know it. Should be called from the same
+    //!  thread as write().
+    virtual core::nanoseconds_t latency() const = 0;
 };
 
 } // namespace sndio
@@ -13,6 +13,7 @@
 #define ROC_SNDIO_ISOURCE_H_
 
 #include "roc_audio/frame.h"
+#include "roc_core/time.h"
 
 namespace roc {
 namespace sndio {
@@ -45,6 +46,12 @@ public:
     //!  Spurious wakeups are allowed.
     virtual void wait_active() const = 0;
 
+    //! Set playback latency of the sink the source is read to.
+    //! @remarks
+    //!  Called before every read(). Sources that adjust their clock to keep
+    //!  a target latency may take it into account; others just ignore it.
+    virtual void set_sink_latency(core::nanoseconds_t latency) = 0;
+
     //! Read frame.
     //! @returns
     //!  false if there is nothing to read anymore.
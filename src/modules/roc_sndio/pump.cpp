@@ -55,6 +55,8 @@ bool Pump::run() {
             n_bufs_++;
         }
 
+        source_.set_sink_latency(sink_.latency());
+
         audio::Frame frame(frame_buffer_.data(), frame_buffer_.size());
         if (!source_.read(frame)) {
             roc_log(LogDebug, "pump: got eof from source");
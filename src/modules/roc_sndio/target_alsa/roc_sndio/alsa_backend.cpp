@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <string.h>
+
+#include "roc_core/log.h"
+#include "roc_core/unique_ptr.h"
+#include "roc_sndio/alsa_backend.h"
+#include "roc_sndio/alsa_sink.h"
+#include "roc_sndio/alsa_source.h"
+#include "roc_sndio/driver_info.h"
+
+namespace roc {
+namespace sndio {
+
+AlsaBackend::AlsaBackend() {
+    roc_log(LogDebug, "initializing alsa backend");
+}
+
+bool AlsaBackend::probe(const char* driver, const char*, int filter_flags) {
+    if ((filter_flags & FilterDevice) == 0) {
+        return false;
+    }
+
+    // "alsa" without a suffix is left to SoX, which is also the default device
+    // driver; the direct backend is used only when requested explicitly
+    return driver && strcmp(driver, "alsa-direct") == 0;
+}
+
+ISink* AlsaBackend::open_sink(core::IAllocator& allocator,
+                              const char*,
+                              const char* output,
+                              const Config& config) {
+    core::UniquePtr<AlsaSink> sink(new (allocator) AlsaSink(config), allocator);
+    if (!sink) {
+        return NULL;
+    }
+
+    if (!sink->open(output)) {
+        return NULL;
+    }
+
+    return sink.release();
+}
+
+ISource* AlsaBackend::open_source(core::IAllocator& allocator,
+                                  const char*,
+                                  const char* input,
+                                  const Config& config) {
+    core::UniquePtr<AlsaSource> source(new (allocator) AlsaSource(config), allocator);
+    if (!source) {
+        return NULL;
+    }
+
+    if (!source->open(input)) {
+        return NULL;
+    }
+
+    return source.release();
+}
+
+bool AlsaBackend::get_drivers(core::Array<DriverInfo>& arr, int filter_flags) {
+    if (filter_flags & FilterDevice) {
+        return add_driver_uniq(arr, "alsa-direct");
+    }
+    return true;
+}
+
+} // namespace sndio
+} // namespace roc
@@ -0,0 +1,405 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_packet/units.h"
+#include "roc_sndio/alsa_device.h"
+
+namespace roc {
+namespace sndio {
+
+namespace {
+
+const core::nanoseconds_t DefaultLatency = core::Millisecond * 20;
+
+const unsigned DefaultSampleRate = 44100;
+
+const snd_pcm_uframes_t MinPeriods = 2;
+
+const int WaitTimeoutMs = 1000;
+
+} // namespace
+
+AlsaDevice::AlsaDevice(const Config& config, snd_pcm_stream_t stream)
+    : name_(stream == SND_PCM_STREAM_PLAYBACK ? "alsa sink" : "alsa source")
+    , stream_(stream)
+    , pcm_(NULL)
+    , sample_rate_(config.sample_rate)
+    , num_channels_(packet::num_channels(config.channels))
+    , frame_size_(config.frame_size)
+    , period_size_(0)
+    , buffer_size_(0) {
+    if (config.latency != 0) {
+        latency_ = config.latency;
+    } else {
+        latency_ = DefaultLatency;
+    }
+}
+
+AlsaDevice::~AlsaDevice() {
+    close_();
+}
+
+bool AlsaDevice::open(const char* device) {
+    if (pcm_) {
+        roc_panic("%s: can't call open() twice", name_);
+    }
+
+    if (!device) {
+        device = "default";
+    }
+
+    roc_log(LogDebug, "%s: opening device: device=%s", name_, device);
+
+    if (!check_params_()) {
+        return false;
+    }
+
+    if (int err = snd_pcm_open(&pcm_, device, stream_, 0)) {
+        roc_log(LogError, "%s: snd_pcm_open(): %s", name_, snd_strerror(err));
+        pcm_ = NULL;
+        return false;
+    }
+
+    if (!set_hw_params_() || !set_sw_params_()) {
+        close_();
+        return false;
+    }
+
+    roc_log(LogInfo,
+            "%s: opened device: device=%s n_channels=%lu sample_rate=%lu"
+            " period_size=%lu buffer_size=%lu",
+            name_, device, (unsigned long)num_channels_, (unsigned long)sample_rate_,
+            (unsigned long)period_size_, (unsigned long)buffer_size_);
+
+    return true;
+}
+
+size_t AlsaDevice::sample_rate() const {
+    if (!pcm_) {
+        roc_panic("%s: sample_rate: non-open device", name_);
+    }
+
+    return sample_rate_;
+}
+
+core::nanoseconds_t AlsaDevice::delay() const {
+    if (!pcm_) {
+        roc_panic("%s: delay: non-open device", name_);
+    }
+
+    snd_pcm_sframes_t frames = 0;
+
+    if (int err = snd_pcm_delay(pcm_, &frames)) {
+        roc_log(LogDebug, "%s: snd_pcm_delay(): %s", name_, snd_strerror(err));
+        return 0;
+    }
+
+    if (frames <= 0) {
+        return 0;
+    }
+
+    return core::nanoseconds_t(frames) * core::Second / core::nanoseconds_t(sample_rate_);
+}
+
+bool AlsaDevice::write(const audio::sample_t* data, size_t size) {
+    roc_panic_if(stream_ != SND_PCM_STREAM_PLAYBACK);
+
+    return transfer_(const_cast<audio::sample_t*>(data), size);
+}
+
+bool AlsaDevice::read(audio::sample_t* data, size_t size) {
+    roc_panic_if(stream_ != SND_PCM_STREAM_CAPTURE);
+
+    return transfer_(data, size);
+}
+
+bool AlsaDevice::check_params_() const {
+    if (num_channels_ == 0) {
+        roc_log(LogError, "%s: # of channels is zero", name_);
+        return false;
+    }
+
+    if (frame_size_ == 0 || frame_size_ % num_channels_ != 0) {
+        roc_log(LogError, "%s: frame size should be a positive multiple of # of channels",
+                name_);
+        return false;
+    }
+
+    if (latency_ <= 0) {
+        roc_log(LogError, "%s: latency should be positive", name_);
+        return false;
+    }
+
+    return true;
+}
+
+bool AlsaDevice::set_hw_params_() {
+    snd_pcm_hw_params_t* params = NULL;
+    snd_pcm_hw_params_alloca(&params);
+
+    int err = 0;
+
+    if ((err = snd_pcm_hw_params_any(pcm_, params)) < 0) {
+        roc_log(LogError, "%s: snd_pcm_hw_params_any(): %s", name_, snd_strerror(err));
+        return false;
+    }
+
+    if ((err = snd_pcm_hw_params_set_access(pcm_, params,
+                                            SND_PCM_ACCESS_MMAP_INTERLEAVED))
+        < 0) {
+        roc_log(LogError, "%s: device doesn't support mmap interleaved access: %s",
+                name_, snd_strerror(err));
+        return false;
+    }
+
+    roc_panic_if(sizeof(audio::sample_t) != sizeof(float));
+
+    if ((err = snd_pcm_hw_params_set_format(pcm_, params, SND_PCM_FORMAT_FLOAT)) < 0) {
+        roc_log(LogError, "%s: device doesn't support float samples: %s", name_,
+                snd_strerror(err));
+        return false;
+    }
+
+    if ((err = snd_pcm_hw_params_set_channels(pcm_, params, (unsigned)num_channels_))
+        < 0) {
+        roc_log(LogError, "%s: device doesn't support %lu channels: %s", name_,
+                (unsigned long)num_channels_, snd_strerror(err));
+        return false;
+    }
+
+    unsigned rate = sample_rate_ != 0 ? (unsigned)sample_rate_ : DefaultSampleRate;
+
+    if ((err = snd_pcm_hw_params_set_rate_near(pcm_, params, &rate, NULL)) < 0) {
+        roc_log(LogError, "%s: snd_pcm_hw_params_set_rate_near(): %s", name_,
+                snd_strerror(err));
+        return false;
+    }
+
+    if (sample_rate_ != 0 && rate != sample_rate_) {
+        roc_log(LogError, "%s: device doesn't support sample rate: requested=%lu got=%u",
+                name_, (unsigned long)sample_rate_, rate);
+        return false;
+    }
+
+    sample_rate_ = rate;
+
+    snd_pcm_uframes_t period_size = frame_size_ / num_channels_;
+
+    if ((err = snd_pcm_hw_params_set_period_size_near(pcm_, params, &period_size,
+                                                      NULL))
+        < 0) {
+        roc_log(LogError, "%s: snd_pcm_hw_params_set_period_size_near(): %s", name_,
+                snd_strerror(err));
+        return false;
+    }
+
+    const snd_pcm_uframes_t latency =
+        (snd_pcm_uframes_t)packet::timestamp_from_ns(latency_, sample_rate_);
+
+    snd_pcm_uframes_t n_periods = (latency + period_size - 1) / period_size;
+    if (n_periods < MinPeriods) {
+        n_periods = MinPeriods;
+    }
+
+    snd_pcm_uframes_t buffer_size = period_size * n_periods;
+
+    if ((err = snd_pcm_hw_params_set_buffer_size_near(pcm_, params, &buffer_size))
+        < 0) {
+        roc_log(LogError, "%s: snd_pcm_hw_params_set_buffer_size_near(): %s", name_,
+                snd_strerror(err));
+        return false;
+    }
+
+    if ((err = snd_pcm_hw_params(pcm_, params)) < 0) {
+        roc_log(LogError, "%s: snd_pcm_hw_params(): %s", name_, snd_strerror(err));
+        return false;
+    }
+
+    snd_pcm_hw_params_get_period_size(params, &period_size_, NULL);
+    snd_pcm_hw_params_get_buffer_size(params, &buffer_size_);
+
+    if (period_size_ * num_channels_ != frame_size_) {
+        roc_log(LogInfo,
+                "%s: device period size is not aligned to frame size:"
+                " period_size=%lu frame_size=%lu",
+                name_, (unsigned long)period_size_,
+                (unsigned long)(frame_size_ / num_channels_));
+    }
+
+    return true;
+}
+
+bool AlsaDevice::set_sw_params_() {
+    snd_pcm_sw_params_t* params = NULL;
+    snd_pcm_sw_params_alloca(&params);
+
+    int err = 0;
+
+    if ((err = snd_pcm_sw_params_current(pcm_, params)) < 0) {
+        roc_log(LogError, "%s: snd_pcm_sw_params_current(): %s", name_,
+                snd_strerror(err));
+        return false;
+    }
+
+    if ((err = snd_pcm_sw_params_set_avail_min(pcm_, params, period_size_)) < 0) {
+        roc_log(LogError, "%s: snd_pcm_sw_params_set_avail_min(): %s", name_,
+                snd_strerror(err));
+        return false;
+    }
+
+    // playback starts when the buffer is full, capture is started explicitly
+    const snd_pcm_uframes_t start_threshold =
+        stream_ == SND_PCM_STREAM_PLAYBACK ? buffer_size_ : buffer_size_ * 2;
+
+    if ((err = snd_pcm_sw_params_set_start_threshold(pcm_, params, start_threshold))
+        < 0) {
+        roc_log(LogError, "%s: snd_pcm_sw_params_set_start_threshold(): %s", name_,
+                snd_strerror(err));
+        return false;
+    }
+
+    if ((err = snd_pcm_sw_params(pcm_, params)) < 0) {
+        roc_log(LogError, "%s: snd_pcm_sw_params(): %s", name_, snd_strerror(err));
+        return false;
+    }
+
+    return true;
+}
+
+bool AlsaDevice::transfer_(audio::sample_t* data, size_t size) {
+    if (!pcm_) {
+        roc_panic("%s: transfer: non-open device", name_);
+    }
+
+    roc_panic_if(size % num_channels_ != 0);
+
+    snd_pcm_uframes_t n_frames = size / num_channels_;
+
+    while (n_frames > 0) {
+        const snd_pcm_sframes_t avail = wait_();
+        if (avail < 0) {
+            return false;
+        }
+
+        const snd_pcm_channel_area_t* areas = NULL;
+        snd_pcm_uframes_t offset = 0;
+        snd_pcm_uframes_t frames = (snd_pcm_uframes_t)avail;
+
+        if (frames > n_frames) {
+            frames = n_frames;
+        }
+
+        if (int err = snd_pcm_mmap_begin(pcm_, &areas, &offset, &frames)) {
+            if (!recover_(err)) {
+                return false;
+            }
+            continue;
+        }
+
+        // interleaved access: all channels share the first area
+        audio::sample_t* buffer =
+            (audio::sample_t*)((uint8_t*)areas[0].addr + areas[0].first / 8
+                               + offset * areas[0].step / 8);
+
+        const size_t n_bytes = frames * num_channels_ * sizeof(audio::sample_t);
+
+        if (stream_ == SND_PCM_STREAM_PLAYBACK) {
+            memcpy(buffer, data, n_bytes);
+        } else {
+            memcpy(data, buffer, n_bytes);
+        }
+
+        const snd_pcm_sframes_t ret = snd_pcm_mmap_commit(pcm_, offset, frames);
+
+        if (ret < 0 || (snd_pcm_uframes_t)ret != frames) {
+            if (!recover_(ret < 0 ? (int)ret : -EPIPE)) {
+                return false;
+            }
+            continue;
+        }
+
+        data += frames * num_channels_;
+        n_frames -= frames;
+    }
+
+    return true;
+}
+
+snd_pcm_sframes_t AlsaDevice::wait_() {
+    for (;;) {
+        const snd_pcm_sframes_t avail = snd_pcm_avail_update(pcm_);
+
+        if (avail < 0) {
+            if (!recover_((int)avail)) {
+                return -1;
+            }
+            continue;
+        }
+
+        if (avail > 0) {
+            return avail;
+        }
+
+        if (snd_pcm_state(pcm_) == SND_PCM_STATE_PREPARED) {
+            if (int err = snd_pcm_start(pcm_)) {
+                if (!recover_(err)) {
+                    return -1;
+                }
+            }
+            continue;
+        }
+
+        const int ret = snd_pcm_wait(pcm_, WaitTimeoutMs);
+
+        if (ret == 0) {
+            roc_log(LogError, "%s: device timeout expired", name_);
+            return -1;
+        }
+
+        if (ret < 0 && !recover_(ret)) {
+            return -1;
+        }
+    }
+}
+
+bool AlsaDevice::recover_(int err) {
+    if (err == -EPIPE) {
+        roc_log(LogDebug, "%s: %s", name_,
+                stream_ == SND_PCM_STREAM_PLAYBACK ? "underrun" : "overrun");
+    }
+
+    if ((err = snd_pcm_recover(pcm_, err, 1)) < 0) {
+        roc_log(LogError, "%s: snd_pcm_recover(): %s", name_, snd_strerror(err));
+        return false;
+    }
+
+    return true;
+}
+
+void AlsaDevice::close_() {
+    if (!pcm_) {
+        return;
+    }
+
+    roc_log(LogDebug, "%s: closing device", name_);
+
+    if (stream_ == SND_PCM_STREAM_PLAYBACK) {
+        snd_pcm_drain(pcm_);
+    }
+
+    snd_pcm_close(pcm_);
+    pcm_ = NULL;
+}
+
+} // namespace sndio
+} // namespace roc
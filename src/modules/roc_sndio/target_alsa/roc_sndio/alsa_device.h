@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_sndio/target_alsa/roc_sndio/alsa_device.h
+//! @brief ALSA device.
+
+#ifndef ROC_SNDIO_ALSA_DEVICE_H_
+#define ROC_SNDIO_ALSA_DEVICE_H_
+
+#include <alsa/asoundlib.h>
+
+#include "roc_audio/units.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_sndio/config.h"
+
+namespace roc {
+namespace sndio {
+
+//! ALSA PCM device.
+//! @remarks
+//!  Opens PCM device with interleaved float samples and mmap access, and
+//!  copies samples directly to or from the ring buffer of the device. Period
+//!  size is set to the frame size, and the buffer holds the requested latency
+//!  rounded up to a multiple of the period, but at least two periods.
+class AlsaDevice : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    AlsaDevice(const Config& config, snd_pcm_stream_t stream);
+
+    ~AlsaDevice();
+
+    //! Open device.
+    //! @remarks
+    //!  If @p device is NULL, "default" is used.
+    bool open(const char* device);
+
+    //! Get sample rate of the device.
+    size_t sample_rate() const;
+
+    //! Get current device delay.
+    //! @remarks
+    //!  For playback, it's the time until a sample written now is played.
+    //!  Returns zero if the delay can't be obtained.
+    core::nanoseconds_t delay() const;
+
+    //! Write samples.
+    //! @remarks
+    //!  Blocks until all samples are copied to the ring buffer.
+    //!  @p size is the number of samples for all channels.
+    bool write(const audio::sample_t* data, size_t size);
+
+    //! Read samples.
+    //! @remarks
+    //!  Blocks until all samples are copied from the ring buffer.
+    //!  @p size is the number of samples for all channels.
+    bool read(audio::sample_t* data, size_t size);
+
+private:
+    bool check_params_() const;
+
+    bool set_hw_params_();
+    bool set_sw_params_();
+
+    bool transfer_(audio::sample_t* data, size_t size);
+
+    snd_pcm_sframes_t wait_();
+    bool recover_(int err);
+
+    void close_();
+
+    const char* name_;
+    const snd_pcm_stream_t stream_;
+
+    snd_pcm_t* pcm_;
+
+    size_t sample_rate_;
+    const size_t num_channels_;
+    const size_t frame_size_;
+
+    core::nanoseconds_t latency_;
+
+    snd_pcm_uframes_t period_size_;
+    snd_pcm_uframes_t buffer_size_;
+};
+
+} // namespace sndio
+} // namespace roc
+
+#endif // ROC_SNDIO_ALSA_DEVICE_H_
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_sndio/alsa_sink.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace sndio {
+
+AlsaSink::AlsaSink(const Config& config)
+    : device_(config, SND_PCM_STREAM_PLAYBACK) {
+}
+
+bool AlsaSink::open(const char* device) {
+    return device_.open(device);
+}
+
+size_t AlsaSink::sample_rate() const {
+    return device_.sample_rate();
+}
+
+bool AlsaSink::has_clock() const {
+    return true;
+}
+
+core::nanoseconds_t AlsaSink::latency() const {
+    return device_.delay();
+}
+
+void AlsaSink::write(audio::Frame& frame) {
+    if (!device_.write(frame.data(), frame.size())) {
+        roc_panic("alsa sink: can't write to device");
+    }
+}
+
+} // namespace sndio
+} // namespace roc
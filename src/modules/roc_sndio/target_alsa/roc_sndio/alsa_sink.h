@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_sndio/target_alsa/roc_sndio/alsa_sink.h
+//! @brief ALSA sink.
+
+#ifndef ROC_SNDIO_ALSA_SINK_H_
+#define ROC_SNDIO_ALSA_SINK_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_sndio/alsa_device.h"
+#include "roc_sndio/config.h"
+#include "roc_sndio/isink.h"
+
+namespace roc {
+namespace sndio {
+
+//! ALSA sink.
+//! @remarks
+//!  Writes samples to ALSA playback device using mmap transfers.
+//!  Write blocks until there is space in the device buffer, so the sink
+//!  is clocked by the device.
+class AlsaSink : public ISink, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    AlsaSink(const Config& config);
+
+    //! Open output device.
+    //! @remarks
+    //!  If @p device is NULL, "default" is used.
+    bool open(const char* device);
+
+    //! Get sample rate of the sink.
+    virtual size_t sample_rate() const;
+
+    //! Check if the sink has own clock.
+    virtual bool has_clock() const;
+
+    //! Get current playback latency of the sink.
+    virtual core::nanoseconds_t latency() const;
+
+    //! Write audio frame.
+    virtual void write(audio::Frame& frame);
+
+private:
+    AlsaDevice device_;
+};
+
+} // namespace sndio
+} // namespace roc
+
+#endif // ROC_SNDIO_ALSA_SINK_H_
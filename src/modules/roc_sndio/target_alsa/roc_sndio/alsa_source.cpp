@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_sndio/alsa_source.h"
+#include "roc_core/log.h"
+
+namespace roc {
+namespace sndio {
+
+AlsaSource::AlsaSource(const Config& config)
+    : device_(config, SND_PCM_STREAM_CAPTURE) {
+}
+
+bool AlsaSource::open(const char* device) {
+    return device_.open(device);
+}
+
+size_t AlsaSource::sample_rate() const {
+    return device_.sample_rate();
+}
+
+bool AlsaSource::has_clock() const {
+    return true;
+}
+
+ISource::State AlsaSource::state() const {
+    return Active;
+}
+
+void AlsaSource::wait_active() const {
+}
+
+void AlsaSource::set_sink_latency(core::nanoseconds_t) {
+}
+
+bool AlsaSource::read(audio::Frame& frame) {
+    if (!device_.read(frame.data(), frame.size())) {
+        roc_log(LogError, "alsa source: can't read from device");
+        return false;
+    }
+    return true;
+}
+
+} // namespace sndio
+} // namespace roc
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_sndio/target_alsa/roc_sndio/alsa_source.h
+//! @brief ALSA source.
+
+#ifndef ROC_SNDIO_ALSA_SOURCE_H_
+#define ROC_SNDIO_ALSA_SOURCE_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_sndio/alsa_device.h"
+#include "roc_sndio/config.h"
+#include "roc_sndio/isource.h"
+
+namespace roc {
+namespace sndio {
+
+//! ALSA source.
+//! @remarks
+//!  Reads samples from ALSA capture device using mmap transfers.
+//!  Read blocks until the device captures enough samples, so the source
+//!  is clocked by the device.
+class AlsaSource : public ISource, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    AlsaSource(const Config& config);
+
+    //! Open input device.
+    //! @remarks
+    //!  If @p device is NULL, "default" is used.
+    bool open(const char* device);
+
+    //! Get sample rate of the source.
+    virtual size_t sample_rate() const;
+
+    //! Check if the source has own clock.
+    virtual bool has_clock() const;
+
+    //! Get current source state.
+    virtual State state() const;
+
+    //! Wait until the source state becomes active.
+    virtual void wait_active() const;
+
+    //! Set playback latency of the sink the source is read to.
+    virtual void set_sink_latency(core::nanoseconds_t latency);
+
+    //! Read frame.
+    virtual bool read(audio::Frame& frame);
+
+private:
+    AlsaDevice device_;
+};
+
+} // namespace sndio
+} // namespace roc
+
+#endif // ROC_SNDIO_ALSA_SOURCE_H_
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_sndio/mapped_file.h"
+
+namespace roc {
+namespace sndio {
+
+namespace {
+
+// How much data to prefetch ahead of the read position, and how much data
+// to keep behind it; should be a multiple of page size.
+const size_t PrefetchSize = 1024 * 1024;
+
+// Initial mapping size in write mode; should be a multiple of page size.
+const size_t MinCapacity = 1024 * 1024;
+
+} // namespace
+
+MappedFile::MappedFile()
+    : fd_(-1)
+    , mode_(ModeRead)
+    , data_(NULL)
+    , size_(0)
+    , capacity_(0)
+    , prefetch_pos_(0)
+    , release_pos_(0) {
+}
+
+MappedFile::~MappedFile() {
+    if (is_open()) {
+        close();
+    }
+}
+
+bool MappedFile::open(const char* path, Mode mode) {
+    if (is_open()) {
+        roc_panic("mapped file: can't call open() twice");
+    }
+
+    mode_ = mode;
+
+    bool ok = false;
+
+    switch (mode) {
+    case ModeRead:
+        ok = open_read_(path);
+        break;
+    case ModeWrite:
+        ok = open_write_(path);
+        break;
+    }
+
+    if (!ok) {
+        close();
+    }
+
+    return ok;
+}
+
+bool MappedFile::close() {
+    bool ok = true;
+
+    unmap_();
+
+    if (fd_ != -1) {
+        if (mode_ == ModeWrite && ftruncate(fd_, (off_t)size_) == -1) {
+            roc_log(LogError, "mapped file: ftruncate(): %s",
+                    core::errno_to_str().c_str());
+            ok = false;
+        }
+
+        if (::close(fd_) == -1) {
+            roc_log(LogError, "mapped file: close(): %s", core::errno_to_str().c_str());
+            ok = false;
+        }
+    }
+
+    fd_ = -1;
+    size_ = 0;
+
+    return ok;
+}
+
+bool MappedFile::is_open() const {
+    return fd_ != -1;
+}
+
+size_t MappedFile::size() const {
+    return size_;
+}
+
+const uint8_t* MappedFile::data() const {
+    return data_;
+}
+
+uint8_t* MappedFile::mutable_data() {
+    roc_panic_if(mode_ != ModeWrite);
+
+    return data_;
+}
+
+bool MappedFile::resize(size_t size) {
+    roc_panic_if(mode_ != ModeWrite);
+    roc_panic_if(!is_open());
+
+    if (size > capacity_) {
+        size_t capacity = capacity_ * 2;
+        if (capacity < MinCapacity) {
+            capacity = MinCapacity;
+        }
+        if (capacity < size) {
+            capacity = (size + MinCapacity - 1) / MinCapacity * MinCapacity;
+        }
+
+        // The mapping may extend beyond the end of file; only the pages below
+        // the file size are ever accessed.
+        unmap_();
+
+        if (!map_(capacity)) {
+            return false;
+        }
+    }
+
+    if (size != size_) {
+        // Keep the file length equal to the data size at all times, so that
+        // the file is consistent even if the process is killed before close().
+        if (ftruncate(fd_, (off_t)size) == -1) {
+            roc_log(LogError, "mapped file: ftruncate(): %s",
+                    core::errno_to_str().c_str());
+            return false;
+        }
+    }
+
+    size_ = size;
+
+    return true;
+}
+
+void MappedFile::advise(size_t offset) {
+    roc_panic_if(mode_ != ModeRead);
+
+    if (!data_) {
+        return;
+    }
+
+    while (prefetch_pos_ < size_ && prefetch_pos_ < offset + PrefetchSize) {
+        size_t len = size_ - prefetch_pos_;
+        if (len > PrefetchSize) {
+            len = PrefetchSize;
+        }
+
+        (void)posix_madvise(data_ + prefetch_pos_, len, POSIX_MADV_WILLNEED);
+        prefetch_pos_ += len;
+    }
+
+    if (offset > PrefetchSize * 2) {
+        const size_t release_end = (offset - PrefetchSize) / PrefetchSize * PrefetchSize;
+
+        if (release_end > release_pos_) {
+            (void)posix_madvise(data_ + release_pos_, release_end - release_pos_,
+                                POSIX_MADV_DONTNEED);
+            release_pos_ = release_end;
+        }
+    }
+}
+
+bool MappedFile::open_read_(const char* path) {
+    fd_ = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd_ == -1) {
+        roc_log(LogDebug, "mapped file: open(): %s: %s", path,
+                core::errno_to_str().c_str());
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) == -1) {
+        roc_log(LogError, "mapped file: fstat(): %s: %s", path,
+                core::errno_to_str().c_str());
+        return false;
+    }
+
+    if (!S_ISREG(st.st_mode)) {
+        roc_log(LogDebug, "mapped file: not a regular file: %s", path);
+        return false;
+    }
+
+    if (st.st_size == 0) {
+        return true;
+    }
+
+    if (!map_((size_t)st.st_size)) {
+        return false;
+    }
+
+    size_ = (size_t)st.st_size;
+
+    (void)posix_madvise(data_, size_, POSIX_MADV_SEQUENTIAL);
+
+    prefetch_pos_ = 0;
+    release_pos_ = 0;
+
+    advise(0);
+
+    return true;
+}
+
+bool MappedFile::open_write_(const char* path) {
+    fd_ = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ == -1) {
+        roc_log(LogError, "mapped file: open(): %s: %s", path,
+                core::errno_to_str().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool MappedFile::map_(size_t size) {
+    int prot = PROT_READ;
+    int flags = MAP_PRIVATE;
+
+    if (mode_ == ModeWrite) {
+        prot |= PROT_WRITE;
+        flags = MAP_SHARED;
+    }
+
+    void* data = mmap(NULL, size, prot, flags, fd_, 0);
+    if (data == MAP_FAILED) {
+        roc_log(LogError, "mapped file: mmap(): %s", core::errno_to_str().c_str());
+        return false;
+    }
+
+    data_ = (uint8_t*)data;
+    capacity_ = size;
+
+    return true;
+}
+
+void MappedFile::unmap_() {
+    if (!data_) {
+        return;
+    }
+
+    if (munmap(data_, capacity_) == -1) {
+        roc_panic("mapped file: munmap(): %s", core::errno_to_str().c_str());
+    }
+
+    data_ = NULL;
+    capacity_ = 0;
+}
+
+} // namespace sndio
+} // namespace roc
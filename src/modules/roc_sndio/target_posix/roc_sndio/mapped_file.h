@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_sndio/target_posix/roc_sndio/mapped_file.h
+//! @brief Memory-mapped file.
+
+#ifndef ROC_SNDIO_MAPPED_FILE_H_
+#define ROC_SNDIO_MAPPED_FILE_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace sndio {
+
+//! Memory-mapped file.
+//! @remarks
+//!  In read mode, the whole file is mapped read-only and is expected to be
+//!  accessed sequentially; advise() prefetches pages ahead of the current
+//!  position and releases pages behind it. In write mode, the mapping grows
+//!  geometrically on resize(), while the file length always matches the
+//!  current size, so the file stays consistent if it's never closed.
+class MappedFile : public core::NonCopyable<> {
+public:
+    //! Open mode.
+    enum Mode {
+        //! Map existing file for reading.
+        ModeRead,
+
+        //! Create or truncate file and map it for writing.
+        ModeWrite
+    };
+
+    //! Initialize.
+    MappedFile();
+
+    ~MappedFile();
+
+    //! Open and map file.
+    bool open(const char* path, Mode mode);
+
+    //! Unmap and close file.
+    //! @returns
+    //!  false if an error occurred while flushing the file.
+    bool close();
+
+    //! Check if the file is opened.
+    bool is_open() const;
+
+    //! Get file size.
+    size_t size() const;
+
+    //! Get pointer to the mapped data.
+    const uint8_t* data() const;
+
+    //! Get writable pointer to the mapped data.
+    //! @remarks
+    //!  Should be used only in write mode.
+    uint8_t* mutable_data();
+
+    //! Change file size.
+    //! @remarks
+    //!  Should be used only in write mode. Changes the file length immediately.
+    //!  May remap the file, so the data pointer should be obtained again after
+    //!  this call.
+    bool resize(size_t size);
+
+    //! Hint that the data will be read from given offset onwards.
+    //! @remarks
+    //!  Should be used only in read mode.
+    void advise(size_t offset);
+
+private:
+    bool open_read_(const char* path);
+    bool open_write_(const char* path);
+
+    bool map_(size_t size);
+    void unmap_();
+
+    int fd_;
+    Mode mode_;
+
+    uint8_t* data_;
+    size_t size_;
+    size_t capacity_;
+
+    size_t prefetch_pos_;
+    size_t release_pos_;
+};
+
+} // namespace sndio
+} // namespace roc
+
+#endif // ROC_SNDIO_MAPPED_FILE_H_
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <string.h>
+#include <strings.h>
+
+#include "roc_core/log.h"
+#include "roc_core/unique_ptr.h"
+#include "roc_sndio/driver_info.h"
+#include "roc_sndio/mapped_file.h"
+#include "roc_sndio/wav_backend.h"
+#include "roc_sndio/wav_format.h"
+#include "roc_sndio/wav_sink.h"
+#include "roc_sndio/wav_source.h"
+
+namespace roc {
+namespace sndio {
+
+namespace {
+
+const char* select_driver(const char* driver, const char* inout) {
+    if (driver) {
+        if (strcmp(driver, "wav") == 0 || strcmp(driver, "f32") == 0) {
+            return driver;
+        }
+        return NULL;
+    }
+
+    if (!inout) {
+        return NULL;
+    }
+
+    const char* ext = strrchr(inout, '.');
+    if (!ext) {
+        return NULL;
+    }
+
+    if (strcasecmp(ext, ".wav") == 0) {
+        return "wav";
+    }
+
+    if (strcasecmp(ext, ".f32") == 0) {
+        return "f32";
+    }
+
+    return NULL;
+}
+
+bool is_supported_wav(const char* input) {
+    MappedFile file;
+    if (!file.open(input, MappedFile::ModeRead)) {
+        return false;
+    }
+
+    WavFormat format;
+    return wav_parse_header(file.data(), file.size(), format);
+}
+
+} // namespace
+
+WavBackend::WavBackend() {
+    roc_log(LogDebug, "initializing wav backend");
+}
+
+bool WavBackend::probe(const char* driver, const char* inout, int filter_flags) {
+    if ((filter_flags & FilterFile) == 0) {
+        return false;
+    }
+
+    if (!inout || strcmp(inout, "-") == 0) {
+        return false;
+    }
+
+    driver = select_driver(driver, inout);
+    if (!driver) {
+        return false;
+    }
+
+    if ((filter_flags & FilterSource) && strcmp(driver, "wav") == 0) {
+        // let other backends handle encodings we don't support
+        return is_supported_wav(inout);
+    }
+
+    return true;
+}
+
+ISink* WavBackend::open_sink(core::IAllocator& allocator,
+                             const char* driver,
+                             const char* output,
+                             const Config& config) {
+    driver = select_driver(driver, output);
+
+    core::UniquePtr<WavSink> sink(new (allocator) WavSink(config), allocator);
+    if (!sink) {
+        return NULL;
+    }
+
+    if (!sink->valid()) {
+        return NULL;
+    }
+
+    if (!sink->open(driver, output)) {
+        return NULL;
+    }
+
+    return sink.release();
+}
+
+ISource* WavBackend::open_source(core::IAllocator& allocator,
+                                 const char* driver,
+                                 const char* input,
+                                 const Config& config) {
+    driver = select_driver(driver, input);
+
+    core::UniquePtr<WavSource> source(new (allocator) WavSource(config), allocator);
+    if (!source) {
+        return NULL;
+    }
+
+    if (!source->valid()) {
+        return NULL;
+    }
+
+    if (!source->open(driver, input)) {
+        return NULL;
+    }
+
+    return source.release();
+}
+
+bool WavBackend::get_drivers(core::Array<DriverInfo>& arr, int filter_flags) {
+    if (filter_flags & FilterFile) {
+        if (!add_driver_uniq(arr, "wav")) {
+            return false;
+        }
+        if (!add_driver_uniq(arr, "f32")) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace sndio
+} // namespace roc
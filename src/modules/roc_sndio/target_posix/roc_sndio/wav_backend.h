@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_sndio/target_posix/roc_sndio/wav_backend.h
+//! @brief WAV backend.
+
+#ifndef ROC_SNDIO_WAV_BACKEND_H_
+#define ROC_SNDIO_WAV_BACKEND_H_
+
+#include "roc_core/array.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/singleton.h"
+#include "roc_sndio/ibackend.h"
+
+namespace roc {
+namespace sndio {
+
+//! WAV backend.
+//! @remarks
+//!  Handles "wav" files with 16, 24 or 32-bit integer or 32-bit float samples,
+//!  and "f32" files with raw 32-bit float samples, using memory-mapped I/O.
+//!  WAV files with other encodings are left to other backends.
+class WavBackend : public IBackend, core::NonCopyable<> {
+public:
+    //! Get instance.
+    static WavBackend& instance() {
+        return core::Singleton<WavBackend>::instance();
+    }
+
+    //! Check whether the backend can handle given input or output.
+    virtual bool probe(const char* driver, const char* inout, int filter_flags);
+
+    //! Create and open a sink.
+    virtual ISink* open_sink(core::IAllocator& allocator,
+                             const char* driver,
+                             const char* output,
+                             const Config& config);
+
+    //! Create and open a source.
+    virtual ISource* open_source(core::IAllocator& allocator,
+                                 const char* driver,
+                                 const char* input,
+                                 const Config& config);
+
+    //! Append supported dirvers to the list.
+    virtual bool get_drivers(core::Array<DriverInfo>& arr, int filter_flags);
+
+private:
+    friend class core::Singleton<WavBackend>;
+
+    WavBackend();
+};
+
+} // namespace sndio
+} // namespace roc
+
+#endif // ROC_SNDIO_WAV_BACKEND_H_
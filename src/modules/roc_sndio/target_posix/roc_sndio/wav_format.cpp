@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_sndio/wav_format.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace sndio {
+
+namespace {
+
+enum {
+    FormatTag_PCM = 0x0001,
+    FormatTag_Float = 0x0003,
+    FormatTag_Extensible = 0xFFFE
+};
+
+// Byte-wise loads and stores don't depend on host endianness and alignment;
+// compilers merge them into plain loads and stores and vectorize the loops
+// below on little-endian targets.
+
+inline uint16_t load_le16(const uint8_t* p) {
+    return uint16_t(uint16_t(p[0]) | uint16_t(p[1]) << 8);
+}
+
+inline uint32_t load_le32(const uint8_t* p) {
+    return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16
+        | uint32_t(p[3]) << 24;
+}
+
+inline void store_le16(uint8_t* p, uint16_t v) {
+    p[0] = uint8_t(v);
+    p[1] = uint8_t(v >> 8);
+}
+
+inline void store_le32(uint8_t* p, uint32_t v) {
+    p[0] = uint8_t(v);
+    p[1] = uint8_t(v >> 8);
+    p[2] = uint8_t(v >> 16);
+    p[3] = uint8_t(v >> 24);
+}
+
+inline uint32_t clamp_u32(size_t v) {
+    return v > 0xffffffffu ? 0xffffffffu : uint32_t(v);
+}
+
+bool parse_fmt_chunk(const uint8_t* chunk, size_t chunk_size, WavFormat& format) {
+    if (chunk_size < 16) {
+        return false;
+    }
+
+    uint16_t tag = load_le16(chunk);
+    const uint16_t num_channels = load_le16(chunk + 2);
+    const uint32_t sample_rate = load_le32(chunk + 4);
+    const uint16_t block_align = load_le16(chunk + 12);
+    const uint16_t bits = load_le16(chunk + 14);
+
+    if (tag == FormatTag_Extensible) {
+        if (chunk_size < 40) {
+            return false;
+        }
+        // first two bytes of SubFormat GUID hold the format tag
+        tag = load_le16(chunk + 24);
+    }
+
+    if (tag == FormatTag_PCM && bits == 16) {
+        format.encoding = WavEncoding_Int16;
+    } else if (tag == FormatTag_PCM && bits == 24) {
+        format.encoding = WavEncoding_Int24;
+    } else if (tag == FormatTag_PCM && bits == 32) {
+        format.encoding = WavEncoding_Int32;
+    } else if (tag == FormatTag_Float && bits == 32) {
+        format.encoding = WavEncoding_Float32;
+    } else {
+        return false;
+    }
+
+    if (num_channels == 0 || sample_rate == 0) {
+        return false;
+    }
+
+    if (block_align != num_channels * wav_sample_size(format.encoding)) {
+        return false;
+    }
+
+    format.num_channels = num_channels;
+    format.sample_rate = sample_rate;
+
+    return true;
+}
+
+} // namespace
+
+size_t wav_sample_size(WavEncoding encoding) {
+    switch (encoding) {
+    case WavEncoding_Int16:
+        return 2;
+    case WavEncoding_Int24:
+        return 3;
+    case WavEncoding_Int32:
+    case WavEncoding_Float32:
+        return 4;
+    }
+
+    roc_panic("wav format: unknown encoding %d", (int)encoding);
+}
+
+bool wav_parse_header(const uint8_t* data, size_t size, WavFormat& format) {
+    if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    bool has_fmt = false;
+
+    for (size_t pos = 12; pos + 8 <= size;) {
+        const uint8_t* chunk_id = data + pos;
+        const size_t chunk_size = load_le32(data + pos + 4);
+        const size_t chunk_pos = pos + 8;
+        const size_t chunk_avail = size - chunk_pos;
+
+        if (memcmp(chunk_id, "fmt ", 4) == 0) {
+            if (chunk_size > chunk_avail
+                || !parse_fmt_chunk(data + chunk_pos, chunk_size, format)) {
+                return false;
+            }
+            has_fmt = true;
+        } else if (memcmp(chunk_id, "data", 4) == 0) {
+            if (!has_fmt) {
+                return false;
+            }
+
+            const size_t block_size =
+                format.num_channels * wav_sample_size(format.encoding);
+
+            // truncated files and streams with unknown size are common
+            format.data_offset = chunk_pos;
+            format.data_size = std::min(chunk_size, chunk_avail);
+            format.data_size -= format.data_size % block_size;
+
+            return true;
+        }
+
+        if (chunk_size >= chunk_avail) {
+            break;
+        }
+
+        pos = chunk_pos + chunk_size + (chunk_size & 1);
+    }
+
+    return false;
+}
+
+void wav_write_header(uint8_t* data, const WavFormat& format) {
+    roc_panic_if(format.encoding != WavEncoding_Float32);
+
+    const size_t block_size = format.num_channels * wav_sample_size(format.encoding);
+
+    uint8_t* p = data;
+
+    memcpy(p, "RIFF", 4);
+    store_le32(p + 4, clamp_u32(WavHeaderSize - 8 + format.data_size));
+    memcpy(p + 8, "WAVE", 4);
+    p += 12;
+
+    memcpy(p, "fmt ", 4);
+    store_le32(p + 4, 18);
+    store_le16(p + 8, FormatTag_Float);
+    store_le16(p + 10, uint16_t(format.num_channels));
+    store_le32(p + 12, uint32_t(format.sample_rate));
+    store_le32(p + 16, uint32_t(format.sample_rate * block_size));
+    store_le16(p + 20, uint16_t(block_size));
+    store_le16(p + 22, 32);
+    store_le16(p + 24, 0);
+    p += 26;
+
+    memcpy(p, "fact", 4);
+    store_le32(p + 4, 4);
+    store_le32(p + 8, clamp_u32(format.data_size / block_size));
+    p += 12;
+
+    memcpy(p, "data", 4);
+    store_le32(p + 4, clamp_u32(format.data_size));
+    p += 8;
+
+    roc_panic_if(p - data != WavHeaderSize);
+}
+
+void wav_decode_samples(WavEncoding encoding,
+                        const uint8_t* in,
+                        audio::sample_t* out,
+                        size_t n_samples) {
+    switch (encoding) {
+    case WavEncoding_Int16:
+        for (size_t n = 0; n < n_samples; n++) {
+            out[n] = float(int16_t(load_le16(in + n * 2))) * (1.0f / 32768.0f);
+        }
+        break;
+
+    case WavEncoding_Int24:
+        for (size_t n = 0; n < n_samples; n++) {
+            const uint8_t* p = in + n * 3;
+            const int32_t s = int32_t(uint32_t(p[0]) << 8 | uint32_t(p[1]) << 16
+                                      | uint32_t(p[2]) << 24)
+                >> 8;
+            out[n] = float(s) * (1.0f / 8388608.0f);
+        }
+        break;
+
+    case WavEncoding_Int32:
+        for (size_t n = 0; n < n_samples; n++) {
+            out[n] = float(int32_t(load_le32(in + n * 4))) * (1.0f / 2147483648.0f);
+        }
+        break;
+
+    case WavEncoding_Float32:
+        for (size_t n = 0; n < n_samples; n++) {
+            const uint32_t s = load_le32(in + n * 4);
+            memcpy(&out[n], &s, sizeof(float));
+        }
+        break;
+    }
+}
+
+void wav_encode_samples(const audio::sample_t* in, uint8_t* out, size_t n_samples) {
+    for (size_t n = 0; n < n_samples; n++) {
+        uint32_t s;
+        memcpy(&s, &in[n], sizeof(float));
+        store_le32(out + n * 4, s);
+    }
+}
+
+} // namespace sndio
+} // namespace roc
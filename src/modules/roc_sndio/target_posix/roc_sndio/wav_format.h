@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_sndio/target_posix/roc_sndio/wav_format.h
+//! @brief WAV format.
+
+#ifndef ROC_SNDIO_WAV_FORMAT_H_
+#define ROC_SNDIO_WAV_FORMAT_H_
+
+#include "roc_audio/units.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace sndio {
+
+//! Sample encoding of WAV or raw file.
+//! @remarks
+//!  All encodings are little-endian.
+enum WavEncoding {
+    //! 16-bit signed integer.
+    WavEncoding_Int16,
+
+    //! 24-bit signed integer.
+    WavEncoding_Int24,
+
+    //! 32-bit signed integer.
+    WavEncoding_Int32,
+
+    //! 32-bit IEEE float.
+    WavEncoding_Float32
+};
+
+//! WAV stream parameters.
+struct WavFormat {
+    //! Sample encoding.
+    WavEncoding encoding;
+
+    //! Number of channels.
+    size_t num_channels;
+
+    //! Number of samples per channel per second.
+    size_t sample_rate;
+
+    //! Offset of the sample data from the beginning of file, in bytes.
+    size_t data_offset;
+
+    //! Size of the sample data, in bytes.
+    size_t data_size;
+
+    WavFormat()
+        : encoding(WavEncoding_Float32)
+        , num_channels(0)
+        , sample_rate(0)
+        , data_offset(0)
+        , data_size(0) {
+    }
+};
+
+//! Size of header written by wav_write_header().
+enum { WavHeaderSize = 58 };
+
+//! Get size of one sample in bytes.
+size_t wav_sample_size(WavEncoding encoding);
+
+//! Parse WAV header.
+//! @remarks
+//!  @p data and @p size define the whole file. Fills @p format, including
+//!  the position of the sample data, which is truncated to the file size
+//!  and to a multiple of the size of one sample for all channels.
+//! @returns
+//!  false if the file is not a WAV file or has unsupported encoding.
+bool wav_parse_header(const uint8_t* data, size_t size, WavFormat& format);
+
+//! Write WAV header.
+//! @remarks
+//!  Writes WavHeaderSize bytes to @p data. Only WavEncoding_Float32 is
+//!  supported. The data size is taken from @p format.
+void wav_write_header(uint8_t* data, const WavFormat& format);
+
+//! Decode samples.
+//! @remarks
+//!  Converts @p n_samples samples from @p in to floats in @p out.
+void wav_decode_samples(WavEncoding encoding,
+                        const uint8_t* in,
+                        audio::sample_t* out,
+                        size_t n_samples);
+
+//! Encode samples.
+//! @remarks
+//!  Converts @p n_samples floats from @p in to WavEncoding_Float32 in @p out.
+void wav_encode_samples(const audio::sample_t* in, uint8_t* out, size_t n_samples);
+
+} // namespace sndio
+} // namespace roc
+
+#endif // ROC_SNDIO_WAV_FORMAT_H_
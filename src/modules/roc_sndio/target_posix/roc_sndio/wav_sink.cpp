@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <string.h>
+
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_sndio/wav_sink.h"
+
+namespace roc {
+namespace sndio {
+
+WavSink::WavSink(const Config& config)
+    : has_header_(false)
+    , pos_(0)
+    , valid_(false) {
+    format_.encoding = WavEncoding_Float32;
+    format_.num_channels = packet::num_channels(config.channels);
+    format_.sample_rate = config.sample_rate;
+
+    if (format_.num_channels == 0) {
+        roc_log(LogError, "wav sink: # of channels is zero");
+        return;
+    }
+
+    if (format_.sample_rate == 0) {
+        roc_log(LogError, "wav sink: sample rate is zero");
+        return;
+    }
+
+    if (config.latency != 0) {
+        roc_log(LogError, "wav sink: setting io latency not supported by wav backend");
+        return;
+    }
+
+    valid_ = true;
+}
+
+WavSink::~WavSink() {
+    close_();
+}
+
+bool WavSink::valid() const {
+    return valid_;
+}
+
+bool WavSink::open(const char* driver, const char* output) {
+    roc_panic_if(!valid_);
+
+    roc_log(LogInfo, "wav sink: opening: driver=%s output=%s", driver, output);
+
+    if (file_.is_open()) {
+        roc_panic("wav sink: can't call open() more than once");
+    }
+
+    if (!file_.open(output, MappedFile::ModeWrite)) {
+        roc_log(LogError, "wav sink: can't open output file: %s", output);
+        return false;
+    }
+
+    has_header_ = !(driver && strcmp(driver, "f32") == 0);
+
+    if (has_header_) {
+        format_.data_offset = WavHeaderSize;
+
+        if (!file_.resize(format_.data_offset)) {
+            return false;
+        }
+    }
+
+    pos_ = format_.data_offset;
+
+    update_header_();
+
+    roc_log(LogInfo, "wav sink: bits=%lu out_rate=%lu ch=%lu has_header=%d",
+            (unsigned long)wav_sample_size(format_.encoding) * 8,
+            (unsigned long)format_.sample_rate, (unsigned long)format_.num_channels,
+            (int)has_header_);
+
+    return true;
+}
+
+size_t WavSink::sample_rate() const {
+    roc_panic_if(!valid_);
+
+    return format_.sample_rate;
+}
+
+bool WavSink::has_clock() const {
+    roc_panic_if(!valid_);
+
+    return false;
+}
+
+core::nanoseconds_t WavSink::latency() const {
+    roc_panic_if(!valid_);
+
+    return 0;
+}
+
+void WavSink::write(audio::Frame& frame) {
+    roc_panic_if(!valid_);
+
+    if (!file_.is_open()) {
+        roc_panic("wav sink: write: non-open output file");
+    }
+
+    const size_t n_bytes = frame.size() * wav_sample_size(format_.encoding);
+
+    if (!file_.resize(pos_ + n_bytes)) {
+        roc_log(LogError, "wav sink: failed to write output buffer");
+        return;
+    }
+
+    wav_encode_samples(frame.data(), file_.mutable_data() + pos_, frame.size());
+
+    pos_ += n_bytes;
+
+    update_header_();
+}
+
+void WavSink::close_() {
+    if (!file_.is_open()) {
+        return;
+    }
+
+    roc_log(LogInfo, "wav sink: closing output");
+
+    update_header_();
+
+    if (!file_.close()) {
+        roc_log(LogError, "wav sink: can't close output");
+    }
+}
+
+void WavSink::update_header_() {
+    if (!has_header_ || !file_.data()) {
+        return;
+    }
+
+    format_.data_size = pos_ - format_.data_offset;
+    wav_write_header(file_.mutable_data(), format_);
+}
+
+} // namespace sndio
+} // namespace roc
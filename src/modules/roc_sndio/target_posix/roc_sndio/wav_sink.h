@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_sndio/target_posix/roc_sndio/wav_sink.h
+//! @brief WAV sink.
+
+#ifndef ROC_SNDIO_WAV_SINK_H_
+#define ROC_SNDIO_WAV_SINK_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_sndio/config.h"
+#include "roc_sndio/isink.h"
+#include "roc_sndio/mapped_file.h"
+#include "roc_sndio/wav_format.h"
+
+namespace roc {
+namespace sndio {
+
+//! WAV sink.
+//! @remarks
+//!  Maps output file into memory and encodes frames directly into the
+//!  mapping as 32-bit floats. WAV header is written when the sink is opened
+//!  and its data size is updated after every frame, so the output is a valid
+//!  WAV file even if the process is terminated without closing the sink.
+class WavSink : public ISink, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    WavSink(const Config& config);
+
+    ~WavSink();
+
+    //! Check if the object was successfully constructed.
+    bool valid() const;
+
+    //! Open output file.
+    //! @remarks
+    //!  If @p driver is "f32", raw 32-bit floats are written without header.
+    //!  Otherwise a WAV file is written.
+    bool open(const char* driver, const char* output);
+
+    //! Get sample rate of the sink.
+    virtual size_t sample_rate() const;
+
+    //! Check if the sink has own clock.
+    virtual bool has_clock() const;
+
+    //! Get current playback latency of the sink.
+    virtual core::nanoseconds_t latency() const;
+
+    //! Write audio frame.
+    virtual void write(audio::Frame& frame);
+
+private:
+    void close_();
+    void update_header_();
+
+    MappedFile file_;
+    WavFormat format_;
+
+    bool has_header_;
+    size_t pos_;
+
+    bool valid_;
+};
+
+} // namespace sndio
+} // namespace roc
+
+#endif // ROC_SNDIO_WAV_SINK_H_
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <string.h>
+
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_sndio/wav_source.h"
+
+namespace roc {
+namespace sndio {
+
+WavSource::WavSource(const Config& config)
+    : num_channels_(packet::num_channels(config.channels))
+    , config_sample_rate_(config.sample_rate)
+    , pos_(0)
+    , end_(0)
+    , valid_(false) {
+    if (num_channels_ == 0) {
+        roc_log(LogError, "wav source: # of channels is zero");
+        return;
+    }
+
+    if (config.latency != 0) {
+        roc_log(LogError, "wav source: setting io latency not supported by wav backend");
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool WavSource::valid() const {
+    return valid_;
+}
+
+bool WavSource::open(const char* driver, const char* input) {
+    roc_panic_if(!valid_);
+
+    roc_log(LogInfo, "wav source: opening: driver=%s input=%s", driver, input);
+
+    if (file_.is_open()) {
+        roc_panic("wav source: can't call open() more than once");
+    }
+
+    if (!file_.open(input, MappedFile::ModeRead)) {
+        roc_log(LogError, "wav source: can't open input file: %s", input);
+        return false;
+    }
+
+    if (driver && strcmp(driver, "f32") == 0) {
+        if (config_sample_rate_ == 0) {
+            roc_log(LogError, "wav source: sample rate should be set for raw input");
+            return false;
+        }
+
+        format_.encoding = WavEncoding_Float32;
+        format_.num_channels = num_channels_;
+        format_.sample_rate = config_sample_rate_;
+        format_.data_offset = 0;
+        format_.data_size = file_.size()
+            - file_.size() % (num_channels_ * wav_sample_size(format_.encoding));
+    } else {
+        if (!wav_parse_header(file_.data(), file_.size(), format_)) {
+            roc_log(LogError, "wav source: not a wav file or unsupported encoding: %s",
+                    input);
+            return false;
+        }
+    }
+
+    roc_log(LogInfo,
+            "wav source: in_bits=%lu in_rate=%lu in_ch=%lu out_ch=%lu data_size=%lu",
+            (unsigned long)wav_sample_size(format_.encoding) * 8,
+            (unsigned long)format_.sample_rate, (unsigned long)format_.num_channels,
+            (unsigned long)num_channels_, (unsigned long)format_.data_size);
+
+    if (format_.num_channels != num_channels_) {
+        roc_log(LogError,
+                "wav source: can't open: unsupported # of channels: "
+                "expected=%lu actual=%lu",
+                (unsigned long)num_channels_, (unsigned long)format_.num_channels);
+        return false;
+    }
+
+    pos_ = format_.data_offset;
+    end_ = format_.data_offset + format_.data_size;
+
+    return true;
+}
+
+size_t WavSource::sample_rate() const {
+    roc_panic_if(!valid_);
+
+    if (!file_.is_open()) {
+        roc_panic("wav source: sample_rate: non-open input file");
+    }
+
+    return format_.sample_rate;
+}
+
+bool WavSource::has_clock() const {
+    roc_panic_if(!valid_);
+
+    return false;
+}
+
+ISource::State WavSource::state() const {
+    roc_panic_if(!valid_);
+
+    return Active;
+}
+
+void WavSource::wait_active() const {
+    roc_panic_if(!valid_);
+
+    // always active
+}
+
+void WavSource::set_sink_latency(core::nanoseconds_t) {
+    roc_panic_if(!valid_);
+
+    // not used
+}
+
+bool WavSource::read(audio::Frame& frame) {
+    roc_panic_if(!valid_);
+
+    const size_t sample_size = wav_sample_size(format_.encoding);
+
+    size_t n_samples = (end_ - pos_) / sample_size;
+    if (n_samples == 0) {
+        return false;
+    }
+    if (n_samples > frame.size()) {
+        n_samples = frame.size();
+    }
+
+    wav_decode_samples(format_.encoding, file_.data() + pos_, frame.data(), n_samples);
+
+    if (n_samples < frame.size()) {
+        memset(frame.data() + n_samples, 0,
+               (frame.size() - n_samples) * sizeof(audio::sample_t));
+    }
+
+    pos_ += n_samples * sample_size;
+
+    file_.advise(pos_);
+
+    return true;
+}
+
+} // namespace sndio
+} // namespace roc
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_sndio/target_posix/roc_sndio/wav_source.h
+//! @brief WAV source.
+
+#ifndef ROC_SNDIO_WAV_SOURCE_H_
+#define ROC_SNDIO_WAV_SOURCE_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_sndio/config.h"
+#include "roc_sndio/isource.h"
+#include "roc_sndio/mapped_file.h"
+#include "roc_sndio/wav_format.h"
+
+namespace roc {
+namespace sndio {
+
+//! WAV source.
+//! @remarks
+//!  Maps WAV or raw float file into memory and decodes samples directly
+//!  from the mapping into frames, without intermediate buffers.
+class WavSource : public ISource, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    WavSource(const Config& config);
+
+    //! Check if the object was successfully constructed.
+    bool valid() const;
+
+    //! Open input file.
+    //! @remarks
+    //!  If @p driver is "f32", the file is read as raw 32-bit floats with
+    //!  the sample rate and channels from config. Otherwise it's read as
+    //!  a WAV file, which should have the same channels as config.
+    bool open(const char* driver, const char* input);
+
+    //! Get source sample rate.
+    virtual size_t sample_rate() const;
+
+    //! Check if the source has own clock.
+    virtual bool has_clock() const;
+
+    //! Get current source state.
+    virtual State state() const;
+
+    //! Wait until the source state becomes active.
+    virtual void wait_active() const;
+
+    //! Set playback latency of the sink the source is read to.
+    virtual void set_sink_latency(core::nanoseconds_t latency);
+
+    //! Read frame.
+    virtual bool read(audio::Frame& frame);
+
+private:
+    MappedFile file_;
+    WavFormat format_;
+
+    const size_t num_channels_;
+    const size_t config_sample_rate_;
+
+    size_t pos_;
+    size_t end_;
+
+    bool valid_;
+};
+
+} // namespace sndio
+} // namespace roc
+
+#endif // ROC_SNDIO_WAV_SOURCE_H_
@@ -38,8 +38,8 @@ ISink* PulseaudioBackend::open_sink(core::IAllocator& allocator,
                                     const char*,
                                     const char* output,
                                     const Config& config) {
-    core::UniquePtr<PulseaudioSink> sink(new (allocator) PulseaudioSink(config),
-                                         allocator);
+    core::UniquePtr<PulseaudioSink> sink(
+        new (allocator) PulseaudioSink(allocator, config), allocator);
     if (!sink) {
         return NULL;
     }
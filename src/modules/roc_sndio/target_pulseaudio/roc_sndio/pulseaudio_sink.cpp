@@ -26,9 +26,12 @@ const core::nanoseconds_t DefaultLatency = core::Millisecond * 60;
 const core::nanoseconds_t MinTimeout = core::Millisecond * 50;
 const core::nanoseconds_t MaxTimeout = core::Second * 2;
 
+// Number of frames that fit into the ring between pipeline and stream.
+const size_t RingFrames = 4;
+
 } // namespace
 
-PulseaudioSink::PulseaudioSink(const Config& config)
+PulseaudioSink::PulseaudioSink(core::IAllocator& allocator, const Config& config)
     : device_(NULL)
     , sample_rate_(config.sample_rate)
     , num_channels_(packet::num_channels(config.channels))
@@ -39,8 +42,11 @@ PulseaudioSink::PulseaudioSink(const Config& config)
     , context_(NULL)
     , sink_info_op_(NULL)
     , stream_(NULL)
-    , timer_(NULL)
-    , timer_deadline_(0)
+    , ring_(allocator, config.frame_size * RingFrames)
+    , wait_cond_(wait_mutex_)
+    , stream_latency_us_(0)
+    , n_underruns_(0)
+    , n_silence_samples_(0)
     , rate_limiter_(ReportInterval) {
     if (config.latency != 0) {
         latency_ = config.latency;
@@ -104,6 +110,22 @@ bool PulseaudioSink::has_clock() const {
     return true;
 }
 
+core::nanoseconds_t PulseaudioSink::latency() const {
+    ensure_started_();
+
+    // doesn't lock the mainloop; stream latency is updated by the latency
+    // callback, and sample rate doesn't change after open()
+
+    const core::nanoseconds_t stream_latency =
+        core::nanoseconds_t(stream_latency_us_) * core::Microsecond;
+
+    const core::nanoseconds_t ring_latency = core::nanoseconds_t(ring_.size())
+        / core::nanoseconds_t(num_channels_) * core::Second
+        / core::nanoseconds_t(sample_rate_);
+
+    return stream_latency + ring_latency;
+}
+
 void PulseaudioSink::write(audio::Frame& frame) {
     ensure_started_();
 
@@ -122,24 +144,77 @@ bool PulseaudioSink::write_frame_(audio::Frame& frame) {
     const audio::sample_t* data = frame.data();
     size_t size = frame.size();
 
-    while (size > 0) {
-        pa_threaded_mainloop_lock(mainloop_);
+    for (;;) {
+        if (broken_) {
+            roc_log(LogError, "pulseaudio sink: stream is broken");
+            return false;
+        }
 
-        const ssize_t ret = write_stream_(data, size);
+        const size_t ret = ring_.write(data, size);
 
-        pa_threaded_mainloop_unlock(mainloop_);
+        data += ret;
+        size -= ret;
 
-        if (ret < 0) {
+        if (size == 0) {
+            return true;
+        }
+
+        if (!wait_ring_()) {
             return false;
         }
+    }
+}
+
+bool PulseaudioSink::wait_ring_() {
+    core::Mutex::Lock lock(wait_mutex_);
+
+    waiting_ = true;
+
+    bool timeout_expired = false;
+
+    while (ring_.size() == ring_.capacity() && !broken_) {
+        if (!wait_cond_.timed_wait(timeout_)) {
+            timeout_expired = ring_.size() == ring_.capacity();
+            break;
+        }
+    }
+
+    waiting_ = false;
+
+    if (timeout_expired) {
+        roc_log(LogInfo,
+                "pulseaudio sink: stream timeout expired: latency=%ld timeout=%ld",
+                (long)packet::timestamp_from_ns(latency_, sample_rate_),
+                (long)packet::timestamp_from_ns(timeout_, sample_rate_));
+
+        if (timeout_ < MaxTimeout) {
+            timeout_ *= 2;
+            if (timeout_ > MaxTimeout) {
+                timeout_ = MaxTimeout;
+            }
+            roc_log(LogDebug,
+                    "pulseaudio sink: stream timeout increased: latency=%ld timeout=%ld",
+                    (long)packet::timestamp_from_ns(latency_, sample_rate_),
+                    (long)packet::timestamp_from_ns(timeout_, sample_rate_));
+        }
 
-        data += (size_t)ret;
-        size -= (size_t)ret;
+        return false;
     }
 
     return true;
 }
 
+void PulseaudioSink::notify_writer_() {
+    // fast path: writer is not waiting, so no need to take the lock
+    if (!waiting_) {
+        return;
+    }
+
+    core::Mutex::Lock lock(wait_mutex_);
+
+    wait_cond_.broadcast();
+}
+
 bool PulseaudioSink::check_params_() const {
     if (num_channels_ == 0) {
         roc_log(LogError, "pulseaudio sink: # of channels is zero");
@@ -156,6 +231,11 @@ bool PulseaudioSink::check_params_() const {
         return false;
     }
 
+    if (!ring_.valid()) {
+        roc_log(LogError, "pulseaudio sink: can't allocate ring");
+        return false;
+    }
+
     return true;
 }
 
@@ -221,7 +301,6 @@ void PulseaudioSink::close_() {
 
     pa_threaded_mainloop_lock(mainloop_);
 
-    stop_timer_();
     close_stream_();
     cancel_sink_info_op_();
     close_context_();
@@ -229,6 +308,8 @@ void PulseaudioSink::close_() {
     open_done_ = false;
     opened_ = false;
 
+    broken_ = false;
+
     pa_threaded_mainloop_unlock(mainloop_);
 }
 
@@ -425,74 +506,47 @@ void PulseaudioSink::close_stream_() {
     stream_ = NULL;
 }
 
-ssize_t PulseaudioSink::write_stream_(const audio::sample_t* data, size_t size) {
-    ensure_opened_();
-
-    ssize_t writable_size = wait_stream_();
-
-    if (writable_size == -1) {
-        return -1;
-    }
-
-    roc_log(LogTrace, "pulseaudio sink: write: requested_size=%lu writable_size=%lu",
-            (unsigned long)size, (unsigned long)writable_size);
-
-    if (size > (size_t)writable_size) {
-        size = (size_t)writable_size;
-    }
-
-    int err = pa_stream_write(stream_, data, size * sizeof(audio::sample_t), NULL, 0,
-                              PA_SEEK_RELATIVE);
+void PulseaudioSink::write_stream_(size_t length) {
+    roc_panic_if_not(stream_);
 
-    if (err != 0) {
-        roc_log(LogError, "pulseaudio sink: pa_stream_write(): %s", pa_strerror(err));
-        return -1;
-    }
+    while (length > 0) {
+        void* data = NULL;
+        size_t size = length;
 
-    return (ssize_t)size;
-}
-
-ssize_t PulseaudioSink::wait_stream_() {
-    bool timer_expired = false;
+        if (int err = pa_stream_begin_write(stream_, &data, &size)) {
+            roc_log(LogError, "pulseaudio sink: pa_stream_begin_write(): %s",
+                    pa_strerror(err));
+            return;
+        }
 
-    for (;;) {
-        size_t writable_size = pa_stream_writable_size(stream_);
+        if (size > length) {
+            size = length;
+        }
 
-        if (writable_size == (size_t)-1) {
-            roc_log(LogError, "pulseaudio sink: stream is broken");
-            return -1;
+        const size_t n_samples = size / sizeof(audio::sample_t);
+        if (n_samples == 0) {
+            pa_stream_cancel_write(stream_);
+            return;
         }
 
-        if (writable_size == 0 && timer_expired) {
-            roc_log(LogInfo,
-                    "pulseaudio sink: stream timeout expired: latency=%ld timeout=%ld",
-                    (long)packet::timestamp_from_ns(latency_, sample_rate_),
-                    (long)packet::timestamp_from_ns(timeout_, sample_rate_));
+        audio::sample_t* samples = (audio::sample_t*)data;
 
-            if (timeout_ < MaxTimeout) {
-                timeout_ *= 2;
-                if (timeout_ > MaxTimeout) {
-                    timeout_ = MaxTimeout;
-                }
-                roc_log(LogDebug,
-                        "pulseaudio sink: stream timeout increased: "
-                        "latency=%ld timeout=%ld",
-                        (long)packet::timestamp_from_ns(latency_, sample_rate_),
-                        (long)packet::timestamp_from_ns(timeout_, sample_rate_));
-            }
+        const size_t n_read = ring_.read(samples, n_samples);
 
-            return -1;
-        }
+        if (n_read < n_samples) {
+            memset(samples + n_read, 0, (n_samples - n_read) * sizeof(audio::sample_t));
 
-        if (writable_size != 0) {
-            return (ssize_t)writable_size;
+            n_underruns_++;
+            n_silence_samples_ += n_samples - n_read;
         }
 
-        start_timer_(timeout_);
-
-        pa_threaded_mainloop_wait(mainloop_);
+        if (int err = pa_stream_write(stream_, data, n_samples * sizeof(audio::sample_t),
+                                      NULL, 0, PA_SEEK_RELATIVE)) {
+            roc_log(LogError, "pulseaudio sink: pa_stream_write(): %s", pa_strerror(err));
+            return;
+        }
 
-        timer_expired = stop_timer_();
+        length -= n_samples * sizeof(audio::sample_t);
     }
 }
 
@@ -501,12 +555,18 @@ void PulseaudioSink::stream_state_cb_(pa_stream* stream, void* userdata) {
 
     PulseaudioSink& self = *(PulseaudioSink*)userdata;
 
+    const pa_stream_state_t state = pa_stream_get_state(stream);
+
     if (self.opened_) {
+        if (state == PA_STREAM_FAILED || state == PA_STREAM_TERMINATED) {
+            roc_log(LogError, "pulseaudio sink: stream failed");
+
+            self.broken_ = true;
+            self.notify_writer_();
+        }
         return;
     }
 
-    const pa_stream_state_t state = pa_stream_get_state(stream);
-
     switch ((unsigned)state) {
     case PA_STREAM_READY:
         roc_log(LogTrace, "pulseaudio sink: successfully opened stream");
@@ -533,7 +593,8 @@ void PulseaudioSink::stream_write_cb_(pa_stream*, size_t length, void* userdata)
     PulseaudioSink& self = *(PulseaudioSink*)userdata;
 
     if (length != 0) {
-        pa_threaded_mainloop_signal(self.mainloop_, 0);
+        self.write_stream_(length);
+        self.notify_writer_();
     }
 }
 
@@ -542,10 +603,6 @@ void PulseaudioSink::stream_latency_cb_(pa_stream* stream, void* userdata) {
 
     PulseaudioSink& self = *(PulseaudioSink*)userdata;
 
-    if (!self.rate_limiter_.allow()) {
-        return;
-    }
-
     pa_usec_t latency_us = 0;
     int negative = 0;
 
@@ -555,6 +612,12 @@ void PulseaudioSink::stream_latency_cb_(pa_stream* stream, void* userdata) {
         return;
     }
 
+    self.stream_latency_us_ = negative ? 0 : (long)latency_us;
+
+    if (!self.rate_limiter_.allow()) {
+        return;
+    }
+
     ssize_t latency = (ssize_t)(pa_usec_to_bytes(latency_us, &self.sample_spec_)
                                 / sizeof(audio::sample_t) / self.num_channels_);
 
@@ -562,50 +625,12 @@ void PulseaudioSink::stream_latency_cb_(pa_stream* stream, void* userdata) {
         latency = -latency;
     }
 
-    roc_log(LogDebug, "pulseaudio sink: stream_latency=%ld", (long)latency);
-}
-
-void PulseaudioSink::start_timer_(core::nanoseconds_t timeout) {
-    roc_panic_if_not(context_);
-
-    const core::nanoseconds_t timeout_usec =
-        (timeout + core::Microsecond - 1) / core::Microsecond;
-
-    timer_deadline_ = core::timestamp() + timeout_usec * core::Microsecond;
-
-    const pa_usec_t pa_deadline = pa_rtclock_now() + (pa_usec_t)timeout_usec;
-
-    if (!timer_) {
-        timer_ = pa_context_rttime_new(context_, pa_deadline, timer_cb_, this);
-        if (!timer_) {
-            roc_panic("pulseaudio sink: can't create timer");
-        }
-    } else {
-        pa_context_rttime_restart(context_, timer_, pa_deadline);
-    }
-}
-
-bool PulseaudioSink::stop_timer_() {
-    if (!timer_) {
-        return false;
-    }
-
-    pa_context_rttime_restart(context_, timer_, PA_USEC_INVALID);
-
-    const bool expired = core::timestamp() >= timer_deadline_;
-
-    return expired;
-}
-
-void PulseaudioSink::timer_cb_(pa_mainloop_api*,
-                               pa_time_event*,
-                               const struct timeval*,
-                               void* userdata) {
-    roc_log(LogTrace, "pulseaudio sink: timer callback");
-
-    PulseaudioSink& self = *(PulseaudioSink*)userdata;
-
-    pa_threaded_mainloop_signal(self.mainloop_, 0);
+    roc_log(LogDebug,
+            "pulseaudio sink: stream_latency=%ld ring_fill=%lu/%lu underruns=%lu"
+            " silence_samples=%lu",
+            (long)latency, (unsigned long)self.ring_.size(),
+            (unsigned long)self.ring_.capacity(), (unsigned long)self.n_underruns_,
+            (unsigned long)self.n_silence_samples_);
 }
 
 } // namespace sndio
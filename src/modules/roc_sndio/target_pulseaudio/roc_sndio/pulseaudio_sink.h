@@ -14,8 +14,13 @@
 
 #include <pulse/pulseaudio.h>
 
+#include "roc_core/atomic.h"
+#include "roc_core/cond.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/mutex.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/rate_limiter.h"
+#include "roc_core/spsc_ring.h"
 #include "roc_core/stddefs.h"
 #include "roc_packet/units.h"
 #include "roc_sndio/config.h"
@@ -24,11 +29,17 @@
 namespace roc {
 namespace sndio {
 
-//! PulseAudio sink,
+//! PulseAudio sink.
+//! @remarks
+//!  write() copies samples into a lock-free ring, and the stream write callback
+//!  drains the ring on the PulseAudio thread. The pipeline thread never takes
+//!  the mainloop lock; it only waits when the ring is full, which clocks the
+//!  pipeline by the sound server. If the ring doesn't have enough samples when
+//!  the server requests them, the rest is filled with silence.
 class PulseaudioSink : public ISink, public core::NonCopyable<> {
 public:
     //! Initialize.
-    PulseaudioSink(const Config& config);
+    PulseaudioSink(core::IAllocator& allocator, const Config& config);
 
     ~PulseaudioSink();
 
@@ -41,6 +52,9 @@ public:
     //! Check if the sink has own clock.
     virtual bool has_clock() const;
 
+    //! Get current playback latency of the sink.
+    virtual core::nanoseconds_t latency() const;
+
     //! Write audio frame.
     virtual void write(audio::Frame& frame);
 
@@ -54,12 +68,9 @@ private:
     static void stream_write_cb_(pa_stream* stream, size_t length, void* userdata);
     static void stream_latency_cb_(pa_stream* stream, void* userdata);
 
-    static void timer_cb_(pa_mainloop_api* mainloop,
-                          pa_time_event* timer,
-                          const struct timeval* tv,
-                          void* userdata);
-
     bool write_frame_(audio::Frame& frame);
+    bool wait_ring_();
+    void notify_writer_();
 
     bool check_params_() const;
 
@@ -82,11 +93,7 @@ private:
     void init_stream_params_(const pa_sink_info& info);
     bool open_stream_();
     void close_stream_();
-    ssize_t write_stream_(const audio::sample_t* data, size_t size);
-    ssize_t wait_stream_();
-
-    void start_timer_(core::nanoseconds_t timeout);
-    bool stop_timer_();
+    void write_stream_(size_t length);
 
     const char* device_;
     size_t sample_rate_;
@@ -103,13 +110,23 @@ private:
     pa_context* context_;
     pa_operation* sink_info_op_;
     pa_stream* stream_;
-    pa_time_event* timer_;
-
-    core::nanoseconds_t timer_deadline_;
 
     pa_sample_spec sample_spec_;
     pa_buffer_attr buffer_attrs_;
 
+    core::SpscRing<audio::sample_t> ring_;
+
+    core::Mutex wait_mutex_;
+    core::Cond wait_cond_;
+    core::Atomic waiting_;
+    core::Atomic broken_;
+
+    // written on PulseAudio thread, read on pipeline thread
+    core::Atomic stream_latency_us_;
+
+    size_t n_underruns_;
+    size_t n_silence_samples_;
+
     core::RateLimiter rate_limiter_;
 };
 
@@ -94,6 +94,17 @@ bool SoxSink::has_clock() const {
     return !is_file_;
 }
 
+core::nanoseconds_t SoxSink::latency() const {
+    roc_panic_if(!valid_);
+
+    if (!output_) {
+        roc_panic("sox sink: latency: non-open output file or device");
+    }
+
+    // SoX doesn't report device latency
+    return 0;
+}
+
 void SoxSink::write(audio::Frame& frame) {
     roc_panic_if(!valid_);
 
@@ -106,6 +106,12 @@ void SoxSource::wait_active() const {
     // always active
 }
 
+void SoxSource::set_sink_latency(core::nanoseconds_t) {
+    roc_panic_if(!valid_);
+
+    // not used
+}
+
 bool SoxSource::read(audio::Frame& frame) {
     roc_panic_if(!valid_);
 
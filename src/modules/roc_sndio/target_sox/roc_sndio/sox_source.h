@@ -61,6 +61,9 @@ public:
     //! Wait until the source state becomes active.
     virtual void wait_active() const;
 
+    //! Set playback latency of the sink the source is read to.
+    virtual void set_sink_latency(core::nanoseconds_t latency);
+
     //! Read frame.
     virtual bool read(audio::Frame&);
 
@@ -211,8 +211,12 @@ TEST(depacketizer, drop_late_packets) {
     queue.write(new_packet(encoder, ts2, 0.22f));
     queue.write(new_packet(encoder, ts3, 0.33f));
 
+    LONGS_EQUAL(0, dp.num_late_packets());
+
     expect_output(dp, SamplesPerPacket, 0.11f);
     expect_output(dp, SamplesPerPacket, 0.33f);
+
+    LONGS_EQUAL(1, dp.num_late_packets());
 }
 
 TEST(depacketizer, drop_late_packets_timestamp_overflow) {
@@ -9,6 +9,7 @@
 #include <CppUTest/TestHarness.h>
 
 #include "roc_audio/freq_estimator.h"
+#include "roc_audio/freq_estimator_decim.h"
 
 namespace roc {
 namespace audio {
@@ -19,6 +20,72 @@ enum { Target = 10000 };
 
 const double Epsilon = 0.0001;
 
+// Straightforward implementation of decimators and controller.
+class ReferenceEstimator {
+public:
+    explicit ReferenceEstimator(float target)
+        : target_(target)
+        , dec1_ind_(0)
+        , dec2_ind_(0)
+        , counter_(0)
+        , accum_(0)
+        , coeff_(1) {
+        for (size_t i = 0; i < fe_decim_len; i++) {
+            dec1_[i] = target;
+            dec2_[i] = target;
+        }
+    }
+
+    float freq_coeff() const {
+        return coeff_;
+    }
+
+    void update(packet::timestamp_t current) {
+        counter_++;
+
+        dec1_[dec1_ind_] = (float)current;
+
+        if (counter_ % fe_decim_factor == 0) {
+            dec2_[dec2_ind_] = filter_(dec1_, dec1_ind_);
+
+            if (counter_ % (fe_decim_factor * fe_decim_factor) == 0) {
+                counter_ = 0;
+
+                const float error = filter_(dec2_, dec2_ind_) - target_;
+                accum_ += error;
+                coeff_ = 1 + 100e-8f * error + 0.5e-8f * accum_;
+                return;
+            }
+
+            dec2_ind_ = (dec2_ind_ + 1) & fe_decim_len_mask;
+        }
+
+        dec1_ind_ = (dec1_ind_ + 1) & fe_decim_len_mask;
+    }
+
+private:
+    static float filter_(const float* samples, size_t ind) {
+        double accum = 0;
+        for (size_t j = 0; j < fe_decim_len; j++) {
+            const size_t i = (ind - j) & fe_decim_len_mask;
+            accum += (double)fe_decim_h[j] * (double)samples[i];
+        }
+        return (float)accum / fe_decim_h_gain;
+    }
+
+    const float target_;
+
+    float dec1_[fe_decim_len];
+    size_t dec1_ind_;
+
+    float dec2_[fe_decim_len];
+    size_t dec2_ind_;
+
+    size_t counter_;
+    float accum_;
+    float coeff_;
+};
+
 } // namespace
 
 TEST_GROUP(freq_estimator) {};
@@ -55,5 +122,21 @@ TEST(freq_estimator, small_queue_size) {
     } while (fe.freq_coeff() > 0.99f);
 }
 
+TEST(freq_estimator, reference) {
+    FreqEstimator fe(Target);
+    ReferenceEstimator ref(Target);
+
+    for (size_t n = 0; n < 100000; n++) {
+        // slow drift with periodic jitter
+        const packet::timestamp_t latency =
+            packet::timestamp_t(Target + n / 20 + (n * 7919) % 400);
+
+        fe.update(latency);
+        ref.update(latency);
+
+        DOUBLES_EQUAL((double)ref.freq_coeff(), (double)fe.freq_coeff(), 1e-6);
+    }
+}
+
 } // namespace audio
 } // namespace roc
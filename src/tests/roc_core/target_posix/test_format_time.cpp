@@ -10,6 +10,7 @@
 
 #include "roc_core/format_time.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/time.h"
 
 namespace roc {
 namespace core {
@@ -29,11 +30,11 @@ TEST(format_time, buffer_size) {
     char buf[64];
 
     for (size_t i = 0; i < TsLen; i++) {
-        CHECK(!format_time(buf, i));
+        CHECK(!format_time(buf, i, timestamp_realtime()));
     }
 
     for (size_t i = TsLen; i < sizeof(buf); i++) {
-        CHECK(format_time(buf, i));
+        CHECK(format_time(buf, i, timestamp_realtime()));
     }
 }
 
@@ -41,7 +42,7 @@ TEST(format_time, zero_terminator) {
     char buf[64];
     memset(buf, 'x', sizeof(buf));
 
-    CHECK(format_time(buf, sizeof(buf) - 10));
+    CHECK(format_time(buf, sizeof(buf) - 10, timestamp_realtime()));
 
     for (size_t i = 0; i < TsLen - 1; i++) {
         CHECK(buf[i] != '\0' && buf[i] != 'x');
@@ -54,5 +55,14 @@ TEST(format_time, zero_terminator) {
     }
 }
 
+TEST(format_time, milliseconds) {
+    char buf[64];
+
+    CHECK(format_time(buf, sizeof(buf), 1234 * Millisecond + 999 * Microsecond));
+    STRCMP_EQUAL(".234", buf + TsLen - 5);
+
+    CHECK(!format_time(buf, sizeof(buf), -1));
+}
+
 } // namespace core
 } // namespace roc
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/thread.h"
+#include "roc_core/thread_params.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+class TestThread : public Thread {
+public:
+    TestThread()
+        : result(false) {
+    }
+
+    ~TestThread() {
+        join();
+    }
+
+    ThreadParams params;
+    bool result;
+
+private:
+    virtual void run() {
+        result = set_thread_params(params);
+    }
+};
+
+} // namespace
+
+TEST_GROUP(thread_params) {};
+
+TEST(thread_params, set_name) {
+    ThreadParams params;
+    STRCMP_EQUAL("", params.name);
+
+    params.set_name("roc-test");
+    STRCMP_EQUAL("roc-test", params.name);
+
+    params.set_name("roc-very-long-thread-name");
+    LONGS_EQUAL(ThreadParams::MaxNameLen - 1, strlen(params.name));
+    STRCMP_EQUAL("roc-very-long-t", params.name);
+
+    params.set_name(NULL);
+    STRCMP_EQUAL("", params.name);
+}
+
+TEST(thread_params, defaults) {
+    TestThread thread;
+
+    CHECK(thread.start());
+    thread.join();
+
+    CHECK(thread.result);
+}
+
+TEST(thread_params, name) {
+    TestThread thread;
+    thread.params.set_name("roc-test");
+
+    CHECK(thread.start());
+    thread.join();
+
+    CHECK(thread.result);
+}
+
+TEST(thread_params, bad_priority) {
+    TestThread thread;
+    thread.params.policy = ThreadPolicyFifo;
+    thread.params.priority = 100000;
+
+    CHECK(thread.start());
+    thread.join();
+
+    CHECK(!thread.result);
+}
+
+TEST(thread_params, thread) {
+    ThreadParams params;
+    params.set_name("roc-test");
+
+    TestThread thread;
+    thread.set_params(params);
+
+    CHECK(thread.start());
+    thread.join();
+
+    CHECK(thread.result);
+}
+
+} // namespace core
+} // namespace roc
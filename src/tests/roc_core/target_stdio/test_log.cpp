@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "roc_core/log.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+enum { MaxMessages = 1000 };
+
+char messages[MaxMessages][64];
+LogLevel levels[MaxMessages];
+const char* modules[MaxMessages];
+size_t num_messages;
+
+void handle_message(LogLevel level, const char* module, const char* message) {
+    if (num_messages < MaxMessages) {
+        strncpy(messages[num_messages], message, sizeof(messages[0]) - 1);
+        levels[num_messages] = level;
+        modules[num_messages] = module;
+    }
+    num_messages++;
+}
+
+size_t count_messages(const char* prefix) {
+    size_t count = 0;
+    for (size_t n = 0; n < num_messages && n < MaxMessages; n++) {
+        if (strncmp(messages[n], prefix, strlen(prefix)) == 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+int evaluate(int& counter) {
+    return ++counter;
+}
+
+} // namespace
+
+TEST_GROUP(log) {
+    LogLevel saved_level;
+
+    void setup() {
+        saved_level = Logger::instance().level();
+
+        num_messages = 0;
+        memset(messages, 0, sizeof(messages));
+
+        Logger::instance().set_level(LogDebug);
+        Logger::instance().set_handler(handle_message);
+    }
+
+    void teardown() {
+        CHECK(Logger::instance().set_async(AsyncDisabled));
+
+        Logger::instance().set_handler(NULL);
+        Logger::instance().set_level(saved_level);
+    }
+};
+
+TEST(log, sync) {
+    roc_log(LogDebug, "message %d", 1);
+    roc_log(LogTrace, "message %d", 2);
+
+    LONGS_EQUAL(1, num_messages);
+    STRCMP_EQUAL("message 1", messages[0]);
+}
+
+TEST(log, disabled_args) {
+    int counter = 0;
+
+    roc_log(LogTrace, "message %d", evaluate(counter));
+    LONGS_EQUAL(0, counter);
+
+    roc_log(LogDebug, "message %d", evaluate(counter));
+    LONGS_EQUAL(1, counter);
+
+    LONGS_EQUAL(1, num_messages);
+}
+
+TEST(log, async) {
+    enum { NumMessages = 40 };
+
+    CHECK(Logger::instance().set_async(AsyncEnabled));
+
+    for (int n = 0; n < NumMessages; n++) {
+        roc_log(LogDebug, "message %d", n);
+    }
+    roc_log(LogTrace, "skipped message");
+
+    CHECK(Logger::instance().set_async(AsyncDisabled));
+
+    LONGS_EQUAL(NumMessages, num_messages);
+
+    for (int n = 0; n < NumMessages; n++) {
+        char expected[64] = {};
+        snprintf(expected, sizeof(expected), "message %d", n);
+        STRCMP_EQUAL(expected, messages[n]);
+    }
+}
+
+TEST(log, async_rate_limit) {
+    enum { NumMessages = 500 };
+
+    CHECK(Logger::instance().set_async(AsyncEnabled));
+
+    for (int n = 0; n < NumMessages; n++) {
+        roc_log(LogDebug, "repeated message %d", n);
+    }
+
+    CHECK(Logger::instance().set_async(AsyncDisabled));
+
+    // the one-second window may roll over during the loop
+    CHECK(num_messages >= Logger::MaxMessagesPerSecond);
+    CHECK(num_messages <= Logger::MaxMessagesPerSecond * 2 + 1);
+}
+
+TEST(log, async_rate_limit_errors) {
+    enum { NumMessages = 300 };
+
+    CHECK(Logger::instance().set_async(AsyncEnabled));
+
+    for (int n = 0; n < NumMessages; n++) {
+        roc_log(LogError, "error message %d", n);
+    }
+
+    CHECK(Logger::instance().set_async(AsyncDisabled));
+
+    LONGS_EQUAL(NumMessages, num_messages);
+}
+
+TEST(log, async_rate_limit_sites) {
+    enum { NumMessages = 200 };
+
+    CHECK(Logger::instance().set_async(AsyncEnabled));
+
+    for (int n = 0; n < NumMessages; n++) {
+        roc_log(LogDebug, "first site %d", n);
+        roc_log(LogDebug, "second site %d", n);
+    }
+
+    CHECK(Logger::instance().set_async(AsyncDisabled));
+
+    CHECK(count_messages("first site") >= Logger::MaxMessagesPerSecond);
+    CHECK(count_messages("second site") >= Logger::MaxMessagesPerSecond);
+}
+
+TEST(log, async_rate_limit_report) {
+    enum { NumMessages = 100 };
+
+    CHECK(Logger::instance().set_async(AsyncEnabled));
+
+    for (int n = 0; n < NumMessages; n++) {
+        Logger::instance().print("test_module", LogInfo, "info message %d", n);
+    }
+
+    // next message from the same site starts a new window and reports
+    // suppressed messages of the previous one
+    sleep_for(Second);
+    Logger::instance().print("test_module", LogInfo, "info message %d", NumMessages);
+
+    CHECK(Logger::instance().set_async(AsyncDisabled));
+
+    CHECK(count_messages("suppressed ") >= 1);
+
+    for (size_t n = 0; n < num_messages; n++) {
+        if (strncmp(messages[n], "suppressed ", strlen("suppressed ")) == 0) {
+            LONGS_EQUAL(LogInfo, levels[n]);
+            STRCMP_EQUAL("test_module", modules[n]);
+        }
+    }
+}
+
+} // namespace core
+} // namespace roc
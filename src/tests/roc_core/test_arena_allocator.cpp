@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/alignment.h"
+#include "roc_core/arena_allocator.h"
+#include "roc_core/heap_allocator.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+enum { BlockSize = 1024 };
+
+} // namespace
+
+TEST_GROUP(arena_allocator) {};
+
+TEST(arena_allocator, block) {
+    HeapAllocator heap;
+
+    {
+        ArenaAllocator arena(heap, BlockSize);
+        CHECK(arena.valid());
+
+        LONGS_EQUAL(1, heap.num_allocations());
+
+        char* a = (char*)arena.allocate(10);
+        char* b = (char*)arena.allocate(20);
+        CHECK(a);
+        CHECK(b);
+
+        LONGS_EQUAL(1, heap.num_allocations());
+        LONGS_EQUAL(0, arena.num_parent_allocations());
+
+        CHECK(b == a + max_align(10));
+        LONGS_EQUAL(max_align(10) + max_align(20), arena.block_used());
+
+        arena.deallocate(a);
+        arena.deallocate(b);
+
+        LONGS_EQUAL(0, arena.block_used());
+    }
+
+    LONGS_EQUAL(0, heap.num_allocations());
+}
+
+TEST(arena_allocator, overflow) {
+    HeapAllocator heap;
+
+    {
+        ArenaAllocator arena(heap, BlockSize);
+        CHECK(arena.valid());
+
+        void* a = arena.allocate(BlockSize / 2);
+        void* b = arena.allocate(BlockSize);
+        void* c = arena.allocate(BlockSize / 4);
+        CHECK(a);
+        CHECK(b);
+        CHECK(c);
+
+        LONGS_EQUAL(2, heap.num_allocations());
+        LONGS_EQUAL(1, arena.num_parent_allocations());
+        LONGS_EQUAL(BlockSize / 2 + BlockSize / 4, arena.block_used());
+
+        arena.deallocate(b);
+
+        LONGS_EQUAL(1, heap.num_allocations());
+        LONGS_EQUAL(0, arena.num_parent_allocations());
+
+        arena.deallocate(a);
+        arena.deallocate(c);
+    }
+
+    LONGS_EQUAL(0, heap.num_allocations());
+}
+
+TEST(arena_allocator, reuse) {
+    HeapAllocator heap;
+    ArenaAllocator arena(heap, BlockSize);
+
+    void* a = arena.allocate(BlockSize);
+    CHECK(a);
+
+    LONGS_EQUAL(BlockSize, arena.block_used());
+
+    void* b = arena.allocate(1);
+    CHECK(b);
+
+    LONGS_EQUAL(1, arena.num_parent_allocations());
+
+    arena.deallocate(a);
+    arena.deallocate(b);
+
+    LONGS_EQUAL(0, arena.block_used());
+
+    void* c = arena.allocate(BlockSize);
+    CHECK(c == a);
+
+    LONGS_EQUAL(0, arena.num_parent_allocations());
+
+    arena.deallocate(c);
+}
+
+TEST(arena_allocator, no_block) {
+    HeapAllocator heap;
+
+    {
+        ArenaAllocator arena(heap, 0);
+        CHECK(arena.valid());
+
+        LONGS_EQUAL(0, heap.num_allocations());
+
+        void* a = arena.allocate(10);
+        CHECK(a);
+
+        LONGS_EQUAL(1, heap.num_allocations());
+        LONGS_EQUAL(1, arena.num_parent_allocations());
+
+        arena.deallocate(a);
+    }
+
+    LONGS_EQUAL(0, heap.num_allocations());
+}
+
+} // namespace core
+} // namespace roc
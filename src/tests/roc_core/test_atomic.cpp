@@ -30,6 +30,14 @@ TEST(atomic, store_load) {
     CHECK(a == 1);
 }
 
+TEST(atomic, load_relaxed) {
+    Atomic a(5);
+    CHECK(a.load_relaxed() == 5);
+
+    a += 2;
+    CHECK(a.load_relaxed() == 7);
+}
+
 TEST(atomic, inc_dec) {
     Atomic a;
 
@@ -40,5 +48,35 @@ TEST(atomic, inc_dec) {
     CHECK(a == 0);
 }
 
+TEST(atomic, add) {
+    Atomic a;
+
+    CHECK((a += 10) == 10);
+    CHECK(a == 10);
+
+    CHECK((a += -3) == 7);
+    CHECK(a == 7);
+}
+
+TEST(atomic, compare_exchange) {
+    Atomic a(5);
+
+    CHECK(!a.compare_exchange(4, 10));
+    CHECK(a == 5);
+
+    CHECK(a.compare_exchange(5, 10));
+    CHECK(a == 10);
+}
+
+TEST(atomic, exchange) {
+    Atomic a(5);
+
+    CHECK(a.exchange(-7) == 5);
+    CHECK(a == -7);
+
+    CHECK(a.exchange(0) == -7);
+    CHECK(a == 0);
+}
+
 } // namespace core
 } // namespace roc
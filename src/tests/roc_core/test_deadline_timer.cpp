@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/deadline_timer.h"
+
+namespace roc {
+namespace core {
+
+TEST_GROUP(deadline_timer) {};
+
+TEST(deadline_timer, init) {
+    DeadlineTimer timer(0);
+
+    DeadlineTimerStats stats;
+    timer.get_stats(stats);
+
+    UNSIGNED_LONGS_EQUAL(0, stats.num_waits);
+    LONGS_EQUAL(0, stats.mean_jitter);
+    LONGS_EQUAL(0, stats.max_jitter);
+}
+
+TEST(deadline_timer, wait_sleep) {
+    DeadlineTimer timer(0);
+
+    const nanoseconds_t deadline = timestamp() + Millisecond;
+
+    const nanoseconds_t jitter = timer.wait(deadline);
+
+    CHECK(timestamp() >= deadline);
+    CHECK(jitter >= 0);
+}
+
+TEST(deadline_timer, wait_spin) {
+    DeadlineTimer timer(Millisecond);
+
+    const nanoseconds_t deadline = timestamp() + 2 * Millisecond;
+
+    const nanoseconds_t jitter = timer.wait(deadline);
+
+    CHECK(timestamp() >= deadline);
+    CHECK(jitter >= 0);
+}
+
+TEST(deadline_timer, wait_passed) {
+    DeadlineTimer timer(Millisecond);
+
+    const nanoseconds_t deadline = timestamp();
+    sleep_for(Millisecond);
+
+    CHECK(timer.wait(deadline) >= Millisecond);
+}
+
+TEST(deadline_timer, stats) {
+    enum { NumWaits = 10 };
+
+    DeadlineTimer timer(100 * Microsecond);
+
+    const nanoseconds_t start = timestamp();
+
+    nanoseconds_t max_jitter = 0;
+    nanoseconds_t sum_jitter = 0;
+
+    for (int n = 1; n <= NumWaits; n++) {
+        const nanoseconds_t jitter = timer.wait(start + n * 200 * Microsecond);
+
+        sum_jitter += jitter;
+        if (jitter > max_jitter) {
+            max_jitter = jitter;
+        }
+    }
+
+    DeadlineTimerStats stats;
+    timer.get_stats(stats);
+
+    UNSIGNED_LONGS_EQUAL(NumWaits, stats.num_waits);
+    LONGS_EQUAL(sum_jitter / NumWaits, stats.mean_jitter);
+    LONGS_EQUAL(max_jitter, stats.max_jitter);
+}
+
+} // namespace core
+} // namespace roc
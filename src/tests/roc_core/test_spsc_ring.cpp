@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_allocator.h"
+#include "roc_core/spsc_ring.h"
+#include "roc_core/thread.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+enum { Capacity = 10, NumElems = 100000, ChunkSize = 7 };
+
+HeapAllocator allocator;
+
+class Producer : public Thread {
+public:
+    Producer(SpscRing<int>& ring)
+        : ring_(ring) {
+    }
+
+private:
+    virtual void run() {
+        int buf[ChunkSize];
+        int next = 0;
+
+        while (next < NumElems) {
+            size_t n = 0;
+            while (n < ChunkSize && next + (int)n < NumElems) {
+                buf[n] = next + (int)n;
+                n++;
+            }
+            next += (int)ring_.write(buf, n);
+        }
+    }
+
+    SpscRing<int>& ring_;
+};
+
+} // namespace
+
+TEST_GROUP(spsc_ring) {};
+
+TEST(spsc_ring, empty) {
+    SpscRing<int> ring(allocator, Capacity);
+    CHECK(ring.valid());
+
+    LONGS_EQUAL(Capacity, ring.capacity());
+    LONGS_EQUAL(0, ring.size());
+
+    int buf[Capacity];
+    LONGS_EQUAL(0, ring.read(buf, Capacity));
+}
+
+TEST(spsc_ring, write_read) {
+    SpscRing<int> ring(allocator, Capacity);
+    CHECK(ring.valid());
+
+    int in[] = { 1, 2, 3, 4 };
+    LONGS_EQUAL(4, ring.write(in, 4));
+    LONGS_EQUAL(4, ring.size());
+
+    int out[Capacity] = {};
+    LONGS_EQUAL(3, ring.read(out, 3));
+    LONGS_EQUAL(1, ring.size());
+
+    LONGS_EQUAL(1, out[0]);
+    LONGS_EQUAL(2, out[1]);
+    LONGS_EQUAL(3, out[2]);
+
+    LONGS_EQUAL(1, ring.read(out, Capacity));
+    LONGS_EQUAL(4, out[0]);
+
+    LONGS_EQUAL(0, ring.size());
+}
+
+TEST(spsc_ring, full) {
+    SpscRing<int> ring(allocator, Capacity);
+    CHECK(ring.valid());
+
+    int in[Capacity + 5];
+    for (int i = 0; i < Capacity + 5; i++) {
+        in[i] = i;
+    }
+
+    LONGS_EQUAL(Capacity, ring.write(in, Capacity + 5));
+    LONGS_EQUAL(Capacity, ring.size());
+
+    LONGS_EQUAL(0, ring.write(in, 1));
+
+    int out[Capacity];
+    LONGS_EQUAL(2, ring.read(out, 2));
+
+    LONGS_EQUAL(2, ring.write(in, 5));
+    LONGS_EQUAL(Capacity, ring.size());
+}
+
+TEST(spsc_ring, wrap) {
+    SpscRing<int> ring(allocator, Capacity);
+    CHECK(ring.valid());
+
+    int next_in = 0;
+    int next_out = 0;
+
+    for (int iter = 0; iter < 50; iter++) {
+        int in[ChunkSize];
+        for (int i = 0; i < ChunkSize; i++) {
+            in[i] = next_in + i;
+        }
+        LONGS_EQUAL(ChunkSize, ring.write(in, ChunkSize));
+        next_in += ChunkSize;
+
+        int out[ChunkSize];
+        LONGS_EQUAL(ChunkSize, ring.read(out, ChunkSize));
+        for (int i = 0; i < ChunkSize; i++) {
+            LONGS_EQUAL(next_out, out[i]);
+            next_out++;
+        }
+    }
+
+    LONGS_EQUAL(0, ring.size());
+}
+
+TEST(spsc_ring, concurrent) {
+    SpscRing<int> ring(allocator, Capacity);
+    CHECK(ring.valid());
+
+    Producer producer(ring);
+    CHECK(producer.start());
+
+    int next = 0;
+    while (next < NumElems) {
+        int buf[ChunkSize];
+        const size_t n = ring.read(buf, ChunkSize);
+        for (size_t i = 0; i < n; i++) {
+            LONGS_EQUAL(next, buf[i]);
+            next++;
+        }
+    }
+
+    producer.join();
+
+    LONGS_EQUAL(0, ring.size());
+}
+
+} // namespace core
+} // namespace roc
@@ -23,6 +23,13 @@ TEST(time, timestamp) {
     }
 }
 
+TEST(time, timestamp_realtime) {
+    // 2000-01-01 00:00:00 UTC
+    const nanoseconds_t y2k = nanoseconds_t(946684800) * Second;
+
+    CHECK(timestamp_realtime() > y2k);
+}
+
 TEST(time, sleep_until) {
     const nanoseconds_t ts = timestamp();
 
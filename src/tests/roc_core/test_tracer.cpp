@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/thread.h"
+#include "roc_core/tracer.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+const char* StageA = "test.stage_a";
+const char* StageB = "test.stage_b";
+const char* StageC = "test.stage_c";
+
+struct EventCounter {
+    const char* name;
+    size_t count;
+    size_t thread;
+    nanoseconds_t last_begin;
+    bool ordered;
+
+    explicit EventCounter(const char* n)
+        : name(n)
+        , count(0)
+        , thread((size_t)-1)
+        , last_begin(0)
+        , ordered(true) {
+    }
+};
+
+void count_event(void* arg, size_t thread, const TraceEvent& event) {
+    EventCounter& counter = *(EventCounter*)arg;
+
+    if (event.name != counter.name) {
+        return;
+    }
+
+    if (event.begin < counter.last_begin) {
+        counter.ordered = false;
+    }
+
+    counter.count++;
+    counter.thread = thread;
+    counter.last_begin = event.begin;
+}
+
+class TestThread : public Thread {
+private:
+    virtual void run() {
+        TraceScope scope(StageC);
+    }
+};
+
+} // namespace
+
+TEST_GROUP(tracer) {};
+
+TEST(tracer, scope) {
+    EventCounter prev_counter(StageA);
+    Tracer::instance().iterate_events(count_event, &prev_counter);
+
+    const nanoseconds_t before = timestamp();
+    {
+        TraceScope scope(StageA);
+    }
+    const nanoseconds_t after = timestamp();
+
+    EventCounter counter(StageA);
+    Tracer::instance().iterate_events(count_event, &counter);
+
+    LONGS_EQUAL(prev_counter.count + 1, counter.count);
+    CHECK(counter.last_begin >= before);
+    CHECK(counter.last_begin <= after);
+}
+
+TEST(tracer, overwrite) {
+    for (size_t n = 0; n < Tracer::MaxEvents * 2; n++) {
+        Tracer::instance().add_event(StageB, nanoseconds_t(n), nanoseconds_t(n + 1));
+    }
+
+    EventCounter counter(StageB);
+    Tracer::instance().iterate_events(count_event, &counter);
+
+    LONGS_EQUAL(Tracer::MaxEvents, counter.count);
+    CHECK(counter.ordered);
+    CHECK(counter.last_begin == nanoseconds_t(Tracer::MaxEvents * 2 - 1));
+}
+
+TEST(tracer, threads) {
+    {
+        TraceScope scope(StageA);
+    }
+
+    TestThread thread;
+    CHECK(thread.start());
+    thread.join();
+
+    EventCounter counter_a(StageA);
+    Tracer::instance().iterate_events(count_event, &counter_a);
+
+    EventCounter counter_c(StageC);
+    Tracer::instance().iterate_events(count_event, &counter_c);
+
+    LONGS_EQUAL(1, counter_c.count);
+    CHECK(counter_a.thread != counter_c.thread);
+}
+
+} // namespace core
+} // namespace roc
@@ -223,6 +223,92 @@ TEST(encoder_decoder, full_repair_payload_sizes) {
     }
 }
 
+TEST(encoder_decoder, change_block_sizes) {
+    enum { NumIterations = 5, PayloadSize = 251 };
+
+    const size_t block_sizes[][2] = {
+        { 20, 10 }, { 10, 10 }, { 20, 10 }, { 15, 15 }, { 10, 10 }, { 5, 10 }, { 20, 10 }
+    };
+    const size_t n_block_sizes = sizeof(block_sizes) / sizeof(block_sizes[0]);
+
+    for (size_t n_scheme = 0; n_scheme < Test_n_fec_schemes; n_scheme++) {
+        CodecConfig config;
+        config.scheme = Test_fec_schemes[n_scheme];
+
+        Codec code(config);
+
+        for (size_t test_num = 0; test_num < NumIterations; ++test_num) {
+            for (size_t n_size = 0; n_size < n_block_sizes; n_size++) {
+                const size_t n_source = block_sizes[n_size][0];
+                const size_t n_repair = block_sizes[n_size][1];
+
+                code.encode(n_source, n_repair, PayloadSize);
+
+                CHECK(code.decoder().begin(n_source, n_repair, PayloadSize));
+
+                for (size_t i = 0; i < n_source + n_repair; ++i) {
+                    if (i == n_source - 1) {
+                        continue;
+                    }
+                    code.decoder().set(i, code.get_buffer(i));
+                }
+                CHECK(code.decode(n_source, PayloadSize));
+
+                code.decoder().end();
+            }
+        }
+    }
+}
+
+TEST(encoder_decoder, ldpc_less_than_sblen_packets) {
+    enum { NumSourcePackets = 20, NumRepairPackets = 20, PayloadSize = 251 };
+
+    CodecConfig config;
+    config.scheme = packet::FEC_LDPC_Staircase;
+
+    Codec code(config);
+
+    size_t n_repaired = 0;
+
+    // lose two source packets and receive only the first repair packet, so that
+    // the decoder has sblen - 1 packets; the first repair packet is the sum of
+    // a subset of source packets, and if exactly one of the lost packets is in
+    // this subset, it can be repaired iteratively
+    for (size_t lost = 1; lost < NumSourcePackets; lost++) {
+        code.encode(NumSourcePackets, NumRepairPackets, PayloadSize);
+
+        CHECK(code.decoder().begin(NumSourcePackets, NumRepairPackets, PayloadSize));
+
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            if (i == 0 || i == lost) {
+                continue;
+            }
+            code.decoder().set(i, code.get_buffer(i));
+        }
+        code.decoder().set(NumSourcePackets, code.get_buffer(NumSourcePackets));
+
+        const size_t lost_packets[] = { 0, lost };
+
+        for (size_t n = 0; n < ROC_ARRAY_SIZE(lost_packets); n++) {
+            const size_t i = lost_packets[n];
+
+            core::Slice<uint8_t> decoded = code.decoder().repair(i);
+            if (!decoded) {
+                continue;
+            }
+
+            UNSIGNED_LONGS_EQUAL(PayloadSize, decoded.size());
+            CHECK(memcmp(code.get_buffer(i).data(), decoded.data(), PayloadSize) == 0);
+
+            n_repaired++;
+        }
+
+        code.decoder().end();
+    }
+
+    CHECK(n_repaired > 0);
+}
+
 TEST(encoder_decoder, max_source_block) {
     for (size_t n_scheme = 0; n_scheme < Test_n_fec_schemes; ++n_scheme) {
         CodecConfig config;
@@ -251,6 +251,8 @@ TEST(writer_reader, no_losses) {
             check_audio_packet(p, i);
             check_restored(p, false);
         }
+
+        UNSIGNED_LONGS_EQUAL(0, reader.num_restored());
     }
 }
 
@@ -298,6 +300,8 @@ TEST(writer_reader, 1_loss) {
             check_audio_packet(p, i);
             check_restored(p, i == 11);
         }
+
+        UNSIGNED_LONGS_EQUAL(1, reader.num_restored());
     }
 }
 
@@ -1010,6 +1014,164 @@ TEST(writer_reader, multiple_repair_attempts) {
     }
 }
 
+TEST(writer_reader, early_repair_no_losses) {
+    for (size_t n_scheme = 0; n_scheme < Test_n_fec_schemes; n_scheme++) {
+        codec_config.scheme = Test_fec_schemes[n_scheme];
+        reader_config.early_repair = true;
+
+        core::UniquePtr<IBlockEncoder> encoder(
+            codec_map.new_encoder(codec_config, buffer_pool, allocator), allocator);
+        core::UniquePtr<IBlockDecoder> decoder(
+            codec_map.new_decoder(codec_config, buffer_pool, allocator), allocator);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        PacketDispatcher dispatcher(source_parser(), repair_parser(), packet_pool,
+                                    NumSourcePackets, NumRepairPackets);
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                      source_composer(), repair_composer(), packet_pool, buffer_pool,
+                      allocator);
+
+        Reader reader(reader_config, codec_config.scheme, *decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_pool, allocator);
+
+        CHECK(writer.valid());
+        CHECK(reader.valid());
+
+        fill_all_packets(0);
+
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            writer.write(source_packets[i]);
+        }
+        dispatcher.push_stocks();
+
+        packet::PacketPtr repair_packet = dispatcher.repair_head();
+        CHECK(repair_packet);
+
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            packet::PacketPtr p = reader.read();
+            CHECK(p);
+            check_audio_packet(p, i);
+            check_restored(p, false);
+
+            // block is complete, repair packets should be released
+            // before reader reaches the end of the block
+            LONGS_EQUAL(1, repair_packet->getref());
+        }
+    }
+}
+
+TEST(writer_reader, early_repair_1_loss) {
+    for (size_t n_scheme = 0; n_scheme < Test_n_fec_schemes; n_scheme++) {
+        codec_config.scheme = Test_fec_schemes[n_scheme];
+        reader_config.early_repair = true;
+
+        core::UniquePtr<IBlockEncoder> encoder(
+            codec_map.new_encoder(codec_config, buffer_pool, allocator), allocator);
+        core::UniquePtr<IBlockDecoder> decoder(
+            codec_map.new_decoder(codec_config, buffer_pool, allocator), allocator);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        PacketDispatcher dispatcher(source_parser(), repair_parser(), packet_pool,
+                                    NumSourcePackets, NumRepairPackets);
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                      source_composer(), repair_composer(), packet_pool, buffer_pool,
+                      allocator);
+
+        Reader reader(reader_config, codec_config.scheme, *decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_pool, allocator);
+
+        CHECK(writer.valid());
+        CHECK(reader.valid());
+
+        fill_all_packets(0);
+
+        dispatcher.lose(11);
+
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            writer.write(source_packets[i]);
+        }
+        dispatcher.push_stocks();
+
+        packet::PacketPtr repair_packet = dispatcher.repair_head();
+        CHECK(repair_packet);
+
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            packet::PacketPtr p = reader.read();
+            CHECK(p);
+            check_audio_packet(p, i);
+            check_restored(p, i == 11);
+
+            // lost packet should be repaired when the first packet is read,
+            // and repair packets should be released after that
+            LONGS_EQUAL(1, repair_packet->getref());
+        }
+    }
+}
+
+TEST(writer_reader, early_repair_upcoming_blocks) {
+    enum { NumBlocks = 3 };
+
+    for (size_t n_scheme = 0; n_scheme < Test_n_fec_schemes; n_scheme++) {
+        codec_config.scheme = Test_fec_schemes[n_scheme];
+        reader_config.early_repair = true;
+
+        core::UniquePtr<IBlockEncoder> encoder(
+            codec_map.new_encoder(codec_config, buffer_pool, allocator), allocator);
+        core::UniquePtr<IBlockDecoder> decoder(
+            codec_map.new_decoder(codec_config, buffer_pool, allocator), allocator);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        PacketDispatcher dispatcher(source_parser(), repair_parser(), packet_pool,
+                                    NumSourcePackets, NumRepairPackets);
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                      source_composer(), repair_composer(), packet_pool, buffer_pool,
+                      allocator);
+
+        Reader reader(reader_config, codec_config.scheme, *decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_pool, allocator);
+
+        CHECK(writer.valid());
+        CHECK(reader.valid());
+
+        dispatcher.lose(11);
+
+        for (size_t n_block = 0; n_block < NumBlocks; n_block++) {
+            fill_all_packets(n_block * NumSourcePackets);
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                writer.write(source_packets[i]);
+            }
+        }
+        dispatcher.push_stocks();
+
+        for (size_t i = 0; i < NumSourcePackets * NumBlocks; ++i) {
+            packet::PacketPtr p = reader.read();
+            CHECK(p);
+            check_audio_packet(p, i);
+            CHECK(((p->flags() & packet::Packet::FlagRestored) != 0)
+                  == (i % NumSourcePackets == 11));
+
+            // losses in all blocks should be repaired when the first packet
+            // is read, without waiting until reader reaches these blocks
+            UNSIGNED_LONGS_EQUAL(NumBlocks, reader.num_restored());
+        }
+
+        LONGS_EQUAL(0, dispatcher.source_size());
+    }
+}
+
 TEST(writer_reader, drop_outdated_block) {
     for (size_t n_scheme = 0; n_scheme < Test_n_fec_schemes; n_scheme++) {
         codec_config.scheme = Test_fec_schemes[n_scheme];
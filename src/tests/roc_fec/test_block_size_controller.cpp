@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_fec/block_size_controller.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+enum { NumSourcePackets = 20, MinRepairPackets = 2, MaxRepairPackets = 10 };
+
+BlockSizeControllerConfig make_config() {
+    BlockSizeControllerConfig config;
+    config.min_repair_packets = MinRepairPackets;
+    config.max_repair_packets = MaxRepairPackets;
+    config.redundancy = 2.0f;
+    config.decay = 0.5f;
+    return config;
+}
+
+} // namespace
+
+TEST_GROUP(block_size_controller) {};
+
+TEST(block_size_controller, invalid_config) {
+    BlockSizeControllerConfig config = make_config();
+    config.min_repair_packets = MaxRepairPackets + 1;
+
+    BlockSizeController controller(config, NumSourcePackets);
+    CHECK(!controller.valid());
+}
+
+TEST(block_size_controller, initial) {
+    BlockSizeController controller(make_config(), NumSourcePackets);
+    CHECK(controller.valid());
+
+    LONGS_EQUAL(NumSourcePackets, controller.n_source_packets());
+    LONGS_EQUAL(MaxRepairPackets, controller.n_repair_packets());
+}
+
+TEST(block_size_controller, no_losses) {
+    BlockSizeController controller(make_config(), NumSourcePackets);
+    CHECK(controller.valid());
+
+    controller.report_loss(0);
+
+    LONGS_EQUAL(NumSourcePackets, controller.n_source_packets());
+    LONGS_EQUAL(MinRepairPackets, controller.n_repair_packets());
+}
+
+TEST(block_size_controller, losses) {
+    BlockSizeController controller(make_config(), NumSourcePackets);
+    CHECK(controller.valid());
+
+    // 20 * 0.05 * 2 = 2 repair packets above minimum
+    controller.report_loss(0.05f);
+    LONGS_EQUAL(MinRepairPackets + 2, controller.n_repair_packets());
+
+    // 20 * 0.1 * 2 = 4 repair packets above minimum
+    controller.report_loss(0.1f);
+    LONGS_EQUAL(MinRepairPackets + 4, controller.n_repair_packets());
+
+    // 20 * 0.12 * 2 = 4.8, rounded up
+    controller.report_loss(0.12f);
+    LONGS_EQUAL(MinRepairPackets + 5, controller.n_repair_packets());
+}
+
+TEST(block_size_controller, clamp) {
+    BlockSizeController controller(make_config(), NumSourcePackets);
+    CHECK(controller.valid());
+
+    controller.report_loss(0.5f);
+    LONGS_EQUAL(MaxRepairPackets, controller.n_repair_packets());
+
+    controller.report_loss(2.0f);
+    LONGS_EQUAL(MaxRepairPackets, controller.n_repair_packets());
+
+    BlockSizeController controller2(make_config(), NumSourcePackets);
+
+    controller2.report_loss(-1.0f);
+    LONGS_EQUAL(MinRepairPackets, controller2.n_repair_packets());
+}
+
+TEST(block_size_controller, decay) {
+    BlockSizeController controller(make_config(), NumSourcePackets);
+    CHECK(controller.valid());
+
+    // loss = 0.2, 8 repair packets above minimum
+    controller.report_loss(0.2f);
+    LONGS_EQUAL(MaxRepairPackets, controller.n_repair_packets());
+
+    // loss = 0.1, 4 repair packets above minimum
+    controller.report_loss(0.0f);
+    LONGS_EQUAL(MinRepairPackets + 4, controller.n_repair_packets());
+
+    // loss = 0.05, 2 repair packets above minimum
+    controller.report_loss(0.0f);
+    LONGS_EQUAL(MinRepairPackets + 2, controller.n_repair_packets());
+
+    // loss increase is applied immediately
+    controller.report_loss(0.2f);
+    LONGS_EQUAL(MaxRepairPackets, controller.n_repair_packets());
+
+    for (int n = 0; n < 100; n++) {
+        controller.report_loss(0.0f);
+    }
+    LONGS_EQUAL(MinRepairPackets, controller.n_repair_packets());
+}
+
+} // namespace fec
+} // namespace roc
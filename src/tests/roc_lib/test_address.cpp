@@ -52,6 +52,28 @@ TEST(address, detect) {
     LONGS_EQUAL(ROC_AF_IPv6, roc_address_family(&addr));
 }
 
+TEST(address, multicast) {
+    roc_address addr;
+    LONGS_EQUAL(0, roc_address_init(&addr, ROC_AF_IPv4, "239.1.2.3", 123));
+
+    LONGS_EQUAL(0, roc_address_set_multicast_interface(&addr, "1.2.3.4"));
+    LONGS_EQUAL(-1, roc_address_set_multicast_interface(&addr, "2001:db8::1"));
+    LONGS_EQUAL(-1, roc_address_set_multicast_interface(&addr, "bad"));
+    LONGS_EQUAL(-1, roc_address_set_multicast_interface(&addr, NULL));
+    LONGS_EQUAL(-1, roc_address_set_multicast_interface(NULL, "1.2.3.4"));
+
+    LONGS_EQUAL(0, roc_address_set_multicast_ttl(&addr, 16));
+    LONGS_EQUAL(-1, roc_address_set_multicast_ttl(&addr, -1));
+    LONGS_EQUAL(-1, roc_address_set_multicast_ttl(&addr, 256));
+    LONGS_EQUAL(-1, roc_address_set_multicast_ttl(NULL, 16));
+
+    LONGS_EQUAL(0, roc_address_set_multicast_loop(&addr, 1));
+    LONGS_EQUAL(0, roc_address_set_multicast_loop(&addr, 0));
+    LONGS_EQUAL(-1, roc_address_set_multicast_loop(NULL, 1));
+
+    LONGS_EQUAL(123, roc_address_port(&addr));
+}
+
 TEST(address, bad_args) {
     char buf[16];
 
@@ -26,6 +26,15 @@ TEST(context, open_close) {
     LONGS_EQUAL(0, roc_context_close(context));
 }
 
+TEST(context, bad_thread_policy) {
+    roc_context_config config;
+    memset(&config, 0, sizeof(config));
+
+    config.network_thread_policy = (roc_thread_policy)100;
+
+    CHECK(!roc_context_open(&config));
+}
+
 TEST(context, close_null) {
     LONGS_EQUAL(-1, roc_context_close(NULL));
 }
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <string.h>
+
+#include "roc_core/atomic.h"
+#include "roc_core/time.h"
+
+#include "roc/address.h"
+#include "roc/context.h"
+#include "roc/receiver.h"
+
+namespace roc {
+
+namespace {
+
+enum { SampleRate = 44100, NumChans = 2, FrameSamples = 441 * NumChans };
+
+struct CallbackState {
+    core::Atomic num_frames;
+    core::Atomic num_errors;
+};
+
+void count_frames(void* arg, const roc_frame* frame) {
+    CallbackState& state = *(CallbackState*)arg;
+
+    if (!frame || !frame->samples
+        || frame->samples_size != FrameSamples * sizeof(float)) {
+        ++state.num_errors;
+    }
+
+    ++state.num_frames;
+}
+
+} // namespace
+
+TEST_GROUP(receiver) {
+    roc_context* context;
+    roc_receiver_config config;
+
+    void setup() {
+        roc_context_config context_config;
+        memset(&context_config, 0, sizeof(context_config));
+
+        context = roc_context_open(&context_config);
+        CHECK(context);
+
+        memset(&config, 0, sizeof(config));
+        config.frame_sample_rate = SampleRate;
+        config.frame_channels = ROC_CHANNEL_SET_STEREO;
+        config.frame_encoding = ROC_FRAME_ENCODING_PCM_FLOAT;
+    }
+
+    void teardown() {
+        LONGS_EQUAL(0, roc_context_close(context));
+    }
+};
+
+TEST(receiver, start_stop) {
+    roc_receiver* receiver = roc_receiver_open(context, &config);
+    CHECK(receiver);
+
+    CallbackState state;
+
+    LONGS_EQUAL(0, roc_receiver_start(receiver, FrameSamples * sizeof(float),
+                                      count_frames, &state));
+
+    while (state.num_frames < 5) {
+        core::sleep_for(core::Millisecond);
+    }
+
+    roc_receiver_stats stats;
+    LONGS_EQUAL(0, roc_receiver_get_stats(receiver, &stats));
+
+    CHECK(stats.timer_frames >= 5);
+    CHECK(stats.timer_mean_jitter >= 0);
+    CHECK(stats.timer_max_jitter >= stats.timer_mean_jitter);
+
+    LONGS_EQUAL(0, roc_receiver_stop(receiver));
+
+    const long num_frames = state.num_frames;
+    core::sleep_for(20 * core::Millisecond);
+
+    LONGS_EQUAL(num_frames, (long)state.num_frames);
+    LONGS_EQUAL(0, (long)state.num_errors);
+
+    LONGS_EQUAL(0, roc_receiver_get_stats(receiver, &stats));
+    CHECK(stats.timer_frames == 0);
+
+    LONGS_EQUAL(0, roc_receiver_close(receiver));
+}
+
+TEST(receiver, start_twice) {
+    roc_receiver* receiver = roc_receiver_open(context, &config);
+    CHECK(receiver);
+
+    CallbackState state;
+
+    LONGS_EQUAL(0, roc_receiver_start(receiver, FrameSamples * sizeof(float),
+                                      count_frames, &state));
+    LONGS_EQUAL(-1, roc_receiver_start(receiver, FrameSamples * sizeof(float),
+                                       count_frames, &state));
+
+    LONGS_EQUAL(0, roc_receiver_stop(receiver));
+    LONGS_EQUAL(-1, roc_receiver_stop(receiver));
+
+    LONGS_EQUAL(0, roc_receiver_start(receiver, FrameSamples * sizeof(float),
+                                      count_frames, &state));
+
+    LONGS_EQUAL(0, roc_receiver_close(receiver));
+}
+
+TEST(receiver, read_while_started) {
+    roc_receiver* receiver = roc_receiver_open(context, &config);
+    CHECK(receiver);
+
+    CallbackState state;
+
+    LONGS_EQUAL(0, roc_receiver_start(receiver, FrameSamples * sizeof(float),
+                                      count_frames, &state));
+
+    float samples[FrameSamples];
+
+    roc_frame frame;
+    frame.samples = samples;
+    frame.samples_size = sizeof(samples);
+
+    LONGS_EQUAL(-1, roc_receiver_read(receiver, &frame));
+
+    LONGS_EQUAL(0, roc_receiver_stop(receiver));
+
+    LONGS_EQUAL(0, roc_receiver_read(receiver, &frame));
+
+    LONGS_EQUAL(0, roc_receiver_close(receiver));
+}
+
+TEST(receiver, start_bad_args) {
+    roc_receiver* receiver = roc_receiver_open(context, &config);
+    CHECK(receiver);
+
+    CallbackState state;
+
+    LONGS_EQUAL(-1, roc_receiver_start(NULL, FrameSamples * sizeof(float),
+                                       count_frames, &state));
+    LONGS_EQUAL(-1, roc_receiver_start(receiver, FrameSamples * sizeof(float), NULL,
+                                       &state));
+    LONGS_EQUAL(-1, roc_receiver_start(receiver, 0, count_frames, &state));
+    LONGS_EQUAL(-1, roc_receiver_start(receiver, sizeof(float), count_frames, &state));
+
+    LONGS_EQUAL(-1, roc_receiver_stop(NULL));
+    LONGS_EQUAL(-1, roc_receiver_stop(receiver));
+
+    LONGS_EQUAL(0, roc_receiver_close(receiver));
+}
+
+TEST(receiver, start_automatic_timing) {
+    config.automatic_timing = 1;
+
+    roc_receiver* receiver = roc_receiver_open(context, &config);
+    CHECK(receiver);
+
+    CallbackState state;
+
+    LONGS_EQUAL(-1, roc_receiver_start(receiver, FrameSamples * sizeof(float),
+                                       count_frames, &state));
+
+    LONGS_EQUAL(0, roc_receiver_close(receiver));
+}
+
+TEST(receiver, bind_control) {
+    roc_receiver* receiver = roc_receiver_open(context, &config);
+    CHECK(receiver);
+
+    roc_address addr;
+    CHECK(roc_address_init(&addr, ROC_AF_AUTO, "127.0.0.1", 0) == 0);
+
+    LONGS_EQUAL(-1, roc_receiver_bind(receiver, ROC_PORT_CONTROL, ROC_PROTO_RTP, &addr));
+
+    CHECK(roc_address_init(&addr, ROC_AF_AUTO, "127.0.0.1", 0) == 0);
+
+    LONGS_EQUAL(0, roc_receiver_bind(receiver, ROC_PORT_CONTROL, ROC_PROTO_RTCP, &addr));
+
+    CHECK(roc_address_init(&addr, ROC_AF_AUTO, "127.0.0.1", 0) == 0);
+
+    LONGS_EQUAL(-1, roc_receiver_bind(receiver, ROC_PORT_CONTROL, ROC_PROTO_RTCP, &addr));
+
+    LONGS_EQUAL(0, roc_receiver_close(receiver));
+}
+
+} // namespace roc
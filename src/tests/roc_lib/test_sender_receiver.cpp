@@ -18,6 +18,7 @@
 #include "roc_core/random.h"
 #include "roc_core/stddefs.h"
 #include "roc_core/thread.h"
+#include "roc_core/time.h"
 #include "roc_netio/transceiver.h"
 #include "roc_packet/address.h"
 #include "roc_packet/address_to_str.h"
@@ -48,10 +49,12 @@ enum {
     TotalSamples = PacketSamples * SourcePackets * 3,
 
     Latency = TotalSamples / NumChans,
-    Timeout = TotalSamples * 10
+    Timeout = TotalSamples * 10,
+
+    ReportInterval = 1000000 // 1ms
 };
 
-enum { FlagFEC = (1 << 0) };
+enum { FlagFEC = (1 << 0), FlagControl = (1 << 1) };
 
 core::HeapAllocator allocator;
 packet::PacketPool packet_pool(allocator, true);
@@ -115,6 +118,18 @@ public:
         roc_sender_close(sndr_);
     }
 
+    void connect_control(const roc_address* dst_control_addr) {
+        CHECK(roc_sender_connect(sndr_, ROC_PORT_CONTROL, ROC_PROTO_RTCP,
+                                 dst_control_addr)
+              == 0);
+    }
+
+    roc_sender_stats get_stats() {
+        roc_sender_stats stats;
+        CHECK(roc_sender_get_stats(sndr_, &stats) == 0);
+        return stats;
+    }
+
 private:
     virtual void run() {
         for (size_t off = 0; off < total_samples_; off += frame_size_) {
@@ -152,6 +167,7 @@ public:
         , frame_size_(frame_size) {
         CHECK(roc_address_init(&source_addr_, ROC_AF_AUTO, "127.0.0.1", 0) == 0);
         CHECK(roc_address_init(&repair_addr_, ROC_AF_AUTO, "127.0.0.1", 0) == 0);
+        CHECK(roc_address_init(&control_addr_, ROC_AF_AUTO, "127.0.0.1", 0) == 0);
         recv_ = roc_receiver_open(context.get(), &config);
         CHECK(recv_);
         if (flags & FlagFEC) {
@@ -166,12 +182,27 @@ public:
                                     &source_addr_)
                   == 0);
         }
+        if (flags & FlagControl) {
+            CHECK(roc_receiver_bind(recv_, ROC_PORT_CONTROL, ROC_PROTO_RTCP,
+                                    &control_addr_)
+                  == 0);
+        }
     }
 
     ~Receiver() {
         roc_receiver_close(recv_);
     }
 
+    roc_receiver_stats get_stats() {
+        roc_receiver_stats stats;
+        CHECK(roc_receiver_get_stats(recv_, &stats) == 0);
+        return stats;
+    }
+
+    bool get_session_stats(unsigned int index, roc_session_stats& stats) {
+        return roc_receiver_get_session_stats(recv_, index, &stats) == 0;
+    }
+
     const roc_address* source_addr() const {
         return &source_addr_;
     }
@@ -180,6 +211,10 @@ public:
         return &repair_addr_;
     }
 
+    const roc_address* control_addr() const {
+        return &control_addr_;
+    }
+
     void run() {
         float rx_buff[MaxBufSize];
 
@@ -246,6 +281,7 @@ private:
 
     roc_address source_addr_;
     roc_address repair_addr_;
+    roc_address control_addr_;
 
     const float* samples_;
     const size_t total_samples_;
@@ -258,7 +294,7 @@ public:
           const roc_address* dst_repair_addr,
           size_t n_source_packets,
           size_t n_repair_packets)
-        : trx_(packet_pool, byte_buffer_pool, allocator)
+        : trx_(netio::TransceiverConfig(), packet_pool, byte_buffer_pool, allocator)
         , n_source_packets_(n_source_packets)
         , n_repair_packets_(n_repair_packets)
         , pos_(0) {
@@ -403,6 +439,11 @@ TEST_GROUP(sender_receiver) {
         receiver_conf.resampler_profile = ROC_RESAMPLER_DISABLE;
         receiver_conf.target_latency = Latency * 1000000000ul / SampleRate;
         receiver_conf.no_playback_timeout = Timeout * 1000000000ul / SampleRate;
+
+        if (flags & FlagControl) {
+            sender_conf.report_interval = ReportInterval;
+            receiver_conf.report_interval = ReportInterval;
+        }
     }
 };
 
@@ -421,6 +462,51 @@ TEST(sender_receiver, bare_rtp) {
     sender.start();
     receiver.run();
     sender.join();
+
+    const roc_sender_stats send_stats = sender.get_stats();
+    CHECK(send_stats.source_packets > 0);
+    UNSIGNED_LONGS_EQUAL(0, send_stats.repair_packets);
+    UNSIGNED_LONGS_EQUAL(0, send_stats.fec_block_source_packets);
+
+    const roc_receiver_stats recv_stats = receiver.get_stats();
+    CHECK(recv_stats.packets_received > 0);
+    CHECK(recv_stats.packets_received <= send_stats.source_packets);
+    UNSIGNED_LONGS_EQUAL(0, recv_stats.network_errors);
+    UNSIGNED_LONGS_EQUAL(0, recv_stats.packets_recovered);
+
+    roc_session_stats sess_stats;
+    CHECK(!receiver.get_session_stats(recv_stats.num_sessions, sess_stats));
+}
+
+TEST(sender_receiver, control_reports) {
+    enum { Flags = FlagControl };
+
+    init_config(Flags);
+
+    Context context;
+
+    Receiver receiver(context, receiver_conf, samples, TotalSamples, FrameSamples, Flags);
+
+    Sender sender(context, sender_conf, receiver.source_addr(), receiver.repair_addr(),
+                  samples, TotalSamples, FrameSamples, Flags);
+
+    sender.connect_control(receiver.control_addr());
+
+    sender.start();
+    receiver.run();
+    sender.join();
+
+    // receiver reports are sent back to the sender control port; the last
+    // ones may still be on their way
+    roc_sender_stats send_stats = sender.get_stats();
+    while (send_stats.rtt == 0) {
+        core::sleep_for(core::Millisecond);
+        send_stats = sender.get_stats();
+    }
+
+    CHECK(send_stats.control_packets > 0);
+    CHECK(send_stats.rtt < (long long)core::Second);
+    DOUBLES_EQUAL(0, send_stats.fraction_lost, 0);
 }
 
 #ifdef ROC_TARGET_OPENFEC
@@ -459,6 +545,41 @@ TEST(sender_receiver, fec_with_losses) {
     sender.start();
     receiver.run();
     sender.join();
+
+    const roc_sender_stats send_stats = sender.get_stats();
+    CHECK(send_stats.source_packets > 0);
+    CHECK(send_stats.repair_packets > 0);
+    UNSIGNED_LONGS_EQUAL(SourcePackets, send_stats.fec_block_source_packets);
+    UNSIGNED_LONGS_EQUAL(RepairPackets, send_stats.fec_block_repair_packets);
+
+    const roc_receiver_stats recv_stats = receiver.get_stats();
+    CHECK(recv_stats.packets_received > 0);
+    CHECK(recv_stats.packets_recovered > 0);
+}
+
+TEST(sender_receiver, fec_early_repair_with_losses) {
+    enum { Flags = FlagFEC };
+
+    init_config(Flags);
+    receiver_conf.fec_early_repair = 1;
+
+    Context context;
+
+    Receiver receiver(context, receiver_conf, samples, TotalSamples, FrameSamples, Flags);
+
+    Proxy proxy(receiver.source_addr(), receiver.repair_addr(), SourcePackets,
+                RepairPackets);
+
+    Sender sender(context, sender_conf, proxy.source_addr(), proxy.repair_addr(), samples,
+                  TotalSamples, FrameSamples, Flags);
+
+    sender.start();
+    receiver.run();
+    sender.join();
+
+    const roc_receiver_stats recv_stats = receiver.get_stats();
+    CHECK(recv_stats.packets_received > 0);
+    CHECK(recv_stats.packets_recovered > 0);
 }
 #endif // ROC_TARGET_OPENFEC
 
@@ -26,6 +26,8 @@ core::HeapAllocator allocator;
 core::BufferPool<uint8_t> buffer_pool(allocator, MaxBufSize, true);
 packet::PacketPool packet_pool(allocator, true);
 
+TransceiverConfig config;
+
 packet::Address make_address(const char* ip, int port) {
     packet::Address addr;
     CHECK(addr.set_ipv4(ip, port));
@@ -37,7 +39,7 @@ packet::Address make_address(const char* ip, int port) {
 TEST_GROUP(transceiver) {};
 
 TEST(transceiver, init) {
-    Transceiver trx(packet_pool, buffer_pool, allocator);
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
 
     CHECK(trx.valid());
 }
@@ -45,7 +47,7 @@ TEST(transceiver, init) {
 TEST(transceiver, bind_any) {
     packet::ConcurrentQueue queue;
 
-    Transceiver trx(packet_pool, buffer_pool, allocator);
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
 
     CHECK(trx.valid());
 
@@ -62,7 +64,7 @@ TEST(transceiver, bind_any) {
 TEST(transceiver, bind_lo) {
     packet::ConcurrentQueue queue;
 
-    Transceiver trx(packet_pool, buffer_pool, allocator);
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
 
     CHECK(trx.valid());
 
@@ -79,7 +81,7 @@ TEST(transceiver, bind_lo) {
 TEST(transceiver, bind_addrinuse) {
     packet::ConcurrentQueue queue;
 
-    Transceiver trx1(packet_pool, buffer_pool, allocator);
+    Transceiver trx1(config, packet_pool, buffer_pool, allocator);
     CHECK(trx1.valid());
 
     packet::Address tx_addr = make_address("127.0.0.1", 0);
@@ -88,7 +90,7 @@ TEST(transceiver, bind_addrinuse) {
     CHECK(trx1.add_udp_sender(tx_addr));
     CHECK(trx1.add_udp_receiver(rx_addr, queue));
 
-    Transceiver trx2(packet_pool, buffer_pool, allocator);
+    Transceiver trx2(config, packet_pool, buffer_pool, allocator);
     CHECK(trx2.valid());
 
     CHECK(!trx2.add_udp_sender(tx_addr));
@@ -98,7 +100,7 @@ TEST(transceiver, bind_addrinuse) {
 TEST(transceiver, add) {
     packet::ConcurrentQueue queue;
 
-    Transceiver trx(packet_pool, buffer_pool, allocator);
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
 
     CHECK(trx.valid());
 
@@ -112,7 +114,7 @@ TEST(transceiver, add) {
 TEST(transceiver, add_remove) {
     packet::ConcurrentQueue queue;
 
-    Transceiver trx(packet_pool, buffer_pool, allocator);
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
 
     CHECK(trx.valid());
 
@@ -135,7 +137,7 @@ TEST(transceiver, add_remove) {
 }
 
 TEST(transceiver, add_remove_add) {
-    Transceiver trx(packet_pool, buffer_pool, allocator);
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
 
     CHECK(trx.valid());
 
@@ -149,7 +151,7 @@ TEST(transceiver, add_remove_add) {
 TEST(transceiver, add_duplicate) {
     packet::ConcurrentQueue queue;
 
-    Transceiver trx(packet_pool, buffer_pool, allocator);
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
 
     CHECK(trx.valid());
 
@@ -181,5 +183,39 @@ TEST(transceiver, add_duplicate) {
     UNSIGNED_LONGS_EQUAL(0, trx.num_ports());
 }
 
+TEST(transceiver, multiple_loops) {
+    enum { NumLoops = 4, NumPorts = 10 };
+
+    TransceiverConfig mt_config;
+    mt_config.num_loops = NumLoops;
+
+    packet::ConcurrentQueue queue;
+
+    Transceiver trx(mt_config, packet_pool, buffer_pool, allocator);
+
+    CHECK(trx.valid());
+    UNSIGNED_LONGS_EQUAL(NumLoops, trx.num_loops());
+
+    packet::Address tx_addrs[NumPorts];
+    packet::Address rx_addrs[NumPorts];
+
+    for (size_t n = 0; n < NumPorts; n++) {
+        tx_addrs[n] = make_address("0.0.0.0", 0);
+        rx_addrs[n] = make_address("0.0.0.0", 0);
+
+        CHECK(trx.add_udp_sender(tx_addrs[n]));
+        CHECK(trx.add_udp_receiver(rx_addrs[n], queue));
+
+        UNSIGNED_LONGS_EQUAL((n + 1) * 2, trx.num_ports());
+    }
+
+    for (size_t n = 0; n < NumPorts; n++) {
+        trx.remove_port(tx_addrs[n]);
+        trx.remove_port(rx_addrs[n]);
+
+        UNSIGNED_LONGS_EQUAL((NumPorts - n - 1) * 2, trx.num_ports());
+    }
+}
+
 } // namespace netio
 } // namespace roc
@@ -8,8 +8,11 @@
 
 #include <CppUTest/TestHarness.h>
 
+#include <sys/socket.h>
+
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
+#include "roc_core/time.h"
 #include "roc_netio/transceiver.h"
 #include "roc_packet/address.h"
 #include "roc_packet/concurrent_queue.h"
@@ -26,6 +29,8 @@ core::HeapAllocator allocator;
 core::BufferPool<uint8_t> buffer_pool(allocator, BufferSize, true);
 packet::PacketPool packet_pool(allocator, true);
 
+TransceiverConfig config;
+
 } // namespace
 
 TEST_GROUP(udp) {
@@ -85,7 +90,7 @@ TEST(udp, one_sender_one_receiver_single_thread) {
     packet::Address tx_addr = new_address();
     packet::Address rx_addr = new_address();
 
-    Transceiver trx(packet_pool, buffer_pool, allocator);
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
     CHECK(trx.valid());
 
     packet::IWriter* tx_sender = trx.add_udp_sender(tx_addr);
@@ -103,19 +108,137 @@ TEST(udp, one_sender_one_receiver_single_thread) {
     }
 }
 
+TEST(udp, socket_buffer_sizes) {
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address tx_addr = new_address();
+    packet::Address rx_addr = new_address();
+
+    TransceiverConfig buf_config;
+    buf_config.recv_buffer_size = 256 * 1024;
+    buf_config.send_buffer_size = 256 * 1024;
+
+    Transceiver trx(buf_config, packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_udp_sender(tx_addr);
+    CHECK(tx_sender);
+
+    CHECK(trx.add_udp_receiver(rx_addr, rx_queue));
+
+    for (int p = 0; p < NumPackets; p++) {
+        tx_sender->write(new_packet(tx_addr, rx_addr, p));
+    }
+    for (int p = 0; p < NumPackets; p++) {
+        check_packet(rx_queue.read(), tx_addr, rx_addr, p);
+    }
+}
+
+TEST(udp, port_stats) {
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address tx_addr = new_address();
+    packet::Address rx_addr = new_address();
+
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_udp_sender(tx_addr);
+    CHECK(tx_sender);
+
+    CHECK(trx.add_udp_receiver(rx_addr, rx_queue));
+
+    PortStats stats;
+
+    CHECK(trx.get_port_stats(rx_addr, stats));
+    UNSIGNED_LONGS_EQUAL(0, stats.packets);
+    UNSIGNED_LONGS_EQUAL(0, stats.bytes);
+    UNSIGNED_LONGS_EQUAL(0, stats.errors);
+
+    for (int p = 0; p < NumPackets; p++) {
+        tx_sender->write(new_packet(tx_addr, rx_addr, p));
+    }
+    for (int p = 0; p < NumPackets; p++) {
+        check_packet(rx_queue.read(), tx_addr, rx_addr, p);
+    }
+
+    CHECK(trx.get_port_stats(rx_addr, stats));
+    UNSIGNED_LONGS_EQUAL(NumPackets, stats.packets);
+    UNSIGNED_LONGS_EQUAL(NumPackets * BufferSize, stats.bytes);
+    UNSIGNED_LONGS_EQUAL(0, stats.errors);
+
+    // send completion may be reported after the packets are received
+    for (;;) {
+        CHECK(trx.get_port_stats(tx_addr, stats));
+        if (stats.packets == NumPackets) {
+            break;
+        }
+        core::sleep_for(core::Millisecond);
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumPackets * BufferSize, stats.bytes);
+    UNSIGNED_LONGS_EQUAL(0, stats.errors);
+
+    packet::Address unknown_addr = new_address();
+    CHECK(!trx.get_port_stats(unknown_addr, stats));
+}
+
+TEST(udp, sender_port_receiving) {
+    packet::ConcurrentQueue rx_queue;
+    packet::ConcurrentQueue tx_queue;
+
+    packet::Address tx_addr = new_address();
+    packet::Address rx_addr = new_address();
+    packet::Address peer_addr = new_address();
+
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_udp_sender(tx_addr);
+    CHECK(tx_sender);
+
+    CHECK(trx.add_udp_receiver(rx_addr, rx_queue));
+
+    packet::IWriter* peer_sender = trx.add_udp_sender(peer_addr);
+    CHECK(peer_sender);
+
+    CHECK(trx.start_receiving(tx_addr, tx_queue));
+    CHECK(!trx.start_receiving(tx_addr, tx_queue));
+
+    CHECK(!trx.start_receiving(rx_addr, tx_queue));
+
+    packet::Address unknown_addr = new_address();
+    CHECK(!trx.start_receiving(unknown_addr, tx_queue));
+
+    for (int i = 0; i < NumIterations; i++) {
+        for (int p = 0; p < NumPackets; p++) {
+            tx_sender->write(new_packet(tx_addr, rx_addr, p));
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            check_packet(rx_queue.read(), tx_addr, rx_addr, p);
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            peer_sender->write(new_packet(peer_addr, tx_addr, p * 10));
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            check_packet(tx_queue.read(), peer_addr, tx_addr, p * 10);
+        }
+    }
+}
+
 TEST(udp, one_sender_one_receiver_separate_threads) {
     packet::ConcurrentQueue rx_queue;
 
     packet::Address tx_addr = new_address();
     packet::Address rx_addr = new_address();
 
-    Transceiver tx(packet_pool, buffer_pool, allocator);
+    Transceiver tx(config, packet_pool, buffer_pool, allocator);
     CHECK(tx.valid());
 
     packet::IWriter* tx_sender = tx.add_udp_sender(tx_addr);
     CHECK(tx_sender);
 
-    Transceiver rx(packet_pool, buffer_pool, allocator);
+    Transceiver rx(config, packet_pool, buffer_pool, allocator);
     CHECK(rx.valid());
 
     CHECK(rx.add_udp_receiver(rx_addr, rx_queue));
@@ -141,17 +264,17 @@ TEST(udp, one_sender_multiple_receivers) {
     packet::Address rx_addr2 = new_address();
     packet::Address rx_addr3 = new_address();
 
-    Transceiver tx(packet_pool, buffer_pool, allocator);
+    Transceiver tx(config, packet_pool, buffer_pool, allocator);
     CHECK(tx.valid());
 
     packet::IWriter* tx_sender = tx.add_udp_sender(tx_addr);
     CHECK(tx_sender);
 
-    Transceiver rx1(packet_pool, buffer_pool, allocator);
+    Transceiver rx1(config, packet_pool, buffer_pool, allocator);
     CHECK(rx1.valid());
     CHECK(rx1.add_udp_receiver(rx_addr1, rx_queue1));
 
-    Transceiver rx23(packet_pool, buffer_pool, allocator);
+    Transceiver rx23(config, packet_pool, buffer_pool, allocator);
     CHECK(rx23.valid());
     CHECK(rx23.add_udp_receiver(rx_addr2, rx_queue2));
     CHECK(rx23.add_udp_receiver(rx_addr3, rx_queue3));
@@ -179,13 +302,13 @@ TEST(udp, multiple_senders_one_receiver) {
 
     packet::Address rx_addr = new_address();
 
-    Transceiver tx1(packet_pool, buffer_pool, allocator);
+    Transceiver tx1(config, packet_pool, buffer_pool, allocator);
     CHECK(tx1.valid());
 
     packet::IWriter* tx_sender1 = tx1.add_udp_sender(tx_addr1);
     CHECK(tx_sender1);
 
-    Transceiver tx23(packet_pool, buffer_pool, allocator);
+    Transceiver tx23(config, packet_pool, buffer_pool, allocator);
     CHECK(tx23.valid());
 
     packet::IWriter* tx_sender2 = tx23.add_udp_sender(tx_addr2);
@@ -194,7 +317,7 @@ TEST(udp, multiple_senders_one_receiver) {
     packet::IWriter* tx_sender3 = tx23.add_udp_sender(tx_addr3);
     CHECK(tx_sender3);
 
-    Transceiver rx(packet_pool, buffer_pool, allocator);
+    Transceiver rx(config, packet_pool, buffer_pool, allocator);
     CHECK(rx.valid());
     CHECK(rx.add_udp_receiver(rx_addr, rx_queue));
 
@@ -220,5 +343,114 @@ TEST(udp, multiple_senders_one_receiver) {
     }
 }
 
+TEST(udp, multiple_loops) {
+    enum { NumLoops = 3, NumPorts = 6 };
+
+    TransceiverConfig mt_config;
+    mt_config.num_loops = NumLoops;
+
+    packet::ConcurrentQueue rx_queues[NumPorts];
+
+    packet::Address tx_addrs[NumPorts];
+    packet::Address rx_addrs[NumPorts];
+    packet::IWriter* tx_senders[NumPorts];
+
+    Transceiver trx(mt_config, packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    for (size_t n = 0; n < NumPorts; n++) {
+        tx_addrs[n] = new_address();
+        rx_addrs[n] = new_address();
+
+        tx_senders[n] = trx.add_udp_sender(tx_addrs[n]);
+        CHECK(tx_senders[n]);
+
+        CHECK(trx.add_udp_receiver(rx_addrs[n], rx_queues[n]));
+    }
+
+    for (int i = 0; i < NumIterations; i++) {
+        for (int p = 0; p < NumPackets; p++) {
+            for (size_t n = 0; n < NumPorts; n++) {
+                tx_senders[n]->write(
+                    new_packet(tx_addrs[n], rx_addrs[n], p * int(n + 1)));
+            }
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            for (size_t n = 0; n < NumPorts; n++) {
+                check_packet(rx_queues[n].read(), tx_addrs[n], rx_addrs[n],
+                             p * int(n + 1));
+            }
+        }
+    }
+}
+
+#ifdef SO_REUSEPORT
+TEST(udp, reuse_port) {
+    enum { NumLoops = 4, NumSenders = 8 };
+
+    TransceiverConfig mt_config;
+    mt_config.num_loops = NumLoops;
+    mt_config.reuse_port = true;
+
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address rx_addr = new_address();
+
+    Transceiver rx(mt_config, packet_pool, buffer_pool, allocator);
+    CHECK(rx.valid());
+
+    // bound in every loop, but counted as a single port
+    CHECK(rx.add_udp_receiver(rx_addr, rx_queue));
+    UNSIGNED_LONGS_EQUAL(1, rx.num_ports());
+
+    Transceiver tx(config, packet_pool, buffer_pool, allocator);
+    CHECK(tx.valid());
+
+    packet::Address tx_addrs[NumSenders];
+    packet::IWriter* tx_senders[NumSenders];
+
+    for (size_t n = 0; n < NumSenders; n++) {
+        tx_addrs[n] = new_address();
+        tx_senders[n] = tx.add_udp_sender(tx_addrs[n]);
+        CHECK(tx_senders[n]);
+    }
+
+    for (int p = 0; p < NumPackets; p++) {
+        for (size_t n = 0; n < NumSenders; n++) {
+            tx_senders[n]->write(new_packet(tx_addrs[n], rx_addr, p));
+        }
+    }
+
+    // flows may be spread across loops, so only per-sender order is preserved
+    int next_value[NumSenders] = {};
+
+    for (int p = 0; p < NumPackets * NumSenders; p++) {
+        packet::PacketPtr pp = rx_queue.read();
+        CHECK(pp);
+        CHECK(pp->udp());
+
+        size_t n = 0;
+        for (; n < NumSenders; n++) {
+            if (pp->udp()->src_addr == tx_addrs[n]) {
+                break;
+            }
+        }
+        CHECK(n < NumSenders);
+
+        check_packet(pp, tx_addrs[n], rx_addr, next_value[n]++);
+    }
+
+    PortStats stats;
+
+    CHECK(rx.get_port_stats(rx_addr, stats));
+    UNSIGNED_LONGS_EQUAL(NumPackets * NumSenders, stats.packets);
+    UNSIGNED_LONGS_EQUAL(NumPackets * NumSenders * BufferSize, stats.bytes);
+    UNSIGNED_LONGS_EQUAL(0, stats.errors);
+
+    rx.remove_port(rx_addr);
+    UNSIGNED_LONGS_EQUAL(0, rx.num_ports());
+}
+#endif // SO_REUSEPORT
+
 } // namespace netio
 } // namespace roc
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <stdio.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/temp_file.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/pcap_reader.h"
+#include "roc_packet/pcap_writer.h"
+#include "roc_packet/queue.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { BufferSize = 200, NumPackets = 5 };
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, BufferSize, true);
+PacketPool packet_pool(allocator, true);
+
+PacketPtr new_packet(const Address& src,
+                     const Address& dst,
+                     core::nanoseconds_t ts,
+                     size_t size,
+                     uint8_t value) {
+    PacketPtr pp = new (packet_pool) Packet(packet_pool);
+    CHECK(pp);
+
+    core::Slice<uint8_t> data = pp->alloc_buffer(buffer_pool);
+    CHECK(data);
+    data = data.range(0, size);
+
+    for (size_t n = 0; n < size; n++) {
+        data.data()[n] = uint8_t(value + n);
+    }
+
+    pp->add_flags(Packet::FlagUDP);
+    pp->udp()->src_addr = src;
+    pp->udp()->dst_addr = dst;
+    pp->udp()->receive_timestamp = ts;
+    pp->set_data(data);
+
+    return pp;
+}
+
+void check_packet(const PacketPtr& pp,
+                  const Address& src,
+                  const Address& dst,
+                  core::nanoseconds_t ts,
+                  size_t size,
+                  uint8_t value) {
+    CHECK(pp);
+    CHECK(pp->udp());
+
+    CHECK(pp->udp()->src_addr == src);
+    CHECK(pp->udp()->dst_addr == dst);
+    CHECK(pp->udp()->receive_timestamp == ts);
+
+    UNSIGNED_LONGS_EQUAL(size, pp->data().size());
+    for (size_t n = 0; n < size; n++) {
+        UNSIGNED_LONGS_EQUAL(uint8_t(value + n), pp->data().data()[n]);
+    }
+}
+
+core::nanoseconds_t nth_ts(size_t n) {
+    return 1234 * core::Second + core::nanoseconds_t(n) * 5 * core::Millisecond + 7;
+}
+
+size_t nth_size(size_t n) {
+    return (n * 37) % BufferSize;
+}
+
+void roundtrip(const Address& src, const Address& dst) {
+    core::TempFile file("test.pcap");
+
+    Queue queue;
+
+    {
+        PcapWriter writer(queue);
+        CHECK(writer.open(file.path()));
+
+        for (size_t n = 0; n < NumPackets; n++) {
+            writer.write(new_packet(src, dst, nth_ts(n), nth_size(n), uint8_t(n)));
+        }
+
+        UNSIGNED_LONGS_EQUAL(NumPackets, writer.num_packets());
+        UNSIGNED_LONGS_EQUAL(NumPackets, queue.size());
+    }
+
+    PcapReader reader(packet_pool, buffer_pool);
+    CHECK(reader.open(file.path()));
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        check_packet(reader.read(), src, dst, nth_ts(n), nth_size(n), uint8_t(n));
+    }
+
+    CHECK(!reader.read());
+}
+
+void write_file(const char* path, const uint8_t* data, size_t size) {
+    FILE* fp = fopen(path, "wb");
+    CHECK(fp);
+    UNSIGNED_LONGS_EQUAL(size, fwrite(data, 1, size, fp));
+    CHECK(fclose(fp) == 0);
+}
+
+} // namespace
+
+TEST_GROUP(pcap) {};
+
+TEST(pcap, roundtrip_ipv4) {
+    Address src;
+    CHECK(src.set_ipv4("10.0.0.1", 12345));
+
+    Address dst;
+    CHECK(dst.set_ipv4("192.168.1.2", 10001));
+
+    roundtrip(src, dst);
+}
+
+TEST(pcap, roundtrip_ipv6) {
+    Address src;
+    CHECK(src.set_ipv6("2001:db8::1", 12345));
+
+    Address dst;
+    CHECK(dst.set_ipv6("::1", 10001));
+
+    roundtrip(src, dst);
+}
+
+TEST(pcap, skip_non_udp) {
+    core::TempFile file("test.pcap");
+
+    Address addr;
+    CHECK(addr.set_ipv4("127.0.0.1", 10001));
+
+    Queue queue;
+
+    {
+        PcapWriter writer(queue);
+        CHECK(writer.open(file.path()));
+
+        PacketPtr pp = new (packet_pool) Packet(packet_pool);
+        CHECK(pp);
+        writer.write(pp);
+
+        writer.write(new_packet(addr, addr, nth_ts(0), nth_size(1), 1));
+
+        UNSIGNED_LONGS_EQUAL(1, writer.num_packets());
+        UNSIGNED_LONGS_EQUAL(2, queue.size());
+    }
+
+    PcapReader reader(packet_pool, buffer_pool);
+    CHECK(reader.open(file.path()));
+
+    check_packet(reader.read(), addr, addr, nth_ts(0), nth_size(1), 1);
+    CHECK(!reader.read());
+}
+
+TEST(pcap, ethernet_microsec_big_endian) {
+    const uint8_t data[] = {
+        // file header: big-endian, microseconds, ethernet
+        0xa1, 0xb2, 0xc3, 0xd4, 0x00, 0x02, 0x00, 0x04, //
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+        0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0x00, 0x01, //
+
+        // record 1: ARP, skipped
+        0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02, //
+        0x00, 0x00, 0x00, 0x0e, 0x00, 0x00, 0x00, 0x0e, //
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x11, //
+        0x22, 0x33, 0x44, 0x55, 0x08, 0x06, //
+
+        // record 2: VLAN, IPv4, UDP with 3 bytes of payload
+        0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x03, //
+        0x00, 0x00, 0x00, 0x31, 0x00, 0x00, 0x00, 0x31, //
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x00, 0x11, //
+        0x22, 0x33, 0x44, 0x66, 0x81, 0x00, 0x00, 0x05, //
+        0x08, 0x00,                                     //
+        0x45, 0x00, 0x00, 0x1f, 0x00, 0x00, 0x40, 0x00, //
+        0x40, 0x11, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x01, //
+        0x0a, 0x00, 0x00, 0x02,                         //
+        0x30, 0x39, 0x27, 0x11, 0x00, 0x0b, 0x00, 0x00, //
+        0x01, 0x02, 0x03,
+    };
+
+    core::TempFile file("test.pcap");
+    write_file(file.path(), data, sizeof(data));
+
+    PcapReader reader(packet_pool, buffer_pool);
+    CHECK(reader.open(file.path()));
+
+    Address src;
+    CHECK(src.set_ipv4("10.0.0.1", 12345));
+
+    Address dst;
+    CHECK(dst.set_ipv4("10.0.0.2", 10001));
+
+    check_packet(reader.read(), src, dst, 2 * core::Second + 3 * core::Microsecond, 3,
+                 1);
+    CHECK(!reader.read());
+}
+
+TEST(pcap, bad_magic) {
+    const uint8_t data[24] = { 0x12, 0x34, 0x56, 0x78 };
+
+    core::TempFile file("test.pcap");
+    write_file(file.path(), data, sizeof(data));
+
+    PcapReader reader(packet_pool, buffer_pool);
+    CHECK(!reader.open(file.path()));
+}
+
+} // namespace packet
+} // namespace roc
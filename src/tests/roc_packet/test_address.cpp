@@ -194,5 +194,72 @@ TEST(address, multicast_ipv6) {
     }
 }
 
+TEST(address, miface) {
+    {
+        Address addr;
+        CHECK(!addr.set_miface("1.2.3.4"));
+        CHECK(!addr.has_miface());
+    }
+
+    {
+        Address addr;
+        CHECK(addr.set_ipv4("239.1.2.3", 123));
+        CHECK(!addr.has_miface());
+
+        CHECK(!addr.set_miface("2001:db8::1"));
+        CHECK(!addr.has_miface());
+
+        CHECK(addr.set_miface("1.2.3.4"));
+        CHECK(addr.has_miface());
+
+        char buf[64];
+        CHECK(addr.get_miface(buf, sizeof(buf)));
+        STRCMP_EQUAL("1.2.3.4", buf);
+    }
+
+    {
+        Address addr;
+        CHECK(addr.set_ipv6("ff02::1", 123));
+
+        CHECK(!addr.set_miface("1.2.3.4"));
+        CHECK(addr.set_miface("2001:db8::1"));
+
+        char buf[64];
+        CHECK(addr.get_miface(buf, sizeof(buf)));
+        STRCMP_EQUAL("2001:db8::1", buf);
+    }
+}
+
+TEST(address, multicast_options) {
+    Address addr;
+    CHECK(addr.set_ipv4("239.1.2.3", 123));
+
+    LONGS_EQUAL(-1, addr.multicast_ttl());
+    LONGS_EQUAL(-1, addr.multicast_loop());
+
+    CHECK(addr.set_multicast_ttl(0));
+    LONGS_EQUAL(0, addr.multicast_ttl());
+
+    CHECK(addr.set_multicast_ttl(255));
+    LONGS_EQUAL(255, addr.multicast_ttl());
+
+    CHECK(!addr.set_multicast_ttl(-1));
+    CHECK(!addr.set_multicast_ttl(256));
+    LONGS_EQUAL(255, addr.multicast_ttl());
+
+    addr.set_multicast_loop(false);
+    LONGS_EQUAL(0, addr.multicast_loop());
+
+    addr.set_multicast_loop(true);
+    LONGS_EQUAL(1, addr.multicast_loop());
+
+    Address other;
+    CHECK(other.set_ipv4("239.1.2.3", 123));
+
+    // options don't affect comparison
+    CHECK(addr.set_miface("1.2.3.4"));
+    CHECK(addr == other);
+}
+
 } // namespace packet
 } // namespace roc
@@ -0,0 +1,364 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/impairer.h"
+#include "roc_packet/packet_pool.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { BufferSize = 100, MaxPackets = 2000 };
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, BufferSize, true);
+PacketPool packet_pool(allocator, true);
+
+class MockWriter : public IWriter {
+public:
+    MockWriter()
+        : n_packets_(0)
+        , now_(0) {
+    }
+
+    virtual void write(const PacketPtr& packet) {
+        CHECK(n_packets_ < MaxPackets);
+        packets_[n_packets_] = packet;
+        times_[n_packets_] = now_;
+        n_packets_++;
+    }
+
+    void set_time(core::nanoseconds_t now) {
+        now_ = now;
+    }
+
+    size_t num_packets() const {
+        return n_packets_;
+    }
+
+    const PacketPtr& packet(size_t n) const {
+        CHECK(n < n_packets_);
+        return packets_[n];
+    }
+
+    core::nanoseconds_t time(size_t n) const {
+        CHECK(n < n_packets_);
+        return times_[n];
+    }
+
+private:
+    PacketPtr packets_[MaxPackets];
+    core::nanoseconds_t times_[MaxPackets];
+    size_t n_packets_;
+    core::nanoseconds_t now_;
+};
+
+class CountingWriter : public IWriter {
+public:
+    CountingWriter()
+        : n_packets_(0) {
+    }
+
+    virtual void write(const PacketPtr&) {
+        n_packets_++;
+    }
+
+    size_t num_packets() const {
+        return n_packets_;
+    }
+
+private:
+    size_t n_packets_;
+};
+
+PacketPtr new_packet(size_t size) {
+    PacketPtr pp = new (packet_pool) Packet(packet_pool);
+    CHECK(pp);
+
+    core::Slice<uint8_t> data = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+    CHECK(data);
+
+    pp->add_flags(Packet::FlagUDP);
+    pp->set_data(data.range(0, size));
+
+    return pp;
+}
+
+// Writes packets and reports which of them were lost.
+void loss_pattern(const ImpairerConfig& config, bool* lost, size_t n_packets) {
+    CountingWriter writer;
+    Impairer impairer(writer, packet_pool, config, allocator);
+    CHECK(impairer.valid());
+
+    for (size_t n = 0; n < n_packets; n++) {
+        const size_t n_delivered = writer.num_packets();
+        impairer.write(new_packet(10));
+        lost[n] = (writer.num_packets() == n_delivered);
+    }
+}
+
+} // namespace
+
+TEST_GROUP(impairer) {};
+
+TEST(impairer, passthrough) {
+    MockWriter writer;
+    ImpairerConfig config;
+
+    Impairer impairer(writer, packet_pool, config, allocator);
+    CHECK(impairer.valid());
+
+    PacketPtr packets[10];
+
+    for (size_t n = 0; n < 10; n++) {
+        packets[n] = new_packet(10);
+        impairer.write(packets[n]);
+
+        UNSIGNED_LONGS_EQUAL(n + 1, writer.num_packets());
+        CHECK(writer.packet(n) == packets[n]);
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, impairer.num_pending());
+    UNSIGNED_LONGS_EQUAL(10, impairer.stats().n_written);
+    UNSIGNED_LONGS_EQUAL(10, impairer.stats().n_delivered);
+    UNSIGNED_LONGS_EQUAL(0, impairer.stats().n_lost);
+}
+
+TEST(impairer, invalid_config) {
+    MockWriter writer;
+    ImpairerConfig config;
+
+    config.loss = 1.5f;
+
+    Impairer impairer(writer, packet_pool, config, allocator);
+    CHECK(!impairer.valid());
+}
+
+TEST(impairer, bernoulli) {
+    enum { NumPackets = 20000 };
+
+    ImpairerConfig config;
+    config.loss = 0.1f;
+    config.seed = 123;
+
+    bool lost1[NumPackets];
+    loss_pattern(config, lost1, NumPackets);
+
+    size_t n_lost = 0;
+    for (size_t n = 0; n < NumPackets; n++) {
+        n_lost += lost1[n];
+    }
+
+    CHECK(n_lost > NumPackets / 10 * 9 / 10);
+    CHECK(n_lost < NumPackets / 10 * 11 / 10);
+
+    bool lost2[NumPackets];
+    loss_pattern(config, lost2, NumPackets);
+
+    CHECK(memcmp(lost1, lost2, sizeof(lost1)) == 0);
+
+    config.seed = 456;
+    loss_pattern(config, lost2, NumPackets);
+
+    CHECK(memcmp(lost1, lost2, sizeof(lost1)) != 0);
+}
+
+TEST(impairer, gilbert_elliott) {
+    enum { NumPackets = 100000 };
+
+    ImpairerConfig config;
+    config.burst_start = 0.01f;
+    config.burst_end = 0.2f;
+    config.burst_loss = 1;
+    config.seed = 1;
+
+    bool* lost = new bool[NumPackets];
+    loss_pattern(config, lost, NumPackets);
+
+    size_t n_lost = 0;
+    size_t n_bursts = 0;
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        if (lost[n]) {
+            n_lost++;
+            if (n == 0 || !lost[n - 1]) {
+                n_bursts++;
+            }
+        }
+    }
+
+    delete[] lost;
+
+    // stationary loss rate is burst_start / (burst_start + burst_end)
+    const double loss_rate = double(n_lost) / NumPackets;
+    DOUBLES_EQUAL(0.01 / 0.21, loss_rate, 0.01);
+
+    // average burst length is 1 / burst_end
+    const double burst_len = double(n_lost) / n_bursts;
+    DOUBLES_EQUAL(5, burst_len, 1);
+}
+
+TEST(impairer, duplication) {
+    enum { NumPackets = 1000 };
+
+    MockWriter writer;
+    ImpairerConfig config;
+    config.duplication = 0.5f;
+
+    Impairer impairer(writer, packet_pool, config, allocator);
+    CHECK(impairer.valid());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        impairer.write(new_packet(10));
+    }
+
+    const size_t n_dups = impairer.stats().n_duplicated;
+
+    CHECK(n_dups > NumPackets / 2 * 8 / 10);
+    CHECK(n_dups < NumPackets / 2 * 12 / 10);
+
+    UNSIGNED_LONGS_EQUAL(NumPackets + n_dups, writer.num_packets());
+    UNSIGNED_LONGS_EQUAL(NumPackets + n_dups, impairer.stats().n_delivered);
+
+    size_t n_found = 0;
+    for (size_t n = 1; n < writer.num_packets(); n++) {
+        if (writer.packet(n)->data().data() == writer.packet(n - 1)->data().data()) {
+            CHECK(writer.packet(n) != writer.packet(n - 1));
+            CHECK(writer.packet(n)->udp());
+            n_found++;
+        }
+    }
+
+    UNSIGNED_LONGS_EQUAL(n_dups, n_found);
+}
+
+TEST(impairer, jitter) {
+    enum { NumPackets = 1000 };
+
+    const core::nanoseconds_t interval = core::Millisecond;
+    const core::nanoseconds_t jitter = 10 * core::Millisecond;
+
+    for (int reordering = 0; reordering <= 1; reordering++) {
+        MockWriter writer;
+        ImpairerConfig config;
+        config.jitter = jitter;
+        config.reordering = reordering;
+
+        Impairer impairer(writer, packet_pool, config, allocator);
+        CHECK(impairer.valid());
+
+        PacketPtr packets[NumPackets];
+
+        for (size_t n = 0; n < NumPackets; n++) {
+            const core::nanoseconds_t now = core::nanoseconds_t(n) * interval;
+
+            writer.set_time(now);
+            impairer.advance(now);
+
+            packets[n] = new_packet(10);
+            impairer.write(packets[n]);
+        }
+
+        CHECK(impairer.num_pending() > 0);
+
+        for (size_t n = NumPackets; impairer.num_pending() != 0; n++) {
+            const core::nanoseconds_t now = core::nanoseconds_t(n) * interval;
+
+            CHECK(now <= NumPackets * interval + jitter);
+
+            writer.set_time(now);
+            impairer.advance(now);
+        }
+
+        UNSIGNED_LONGS_EQUAL(NumPackets, writer.num_packets());
+
+        size_t n_reordered = 0;
+
+        for (size_t i = 0; i < NumPackets; i++) {
+            size_t n = 0;
+            while (packets[n] != writer.packet(i)) {
+                n++;
+            }
+
+            if (n != i) {
+                n_reordered++;
+            }
+
+            const core::nanoseconds_t delay =
+                writer.time(i) - core::nanoseconds_t(n) * interval;
+
+            CHECK(delay >= 0);
+            CHECK(delay <= jitter + interval);
+        }
+
+        if (reordering) {
+            CHECK(n_reordered > 0);
+        } else {
+            UNSIGNED_LONGS_EQUAL(0, n_reordered);
+        }
+    }
+}
+
+TEST(impairer, rate_limit) {
+    enum { NumPackets = 10, PacketSize = 100 };
+
+    MockWriter writer;
+    ImpairerConfig config;
+    config.rate = 1000; // 100ms per packet
+    config.max_queue_delay = 350 * core::Millisecond;
+
+    Impairer impairer(writer, packet_pool, config, allocator);
+    CHECK(impairer.valid());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        impairer.write(new_packet(PacketSize));
+    }
+
+    // queue delays are 0, 100, 200, 300ms, other packets are dropped
+    UNSIGNED_LONGS_EQUAL(4, impairer.num_pending());
+    UNSIGNED_LONGS_EQUAL(NumPackets - 4, impairer.stats().n_dropped);
+
+    for (size_t n = 1; n <= 4; n++) {
+        impairer.advance(core::nanoseconds_t(n) * 100 * core::Millisecond - 1);
+        UNSIGNED_LONGS_EQUAL(n - 1, writer.num_packets());
+
+        impairer.advance(core::nanoseconds_t(n) * 100 * core::Millisecond);
+        UNSIGNED_LONGS_EQUAL(n, writer.num_packets());
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, impairer.num_pending());
+}
+
+TEST(impairer, flush) {
+    MockWriter writer;
+    ImpairerConfig config;
+    config.jitter = core::Second;
+    config.seed = 7;
+
+    Impairer impairer(writer, packet_pool, config, allocator);
+    CHECK(impairer.valid());
+
+    for (size_t n = 0; n < 100; n++) {
+        impairer.write(new_packet(10));
+    }
+
+    CHECK(impairer.num_pending() > 0);
+
+    impairer.flush();
+
+    UNSIGNED_LONGS_EQUAL(0, impairer.num_pending());
+    UNSIGNED_LONGS_EQUAL(100, writer.num_packets());
+}
+
+} // namespace packet
+} // namespace roc
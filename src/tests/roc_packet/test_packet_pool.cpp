@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/packet_pool.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { PayloadSize = 100 };
+
+core::HeapAllocator allocator;
+
+// co-allocated payload follows the packet and a few bytes of bookkeeping
+bool is_embedded(const Packet& packet, const core::Slice<uint8_t>& data) {
+    const uint8_t* begin = (const uint8_t*)&packet + sizeof(Packet);
+    const uint8_t* end = begin + 64;
+    return data.data() >= begin && data.data() < end;
+}
+
+} // namespace
+
+TEST_GROUP(packet_pool) {};
+
+TEST(packet_pool, no_payload) {
+    core::BufferPool<uint8_t> buffer_pool(allocator, PayloadSize, true);
+    PacketPool packet_pool(allocator, true);
+
+    CHECK(packet_pool.payload_size() == 0);
+
+    PacketPtr pp = new (packet_pool) Packet(packet_pool);
+    CHECK(pp);
+
+    core::Slice<uint8_t> data = pp->alloc_buffer(buffer_pool);
+    CHECK(data);
+    CHECK(!is_embedded(*pp, data));
+
+    LONGS_EQUAL(PayloadSize, data.size());
+}
+
+TEST(packet_pool, embedded_payload) {
+    core::BufferPool<uint8_t> buffer_pool(allocator, PayloadSize, true);
+    PacketPool packet_pool(allocator, true, PayloadSize);
+
+    CHECK(packet_pool.payload_size() == PayloadSize);
+
+    PacketPtr pp = new (packet_pool) Packet(packet_pool);
+    CHECK(pp);
+
+    core::Slice<uint8_t> data = pp->alloc_buffer(buffer_pool);
+    CHECK(data);
+    CHECK(is_embedded(*pp, data));
+
+    LONGS_EQUAL(PayloadSize, data.size());
+
+    for (size_t n = 0; n < data.size(); n++) {
+        data.data()[n] = uint8_t(n);
+    }
+
+    pp->set_data(data.range(0, PayloadSize / 2));
+
+    LONGS_EQUAL(PayloadSize / 2, pp->data().size());
+    LONGS_EQUAL(10, pp->data().data()[10]);
+}
+
+TEST(packet_pool, payload_too_small) {
+    core::BufferPool<uint8_t> buffer_pool(allocator, PayloadSize, true);
+    PacketPool packet_pool(allocator, true, PayloadSize - 1);
+
+    PacketPtr pp = new (packet_pool) Packet(packet_pool);
+    CHECK(pp);
+
+    core::Slice<uint8_t> data = pp->alloc_buffer(buffer_pool);
+    CHECK(data);
+    CHECK(!is_embedded(*pp, data));
+
+    LONGS_EQUAL(PayloadSize, data.size());
+}
+
+TEST(packet_pool, buffer_outlives_packet) {
+    core::BufferPool<uint8_t> buffer_pool(allocator, PayloadSize, true);
+    PacketPool packet_pool(allocator, true, PayloadSize);
+
+    core::Slice<uint8_t> data;
+
+    {
+        PacketPtr pp = new (packet_pool) Packet(packet_pool);
+        CHECK(pp);
+
+        data = pp->alloc_buffer(buffer_pool);
+        CHECK(data);
+
+        pp->set_data(data);
+
+        data.data()[0] = 42;
+    }
+
+    LONGS_EQUAL(42, data.data()[0]);
+    LONGS_EQUAL(PayloadSize, data.size());
+}
+
+TEST(packet_pool, packet_outlives_buffer) {
+    core::BufferPool<uint8_t> buffer_pool(allocator, PayloadSize, true);
+    PacketPool packet_pool(allocator, true, PayloadSize);
+
+    PacketPtr pp = new (packet_pool) Packet(packet_pool);
+    CHECK(pp);
+
+    {
+        core::Slice<uint8_t> data = pp->alloc_buffer(buffer_pool);
+        CHECK(data);
+    }
+
+    pp->add_flags(Packet::FlagRTP);
+    pp->rtp()->seqnum = 123;
+
+    LONGS_EQUAL(123, pp->rtp()->seqnum);
+}
+
+TEST(packet_pool, reuse) {
+    core::BufferPool<uint8_t> buffer_pool(allocator, PayloadSize, true);
+    PacketPool packet_pool(allocator, true, PayloadSize);
+
+    for (size_t i = 0; i < 10; i++) {
+        PacketPtr pp1 = new (packet_pool) Packet(packet_pool);
+        PacketPtr pp2 = new (packet_pool) Packet(packet_pool);
+        CHECK(pp1);
+        CHECK(pp2);
+
+        core::Slice<uint8_t> data1 = pp1->alloc_buffer(buffer_pool);
+        core::Slice<uint8_t> data2 = pp2->alloc_buffer(buffer_pool);
+        CHECK(data1);
+        CHECK(data2);
+
+        CHECK(is_embedded(*pp1, data1));
+        CHECK(is_embedded(*pp2, data2));
+        CHECK(data1.data() != data2.data());
+
+        pp1->set_data(data1);
+        pp2->set_data(data2);
+    }
+}
+
+} // namespace packet
+} // namespace roc
@@ -393,5 +393,34 @@ TEST(sorted_queue, latest) {
     CHECK(queue.latest() == p4);
 }
 
+TEST(sorted_queue, drop_counters) {
+    SortedQueue queue(2);
+
+    LONGS_EQUAL(0, queue.num_dropped());
+    LONGS_EQUAL(0, queue.num_duplicates());
+
+    queue.write(new_packet(1));
+    queue.write(new_packet(1));
+
+    LONGS_EQUAL(1, queue.size());
+    LONGS_EQUAL(0, queue.num_dropped());
+    LONGS_EQUAL(1, queue.num_duplicates());
+
+    queue.write(new_packet(2));
+    queue.write(new_packet(3));
+    queue.write(new_packet(4));
+
+    LONGS_EQUAL(2, queue.size());
+    LONGS_EQUAL(2, queue.num_dropped());
+    LONGS_EQUAL(1, queue.num_duplicates());
+
+    CHECK(queue.read());
+    CHECK(queue.read());
+
+    LONGS_EQUAL(0, queue.size());
+    LONGS_EQUAL(2, queue.num_dropped());
+    LONGS_EQUAL(1, queue.num_duplicates());
+}
+
 } // namespace packet
 } // namespace roc
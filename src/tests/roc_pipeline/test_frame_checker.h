@@ -36,6 +36,10 @@ public:
         return false;
     }
 
+    virtual core::nanoseconds_t latency() const {
+        return 0;
+    }
+
     virtual void write(audio::Frame& frame) {
         for (size_t n = 0; n < frame.size(); n++) {
             DOUBLES_EQUAL((double)frame.data()[n], (double)nth_sample(off_), Epsilon);
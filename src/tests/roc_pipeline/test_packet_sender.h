@@ -51,7 +51,9 @@ private:
 
         CHECK(pa->flags() & packet::Packet::FlagUDP);
         pb->add_flags(packet::Packet::FlagUDP);
-        *pb->udp() = *pa->udp();
+        pb->udp()->src_addr = pa->udp()->src_addr;
+        pb->udp()->dst_addr = pa->udp()->dst_addr;
+        pb->udp()->receive_timestamp = pa->udp()->receive_timestamp;
 
         pb->set_data(pa->data());
 
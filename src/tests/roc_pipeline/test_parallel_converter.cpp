@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_pipeline/converter.h"
+#include "roc_pipeline/parallel_converter.h"
+#include "roc_sndio/isource.h"
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+enum {
+    FrameSize = 200,
+    NumCh = 2,
+    ChMask = 0x3,
+
+    ManyFrames = 57,
+    MaxSamples = ManyFrames * FrameSize * 2
+};
+
+core::HeapAllocator allocator;
+core::BufferPool<audio::sample_t> sample_buffer_pool(allocator, FrameSize, true);
+
+class MockSource : public sndio::ISource {
+public:
+    MockSource(size_t num_frames)
+        : num_frames_(num_frames)
+        , pos_(0) {
+    }
+
+    virtual size_t sample_rate() const {
+        return 0;
+    }
+
+    virtual bool has_clock() const {
+        return false;
+    }
+
+    virtual State state() const {
+        return Active;
+    }
+
+    virtual void wait_active() const {
+    }
+
+    virtual void set_sink_latency(core::nanoseconds_t) {
+    }
+
+    virtual bool read(audio::Frame& frame) {
+        if (pos_ >= num_frames_ * FrameSize) {
+            return false;
+        }
+        for (size_t n = 0; n < frame.size(); n++) {
+            frame.data()[n] = audio::sample_t(((pos_ * 37 + n * 11) % 201) - 100) / 100;
+            pos_++;
+        }
+        return true;
+    }
+
+private:
+    const size_t num_frames_;
+    size_t pos_;
+};
+
+class MockWriter : public audio::IWriter {
+public:
+    MockWriter()
+        : n_samples_(0) {
+    }
+
+    virtual void write(audio::Frame& frame) {
+        LONGS_EQUAL(FrameSize, frame.size());
+        CHECK(n_samples_ + frame.size() <= MaxSamples);
+
+        memcpy(samples_ + n_samples_, frame.data(),
+               frame.size() * sizeof(audio::sample_t));
+        n_samples_ += frame.size();
+    }
+
+    size_t num_samples() const {
+        return n_samples_;
+    }
+
+    const audio::sample_t* samples() const {
+        return samples_;
+    }
+
+private:
+    audio::sample_t samples_[MaxSamples];
+    size_t n_samples_;
+};
+
+void convert_serial(const ConverterConfig& config,
+                    size_t num_frames,
+                    MockWriter& writer) {
+    Converter converter(config, &writer, sample_buffer_pool, allocator);
+    CHECK(converter.valid());
+
+    MockSource source(num_frames);
+
+    core::Slice<audio::sample_t> buffer =
+        new (sample_buffer_pool) core::Buffer<audio::sample_t>(sample_buffer_pool);
+    CHECK(buffer);
+    buffer.resize(FrameSize);
+
+    for (;;) {
+        audio::Frame frame(buffer.data(), buffer.size());
+        if (!source.read(frame)) {
+            break;
+        }
+        converter.write(frame);
+    }
+}
+
+void convert_parallel(const ConverterConfig& config,
+                      size_t num_frames,
+                      MockWriter& writer) {
+    ParallelConverter converter(config, sample_buffer_pool, allocator);
+    CHECK(converter.valid());
+
+    MockSource source(num_frames);
+    CHECK(converter.run(source, &writer));
+}
+
+void expect_identical(const MockWriter& expected, const MockWriter& actual) {
+    LONGS_EQUAL(expected.num_samples(), actual.num_samples());
+
+    CHECK(memcmp(expected.samples(), actual.samples(),
+                 expected.num_samples() * sizeof(audio::sample_t))
+          == 0);
+}
+
+} // namespace
+
+TEST_GROUP(parallel_converter) {
+    ConverterConfig config;
+
+    void setup() {
+        config.input_channels = ChMask;
+        config.output_channels = ChMask;
+
+        config.input_sample_rate = 44100;
+        config.output_sample_rate = 48000;
+
+        config.internal_frame_size = FrameSize;
+
+        config.resampling = true;
+        config.poisoning = true;
+    }
+};
+
+TEST(parallel_converter, bit_identical) {
+    const size_t num_threads[] = { 1, 2, 3 };
+    const size_t chunk_frames[] = { 1, 2, 5, 100 };
+
+    MockWriter* expected = new MockWriter;
+    convert_serial(config, ManyFrames, *expected);
+
+    CHECK(expected->num_samples() > 0);
+
+    for (size_t t = 0; t < sizeof(num_threads) / sizeof(num_threads[0]); t++) {
+        for (size_t c = 0; c < sizeof(chunk_frames) / sizeof(chunk_frames[0]); c++) {
+            config.num_threads = num_threads[t];
+            config.chunk_frames = chunk_frames[c];
+
+            MockWriter* actual = new MockWriter;
+            convert_parallel(config, ManyFrames, *actual);
+
+            expect_identical(*expected, *actual);
+            delete actual;
+        }
+    }
+
+    delete expected;
+}
+
+TEST(parallel_converter, downsample) {
+    config.input_sample_rate = 48000;
+    config.output_sample_rate = 44100;
+
+    config.num_threads = 3;
+    config.chunk_frames = 4;
+
+    MockWriter* expected = new MockWriter;
+    convert_serial(config, ManyFrames, *expected);
+
+    MockWriter* actual = new MockWriter;
+    convert_parallel(config, ManyFrames, *actual);
+
+    CHECK(expected->num_samples() > 0);
+    expect_identical(*expected, *actual);
+
+    delete expected;
+    delete actual;
+}
+
+TEST(parallel_converter, short_input) {
+    config.num_threads = 2;
+    config.chunk_frames = 3;
+
+    for (size_t num_frames = 0; num_frames < 8; num_frames++) {
+        MockWriter* expected = new MockWriter;
+        convert_serial(config, num_frames, *expected);
+
+        MockWriter* actual = new MockWriter;
+        convert_parallel(config, num_frames, *actual);
+
+        expect_identical(*expected, *actual);
+
+        delete expected;
+        delete actual;
+    }
+}
+
+} // namespace pipeline
+} // namespace roc
@@ -56,6 +56,12 @@ fec::CodecMap codec_map;
 rtp::FormatMap format_map;
 rtp::Composer rtp_composer(NULL);
 
+void copy_session_stats(void* arg, const ReceiverSessionStats& stats) {
+    ReceiverSessionStats* result = (ReceiverSessionStats*)arg;
+    CHECK(result->packets.received == 0);
+    *result = stats;
+}
+
 } // namespace
 
 TEST_GROUP(receiver) {
@@ -1072,6 +1078,207 @@ TEST(receiver, corrupted_packets_existing_session) {
     }
 }
 
+TEST(receiver, stats) {
+    enum { InitialPackets = Latency / SamplesPerPacket, DuplicatePackets = 3 };
+
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(InitialPackets, SamplesPerPacket, ChMask);
+
+    packet_writer.shift_to(InitialPackets - DuplicatePackets, SamplesPerPacket, ChMask);
+    packet_writer.write_packets(DuplicatePackets, SamplesPerPacket, ChMask);
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+        }
+
+        packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+    }
+
+    frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+    ReceiverStats stats;
+    receiver.get_stats(stats);
+
+    UNSIGNED_LONGS_EQUAL(1, stats.num_sessions);
+    UNSIGNED_LONGS_EQUAL(InitialPackets + DuplicatePackets + ManyPackets,
+                         stats.packets.received);
+    UNSIGNED_LONGS_EQUAL(0, stats.packets.late);
+    UNSIGNED_LONGS_EQUAL(0, stats.packets.dropped);
+    UNSIGNED_LONGS_EQUAL(DuplicatePackets, stats.packets.duplicated);
+    UNSIGNED_LONGS_EQUAL(0, stats.packets.restored);
+
+    ReceiverSessionStats sess_stats;
+    receiver.iterate_sessions(copy_session_stats, &sess_stats);
+
+    CHECK(sess_stats.src_address == src1);
+    UNSIGNED_LONGS_EQUAL(stats.packets.received, sess_stats.packets.received);
+    UNSIGNED_LONGS_EQUAL(DuplicatePackets, sess_stats.packets.duplicated);
+    CHECK(sess_stats.queue_size > 0);
+    CHECK(sess_stats.latency > 0);
+    DOUBLES_EQUAL(1.0, (double)sess_stats.scaling, 0.0);
+}
+
+TEST(receiver, sink_latency) {
+    enum {
+        InitialPackets = Latency / SamplesPerPacket,
+        SinkLatency = SamplesPerPacket * 3
+    };
+
+    core::nanoseconds_t session_latency[2] = {};
+
+    for (size_t n = 0; n < 2; n++) {
+        Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                          sample_buffer_pool, allocator);
+
+        CHECK(receiver.valid());
+        CHECK(receiver.add_port(port1));
+
+        FrameReader frame_reader(receiver, sample_buffer_pool);
+
+        PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map,
+                                   packet_pool, byte_buffer_pool, PayloadType, src1,
+                                   port1.address);
+
+        if (n == 1) {
+            receiver.set_sink_latency(SinkLatency * core::Second / SampleRate);
+        }
+
+        packet_writer.write_packets(InitialPackets, SamplesPerPacket, ChMask);
+
+        for (size_t np = 0; np < ManyPackets; np++) {
+            for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+                frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+            }
+
+            packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+        }
+
+        frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+        ReceiverSessionStats sess_stats;
+        receiver.iterate_sessions(copy_session_stats, &sess_stats);
+
+        session_latency[n] = sess_stats.latency;
+    }
+
+    CHECK(session_latency[0] > 0);
+
+    DOUBLES_EQUAL((double)SinkLatency * core::Second / SampleRate,
+                  (double)(session_latency[1] - session_latency[0]),
+                  (double)core::Second / SampleRate);
+}
+
+TEST(receiver, sink_latency_exceeds_bounds) {
+    enum {
+        MinLatency = -Latency,
+        MaxLatency = Latency * 2,
+        SinkLatency = MaxLatency - Latency + SamplesPerPacket
+    };
+
+    config.default_session.latency_monitor.min_latency =
+        (core::nanoseconds_t)MinLatency * core::Second / SampleRate;
+    config.default_session.latency_monitor.max_latency =
+        MaxLatency * core::Second / SampleRate;
+
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map,
+                               packet_pool, byte_buffer_pool, PayloadType, src1,
+                               port1.address);
+
+    receiver.set_sink_latency(SinkLatency * core::Second / SampleRate);
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+
+        packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+    }
+
+    ReceiverSessionStats sess_stats;
+    receiver.iterate_sessions(copy_session_stats, &sess_stats);
+
+    CHECK(sess_stats.latency > MaxLatency * core::Second / SampleRate);
+}
+
+TEST(receiver, sink_latency_exceeds_target) {
+    enum {
+        // large enough for the queue to be non-empty despite resampler lookahead
+        TargetLatency = Latency * 4,
+        MinLatency = -TargetLatency,
+        MaxLatency = TargetLatency * 2,
+        SinkLatency = TargetLatency * 5 / 2,
+        NumPackets = ManyPackets * 200
+    };
+
+    config.common.resampling = true;
+
+    config.default_session.target_latency = TargetLatency * core::Second / SampleRate;
+
+    config.default_session.latency_monitor.min_latency =
+        (core::nanoseconds_t)MinLatency * core::Second / SampleRate;
+    config.default_session.latency_monitor.max_latency =
+        MaxLatency * core::Second / SampleRate;
+
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map,
+                               packet_pool, byte_buffer_pool, PayloadType, src1,
+                               port1.address);
+
+    receiver.set_sink_latency(SinkLatency * core::Second / SampleRate);
+
+    packet_writer.write_packets(TargetLatency / SamplesPerPacket, SamplesPerPacket,
+                                ChMask);
+
+    audio::sample_t samples[SamplesPerFrame * NumCh];
+
+    // frequency estimator would drain the queue to (target - sink) latency,
+    // which is below the minimum, unless the sink latency is capped
+    for (size_t np = 0; np < NumPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            audio::Frame frame(samples, SamplesPerFrame * NumCh);
+            receiver.read(frame);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+
+        packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+    }
+
+    ReceiverSessionStats sess_stats;
+    receiver.iterate_sessions(copy_session_stats, &sess_stats);
+
+    CHECK(sess_stats.latency
+          > (SinkLatency + TargetLatency / 4) * core::Second / SampleRate);
+}
+
 TEST(receiver, status) {
     Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
                       sample_buffer_pool, allocator);
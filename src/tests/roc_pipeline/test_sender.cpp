@@ -58,6 +58,7 @@ TEST_GROUP(sender) {
 
     PortConfig source_port;
     PortConfig repair_port;
+    PortConfig control_port;
 
     void setup() {
         source_port.address = new_address(1);
@@ -76,8 +77,9 @@ TEST_GROUP(sender) {
 TEST(sender, write) {
     packet::Queue queue;
 
-    Sender sender(config, source_port, queue, repair_port, queue, codec_map, format_map,
-                  packet_pool, byte_buffer_pool, sample_buffer_pool, allocator);
+    Sender sender(config, source_port, queue, repair_port, queue, control_port, queue,
+                  codec_map, format_map, packet_pool, byte_buffer_pool,
+                  sample_buffer_pool, allocator);
 
     CHECK(sender.valid());
 
@@ -106,8 +108,9 @@ TEST(sender, frame_size_small) {
 
     packet::Queue queue;
 
-    Sender sender(config, source_port, queue, repair_port, queue, codec_map, format_map,
-                  packet_pool, byte_buffer_pool, sample_buffer_pool, allocator);
+    Sender sender(config, source_port, queue, repair_port, queue, control_port, queue,
+                  codec_map, format_map, packet_pool, byte_buffer_pool,
+                  sample_buffer_pool, allocator);
 
     CHECK(sender.valid());
 
@@ -136,8 +139,9 @@ TEST(sender, frame_size_large) {
 
     packet::Queue queue;
 
-    Sender sender(config, source_port, queue, repair_port, queue, codec_map, format_map,
-                  packet_pool, byte_buffer_pool, sample_buffer_pool, allocator);
+    Sender sender(config, source_port, queue, repair_port, queue, control_port, queue,
+                  codec_map, format_map, packet_pool, byte_buffer_pool,
+                  sample_buffer_pool, allocator);
 
     CHECK(sender.valid());
 
@@ -157,5 +161,80 @@ TEST(sender, frame_size_large) {
     CHECK(!queue.read());
 }
 
+TEST(sender, multiple_destinations) {
+    enum { NumDestinations = 3 };
+
+    packet::Queue queue;
+
+    Sender sender(config, source_port, queue, repair_port, queue, control_port, queue,
+                  codec_map, format_map, packet_pool, byte_buffer_pool,
+                  sample_buffer_pool, allocator);
+
+    CHECK(sender.valid());
+
+    PortConfig extra_ports[NumDestinations - 1];
+    for (size_t nd = 0; nd < NumDestinations - 1; nd++) {
+        extra_ports[nd].address = new_address(int(2 + nd));
+        extra_ports[nd].protocol = Proto_RTP;
+
+        CHECK(sender.add_destination(extra_ports[nd]));
+    }
+
+    // duplicate destination
+    CHECK(!sender.add_destination(extra_ports[0]));
+
+    // protocol mismatch
+    PortConfig bad_port;
+    bad_port.address = new_address(100);
+    bad_port.protocol = Proto_RTP_RSm8_Source;
+    CHECK(!sender.add_destination(bad_port));
+
+    FrameWriter frame_writer(sender, sample_buffer_pool);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_writer.write_samples(SamplesPerFrame * NumCh);
+    }
+
+    packet::Queue dst_queues[NumDestinations];
+
+    for (size_t np = 0; np < ManyFrames / FramesPerPacket; np++) {
+        packet::PacketPtr first = queue.read();
+        CHECK(first);
+        CHECK(first->udp()->dst_addr == source_port.address);
+
+        dst_queues[0].write(first);
+
+        for (size_t nd = 0; nd < NumDestinations - 1; nd++) {
+            packet::PacketPtr pp = queue.read();
+            CHECK(pp);
+            CHECK(pp != first);
+
+            CHECK(pp->udp()->dst_addr == extra_ports[nd].address);
+            CHECK(pp->udp()->src_addr == first->udp()->src_addr);
+
+            // buffer is shared
+            CHECK(pp->data().data() == first->data().data());
+            UNSIGNED_LONGS_EQUAL(first->data().size(), pp->data().size());
+
+            dst_queues[nd + 1].write(pp);
+        }
+    }
+
+    CHECK(!queue.read());
+
+    for (size_t nd = 0; nd < NumDestinations; nd++) {
+        PacketReader packet_reader(allocator, dst_queues[nd], rtp_parser, format_map,
+                                   packet_pool, PayloadType,
+                                   nd == 0 ? source_port.address
+                                           : extra_ports[nd - 1].address);
+
+        for (size_t np = 0; np < ManyFrames / FramesPerPacket; np++) {
+            packet_reader.read_packet(SamplesPerPacket, ChMask);
+        }
+
+        CHECK(!dst_queues[nd].read());
+    }
+}
+
 } // namespace pipeline
 } // namespace roc
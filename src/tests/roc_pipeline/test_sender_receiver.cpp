@@ -11,6 +11,7 @@
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
 #include "roc_packet/packet_pool.h"
+#include "roc_packet/impairer.h"
 #include "roc_packet/queue.h"
 #include "roc_pipeline/receiver.h"
 #include "roc_pipeline/sender.h"
@@ -65,7 +66,10 @@ enum {
     FlagReedSolomon = (1 << 4),
 
     // enable LDPC-Staircase FEC scheme on sender
-    FlagLDPC = (1 << 5)
+    FlagLDPC = (1 << 5),
+
+    // enable jitter, reordering and duplication between sender and receiver
+    FlagImpairments = (1 << 6)
 };
 
 core::HeapAllocator allocator;
@@ -89,6 +93,8 @@ TEST_GROUP(sender_receiver) {
                       queue,
                       repair_port,
                       queue,
+                      PortConfig(),
+                      queue,
                       codec_map,
                       format_map,
                       packet_pool,
@@ -118,7 +124,11 @@ TEST_GROUP(sender_receiver) {
 
         PacketSender packet_sender(packet_pool, receiver);
 
-        filter_packets(flags, queue, packet_sender);
+        if (flags & FlagImpairments) {
+            impair_packets(queue, packet_sender);
+        } else {
+            filter_packets(flags, queue, packet_sender);
+        }
 
         FrameReader frame_reader(receiver, sample_buffer_pool);
 
@@ -157,6 +167,39 @@ TEST_GROUP(sender_receiver) {
         }
     }
 
+    void impair_packets(packet::IReader& reader, packet::IWriter& writer) {
+        const core::nanoseconds_t packet_length =
+            SamplesPerPacket * core::Second / SampleRate;
+
+        packet::ImpairerConfig config;
+        config.seed = 1;
+        config.duplication = 0.05f;
+        config.jitter = packet_length * 3;
+        config.reordering = true;
+
+        packet::Impairer impairer(writer, packet_pool, config, allocator);
+        CHECK(impairer.valid());
+
+        // packets that fill initial latency define where the stream begins on
+        // receiver, so they are delivered as is
+        for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+            writer.write(reader.read());
+        }
+
+        core::nanoseconds_t now = 0;
+
+        while (packet::PacketPtr pp = reader.read()) {
+            impairer.advance(now);
+            impairer.write(pp);
+
+            now += packet_length;
+        }
+
+        impairer.flush();
+
+        CHECK(impairer.stats().n_duplicated > 0);
+    }
+
     PortConfig sender_source_port(int flags) {
         PortConfig port_config;
         if (flags & FlagReedSolomon) {
@@ -264,6 +307,102 @@ TEST(sender_receiver, interleaving) {
     send_receive(FlagInterleaving, 1);
 }
 
+TEST(sender_receiver, impairments) {
+    send_receive(FlagImpairments, 1);
+}
+
+TEST(sender_receiver, control_reports) {
+    enum { ReportInterval = Latency, LossPeriod = 10 };
+
+    packet::Queue queue;
+    packet::Queue report_queue;
+
+    PortConfig control_port;
+    control_port.address = new_address(40);
+    control_port.protocol = Proto_RTCP;
+
+    SenderConfig s_config = sender_config(FlagNone);
+    s_config.report_interval = ReportInterval * core::Second / SampleRate;
+
+    Sender sender(s_config, sender_source_port(FlagNone), queue, PortConfig(), queue,
+                  control_port, queue, codec_map, format_map, packet_pool,
+                  byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(sender.valid());
+
+    ReceiverConfig r_config = receiver_config();
+    r_config.common.report_interval = ReportInterval * core::Second / SampleRate;
+
+    Receiver receiver(r_config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+
+    add_receiver_ports(receiver);
+    CHECK(receiver.add_port(control_port));
+
+    receiver.set_control_writer(&report_queue);
+
+    FrameWriter frame_writer(sender, sample_buffer_pool);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_writer.write_samples(SamplesPerFrame * NumCh);
+    }
+
+    PacketSender packet_sender(packet_pool, receiver);
+
+    // sender reports come from a separate port, and receiver reports should
+    // be sent back to it
+    const packet::Address sender_control_addr = new_address(41);
+
+    // lose every LossPeriod-th audio packet, but deliver all sender reports
+    size_t n_audio = 0;
+    while (packet::PacketPtr pp = queue.read()) {
+        if (pp->rtp() && n_audio++ % LossPeriod == LossPeriod - 1) {
+            continue;
+        }
+        if (pp->flags() & packet::Packet::FlagRTCP) {
+            pp->udp()->src_addr = sender_control_addr;
+        }
+        packet_sender.write(pp);
+    }
+
+    packet_sender.deliver(Latency / SamplesPerPacket);
+
+    audio::sample_t samples[SamplesPerFrame * NumCh];
+    size_t n_reports = 0;
+
+    for (size_t np = 0; np < ManyFrames / FramesPerPacket; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            audio::Frame frame(samples, SamplesPerFrame * NumCh);
+            receiver.read(frame);
+
+            while (packet::PacketPtr pp = report_queue.read()) {
+                CHECK(pp->flags() & packet::Packet::FlagRTCP);
+                CHECK(pp->udp()->dst_addr == sender_control_addr);
+                sender.write(pp);
+                n_reports++;
+            }
+        }
+
+        packet_sender.deliver(1);
+    }
+
+    CHECK(n_reports > 1);
+
+    SenderStats stats;
+    sender.get_stats(stats);
+
+    CHECK(stats.control_packets > 0);
+
+    CHECK(stats.link.cumulative_lost > 0);
+    CHECK(stats.link.fraction_lost > 0);
+    CHECK(stats.link.fraction_lost < 1);
+
+    CHECK(stats.link.rtt >= 0);
+    CHECK(stats.link.rtt < core::Second);
+}
+
 #ifdef ROC_TARGET_OPENFEC
 TEST(sender_receiver, fec_rs) {
     send_receive(FlagReedSolomon, 1);
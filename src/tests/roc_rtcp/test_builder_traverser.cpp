@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_rtcp/builder.h"
+#include "roc_rtcp/headers.h"
+#include "roc_rtcp/traverser.h"
+
+namespace roc {
+namespace rtcp {
+
+namespace {
+
+enum { BufferSize = 1024, MaxReports = 4 };
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, BufferSize, true);
+
+struct TestHandler : IReportHandler {
+    TestHandler()
+        : n_sr(0)
+        , n_rr(0) {
+    }
+
+    virtual void handle_sender_report(const SenderReport& report) {
+        CHECK(n_sr < MaxReports);
+        sr[n_sr++] = report;
+    }
+
+    virtual void handle_reception_report(const ReceptionReport& report) {
+        CHECK(n_rr < MaxReports);
+        rr[n_rr++] = report;
+    }
+
+    SenderReport sr[MaxReports];
+    size_t n_sr;
+
+    ReceptionReport rr[MaxReports];
+    size_t n_rr;
+};
+
+core::Slice<uint8_t> new_buffer() {
+    core::Slice<uint8_t> buf = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+    CHECK(buf);
+    buf.resize(0);
+    return buf;
+}
+
+ReceptionReport make_block(packet::source_t receiver, packet::source_t sender) {
+    ReceptionReport report;
+    report.receiver_ssrc = receiver;
+    report.sender_ssrc = sender;
+    report.fraction_lost = 0.25f;
+    report.cumulative_lost = -3;
+    report.last_seqnum = 0x11223344;
+    report.jitter = 555;
+    report.last_sr = 0x55667788;
+    report.delay_last_sr = 0x99aabbcc;
+    return report;
+}
+
+void check_block(const ReceptionReport& expected, const ReceptionReport& actual) {
+    LONGS_EQUAL(expected.receiver_ssrc, actual.receiver_ssrc);
+    LONGS_EQUAL(expected.sender_ssrc, actual.sender_ssrc);
+    DOUBLES_EQUAL(expected.fraction_lost, actual.fraction_lost, 0.0001);
+    LONGS_EQUAL(expected.cumulative_lost, actual.cumulative_lost);
+    LONGS_EQUAL(expected.last_seqnum, actual.last_seqnum);
+    LONGS_EQUAL(expected.jitter, actual.jitter);
+    LONGS_EQUAL(expected.last_sr, actual.last_sr);
+    LONGS_EQUAL(expected.delay_last_sr, actual.delay_last_sr);
+}
+
+} // namespace
+
+TEST_GROUP(builder_traverser) {};
+
+TEST(builder_traverser, sender_report) {
+    core::Slice<uint8_t> buf = new_buffer();
+
+    SenderReport sr;
+    sr.ssrc = 0x1234;
+    sr.ntp_timestamp = 0x0102030405060708ull;
+    sr.rtp_timestamp = 0xaabbccdd;
+    sr.packet_count = 100;
+    sr.byte_count = 20000;
+
+    ReceptionReport blocks[2] = { make_block(0x1234, 0x10), make_block(0x1234, 0x20) };
+
+    Builder builder(buf);
+    CHECK(builder.add_sender_report(sr, blocks, 2));
+
+    LONGS_EQUAL(sizeof(SenderReportPacket) + 2 * sizeof(ReportBlock), buf.size());
+    LONGS_EQUAL(0, buf.size() % 4);
+
+    Traverser traverser(buf);
+    CHECK(traverser.validate());
+
+    TestHandler handler;
+    CHECK(traverser.traverse(handler));
+
+    LONGS_EQUAL(1, handler.n_sr);
+    LONGS_EQUAL(sr.ssrc, handler.sr[0].ssrc);
+    CHECK(sr.ntp_timestamp == handler.sr[0].ntp_timestamp);
+    LONGS_EQUAL(sr.rtp_timestamp, handler.sr[0].rtp_timestamp);
+    LONGS_EQUAL(sr.packet_count, handler.sr[0].packet_count);
+    LONGS_EQUAL(sr.byte_count, handler.sr[0].byte_count);
+
+    LONGS_EQUAL(2, handler.n_rr);
+    check_block(blocks[0], handler.rr[0]);
+    check_block(blocks[1], handler.rr[1]);
+}
+
+TEST(builder_traverser, compound) {
+    core::Slice<uint8_t> buf = new_buffer();
+
+    SenderReport sr;
+    sr.ssrc = 0x1234;
+
+    ReceptionReport block = make_block(0x5678, 0x1234);
+
+    Builder builder(buf);
+    CHECK(builder.add_sender_report(sr, NULL, 0));
+    CHECK(builder.add_receiver_report(0x5678, &block, 1));
+
+    Traverser traverser(buf);
+
+    TestHandler handler;
+    CHECK(traverser.traverse(handler));
+
+    LONGS_EQUAL(1, handler.n_sr);
+    LONGS_EQUAL(0x1234, handler.sr[0].ssrc);
+
+    LONGS_EQUAL(1, handler.n_rr);
+    check_block(block, handler.rr[0]);
+}
+
+TEST(builder_traverser, no_space) {
+    core::Slice<uint8_t> buf = new_buffer();
+
+    ReceptionReport blocks[MaxReportBlocks];
+
+    Builder builder(buf);
+
+    size_t n_reports = 0;
+    while (builder.add_receiver_report(0x1, blocks, MaxReportBlocks)) {
+        n_reports++;
+    }
+
+    CHECK(n_reports > 0);
+    CHECK(buf.size() <= buf.capacity());
+    CHECK(Traverser(buf).validate());
+}
+
+TEST(builder_traverser, too_many_blocks) {
+    core::Slice<uint8_t> buf = new_buffer();
+
+    ReceptionReport blocks[MaxReportBlocks + 1];
+
+    Builder builder(buf);
+    CHECK(!builder.add_receiver_report(0x1, blocks, MaxReportBlocks + 1));
+
+    LONGS_EQUAL(0, buf.size());
+}
+
+TEST(builder_traverser, bad_packets) {
+    { // empty
+        core::Slice<uint8_t> buf = new_buffer();
+        CHECK(!Traverser(buf).validate());
+    }
+    { // size not multiple of 4
+        core::Slice<uint8_t> buf = new_buffer();
+        CHECK(Builder(buf).add_receiver_report(0x1, NULL, 0));
+        buf.resize(buf.size() - 1);
+        CHECK(!Traverser(buf).validate());
+    }
+    { // truncated blocks
+        core::Slice<uint8_t> buf = new_buffer();
+        ReceptionReport block;
+        CHECK(Builder(buf).add_receiver_report(0x1, &block, 1));
+        buf.resize(buf.size() - sizeof(ReportBlock));
+        CHECK(!Traverser(buf).validate());
+    }
+    { // bad version
+        core::Slice<uint8_t> buf = new_buffer();
+        CHECK(Builder(buf).add_receiver_report(0x1, NULL, 0));
+        buf.data()[0] &= 0x3f;
+        CHECK(!Traverser(buf).validate());
+    }
+    { // not starting with sr or rr
+        core::Slice<uint8_t> buf = new_buffer();
+        CHECK(Builder(buf).add_receiver_report(0x1, NULL, 0));
+        buf.data()[1] = RTCP_SDES;
+        CHECK(!Traverser(buf).validate());
+    }
+}
+
+} // namespace rtcp
+} // namespace roc
@@ -0,0 +1,405 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+#include "roc_rtcp/builder.h"
+#include "roc_rtcp/receiver_reporter.h"
+#include "roc_rtcp/sender_reporter.h"
+
+namespace roc {
+namespace rtcp {
+
+namespace {
+
+enum {
+    SenderSSRC = 0x1111,
+    ReceiverSSRC = 0x2222,
+    SampleRate = 1000,
+    SamplesPerPacket = 10,
+    BufferSize = 1024
+};
+
+const core::nanoseconds_t PacketDuration =
+    SamplesPerPacket * core::Second / SampleRate;
+
+const core::nanoseconds_t StartTime = 100 * core::Second;
+
+// wall clock of the sender, unrelated to monotonic StartTime
+const ntp_timestamp_t StartNtp = ntp_from_unix_ns(1500000000 * core::Second);
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, BufferSize, true);
+packet::PacketPool packet_pool(allocator, true);
+
+packet::PacketPtr new_rtp_packet(packet::seqnum_t sn, core::nanoseconds_t arrival) {
+    packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+    CHECK(pp);
+
+    pp->add_flags(packet::Packet::FlagUDP | packet::Packet::FlagRTP
+                  | packet::Packet::FlagAudio);
+
+    pp->udp()->receive_timestamp = arrival;
+
+    pp->rtp()->source = SenderSSRC;
+    pp->rtp()->seqnum = sn;
+    pp->rtp()->timestamp = packet::timestamp_t(sn * SamplesPerPacket);
+    pp->rtp()->duration = SamplesPerPacket;
+
+    return pp;
+}
+
+core::Slice<uint8_t> new_buffer() {
+    core::Slice<uint8_t> data = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+    CHECK(data);
+    data.resize(0);
+    return data;
+}
+
+packet::PacketPtr new_rtcp_packet(const core::Slice<uint8_t>& data,
+                                  core::nanoseconds_t arrival) {
+    packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+    CHECK(pp);
+
+    pp->add_flags(packet::Packet::FlagUDP | packet::Packet::FlagRTCP);
+
+    pp->udp()->receive_timestamp = arrival;
+    pp->set_data(data);
+
+    return pp;
+}
+
+} // namespace
+
+TEST_GROUP(reporters) {};
+
+TEST(reporters, no_packets) {
+    ReceiverReporter reporter(ReceiverSSRC, SampleRate);
+
+    ReceptionReport report;
+    CHECK(!reporter.build_report(report, StartTime));
+
+    CHECK(!reporter.has_sender_report());
+
+    LinkMetrics metrics = reporter.metrics();
+    DOUBLES_EQUAL(0, metrics.fraction_lost, 0);
+    LONGS_EQUAL(0, metrics.cumulative_lost);
+}
+
+TEST(reporters, receiver_no_losses) {
+    enum { NumPackets = 100 };
+
+    ReceiverReporter reporter(ReceiverSSRC, SampleRate);
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        reporter.process_packet(
+            *new_rtp_packet(packet::seqnum_t(n), StartTime + PacketDuration * n));
+    }
+
+    ReceptionReport report;
+    CHECK(reporter.build_report(report, StartTime + PacketDuration * NumPackets));
+
+    LONGS_EQUAL(ReceiverSSRC, report.receiver_ssrc);
+    LONGS_EQUAL(SenderSSRC, report.sender_ssrc);
+    DOUBLES_EQUAL(0, report.fraction_lost, 0);
+    LONGS_EQUAL(0, report.cumulative_lost);
+    LONGS_EQUAL(NumPackets - 1, report.last_seqnum);
+    LONGS_EQUAL(0, report.jitter);
+    LONGS_EQUAL(0, report.last_sr);
+    LONGS_EQUAL(0, report.delay_last_sr);
+}
+
+TEST(reporters, receiver_losses) {
+    enum { NumPackets = 100, LossPeriod = 4 };
+
+    ReceiverReporter reporter(ReceiverSSRC, SampleRate);
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        if (n % LossPeriod == 1) {
+            continue;
+        }
+        reporter.process_packet(
+            *new_rtp_packet(packet::seqnum_t(n), StartTime + PacketDuration * n));
+    }
+
+    ReceptionReport report;
+    CHECK(reporter.build_report(report, StartTime + PacketDuration * NumPackets));
+
+    DOUBLES_EQUAL(1.0 / LossPeriod, report.fraction_lost, 0.0001);
+    LONGS_EQUAL(NumPackets / LossPeriod, report.cumulative_lost);
+
+    LinkMetrics metrics = reporter.metrics();
+    DOUBLES_EQUAL(1.0 / LossPeriod, metrics.fraction_lost, 0.0001);
+    LONGS_EQUAL(NumPackets / LossPeriod, metrics.cumulative_lost);
+
+    // next interval has no losses
+    for (size_t n = NumPackets; n < NumPackets * 2; n++) {
+        reporter.process_packet(
+            *new_rtp_packet(packet::seqnum_t(n), StartTime + PacketDuration * n));
+    }
+
+    CHECK(reporter.build_report(report, StartTime + PacketDuration * NumPackets * 2));
+
+    DOUBLES_EQUAL(0, report.fraction_lost, 0);
+    LONGS_EQUAL(NumPackets / LossPeriod, report.cumulative_lost);
+}
+
+TEST(reporters, receiver_seqnum_wrap) {
+    enum { NumPackets = 100, FirstSeqnum = 65500 };
+
+    ReceiverReporter reporter(ReceiverSSRC, SampleRate);
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        reporter.process_packet(*new_rtp_packet(packet::seqnum_t(FirstSeqnum + n),
+                                                StartTime + PacketDuration * n));
+    }
+
+    ReceptionReport report;
+    CHECK(reporter.build_report(report, StartTime + PacketDuration * NumPackets));
+
+    LONGS_EQUAL(0, report.cumulative_lost);
+    LONGS_EQUAL(FirstSeqnum + NumPackets - 1, report.last_seqnum);
+}
+
+TEST(reporters, receiver_jitter) {
+    enum { NumPackets = 1000, JitterSamples = 4 };
+
+    const core::nanoseconds_t jitter = JitterSamples * core::Second / SampleRate;
+
+    ReceiverReporter reporter(ReceiverSSRC, SampleRate);
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        reporter.process_packet(
+            *new_rtp_packet(packet::seqnum_t(n),
+                            StartTime + PacketDuration * n + (n % 2 ? jitter : 0)));
+    }
+
+    ReceptionReport report;
+    CHECK(reporter.build_report(report, StartTime + PacketDuration * NumPackets));
+
+    // every packet changes transit time by jitter, so the estimate
+    // converges to it from below
+    CHECK(report.jitter >= JitterSamples - 1);
+    CHECK(report.jitter <= JitterSamples);
+
+    LinkMetrics metrics = reporter.metrics();
+    CHECK(metrics.jitter > jitter * 9 / 10);
+    CHECK(metrics.jitter <= jitter);
+}
+
+TEST(reporters, sender_report) {
+    enum { NumPackets = 10 };
+
+    packet::Queue queue;
+    SenderReporter reporter(queue, SampleRate);
+
+    SenderReport sr;
+    CHECK(!reporter.build_report(sr, StartNtp, StartTime));
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        packet::PacketPtr pp = new_rtp_packet(packet::seqnum_t(n), 0);
+        reporter.write(pp);
+        CHECK(queue.read() == pp);
+    }
+
+    CHECK(reporter.build_report(sr, StartNtp, StartTime));
+
+    LONGS_EQUAL(SenderSSRC, sr.ssrc);
+    CHECK(StartNtp == sr.ntp_timestamp);
+    LONGS_EQUAL(NumPackets * SamplesPerPacket, sr.rtp_timestamp);
+    LONGS_EQUAL(NumPackets, sr.packet_count);
+}
+
+TEST(reporters, round_trip) {
+    enum { NumPackets = 10 };
+
+    const core::nanoseconds_t ForwardDelay = 10 * core::Millisecond;
+    const core::nanoseconds_t ReceiverDelay = 5 * core::Millisecond;
+    const core::nanoseconds_t BackwardDelay = 15 * core::Millisecond;
+
+    packet::Queue queue;
+    SenderReporter sender(queue, SampleRate);
+    ReceiverReporter receiver(ReceiverSSRC, SampleRate);
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        packet::PacketPtr pp = new_rtp_packet(
+            packet::seqnum_t(n), StartTime + PacketDuration * n + ForwardDelay);
+        sender.write(pp);
+        CHECK(queue.read() == pp);
+
+        receiver.process_packet(*pp);
+    }
+
+    core::nanoseconds_t now = StartTime + PacketDuration * NumPackets;
+
+    SenderReport sr;
+    CHECK(sender.build_report(sr, StartNtp, now));
+
+    core::Slice<uint8_t> sr_data = new_buffer();
+    CHECK(Builder(sr_data).add_sender_report(sr, NULL, 0));
+
+    packet::PacketPtr sr_packet = new_rtcp_packet(sr_data, now + ForwardDelay);
+
+    CHECK(receiver.process_packet(*sr_packet));
+    CHECK(receiver.has_sender_report());
+    LONGS_EQUAL(sr.rtp_timestamp, receiver.last_sender_report().rtp_timestamp);
+
+    now += ForwardDelay + ReceiverDelay;
+
+    ReceptionReport rr;
+    CHECK(receiver.build_report(rr, now));
+
+    core::Slice<uint8_t> rr_data = new_buffer();
+    CHECK(Builder(rr_data).add_receiver_report(ReceiverSSRC, &rr, 1));
+
+    packet::PacketPtr rr_packet = new_rtcp_packet(rr_data, now + BackwardDelay);
+
+    CHECK(sender.process_packet(*rr_packet));
+
+    LinkMetrics metrics = sender.metrics();
+
+    const core::nanoseconds_t expected_rtt = ForwardDelay + BackwardDelay;
+    const core::nanoseconds_t precision = 100 * core::Microsecond;
+
+    CHECK(metrics.rtt > expected_rtt - precision);
+    CHECK(metrics.rtt < expected_rtt + precision);
+
+    DOUBLES_EQUAL(0, metrics.fraction_lost, 0);
+    LONGS_EQUAL(0, metrics.cumulative_lost);
+}
+
+TEST(reporters, round_trip_older_report) {
+    enum { NumReports = 3 };
+
+    const core::nanoseconds_t ForwardDelay = 10 * core::Millisecond;
+    const core::nanoseconds_t ReceiverDelay = 5 * core::Millisecond;
+    const core::nanoseconds_t BackwardDelay = 15 * core::Millisecond;
+    const core::nanoseconds_t ReportInterval = 100 * core::Millisecond;
+
+    packet::Queue queue;
+    SenderReporter sender(queue, SampleRate);
+    ReceiverReporter receiver(ReceiverSSRC, SampleRate);
+
+    packet::PacketPtr pp = new_rtp_packet(0, StartTime + ForwardDelay);
+    sender.write(pp);
+    CHECK(queue.read() == pp);
+    receiver.process_packet(*pp);
+
+    // only the first report reaches receiver, next ones are lost
+    core::nanoseconds_t now = StartTime;
+    core::nanoseconds_t first_sr_time = 0;
+
+    for (size_t n = 0; n < NumReports; n++) {
+        SenderReport sr;
+        CHECK(sender.build_report(sr, StartNtp + ntp_from_ns(ReportInterval * n), now));
+
+        if (n == 0) {
+            core::Slice<uint8_t> sr_data = new_buffer();
+            CHECK(Builder(sr_data).add_sender_report(sr, NULL, 0));
+
+            receiver.process_packet(*new_rtcp_packet(sr_data, now + ForwardDelay));
+            first_sr_time = now;
+        }
+
+        now += ReportInterval;
+    }
+
+    now = first_sr_time + ForwardDelay + ReceiverDelay;
+
+    ReceptionReport rr;
+    CHECK(receiver.build_report(rr, now));
+
+    core::Slice<uint8_t> rr_data = new_buffer();
+    CHECK(Builder(rr_data).add_receiver_report(ReceiverSSRC, &rr, 1));
+
+    CHECK(sender.process_packet(*new_rtcp_packet(rr_data, now + BackwardDelay)));
+
+    const core::nanoseconds_t expected_rtt = ForwardDelay + BackwardDelay;
+    const core::nanoseconds_t precision = 100 * core::Microsecond;
+
+    CHECK(sender.metrics().rtt > expected_rtt - precision);
+    CHECK(sender.metrics().rtt < expected_rtt + precision);
+}
+
+TEST(reporters, round_trip_unknown_report) {
+    packet::Queue queue;
+    SenderReporter sender(queue, SampleRate);
+
+    packet::PacketPtr pp = new_rtp_packet(0, StartTime);
+    sender.write(pp);
+
+    SenderReport sr;
+    CHECK(sender.build_report(sr, StartNtp, StartTime));
+
+    ReceptionReport rr;
+    rr.sender_ssrc = SenderSSRC;
+    rr.last_sr = ntp_compact(StartNtp) + 1;
+    rr.delay_last_sr = 0;
+
+    core::Slice<uint8_t> rr_data = new_buffer();
+    CHECK(Builder(rr_data).add_receiver_report(ReceiverSSRC, &rr, 1));
+
+    CHECK(sender.process_packet(*new_rtcp_packet(rr_data, StartTime + core::Second)));
+    LONGS_EQUAL(0, sender.metrics().rtt);
+}
+
+TEST(reporters, ntp_unix_epoch) {
+    // 1970-01-01 00:00:00 UTC in NTP era 0
+    CHECK(ntp_from_unix_ns(0) == (ntp_timestamp_t)2208988800u << 32);
+
+    CHECK(ntp_now() > ntp_from_unix_ns(0));
+}
+
+TEST(reporters, sender_ignores_foreign_reports) {
+    packet::Queue queue;
+    SenderReporter sender(queue, SampleRate);
+
+    packet::PacketPtr pp = new_rtp_packet(0, 0);
+    sender.write(pp);
+
+    ReceptionReport rr;
+    rr.sender_ssrc = SenderSSRC + 1;
+    rr.fraction_lost = 0.5f;
+
+    core::Slice<uint8_t> rr_data = new_buffer();
+    CHECK(Builder(rr_data).add_receiver_report(ReceiverSSRC, &rr, 1));
+
+    packet::PacketPtr rr_packet = new_rtcp_packet(rr_data, StartTime);
+
+    CHECK(!sender.process_packet(*rr_packet));
+    DOUBLES_EQUAL(0, sender.metrics().fraction_lost, 0);
+
+    CHECK(!sender.process_packet(*new_rtp_packet(1, StartTime)));
+}
+
+TEST(reporters, receiver_ignores_foreign_reports) {
+    packet::Queue queue;
+    SenderReporter sender(queue, SampleRate);
+    ReceiverReporter receiver(ReceiverSSRC, SampleRate);
+
+    packet::PacketPtr pp = new_rtp_packet(0, StartTime);
+    sender.write(pp);
+    CHECK(!receiver.process_packet(*pp));
+
+    SenderReport sr;
+    CHECK(sender.build_report(sr, StartNtp, StartTime));
+    sr.ssrc = SenderSSRC + 1;
+
+    core::Slice<uint8_t> sr_data = new_buffer();
+    CHECK(Builder(sr_data).add_sender_report(sr, NULL, 0));
+
+    CHECK(!receiver.process_packet(*new_rtcp_packet(sr_data, StartTime)));
+    CHECK(!receiver.has_sender_report());
+}
+
+} // namespace rtcp
+} // namespace roc
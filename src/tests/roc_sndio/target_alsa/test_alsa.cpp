@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_sndio/alsa_sink.h"
+#include "roc_sndio/alsa_source.h"
+
+namespace roc {
+namespace sndio {
+
+namespace {
+
+enum { FrameSize = 512, SampleRate = 44100, ChMask = 0x3, NumFrames = 20 };
+
+// ALSA "null" PCM discards written samples and captures silence.
+// It's provided by alsa-lib, but may be missing in minimal configurations,
+// in which case the tests below are reported as skipped.
+const char* NullDevice = "null";
+
+} // namespace
+
+TEST_GROUP(alsa) {
+    Config config;
+
+    void setup() {
+        config.channels = ChMask;
+        config.sample_rate = SampleRate;
+        config.frame_size = FrameSize;
+    }
+};
+
+TEST(alsa, sink_error) {
+    AlsaSink sink(config);
+
+    CHECK(!sink.open("roc_test_nonexistent_device"));
+}
+
+TEST(alsa, sink_null_device) {
+    AlsaSink sink(config);
+
+    if (!sink.open(NullDevice)) {
+        UT_PRINT("skipping test: alsa 'null' device is not available");
+        TEST_EXIT;
+    }
+
+    CHECK(sink.has_clock());
+    CHECK(sink.sample_rate() == SampleRate);
+
+    audio::sample_t samples[FrameSize] = {};
+
+    for (size_t n = 0; n < NumFrames; n++) {
+        audio::Frame frame(samples, FrameSize);
+        sink.write(frame);
+    }
+
+    CHECK(sink.latency() >= 0);
+}
+
+TEST(alsa, source_null_device) {
+    AlsaSource source(config);
+
+    if (!source.open(NullDevice)) {
+        UT_PRINT("skipping test: alsa 'null' device is not available");
+        TEST_EXIT;
+    }
+
+    CHECK(source.has_clock());
+    CHECK(source.sample_rate() == SampleRate);
+}
+
+} // namespace sndio
+} // namespace roc
@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <stdio.h>
+
+#include "roc_core/stddefs.h"
+#include "roc_core/temp_file.h"
+#include "roc_sndio/wav_backend.h"
+#include "roc_sndio/wav_sink.h"
+#include "roc_sndio/wav_source.h"
+
+namespace roc {
+namespace sndio {
+
+namespace {
+
+enum {
+    FrameSize = 500,
+    NumFrames = 7,
+    SampleRate = 44100,
+    ChMask = 0x3,
+    NumCh = 2
+};
+
+audio::sample_t nth_sample(size_t n) {
+    return audio::sample_t(int(n % 257) - 128) / 128;
+}
+
+void write_file(const char* path, const uint8_t* data, size_t size) {
+    FILE* fp = fopen(path, "wb");
+    CHECK(fp);
+    UNSIGNED_LONGS_EQUAL(size, fwrite(data, 1, size, fp));
+    CHECK(fclose(fp) == 0);
+}
+
+void write_frames(WavSink& sink, size_t num_samples) {
+    audio::sample_t samples[FrameSize];
+
+    for (size_t off = 0; off < num_samples; off += FrameSize) {
+        for (size_t n = 0; n < FrameSize; n++) {
+            samples[n] = nth_sample(off + n);
+        }
+        audio::Frame frame(samples, FrameSize);
+        sink.write(frame);
+    }
+}
+
+void read_frames(WavSource& source, size_t num_samples) {
+    audio::sample_t samples[FrameSize];
+
+    for (size_t off = 0; off < num_samples; off += FrameSize) {
+        audio::Frame frame(samples, FrameSize);
+        CHECK(source.read(frame));
+
+        for (size_t n = 0; n < FrameSize; n++) {
+            if (off + n < num_samples) {
+                DOUBLES_EQUAL((double)nth_sample(off + n), (double)samples[n], 0);
+            } else {
+                DOUBLES_EQUAL(0, (double)samples[n], 0);
+            }
+        }
+    }
+
+    audio::Frame frame(samples, FrameSize);
+    CHECK(!source.read(frame));
+}
+
+} // namespace
+
+TEST_GROUP(wav) {
+    Config config;
+
+    void setup() {
+        config.channels = ChMask;
+        config.sample_rate = SampleRate;
+        config.frame_size = FrameSize;
+    }
+};
+
+TEST(wav, write_read) {
+    core::TempFile file("test.wav");
+
+    {
+        WavSink sink(config);
+        CHECK(sink.valid());
+        CHECK(sink.open(NULL, file.path()));
+
+        UNSIGNED_LONGS_EQUAL(SampleRate, sink.sample_rate());
+        CHECK(!sink.has_clock());
+
+        write_frames(sink, FrameSize * NumFrames);
+    }
+
+    config.sample_rate = 0;
+
+    WavSource source(config);
+    CHECK(source.valid());
+    CHECK(source.open(NULL, file.path()));
+
+    UNSIGNED_LONGS_EQUAL(SampleRate, source.sample_rate());
+    CHECK(!source.has_clock());
+
+    read_frames(source, FrameSize * NumFrames);
+}
+
+TEST(wav, write_read_raw) {
+    core::TempFile file("test.f32");
+
+    {
+        WavSink sink(config);
+        CHECK(sink.valid());
+        CHECK(sink.open("f32", file.path()));
+
+        write_frames(sink, FrameSize * NumFrames);
+    }
+
+    WavSource source(config);
+    CHECK(source.valid());
+    CHECK(source.open("f32", file.path()));
+
+    UNSIGNED_LONGS_EQUAL(SampleRate, source.sample_rate());
+
+    read_frames(source, FrameSize * NumFrames);
+}
+
+TEST(wav, read_before_close) {
+    core::TempFile file("test.wav");
+
+    WavSink sink(config);
+    CHECK(sink.valid());
+    CHECK(sink.open(NULL, file.path()));
+
+    write_frames(sink, FrameSize * NumFrames);
+
+    FILE* fp = fopen(file.path(), "rb");
+    CHECK(fp);
+    CHECK(fseek(fp, 0, SEEK_END) == 0);
+    LONGS_EQUAL(WavHeaderSize + FrameSize * NumFrames * sizeof(float), ftell(fp));
+    CHECK(fclose(fp) == 0);
+
+    config.sample_rate = 0;
+
+    WavSource source(config);
+    CHECK(source.valid());
+    CHECK(source.open(NULL, file.path()));
+
+    UNSIGNED_LONGS_EQUAL(SampleRate, source.sample_rate());
+
+    read_frames(source, FrameSize * NumFrames);
+}
+
+TEST(wav, read_partial_frame) {
+    enum { NumSamples = FrameSize * 2 + NumCh * 10 };
+
+    core::TempFile file("test.f32");
+
+    {
+        WavSink sink(config);
+        CHECK(sink.valid());
+        CHECK(sink.open("f32", file.path()));
+
+        audio::sample_t samples[NumSamples];
+        for (size_t n = 0; n < NumSamples; n++) {
+            samples[n] = nth_sample(n);
+        }
+        audio::Frame frame(samples, NumSamples);
+        sink.write(frame);
+    }
+
+    WavSource source(config);
+    CHECK(source.valid());
+    CHECK(source.open("f32", file.path()));
+
+    read_frames(source, NumSamples);
+}
+
+TEST(wav, read_int16) {
+    const uint8_t data[] = {
+        'R', 'I', 'F', 'F', 56, 0, 0, 0, 'W', 'A', 'V', 'E',
+        // fmt chunk: PCM, 2 channels, 44100 Hz, 16 bits
+        'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0, 2, 0, 0x44, 0xAC, 0, 0, 0x10, 0xB1, 2,
+        0, 4, 0, 16, 0,
+        // unknown chunk with odd size and padding
+        'x', 'y', 'z', ' ', 3, 0, 0, 0, 1, 2, 3, 0,
+        // data chunk with two frames
+        'd', 'a', 't', 'a', 8, 0, 0, 0, 0x00, 0x40, 0x00, 0xC0, 0xFF, 0x7F, 0x00, 0x80
+    };
+
+    core::TempFile file("test.wav");
+    write_file(file.path(), data, sizeof(data));
+
+    WavSource source(config);
+    CHECK(source.valid());
+    CHECK(source.open(NULL, file.path()));
+
+    UNSIGNED_LONGS_EQUAL(SampleRate, source.sample_rate());
+
+    audio::sample_t samples[6] = {};
+    audio::Frame frame(samples, 6);
+    CHECK(source.read(frame));
+
+    DOUBLES_EQUAL(0.5, (double)samples[0], 0);
+    DOUBLES_EQUAL(-0.5, (double)samples[1], 0);
+    DOUBLES_EQUAL(32767. / 32768., (double)samples[2], 0);
+    DOUBLES_EQUAL(-1.0, (double)samples[3], 0);
+    DOUBLES_EQUAL(0, (double)samples[4], 0);
+    DOUBLES_EQUAL(0, (double)samples[5], 0);
+
+    CHECK(!source.read(frame));
+}
+
+TEST(wav, read_int24) {
+    const uint8_t data[] = {
+        'R', 'I', 'F', 'F', 42, 0, 0, 0, 'W', 'A', 'V', 'E',
+        // fmt chunk: PCM, 2 channels, 48000 Hz, 24 bits
+        'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0, 2, 0, 0x80, 0xBB, 0, 0, 0x00, 0x65, 4,
+        0, 6, 0, 24, 0,
+        // data chunk with one frame
+        'd', 'a', 't', 'a', 6, 0, 0, 0, 0x00, 0x00, 0x40, 0x00, 0x00, 0xC0
+    };
+
+    core::TempFile file("test.wav");
+    write_file(file.path(), data, sizeof(data));
+
+    WavSource source(config);
+    CHECK(source.valid());
+    CHECK(source.open("wav", file.path()));
+
+    UNSIGNED_LONGS_EQUAL(48000, source.sample_rate());
+
+    audio::sample_t samples[2] = {};
+    audio::Frame frame(samples, 2);
+    CHECK(source.read(frame));
+
+    DOUBLES_EQUAL(0.5, (double)samples[0], 0);
+    DOUBLES_EQUAL(-0.5, (double)samples[1], 0);
+
+    CHECK(!source.read(frame));
+}
+
+TEST(wav, unsupported_encoding) {
+    const uint8_t data[] = {
+        'R', 'I', 'F', 'F', 38, 0, 0, 0, 'W', 'A', 'V', 'E',
+        // fmt chunk: PCM, 2 channels, 44100 Hz, 8 bits
+        'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0, 2, 0, 0x44, 0xAC, 0, 0, 0x88, 0x58, 1,
+        0, 2, 0, 8, 0,
+        // data chunk with one frame
+        'd', 'a', 't', 'a', 2, 0, 0, 0, 0x80, 0x80
+    };
+
+    core::TempFile file("test.wav");
+    write_file(file.path(), data, sizeof(data));
+
+    WavSource source(config);
+    CHECK(source.valid());
+    CHECK(!source.open(NULL, file.path()));
+
+    CHECK(!WavBackend::instance().probe(NULL, file.path(),
+                                        IBackend::FilterSource | IBackend::FilterFile));
+}
+
+TEST(wav, channels_mismatch) {
+    core::TempFile file("test.wav");
+
+    {
+        WavSink sink(config);
+        CHECK(sink.valid());
+        CHECK(sink.open(NULL, file.path()));
+
+        write_frames(sink, FrameSize);
+    }
+
+    config.channels = 0x1;
+
+    WavSource source(config);
+    CHECK(source.valid());
+    CHECK(!source.open(NULL, file.path()));
+}
+
+TEST(wav, probe) {
+    core::TempFile file("test.wav");
+
+    {
+        WavSink sink(config);
+        CHECK(sink.valid());
+        CHECK(sink.open(NULL, file.path()));
+    }
+
+    const int source_flags = IBackend::FilterSource | IBackend::FilterFile;
+    const int sink_flags = IBackend::FilterSink | IBackend::FilterFile;
+
+    CHECK(WavBackend::instance().probe(NULL, file.path(), source_flags));
+    CHECK(WavBackend::instance().probe("wav", file.path(), source_flags));
+    CHECK(!WavBackend::instance().probe("mp3", file.path(), source_flags));
+    CHECK(!WavBackend::instance().probe(NULL, file.path(), IBackend::FilterSource));
+
+    CHECK(WavBackend::instance().probe(NULL, "out.wav", sink_flags));
+    CHECK(WavBackend::instance().probe(NULL, "out.f32", sink_flags));
+    CHECK(WavBackend::instance().probe("f32", "out", sink_flags));
+    CHECK(!WavBackend::instance().probe(NULL, "out.mp3", sink_flags));
+    CHECK(!WavBackend::instance().probe(NULL, "-", sink_flags));
+}
+
+} // namespace sndio
+} // namespace roc
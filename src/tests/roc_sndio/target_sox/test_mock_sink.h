@@ -19,7 +19,8 @@ namespace sndio {
 class MockSink : public ISink {
 public:
     MockSink()
-        : pos_(0) {
+        : pos_(0)
+        , latency_(0) {
     }
 
     virtual size_t sample_rate() const {
@@ -30,6 +31,10 @@ public:
         return false;
     }
 
+    virtual core::nanoseconds_t latency() const {
+        return latency_;
+    }
+
     virtual void write(audio::Frame& frame) {
         CHECK(pos_ + frame.size() <= MaxSz);
 
@@ -37,6 +42,10 @@ public:
         pos_ += frame.size();
     }
 
+    void set_latency(core::nanoseconds_t latency) {
+        latency_ = latency;
+    }
+
     void check(size_t offset, size_t size) {
         UNSIGNED_LONGS_EQUAL(pos_, size);
 
@@ -54,6 +63,7 @@ private:
 
     audio::sample_t samples_[MaxSz];
     size_t pos_;
+    core::nanoseconds_t latency_;
 };
 
 } // namespace sndio
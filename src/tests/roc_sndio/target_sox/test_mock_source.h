@@ -20,7 +20,8 @@ class MockSource : public ISource {
 public:
     MockSource()
         : pos_(0)
-        , size_(0) {
+        , size_(0)
+        , sink_latency_(0) {
     }
 
     virtual size_t sample_rate() const {
@@ -43,6 +44,10 @@ public:
         FAIL("not implemented");
     }
 
+    virtual void set_sink_latency(core::nanoseconds_t latency) {
+        sink_latency_ = latency;
+    }
+
     virtual bool read(audio::Frame& frame) {
         size_t ns = frame.size();
         if (ns > size_ - pos_) {
@@ -74,6 +79,10 @@ public:
         return pos_;
     }
 
+    core::nanoseconds_t sink_latency() const {
+        return sink_latency_;
+    }
+
 private:
     enum { MaxSz = 256 * 1024 };
 
@@ -84,6 +93,7 @@ private:
     audio::sample_t samples_[MaxSz];
     size_t pos_;
     size_t size_;
+    core::nanoseconds_t sink_latency_;
 };
 
 } // namespace sndio
@@ -118,5 +118,21 @@ TEST(pump, write_overwrite_read) {
     mock_writer.check(num_returned1, num_returned2);
 }
 
+TEST(pump, sink_latency) {
+    enum { NumSamples = FrameSize * 10 };
+
+    MockSource mock_source;
+    mock_source.add(NumSamples);
+
+    MockSink mock_sink;
+    mock_sink.set_latency(25 * core::Millisecond);
+
+    Pump pump(buffer_pool, mock_source, mock_sink, FrameSize, Pump::ModeOneshot);
+    CHECK(pump.valid());
+    CHECK(pump.run());
+
+    CHECK(mock_source.sink_latency() == 25 * core::Millisecond);
+}
+
 } // namespace sndio
 } // namespace roc
@@ -14,6 +14,7 @@
 #include "roc_core/scoped_destructor.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_pipeline/converter.h"
+#include "roc_pipeline/parallel_converter.h"
 #include "roc_sndio/backend_dispatcher.h"
 #include "roc_sndio/print_drivers.h"
 #include "roc_sndio/pump.h"
@@ -133,6 +134,22 @@ int main(int argc, char** argv) {
     config.resampling = !args.no_resampling_flag;
     config.poisoning = args.poisoning_flag;
 
+    if (args.threads_given) {
+        if (args.threads_arg <= 0) {
+            roc_log(LogError, "invalid --threads: should be > 0");
+            return 1;
+        }
+        config.num_threads = (size_t)args.threads_arg;
+    }
+
+    if (args.chunk_size_given) {
+        if (args.chunk_size_arg <= 0) {
+            roc_log(LogError, "invalid --chunk-size: should be > 0");
+            return 1;
+        }
+        config.chunk_frames = (size_t)args.chunk_size_arg;
+    }
+
     audio::IWriter* output_writer = NULL;
 
     sndio::Config sink_config;
@@ -156,6 +173,23 @@ int main(int argc, char** argv) {
         output_writer = sink.get();
     }
 
+    if (config.num_threads > 1) {
+        if (!config.resampling) {
+            roc_log(LogError, "--threads requires resampling to be enabled");
+            return 1;
+        }
+
+        pipeline::ParallelConverter converter(config, pool, allocator);
+        if (!converter.valid()) {
+            roc_log(LogError, "can't create parallel converter pipeline");
+            return 1;
+        }
+
+        const bool ok = converter.run(*source, output_writer);
+
+        return ok ? 0 : 1;
+    }
+
     pipeline::Converter converter(config, output_writer, pool, allocator);
     if (!converter.valid()) {
         roc_log(LogError, "can't create converter pipeline");
@@ -6,6 +6,8 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <stdlib.h>
+
 #include "roc_audio/resampler_profile.h"
 #include "roc_core/array.h"
 #include "roc_core/colors.h"
@@ -14,8 +16,11 @@
 #include "roc_core/log.h"
 #include "roc_core/parse_duration.h"
 #include "roc_core/scoped_destructor.h"
+#include "roc_core/thread_params.h"
+#include "roc_core/trace_dump.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_netio/transceiver.h"
+#include "roc_packet/pcap_writer.h"
 #include "roc_pipeline/parse_port.h"
 #include "roc_pipeline/receiver.h"
 #include "roc_sndio/backend_dispatcher.h"
@@ -60,6 +65,17 @@ int main(int argc, char** argv) {
         break;
     }
 
+    if (!core::Logger::instance().set_async(core::AsyncEnabled)) {
+        roc_log(LogError, "can't enable asynchronous logging");
+    }
+
+#ifndef ROC_ENABLE_TRACING
+    if (args.trace_given) {
+        roc_log(LogError, "--trace requires a build with --enable-tracing");
+        return 1;
+    }
+#endif
+
     core::HeapAllocator allocator;
 
     if (args.list_drivers_given) {
@@ -71,6 +87,11 @@ int main(int argc, char** argv) {
 
     pipeline::ReceiverConfig config;
 
+    if (args.low_latency_flag) {
+        config.common.internal_frame_size = pipeline::LowLatencyInternalFrameSize;
+        config.default_session.target_latency = pipeline::LowLatencyTargetLatency;
+    }
+
     size_t max_packet_size = 2048;
     if (args.packet_limit_given) {
         if (args.packet_limit_arg <= 0) {
@@ -210,6 +231,8 @@ int main(int argc, char** argv) {
         }
     }
 
+    config.default_session.fec_reader.early_repair = args.fec_early_repair_flag;
+
     config.common.poisoning = args.poisoning_flag;
     config.common.beeping = args.beeping_flag;
 
@@ -217,7 +240,7 @@ int main(int argc, char** argv) {
                                                args.poisoning_flag);
     core::BufferPool<audio::sample_t> sample_buffer_pool(
         allocator, config.common.internal_frame_size, args.poisoning_flag);
-    packet::PacketPool packet_pool(allocator, args.poisoning_flag);
+    packet::PacketPool packet_pool(allocator, args.poisoning_flag, max_packet_size);
 
     core::UniquePtr<sndio::ISink> sink(
         sndio::BackendDispatcher::instance().open_sink(allocator, args.driver_arg,
@@ -257,7 +280,66 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    netio::Transceiver trx(packet_pool, byte_buffer_pool, allocator);
+    packet::PcapWriter capture(receiver);
+    if (args.capture_given) {
+        if (!capture.open(args.capture_arg)) {
+            roc_log(LogError, "can't open --capture file: %s", args.capture_arg);
+            return 1;
+        }
+    }
+
+    packet::IWriter& packet_writer =
+        args.capture_given ? (packet::IWriter&)capture : (packet::IWriter&)receiver;
+
+    core::ThreadParams thread_params;
+
+    switch ((unsigned)args.sched_policy_arg) {
+    case sched_policy_arg_fifo:
+        thread_params.policy = core::ThreadPolicyFifo;
+        break;
+
+    case sched_policy_arg_rr:
+        thread_params.policy = core::ThreadPolicyRoundRobin;
+        break;
+
+    default:
+        break;
+    }
+
+    if (args.sched_priority_given) {
+        if (thread_params.policy == core::ThreadPolicyDefault) {
+            roc_log(LogError, "--sched-priority requires --sched-policy=fifo or rr");
+            return 1;
+        }
+        thread_params.priority = args.sched_priority_arg;
+    } else if (thread_params.policy != core::ThreadPolicyDefault) {
+        roc_log(LogError, "--sched-policy=fifo or rr requires --sched-priority");
+        return 1;
+    }
+
+    if (args.cpu_mask_given) {
+        char* end = NULL;
+        thread_params.cpu_mask = strtoul(args.cpu_mask_arg, &end, 0);
+        if (!*args.cpu_mask_arg || *end || thread_params.cpu_mask == 0) {
+            roc_log(LogError, "invalid --cpu-mask: %s", args.cpu_mask_arg);
+            return 1;
+        }
+    }
+
+    netio::TransceiverConfig trx_config;
+    trx_config.thread_params = thread_params;
+
+    if (args.net_threads_given) {
+        if (args.net_threads_arg <= 0) {
+            roc_log(LogError, "invalid --net-threads: should be > 0");
+            return 1;
+        }
+        trx_config.num_loops = (size_t)args.net_threads_arg;
+    }
+
+    trx_config.reuse_port = args.reuse_port_flag;
+
+    netio::Transceiver trx(trx_config, packet_pool, byte_buffer_pool, allocator);
     if (!trx.valid()) {
         roc_log(LogError, "can't create network transceiver");
         return 1;
@@ -274,7 +356,13 @@ int main(int argc, char** argv) {
             roc_log(LogError, "can't parse source port: %s", args.source_arg[n]);
             return 1;
         }
-        if (!trx.add_udp_receiver(port.address, receiver)) {
+        if (args.miface_given && port.address.multicast()) {
+            if (!port.address.set_miface(args.miface_arg)) {
+                roc_log(LogError, "invalid --miface: %s", args.miface_arg);
+                return 1;
+            }
+        }
+        if (!trx.add_udp_receiver(port.address, packet_writer)) {
             roc_log(LogError, "can't bind source port: %s", args.source_arg[n]);
             return 1;
         }
@@ -290,7 +378,13 @@ int main(int argc, char** argv) {
             roc_log(LogError, "can't parse repair port: %s", args.repair_arg[n]);
             return 1;
         }
-        if (!trx.add_udp_receiver(port.address, receiver)) {
+        if (args.miface_given && port.address.multicast()) {
+            if (!port.address.set_miface(args.miface_arg)) {
+                roc_log(LogError, "invalid --miface: %s", args.miface_arg);
+                return 1;
+            }
+        }
+        if (!trx.add_udp_receiver(port.address, packet_writer)) {
             roc_log(LogError, "can't bind repair port: %s", args.repair_arg[n]);
             return 1;
         }
@@ -300,7 +394,56 @@ int main(int argc, char** argv) {
         }
     }
 
-    const bool ok = pump.run();
+    if (args.control_given) {
+        pipeline::PortConfig port;
+        if (!pipeline::parse_port(pipeline::Port_Control, args.control_arg, port)) {
+            roc_log(LogError, "can't parse control port: %s", args.control_arg);
+            return 1;
+        }
+        if (args.miface_given && port.address.multicast()) {
+            if (!port.address.set_miface(args.miface_arg)) {
+                roc_log(LogError, "invalid --miface: %s", args.miface_arg);
+                return 1;
+            }
+        }
+        if (!trx.add_udp_receiver(port.address, packet_writer)) {
+            roc_log(LogError, "can't bind control port: %s", args.control_arg);
+            return 1;
+        }
+        if (!receiver.add_port(port)) {
+            roc_log(LogError, "can't initialize control port: %s", args.control_arg);
+            return 1;
+        }
+
+        // receiver reports are sent to the sender address from a random port
+        packet::Address report_address;
+        if (port.address.version() == 6) {
+            report_address.set_ipv6("::", 0);
+        } else {
+            report_address.set_ipv4("0.0.0.0", 0);
+        }
+
+        packet::IWriter* report_writer = trx.add_udp_sender(report_address);
+        if (!report_writer) {
+            roc_log(LogError, "can't open port for receiver reports");
+            return 1;
+        }
+
+        receiver.set_control_writer(report_writer);
+    }
+
+    // audio is processed on the main thread
+    core::set_thread_params(thread_params);
+
+    bool ok = pump.run();
+
+    if (args.trace_given) {
+        core::print_trace_histogram();
+
+        if (!core::dump_trace_json(args.trace_arg)) {
+            ok = false;
+        }
+    }
 
     return ok ? 0 : 1;
 }
@@ -0,0 +1,417 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "roc_audio/resampler_profile.h"
+#include "roc_core/array.h"
+#include "roc_core/colors.h"
+#include "roc_core/crash.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/log.h"
+#include "roc_core/parse_duration.h"
+#include "roc_core/scoped_destructor.h"
+#include "roc_core/time.h"
+#include "roc_core/unique_ptr.h"
+#include "roc_packet/pcap_reader.h"
+#include "roc_pipeline/parse_port.h"
+#include "roc_pipeline/receiver.h"
+#include "roc_sndio/backend_dispatcher.h"
+
+#include "roc_replay/cmdline.h"
+
+using namespace roc;
+
+namespace {
+
+typedef core::Array<pipeline::PortConfig> PortArray;
+
+bool add_ports(pipeline::Receiver& receiver,
+               PortArray& ports,
+               pipeline::PortType type,
+               const char* name,
+               char** port_args,
+               size_t n_ports) {
+    for (size_t n = 0; n < n_ports; n++) {
+        pipeline::PortConfig port;
+        if (!pipeline::parse_port(type, port_args[n], port)) {
+            roc_log(LogError, "can't parse %s port: %s", name, port_args[n]);
+            return false;
+        }
+        if (!receiver.add_port(port)) {
+            roc_log(LogError, "can't initialize %s port: %s", name, port_args[n]);
+            return false;
+        }
+        ports.push_back(port);
+    }
+    return true;
+}
+
+// Packets are routed by destination port number only, since the recorded
+// destination address is the address the original receiver was bound to.
+const pipeline::PortConfig* find_port(const PortArray& ports,
+                                      const packet::Address& addr) {
+    for (size_t n = 0; n < ports.size(); n++) {
+        if (ports[n].address.port() == addr.port()) {
+            return &ports[n];
+        }
+    }
+    return NULL;
+}
+
+core::nanoseconds_t thread_cpu_time() {
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0;
+    }
+    return core::nanoseconds_t(ts.tv_sec) * core::Second + ts.tv_nsec;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    core::CrashHandler crash_handler;
+
+    gengetopt_args_info args;
+
+    const int code = cmdline_parser(argc, argv, &args);
+    if (code != 0) {
+        return code;
+    }
+
+    core::ScopedDestructor<gengetopt_args_info*, cmdline_parser_free> args_destructor(
+        &args);
+
+    core::Logger::instance().set_level(
+        LogLevel(core::DefaultLogLevel + args.verbose_given));
+
+    switch ((unsigned)args.color_arg) {
+    case color_arg_auto:
+        core::Logger::instance().set_colors(
+            core::colors_available() ? core::ColorsEnabled : core::ColorsDisabled);
+        break;
+
+    case color_arg_always:
+        core::Logger::instance().set_colors(core::ColorsMode(core::ColorsEnabled));
+        break;
+
+    case color_arg_never:
+        core::Logger::instance().set_colors(core::ColorsMode(core::ColorsDisabled));
+        break;
+
+    default:
+        break;
+    }
+
+    double speed = 1;
+    if (args.speed_given) {
+        if (args.speed_arg < 0) {
+            roc_log(LogError, "invalid --speed: should be >= 0");
+            return 1;
+        }
+        speed = args.speed_arg;
+    }
+
+    if (args.benchmark_flag) {
+        if (args.speed_given && speed != 0) {
+            roc_log(LogError, "--benchmark can't be used with non-zero --speed");
+            return 1;
+        }
+        speed = 0;
+    }
+
+    core::HeapAllocator allocator;
+
+    pipeline::ReceiverConfig config;
+
+    if (args.low_latency_flag) {
+        config.common.internal_frame_size = pipeline::LowLatencyInternalFrameSize;
+        config.default_session.target_latency = pipeline::LowLatencyTargetLatency;
+    }
+
+    size_t max_packet_size = 2048;
+    if (args.packet_limit_given) {
+        if (args.packet_limit_arg <= 0) {
+            roc_log(LogError, "invalid --packet-limit: should be > 0");
+            return 1;
+        }
+        max_packet_size = (size_t)args.packet_limit_arg;
+    }
+
+    if (args.frame_size_given) {
+        if (args.frame_size_arg <= 0) {
+            roc_log(LogError, "invalid --frame-size: should be > 0");
+            return 1;
+        }
+        config.common.internal_frame_size = (size_t)args.frame_size_arg;
+    }
+
+    sndio::BackendDispatcher::instance().set_frame_size(
+        config.common.internal_frame_size);
+
+    if (args.sess_latency_given) {
+        if (!core::parse_duration(args.sess_latency_arg,
+                                  config.default_session.target_latency)) {
+            roc_log(LogError, "invalid --sess-latency");
+            return 1;
+        }
+    }
+
+    if (args.min_latency_given) {
+        if (!core::parse_duration(args.min_latency_arg,
+                                  config.default_session.latency_monitor.min_latency)) {
+            roc_log(LogError, "invalid --min-latency");
+            return 1;
+        }
+    } else {
+        config.default_session.latency_monitor.min_latency =
+            config.default_session.target_latency * pipeline::DefaultMinLatencyFactor;
+    }
+
+    if (args.max_latency_given) {
+        if (!core::parse_duration(args.max_latency_arg,
+                                  config.default_session.latency_monitor.max_latency)) {
+            roc_log(LogError, "invalid --max-latency");
+            return 1;
+        }
+    } else {
+        config.default_session.latency_monitor.max_latency =
+            config.default_session.target_latency * pipeline::DefaultMaxLatencyFactor;
+    }
+
+    if (args.np_timeout_given) {
+        if (!core::parse_duration(args.np_timeout_arg,
+                                  config.default_session.watchdog.no_playback_timeout)) {
+            roc_log(LogError, "invalid --np-timeout");
+            return 1;
+        }
+    }
+
+    if (args.bp_timeout_given) {
+        if (!core::parse_duration(
+                args.bp_timeout_arg,
+                config.default_session.watchdog.broken_playback_timeout)) {
+            roc_log(LogError, "invalid --bp-timeout");
+            return 1;
+        }
+    }
+
+    config.common.resampling = !args.no_resampling_flag;
+
+    switch ((unsigned)args.resampler_profile_arg) {
+    case resampler_profile_arg_low:
+        config.default_session.resampler =
+            audio::resampler_profile(audio::ResamplerProfile_Low);
+        break;
+
+    case resampler_profile_arg_medium:
+        config.default_session.resampler =
+            audio::resampler_profile(audio::ResamplerProfile_Medium);
+        break;
+
+    case resampler_profile_arg_high:
+        config.default_session.resampler =
+            audio::resampler_profile(audio::ResamplerProfile_High);
+        break;
+
+    default:
+        break;
+    }
+
+    sndio::Config sink_config;
+
+    sink_config.channels = config.common.output_channels;
+    sink_config.frame_size = config.common.internal_frame_size;
+    sink_config.sample_rate = pipeline::DefaultSampleRate;
+
+    if (args.rate_given) {
+        if (args.rate_arg <= 0) {
+            roc_log(LogError, "invalid --rate: should be > 0");
+            return 1;
+        }
+        sink_config.sample_rate = (size_t)args.rate_arg;
+    }
+
+    config.common.poisoning = args.poisoning_flag;
+    config.common.beeping = args.beeping_flag;
+
+    // packets are delivered according to the recorded timestamps, so the
+    // receiver itself should not wait for the clock
+    config.common.timing = false;
+
+    core::BufferPool<uint8_t> byte_buffer_pool(allocator, max_packet_size,
+                                               args.poisoning_flag);
+    core::BufferPool<audio::sample_t> sample_buffer_pool(
+        allocator, config.common.internal_frame_size, args.poisoning_flag);
+    packet::PacketPool packet_pool(allocator, args.poisoning_flag, max_packet_size);
+
+    core::UniquePtr<sndio::ISink> sink;
+    if (args.output_given || args.driver_given) {
+        sink.reset(sndio::BackendDispatcher::instance().open_sink(
+                       allocator, args.driver_arg, args.output_arg, sink_config),
+                   allocator);
+        if (!sink) {
+            roc_log(LogError, "can't open output file or device: driver=%s output=%s",
+                    args.driver_arg, args.output_arg);
+            return 1;
+        }
+        if (sink->has_clock() && speed != 1) {
+            roc_log(LogError,
+                    "output device has its own clock, --speed and --benchmark"
+                    " require a file output");
+            return 1;
+        }
+        if (sink->sample_rate() != 0) {
+            sink_config.sample_rate = sink->sample_rate();
+        }
+    }
+
+    config.common.output_sample_rate = sink_config.sample_rate;
+
+    fec::CodecMap codec_map;
+    rtp::FormatMap format_map;
+
+    pipeline::Receiver receiver(config, codec_map, format_map, packet_pool,
+                                byte_buffer_pool, sample_buffer_pool, allocator);
+    if (!receiver.valid()) {
+        roc_log(LogError, "can't create receiver pipeline");
+        return 1;
+    }
+
+    if (args.source_given == 0 && args.repair_given == 0) {
+        roc_log(LogError, "at least one --source or --repair port should be specified");
+        return 1;
+    }
+
+    PortArray ports(allocator);
+    if (!ports.grow(args.source_given + args.repair_given)) {
+        roc_log(LogError, "can't allocate ports");
+        return 1;
+    }
+
+    if (!add_ports(receiver, ports, pipeline::Port_AudioSource, "source",
+                   args.source_arg, args.source_given)) {
+        return 1;
+    }
+
+    if (!add_ports(receiver, ports, pipeline::Port_AudioRepair, "repair",
+                   args.repair_arg, args.repair_given)) {
+        return 1;
+    }
+
+    packet::PcapReader reader(packet_pool, byte_buffer_pool);
+    if (!reader.open(args.input_arg)) {
+        roc_log(LogError, "can't open input file: %s", args.input_arg);
+        return 1;
+    }
+
+    packet::PacketPtr next = reader.read();
+    if (!next) {
+        roc_log(LogError, "no udp packets in input file: %s", args.input_arg);
+        return 1;
+    }
+
+    core::Slice<audio::sample_t> buffer =
+        new (sample_buffer_pool) core::Buffer<audio::sample_t>(sample_buffer_pool);
+    if (!buffer) {
+        roc_log(LogError, "can't allocate buffer");
+        return 1;
+    }
+    buffer.resize(config.common.internal_frame_size);
+
+    const size_t num_channels = packet::num_channels(config.common.output_channels);
+
+    const core::nanoseconds_t frame_duration = core::nanoseconds_t(
+        buffer.size() / num_channels * core::Second / config.common.output_sample_rate);
+
+    // after the last packet, keep reading until sessions are terminated or
+    // all buffered audio is surely played
+    const core::nanoseconds_t drain_duration =
+        config.default_session.latency_monitor.max_latency;
+
+    const core::nanoseconds_t first_ts = next->udp()->receive_timestamp;
+    const core::nanoseconds_t start_ts = core::timestamp();
+
+    // replay position relative to the first recorded packet
+    core::nanoseconds_t position = 0;
+    core::nanoseconds_t last_position = 0;
+
+    size_t n_packets = 0;
+    size_t n_dropped = 0;
+    size_t n_frames = 0;
+
+    core::nanoseconds_t cpu_time = 0;
+
+    roc_log(LogInfo, "replaying %s: speed=%.3f", args.input_arg, speed);
+
+    for (;;) {
+        const core::nanoseconds_t cpu_start = thread_cpu_time();
+
+        while (next && next->udp()->receive_timestamp - first_ts <= position) {
+            last_position = next->udp()->receive_timestamp - first_ts;
+
+            if (const pipeline::PortConfig* port =
+                    find_port(ports, next->udp()->dst_addr)) {
+                next->udp()->dst_addr = port->address;
+                next->udp()->receive_timestamp = start_ts + last_position;
+
+                receiver.write(next);
+                n_packets++;
+            } else {
+                n_dropped++;
+            }
+
+            next = reader.read();
+        }
+
+        if (!next && n_packets != 0 && receiver.num_sessions() == 0) {
+            break;
+        }
+
+        if (!next && position - last_position > drain_duration) {
+            break;
+        }
+
+        audio::Frame frame(buffer.data(), buffer.size());
+        receiver.read(frame);
+
+        cpu_time += thread_cpu_time() - cpu_start;
+
+        if (sink) {
+            sink->write(frame);
+        }
+
+        n_frames++;
+        position += frame_duration;
+
+        if (speed != 0 && !(sink && sink->has_clock())) {
+            core::sleep_until(start_ts + core::nanoseconds_t(double(position) / speed));
+        }
+    }
+
+    const double audio_sec = double(position) / core::Second;
+    const double wall_sec = double(core::timestamp() - start_ts) / core::Second;
+    const double cpu_sec = double(cpu_time) / core::Second;
+
+    roc_log(LogInfo,
+            "replayed %lu packets (%lu dropped as unrouted) and %lu frames:"
+            " audio=%.3fs wall=%.3fs",
+            (unsigned long)n_packets, (unsigned long)n_dropped, (unsigned long)n_frames,
+            audio_sec, wall_sec);
+
+    if (args.benchmark_flag) {
+        printf("audio duration:  %.3f s\n", audio_sec);
+        printf("receiver cpu:    %.3f s\n", cpu_sec);
+        printf("cpu per second:  %.3f ms\n",
+               audio_sec > 0 ? cpu_sec * 1000 / audio_sec : 0.);
+        printf("realtime factor: %.1fx\n", cpu_sec > 0 ? audio_sec / cpu_sec : 0.);
+    }
+
+    return 0;
+}
@@ -6,16 +6,28 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "roc_audio/resampler_profile.h"
 #include "roc_core/array.h"
+#include "roc_core/atomic.h"
 #include "roc_core/colors.h"
 #include "roc_core/crash.h"
+#include "roc_core/deadline_timer.h"
 #include "roc_core/heap_allocator.h"
 #include "roc_core/log.h"
 #include "roc_core/parse_duration.h"
 #include "roc_core/scoped_destructor.h"
+#include "roc_core/thread.h"
+#include "roc_core/thread_params.h"
+#include "roc_core/time.h"
+#include "roc_core/trace_dump.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_netio/transceiver.h"
+#include "roc_packet/impairer.h"
 #include "roc_pipeline/parse_port.h"
 #include "roc_pipeline/port_utils.h"
 #include "roc_pipeline/sender.h"
@@ -27,6 +39,267 @@
 
 using namespace roc;
 
+namespace {
+
+enum { LoadToneFreq = 440 };
+
+// How often delayed packets are delivered by impairer.
+const core::nanoseconds_t ImpairerTickInterval = core::Millisecond;
+
+// Advances impairer time on its own thread, so that delayed packets are sent
+// when they're due, and not when the next packet is written.
+class ImpairerTicker : public core::Thread {
+public:
+    explicit ImpairerTicker(packet::Impairer& impairer)
+        : impairer_(impairer)
+        , timer_(0)
+        , stop_(false) {
+    }
+
+    virtual ~ImpairerTicker() {
+        stop();
+    }
+
+    void stop() {
+        if (joinable()) {
+            stop_ = true;
+            join();
+        }
+    }
+
+private:
+    virtual void run() {
+        while (!stop_) {
+            timer_.wait(core::timestamp() + ImpairerTickInterval);
+            impairer_.advance(core::timestamp());
+        }
+    }
+
+    packet::Impairer& impairer_;
+    core::DeadlineTimer timer_;
+    core::Atomic stop_;
+};
+
+// Senders created in load testing mode.
+class SenderList : public core::NonCopyable<> {
+public:
+    explicit SenderList(core::IAllocator& allocator)
+        : allocator_(allocator)
+        , senders_(allocator) {
+    }
+
+    ~SenderList() {
+        for (size_t n = 0; n < senders_.size(); n++) {
+            allocator_.destroy(*senders_[n]);
+        }
+    }
+
+    bool reserve(size_t n) {
+        return senders_.grow(n);
+    }
+
+    void add(pipeline::Sender& sender) {
+        senders_.push_back(&sender);
+    }
+
+    size_t size() const {
+        return senders_.size();
+    }
+
+    pipeline::Sender& operator[](size_t n) {
+        return *senders_[n];
+    }
+
+private:
+    core::IAllocator& allocator_;
+    core::Array<pipeline::Sender*> senders_;
+};
+
+// Statistics for one report interval of load testing.
+struct LoadReport {
+    core::nanoseconds_t start_time;
+    size_t start_pos;
+    size_t start_packets;
+
+    size_t n_frames;
+    core::nanoseconds_t pacing_sum;
+    core::nanoseconds_t pacing_max;
+
+    LoadReport(core::nanoseconds_t time, size_t pos, size_t packets)
+        : start_time(time)
+        , start_pos(pos)
+        , start_packets(packets)
+        , n_frames(0)
+        , pacing_sum(0)
+        , pacing_max(0) {
+    }
+};
+
+bool add_destinations(pipeline::Sender& sender, const gengetopt_args_info& args) {
+    for (size_t n = 1; n < args.source_given; n++) {
+        pipeline::PortConfig port;
+        if (!pipeline::parse_port(pipeline::Port_AudioSource, args.source_arg[n], port)) {
+            roc_log(LogError, "can't parse remote source port: %s", args.source_arg[n]);
+            return false;
+        }
+        if (!sender.add_destination(port)) {
+            roc_log(LogError, "can't add remote source port: %s", args.source_arg[n]);
+            return false;
+        }
+    }
+
+    for (size_t n = 1; n < args.repair_given; n++) {
+        pipeline::PortConfig port;
+        if (!pipeline::parse_port(pipeline::Port_AudioRepair, args.repair_arg[n], port)) {
+            roc_log(LogError, "can't parse remote repair port: %s", args.repair_arg[n]);
+            return false;
+        }
+        if (!sender.add_destination(port)) {
+            roc_log(LogError, "can't add remote repair port: %s", args.repair_arg[n]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t count_packets(SenderList& senders) {
+    size_t n_packets = 0;
+
+    for (size_t n = 0; n < senders.size(); n++) {
+        pipeline::SenderStats stats;
+        senders[n].get_stats(stats);
+
+        n_packets += stats.source_packets + stats.repair_packets;
+    }
+
+    return n_packets;
+}
+
+// Achieved packet rate is measured by the system clock, nominal packet rate is
+// measured by the stream clock; they differ when the senders can't keep up.
+// Pacing error is how late frames were written compared to the schedule.
+void print_report(const char* name,
+                  const LoadReport& report,
+                  SenderList& senders,
+                  size_t pos,
+                  size_t sample_rate) {
+    const size_t n_packets = count_packets(senders) - report.start_packets;
+
+    const double wall_sec =
+        double(core::timestamp() - report.start_time) / core::Second;
+    const double stream_sec = double(pos - report.start_pos) / sample_rate;
+
+    const double pacing_avg = report.n_frames == 0
+        ? 0.
+        : double(report.pacing_sum) / report.n_frames / core::Millisecond;
+    const double pacing_max = double(report.pacing_max) / core::Millisecond;
+
+    printf("%s: streams=%lu packet_rate=%.1f/s nominal_rate=%.1f/s"
+           " pacing_avg=%.3fms pacing_max=%.3fms\n",
+           name, (unsigned long)senders.size(), wall_sec > 0 ? n_packets / wall_sec : 0.,
+           stream_sec > 0 ? n_packets / stream_sec : 0., pacing_avg, pacing_max);
+    fflush(stdout);
+}
+
+// Generates a sine wave and writes every frame to all senders, so that the
+// signal is computed once for all streams. Frames are paced by the system
+// clock instead of sender tickers, to measure pacing error.
+bool run_load(SenderList& senders,
+              core::BufferPool<audio::sample_t>& buffer_pool,
+              const pipeline::SenderConfig& config,
+              core::nanoseconds_t duration,
+              core::nanoseconds_t report_interval) {
+    const size_t num_ch = packet::num_channels(config.input_channels);
+    const size_t frame_size = config.internal_frame_size / num_ch * num_ch;
+
+    if (frame_size == 0 || buffer_pool.buffer_size() < frame_size) {
+        roc_log(LogError, "invalid frame size: %lu", (unsigned long)frame_size);
+        return false;
+    }
+
+    core::Slice<audio::sample_t> signal =
+        new (buffer_pool) core::Buffer<audio::sample_t>(buffer_pool);
+    core::Slice<audio::sample_t> scratch =
+        new (buffer_pool) core::Buffer<audio::sample_t>(buffer_pool);
+
+    if (!signal || !scratch) {
+        roc_log(LogError, "can't allocate frame buffer");
+        return false;
+    }
+
+    signal.resize(frame_size);
+    scratch.resize(frame_size);
+
+    const double step = 2 * M_PI * LoadToneFreq / config.input_sample_rate;
+    double phase = 0;
+
+    // position in samples per channel
+    size_t pos = 0;
+
+    const core::nanoseconds_t start_time = core::timestamp();
+
+    LoadReport total(start_time, pos, 0);
+    LoadReport report(start_time, pos, 0);
+
+    roc_log(LogInfo, "starting load testing: streams=%lu", (unsigned long)senders.size());
+
+    for (;;) {
+        const core::nanoseconds_t frame_time = core::nanoseconds_t(
+            double(pos) * core::Second / config.input_sample_rate);
+
+        if (duration > 0 && frame_time >= duration) {
+            break;
+        }
+
+        core::sleep_until(start_time + frame_time);
+
+        const core::nanoseconds_t pacing =
+            core::timestamp() - (start_time + frame_time);
+
+        for (size_t n = 0; n < frame_size; n += num_ch) {
+            const audio::sample_t sample = audio::sample_t(sin(phase) * 0.5);
+            for (size_t ch = 0; ch < num_ch; ch++) {
+                signal.data()[n + ch] = sample;
+            }
+            phase = fmod(phase + step, 2 * M_PI);
+        }
+
+        for (size_t n = 0; n < senders.size(); n++) {
+            // poisoning overwrites frame after use
+            if (config.poisoning) {
+                memcpy(scratch.data(), signal.data(),
+                       frame_size * sizeof(audio::sample_t));
+            }
+            audio::Frame frame(config.poisoning ? scratch.data() : signal.data(),
+                               frame_size);
+            senders[n].write(frame);
+        }
+
+        pos += frame_size / num_ch;
+
+        LoadReport* reports[] = { &total, &report };
+        for (size_t n = 0; n < 2; n++) {
+            reports[n]->n_frames++;
+            reports[n]->pacing_sum += pacing;
+            if (reports[n]->pacing_max < pacing) {
+                reports[n]->pacing_max = pacing;
+            }
+        }
+
+        if (core::timestamp() - report.start_time >= report_interval) {
+            print_report("interval", report, senders, pos, config.input_sample_rate);
+            report = LoadReport(core::timestamp(), pos, count_packets(senders));
+        }
+    }
+
+    print_report("total", total, senders, pos, config.input_sample_rate);
+
+    return true;
+}
+
+} // namespace
+
 int main(int argc, char** argv) {
     core::CrashHandler crash_handler;
 
@@ -61,6 +334,17 @@ int main(int argc, char** argv) {
         break;
     }
 
+    if (!core::Logger::instance().set_async(core::AsyncEnabled)) {
+        roc_log(LogError, "can't enable asynchronous logging");
+    }
+
+#ifndef ROC_ENABLE_TRACING
+    if (args.trace_given) {
+        roc_log(LogError, "--trace requires a build with --enable-tracing");
+        return 1;
+    }
+#endif
+
     core::HeapAllocator allocator;
 
     if (args.list_drivers_given) {
@@ -72,6 +356,13 @@ int main(int argc, char** argv) {
 
     pipeline::SenderConfig config;
 
+    if (args.low_latency_flag) {
+        config.packet_length = pipeline::LowLatencyPacketLength;
+        config.internal_frame_size = pipeline::LowLatencyInternalFrameSize;
+        config.fec_writer.n_source_packets = pipeline::LowLatencyFecSourcePackets;
+        config.fec_writer.n_repair_packets = pipeline::LowLatencyFecRepairPackets;
+    }
+
     if (args.packet_length_given) {
         if (!core::parse_duration(args.packet_length_arg, config.packet_length)) {
             roc_log(LogError, "invalid --packet-length");
@@ -100,18 +391,27 @@ int main(int argc, char** argv) {
 
     pipeline::PortConfig source_port;
     if (args.source_given) {
-        if (!pipeline::parse_port(pipeline::Port_AudioSource, args.source_arg,
+        if (!pipeline::parse_port(pipeline::Port_AudioSource, args.source_arg[0],
                                   source_port)) {
-            roc_log(LogError, "can't parse remote source port: %s", args.source_arg);
+            roc_log(LogError, "can't parse remote source port: %s", args.source_arg[0]);
             return 1;
         }
     }
 
     pipeline::PortConfig repair_port;
     if (args.repair_given) {
-        if (!pipeline::parse_port(pipeline::Port_AudioRepair, args.repair_arg,
+        if (!pipeline::parse_port(pipeline::Port_AudioRepair, args.repair_arg[0],
                                   repair_port)) {
-            roc_log(LogError, "can't parse remote repair port: %s", args.repair_arg);
+            roc_log(LogError, "can't parse remote repair port: %s", args.repair_arg[0]);
+            return 1;
+        }
+    }
+
+    pipeline::PortConfig control_port;
+    if (args.control_given) {
+        if (!pipeline::parse_port(pipeline::Port_Control, args.control_arg,
+                                  control_port)) {
+            roc_log(LogError, "can't parse remote control port: %s", args.control_arg);
             return 1;
         }
     }
@@ -196,29 +496,194 @@ int main(int argc, char** argv) {
     config.interleaving = args.interleaving_flag;
     config.poisoning = args.poisoning_flag;
 
+    packet::ImpairerConfig impairer_config;
+    impairer_config.realtime = true;
+
+    if (args.impair_loss_given) {
+        if (args.impair_loss_arg < 0 || args.impair_loss_arg > 100) {
+            roc_log(LogError, "invalid --impair-loss: should be in range [0; 100]");
+            return 1;
+        }
+        impairer_config.loss = float(args.impair_loss_arg / 100);
+    }
+
+    if (args.impair_burst_given) {
+        if (args.impair_burst_arg < 0 || args.impair_burst_arg > 100) {
+            roc_log(LogError, "invalid --impair-burst: should be in range [0; 100]");
+            return 1;
+        }
+        impairer_config.burst_start = float(args.impair_burst_arg / 100);
+    }
+
+    if (args.impair_burst_len_given) {
+        if (!args.impair_burst_given) {
+            roc_log(LogError, "--impair-burst-len requires --impair-burst");
+            return 1;
+        }
+        if (args.impair_burst_len_arg < 1) {
+            roc_log(LogError, "invalid --impair-burst-len: should be >= 1");
+            return 1;
+        }
+        impairer_config.burst_end = float(1 / args.impair_burst_len_arg);
+    }
+
+    if (args.impair_dup_given) {
+        if (args.impair_dup_arg < 0 || args.impair_dup_arg > 100) {
+            roc_log(LogError, "invalid --impair-dup: should be in range [0; 100]");
+            return 1;
+        }
+        impairer_config.duplication = float(args.impair_dup_arg / 100);
+    }
+
+    if (args.impair_jitter_given) {
+        if (!core::parse_duration(args.impair_jitter_arg, impairer_config.jitter)
+            || impairer_config.jitter < 0) {
+            roc_log(LogError, "invalid --impair-jitter");
+            return 1;
+        }
+    }
+
+    impairer_config.reordering = args.impair_reorder_flag;
+
+    if (args.impair_rate_given) {
+        if (args.impair_rate_arg <= 0) {
+            roc_log(LogError, "invalid --impair-rate: should be > 0");
+            return 1;
+        }
+        impairer_config.rate = (size_t)args.impair_rate_arg * 1000 / 8;
+    }
+
+    if (args.impair_queue_given) {
+        if (!args.impair_rate_given) {
+            roc_log(LogError, "--impair-queue requires --impair-rate");
+            return 1;
+        }
+        if (!core::parse_duration(args.impair_queue_arg,
+                                  impairer_config.max_queue_delay)
+            || impairer_config.max_queue_delay < 0) {
+            roc_log(LogError, "invalid --impair-queue");
+            return 1;
+        }
+    }
+
+    if (args.impair_seed_given) {
+        impairer_config.seed = (unsigned)args.impair_seed_arg;
+    }
+
+    const bool impair = args.impair_loss_given || args.impair_burst_given
+        || args.impair_dup_given || args.impair_jitter_given || args.impair_rate_given;
+
+    const bool load = args.load_streams_given;
+
+    core::nanoseconds_t load_duration = 0;
+    core::nanoseconds_t load_report = core::Second;
+
+    if (load) {
+        if (args.load_streams_arg <= 0) {
+            roc_log(LogError, "invalid --load-streams: should be > 0");
+            return 1;
+        }
+        if (args.input_given || args.driver_given) {
+            roc_log(LogError, "--load-streams can't be used with --input or --driver");
+            return 1;
+        }
+        if (impair) {
+            roc_log(LogError, "--load-streams can't be used with --impair options");
+            return 1;
+        }
+        if (!args.source_given) {
+            roc_log(LogError, "--load-streams requires --source");
+            return 1;
+        }
+        if (args.load_duration_given) {
+            if (!core::parse_duration(args.load_duration_arg, load_duration)
+                || load_duration <= 0) {
+                roc_log(LogError, "invalid --load-duration");
+                return 1;
+            }
+        }
+        if (args.load_report_given) {
+            if (!core::parse_duration(args.load_report_arg, load_report)
+                || load_report <= 0) {
+                roc_log(LogError, "invalid --load-report");
+                return 1;
+            }
+        }
+    } else if (args.load_duration_given || args.load_report_given) {
+        roc_log(LogError, "--load-duration and --load-report require --load-streams");
+        return 1;
+    }
+
     core::BufferPool<uint8_t> byte_buffer_pool(allocator, max_packet_size,
                                                args.poisoning_flag);
     core::BufferPool<audio::sample_t> sample_buffer_pool(
         allocator, config.internal_frame_size, args.poisoning_flag);
-    packet::PacketPool packet_pool(allocator, args.poisoning_flag);
-
-    core::UniquePtr<sndio::ISource> source(
-        sndio::BackendDispatcher::instance().open_source(allocator, args.driver_arg,
-                                                         args.input_arg, source_config),
-        allocator);
-    if (!source) {
-        roc_log(LogError, "can't open input file or device: driver=%s input=%s",
-                args.driver_arg, args.input_arg);
-        return 1;
-    }
+    packet::PacketPool packet_pool(allocator, args.poisoning_flag, max_packet_size);
+
+    core::UniquePtr<sndio::ISource> source;
+
+    if (load) {
+        // frames are paced by load generator
+        config.timing = false;
+        config.input_sample_rate = source_config.sample_rate != 0
+            ? source_config.sample_rate
+            : pipeline::DefaultSampleRate;
+    } else {
+        source.reset(sndio::BackendDispatcher::instance().open_source(
+                         allocator, args.driver_arg, args.input_arg, source_config),
+                     allocator);
+        if (!source) {
+            roc_log(LogError, "can't open input file or device: driver=%s input=%s",
+                    args.driver_arg, args.input_arg);
+            return 1;
+        }
 
-    config.timing = !source->has_clock();
-    config.input_sample_rate = source->sample_rate();
+        config.timing = !source->has_clock();
+        config.input_sample_rate = source->sample_rate();
+    }
 
     fec::CodecMap codec_map;
     rtp::FormatMap format_map;
 
-    netio::Transceiver trx(packet_pool, byte_buffer_pool, allocator);
+    core::ThreadParams thread_params;
+
+    switch ((unsigned)args.sched_policy_arg) {
+    case sched_policy_arg_fifo:
+        thread_params.policy = core::ThreadPolicyFifo;
+        break;
+
+    case sched_policy_arg_rr:
+        thread_params.policy = core::ThreadPolicyRoundRobin;
+        break;
+
+    default:
+        break;
+    }
+
+    if (args.sched_priority_given) {
+        if (thread_params.policy == core::ThreadPolicyDefault) {
+            roc_log(LogError, "--sched-priority requires --sched-policy=fifo or rr");
+            return 1;
+        }
+        thread_params.priority = args.sched_priority_arg;
+    } else if (thread_params.policy != core::ThreadPolicyDefault) {
+        roc_log(LogError, "--sched-policy=fifo or rr requires --sched-priority");
+        return 1;
+    }
+
+    if (args.cpu_mask_given) {
+        char* end = NULL;
+        thread_params.cpu_mask = strtoul(args.cpu_mask_arg, &end, 0);
+        if (!*args.cpu_mask_arg || *end || thread_params.cpu_mask == 0) {
+            roc_log(LogError, "invalid --cpu-mask: %s", args.cpu_mask_arg);
+            return 1;
+        }
+    }
+
+    netio::TransceiverConfig trx_config;
+    trx_config.thread_params = thread_params;
+
+    netio::Transceiver trx(trx_config, packet_pool, byte_buffer_pool, allocator);
     if (!trx.valid()) {
         roc_log(LogError, "can't create network transceiver");
         return 1;
@@ -233,29 +698,187 @@ int main(int argc, char** argv) {
     if (!local_addr.valid()) {
         roc_panic("can't initialize local address");
     }
-
-    packet::IWriter* udp_sender = trx.add_udp_sender(local_addr);
-    if (!udp_sender) {
-        roc_log(LogError, "can't create udp sender");
-        return 1;
+    if (args.miface_given) {
+        if (!local_addr.set_miface(args.miface_arg)) {
+            roc_log(LogError, "invalid --miface: should be IP address of the same"
+                              " family as remote ports");
+            return 1;
+        }
     }
 
-    pipeline::Sender sender(config, source_port, *udp_sender, repair_port, *udp_sender,
-                            codec_map, format_map, packet_pool, byte_buffer_pool,
-                            sample_buffer_pool, allocator);
-    if (!sender.valid()) {
-        roc_log(LogError, "can't create sender pipeline");
-        return 1;
-    }
+    // sender reports are sent from a separate port, and receiver reports
+    // sent back to that port are passed to the sender pipeline
+    const bool has_control = control_port.protocol != pipeline::Proto_None;
 
-    sndio::Pump pump(sample_buffer_pool, *source, sender, config.internal_frame_size,
-                     sndio::Pump::ModePermanent);
-    if (!pump.valid()) {
-        roc_log(LogError, "can't create audio pump");
-        return 1;
+    bool ok = true;
+
+    if (load) {
+        SenderList senders(allocator);
+        if (!senders.reserve((size_t)args.load_streams_arg)) {
+            roc_log(LogError, "can't allocate senders");
+            return 1;
+        }
+
+        core::Array<packet::Address> control_addrs(allocator);
+        if (has_control && !control_addrs.grow((size_t)args.load_streams_arg)) {
+            roc_log(LogError, "can't allocate control ports");
+            return 1;
+        }
+
+        // every stream has its own udp sender, and thus its own source port,
+        // and its own sender pipeline, and thus its own SSRC
+        for (size_t n = 0; n < (size_t)args.load_streams_arg; n++) {
+            packet::Address stream_addr = local_addr;
+
+            packet::IWriter* udp_sender = trx.add_udp_sender(stream_addr);
+            if (!udp_sender) {
+                roc_log(LogError, "can't create udp sender for stream %lu",
+                        (unsigned long)n);
+                return 1;
+            }
+
+            packet::IWriter* control_sender = udp_sender;
+            if (has_control) {
+                packet::Address control_addr = local_addr;
+
+                control_sender = trx.add_udp_sender(control_addr);
+                if (!control_sender) {
+                    roc_log(LogError, "can't create control port for stream %lu",
+                            (unsigned long)n);
+                    return 1;
+                }
+
+                control_addrs.push_back(control_addr);
+            }
+
+            pipeline::Sender* sender = new (allocator) pipeline::Sender(
+                config, source_port, *udp_sender, repair_port, *udp_sender,
+                control_port, *control_sender, codec_map, format_map, packet_pool,
+                byte_buffer_pool, sample_buffer_pool, allocator);
+            if (!sender) {
+                roc_log(LogError, "can't allocate sender pipeline");
+                return 1;
+            }
+            senders.add(*sender);
+
+            if (!sender->valid()) {
+                roc_log(LogError, "can't create sender pipeline");
+                return 1;
+            }
+            if (!add_destinations(*sender, args)) {
+                return 1;
+            }
+        }
+
+        for (size_t n = 0; n < control_addrs.size(); n++) {
+            if (!trx.start_receiving(control_addrs[n], senders[n])) {
+                roc_log(LogError, "can't receive control packets for stream %lu",
+                        (unsigned long)n);
+                ok = false;
+                break;
+            }
+        }
+
+        // audio is processed on the main thread
+        core::set_thread_params(thread_params);
+
+        if (ok) {
+            ok = run_load(senders, sample_buffer_pool, config, load_duration,
+                          load_report);
+        }
+
+        // stop passing control packets to senders before destroying them
+        for (size_t n = 0; n < control_addrs.size(); n++) {
+            trx.remove_port(control_addrs[n]);
+        }
+    } else {
+        packet::IWriter* udp_sender = trx.add_udp_sender(local_addr);
+        if (!udp_sender) {
+            roc_log(LogError, "can't create udp sender");
+            return 1;
+        }
+
+        packet::Impairer impairer(*udp_sender, packet_pool, impairer_config,
+                                  allocator);
+        if (!impairer.valid()) {
+            roc_log(LogError, "can't create impairer");
+            return 1;
+        }
+
+        ImpairerTicker impairer_ticker(impairer);
+        if (impair) {
+            core::ThreadParams ticker_params = thread_params;
+            ticker_params.set_name("roc-impairer");
+            impairer_ticker.set_params(ticker_params);
+
+            if (!impairer_ticker.start()) {
+                roc_log(LogError, "can't start impairer thread");
+                return 1;
+            }
+        }
+
+        packet::IWriter& packet_writer =
+            impair ? (packet::IWriter&)impairer : *udp_sender;
+
+        packet::Address control_addr = local_addr;
+        packet::IWriter* control_sender = &packet_writer;
+        if (has_control) {
+            control_sender = trx.add_udp_sender(control_addr);
+            if (!control_sender) {
+                roc_log(LogError, "can't create udp sender for control port");
+                return 1;
+            }
+        }
+
+        pipeline::Sender sender(config, source_port, packet_writer, repair_port,
+                                packet_writer, control_port, *control_sender,
+                                codec_map, format_map, packet_pool, byte_buffer_pool,
+                                sample_buffer_pool, allocator);
+        if (!sender.valid()) {
+            roc_log(LogError, "can't create sender pipeline");
+            return 1;
+        }
+
+        if (!add_destinations(sender, args)) {
+            return 1;
+        }
+
+        sndio::Pump pump(sample_buffer_pool, *source, sender,
+                         config.internal_frame_size, sndio::Pump::ModePermanent);
+        if (!pump.valid()) {
+            roc_log(LogError, "can't create audio pump");
+            return 1;
+        }
+
+        if (has_control && !trx.start_receiving(control_addr, sender)) {
+            roc_log(LogError, "can't receive control packets");
+            return 1;
+        }
+
+        // audio is processed on the main thread
+        core::set_thread_params(thread_params);
+
+        ok = pump.run();
+
+        if (impair) {
+            impairer_ticker.stop();
+            // send packets that are still delayed before the sender goes away
+            impairer.flush();
+        }
+
+        // stop passing control packets to sender before destroying it
+        if (has_control) {
+            trx.remove_port(control_addr);
+        }
     }
 
-    const bool ok = pump.run();
+    if (args.trace_given) {
+        core::print_trace_histogram();
+
+        if (!core::dump_trace_json(args.trace_arg)) {
+            ok = false;
+        }
+    }
 
     return ok ? 0 : 1;
 }